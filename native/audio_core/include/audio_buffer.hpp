@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace music_create::audio {
+
+// Non-owning view of `channels` x `frames` samples in caller memory. Sample
+// (c, f) lives at data[c * channel_stride + f * frame_stride], so one type
+// describes interleaved device and file buffers (frame stride = channels),
+// channel-major planar blocks (frame stride = 1) and any channel or frame
+// range of either without copying. Layout only changes at the boundaries
+// that need it, through CopyFrames.
+template <typename T>
+class BasicAudioBufferView {
+ public:
+  BasicAudioBufferView() noexcept = default;
+  BasicAudioBufferView(T* data, std::size_t channels, std::size_t frames, std::size_t channel_stride,
+                       std::size_t frame_stride) noexcept
+      : data_(data), channels_(channels), frames_(frames), channel_stride_(channel_stride),
+        frame_stride_(frame_stride) {}
+
+  // A writable view converts to a read-only one.
+  template <typename U>
+    requires std::is_same_v<const U, T> && (!std::is_same_v<U, T>)
+  BasicAudioBufferView(const BasicAudioBufferView<U>& other) noexcept
+      : BasicAudioBufferView(other.Data(), other.Channels(), other.Frames(), other.ChannelStride(),
+                             other.FrameStride()) {}
+
+  static BasicAudioBufferView Interleaved(T* data, std::size_t channels, std::size_t frames) noexcept {
+    return {data, channels, frames, 1, channels};
+  }
+
+  // Channel c occupies data[c * frames, (c + 1) * frames).
+  static BasicAudioBufferView Planar(T* data, std::size_t channels, std::size_t frames) noexcept {
+    return {data, channels, frames, frames, 1};
+  }
+
+  T* Data() const noexcept { return data_; }
+  std::size_t Channels() const noexcept { return channels_; }
+  std::size_t Frames() const noexcept { return frames_; }
+  std::size_t ChannelStride() const noexcept { return channel_stride_; }
+  std::size_t FrameStride() const noexcept { return frame_stride_; }
+
+  bool IsInterleaved() const noexcept { return channel_stride_ == 1 && frame_stride_ == channels_; }
+  // Each channel is contiguous (a single channel of an interleaved view is
+  // not, unless the view is mono).
+  bool IsPlanar() const noexcept { return frame_stride_ == 1; }
+
+  T& operator()(std::size_t channel, std::size_t frame) const noexcept {
+    return data_[channel * channel_stride_ + frame * frame_stride_];
+  }
+
+  BasicAudioBufferView Channel(std::size_t channel) const noexcept { return SubChannels(channel, 1); }
+
+  BasicAudioBufferView SubChannels(std::size_t first, std::size_t count) const noexcept {
+    return {data_ + first * channel_stride_, count, frames_, channel_stride_, frame_stride_};
+  }
+
+  BasicAudioBufferView SubFrames(std::size_t first, std::size_t count) const noexcept {
+    return {data_ + first * frame_stride_, channels_, count, channel_stride_, frame_stride_};
+  }
+
+ private:
+  T* data_ = nullptr;
+  std::size_t channels_ = 0;
+  std::size_t frames_ = 0;
+  std::size_t channel_stride_ = 0;
+  std::size_t frame_stride_ = 0;
+};
+
+using AudioBufferView = BasicAudioBufferView<float>;
+using ConstAudioBufferView = BasicAudioBufferView<const float>;
+
+// Stereo layout conversion, vectorized where the CPU allows.
+void InterleaveStereo(const float* left, const float* right, float* interleaved, std::size_t frames) noexcept;
+void DeinterleaveStereo(const float* interleaved, float* left, float* right, std::size_t frames) noexcept;
+
+// Copies the first min(channels) x min(frames) samples of `source` into
+// `destination`; the views must not overlap. Matching layouts copy channel
+// or frame runs, stereo interleaved <-> planar goes through the kernels
+// above, anything else is a strided loop.
+void CopyFrames(ConstAudioBufferView source, const AudioBufferView& destination) noexcept;
+
+}  // namespace music_create::audio
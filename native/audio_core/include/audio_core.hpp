@@ -1,5 +1,7 @@
 #pragma once
 
+#include "audio_export.hpp"
+
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -48,12 +50,6 @@ class AudioCore {
 
 extern "C" {
 
-#ifdef _WIN32
-#define MC_AUDIO_EXPORT __declspec(dllexport)
-#else
-#define MC_AUDIO_EXPORT
-#endif
-
 MC_AUDIO_EXPORT int mc_audio_start(unsigned int sample_rate, unsigned int buffer_size);
 MC_AUDIO_EXPORT int mc_audio_stop();
 MC_AUDIO_EXPORT int mc_audio_is_running();
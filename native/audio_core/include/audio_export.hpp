@@ -0,0 +1,7 @@
+#pragma once
+
+#ifdef _WIN32
+#define MC_AUDIO_EXPORT __declspec(dllexport)
+#else
+#define MC_AUDIO_EXPORT
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "audio_buffer.hpp"
+#include "audio_export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace music_create::audio {
+
+struct AudioFileInfo {
+  std::uint32_t sample_rate = 0;
+  std::uint32_t channels = 0;
+  std::uint32_t bits_per_sample = 0;
+  std::uint64_t total_frames = 0;
+};
+
+// Sequential reader with random access by frame. Reads return float frames
+// normalized to [-1, 1) and advance the position.
+class IAudioFileReader {
+ public:
+  virtual ~IAudioFileReader() = default;
+  virtual const AudioFileInfo& Info() const noexcept = 0;
+  virtual std::uint64_t Position() const noexcept = 0;
+  virtual bool Seek(std::uint64_t frame) = 0;
+
+  // Decodes up to out.Frames() frames straight into `out`, whatever its
+  // layout. Output channel c takes file channel min(c, channels - 1), so a
+  // mono file fills every channel and extra file channels are dropped.
+  // Returns the frames written.
+  virtual std::size_t ReadInto(const AudioBufferView& out) = 0;
+
+  // Interleaved frames with the file's own channel count.
+  std::size_t Read(float* interleaved, std::size_t frames) {
+    return ReadInto(AudioBufferView::Interleaved(interleaved, Info().channels, frames));
+  }
+};
+
+// Picks the decoder from the file signature (RIFF/WAVE or fLaC).
+// Throws std::runtime_error when the file cannot be opened or parsed.
+std::unique_ptr<IAudioFileReader> OpenAudioFileReader(const std::filesystem::path& path);
+std::unique_ptr<IAudioFileReader> OpenWavFileReader(const std::filesystem::path& path);
+std::unique_ptr<IAudioFileReader> OpenFlacFileReader(const std::filesystem::path& path);
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_audio_file mc_audio_file;
+
+MC_AUDIO_EXPORT mc_audio_file* mc_audio_file_open_w(const wchar_t* path);
+MC_AUDIO_EXPORT void mc_audio_file_close(mc_audio_file* file);
+MC_AUDIO_EXPORT int mc_audio_file_info(const mc_audio_file* file, unsigned int* sample_rate, unsigned int* channels,
+                                       unsigned int* bits_per_sample, unsigned long long* total_frames);
+MC_AUDIO_EXPORT int mc_audio_file_seek(mc_audio_file* file, unsigned long long frame);
+MC_AUDIO_EXPORT unsigned long long mc_audio_file_read_f32(mc_audio_file* file, float* interleaved,
+                                                          unsigned long long frames);
+// Planar read: channel c goes to planar[c * frames, c * frames + returned).
+MC_AUDIO_EXPORT unsigned long long mc_audio_file_read_planar_f32(mc_audio_file* file, float* planar,
+                                                                 unsigned long long frames);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "fdn_reverb.hpp"
+#include "audio_export.hpp"
+#include "graph_processor.hpp"
+#include "oversampler.hpp"
+#include "tempo_delay.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+struct EqParams {
+  float low_gain_db = 0.0f;
+  float mid_gain_db = 0.0f;
+  float high_gain_db = 0.0f;
+  float low_freq_hz = 120.0f;
+  float high_freq_hz = 5000.0f;
+};
+
+// Three-band EQ from two one-pole splits, as in the Python preview chain.
+class ThreeBandEq final : public IGraphProcessor {
+ public:
+  ThreeBandEq(std::uint32_t sample_rate, const EqParams& params);
+
+  void Reset() noexcept override;
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  float low_gain_;
+  float mid_gain_;
+  float high_gain_;
+  float low_alpha_;
+  float high_alpha_;
+  std::array<float, 2> low_state_{};
+  std::array<float, 2> high_state_{};
+};
+
+struct SaturatorParams {
+  float drive = 0.0f;
+  float mix = 0.0f;
+  std::size_t oversampling = 1;  // 1, 2, 4 or 8
+};
+
+// Normalized tanh waveshaper blended with the dry signal. With oversampling
+// the shaper runs at the higher rate, so the harmonics it adds above Nyquist
+// are filtered instead of folding back; the dry signal is delayed to match
+// and Latency() reports the round trip.
+class Saturator final : public IGraphProcessor {
+ public:
+  // Throws std::invalid_argument for an unsupported oversampling factor.
+  explicit Saturator(const SaturatorParams& params);
+
+  std::size_t Latency() const noexcept override { return oversamplers_[0].Latency(); }
+  void Reset() noexcept override;
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  static constexpr std::size_t kChunk = 256;
+
+  void Shape(float* samples, std::size_t count) const noexcept;
+
+  float shape_;
+  float inverse_normalizer_;
+  float mix_;
+  std::array<Oversampler, 2> oversamplers_;
+  std::array<std::vector<float>, 2> dry_delay_;  // one ring per channel
+  std::size_t dry_position_ = 0;
+  std::array<float, kChunk> wet_{};
+};
+
+// FdnReverb and TempoDelay run once per channel.
+class StereoReverb final : public IGraphProcessor {
+ public:
+  StereoReverb(std::uint32_t sample_rate, const FdnReverbParams& params);
+
+  void Reset() noexcept override;
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  FdnReverb left_;
+  FdnReverb right_;
+};
+
+class StereoDelay final : public IGraphProcessor {
+ public:
+  StereoDelay(std::uint32_t sample_rate, const TempoDelayParams& params);
+
+  void Reset() noexcept override;
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  TempoDelay left_;
+  TempoDelay right_;
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_saturator mc_saturator;
+
+// `oversampling` is 1, 2, 4 or 8; anything else fails.
+MC_AUDIO_EXPORT mc_saturator* mc_saturator_create(float drive, float mix, unsigned int oversampling);
+MC_AUDIO_EXPORT void mc_saturator_free(mc_saturator* saturator);
+MC_AUDIO_EXPORT unsigned int mc_saturator_latency(const mc_saturator* saturator);
+// Processes `left`/`right` in place; a null `right` processes `left` only.
+MC_AUDIO_EXPORT int mc_saturator_process(mc_saturator* saturator, float* left, float* right,
+                                         unsigned long long frames);
+MC_AUDIO_EXPORT int mc_saturator_reset(mc_saturator* saturator);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "audio_buffer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace music_create::audio {
+
+// Speaker layouts of mix graph nodes, channels in SMPTE order:
+//
+//   kMono        C
+//   kStereo      L R
+//   kLcr         L R C
+//   kSurround51  L R C LFE Ls Rs
+//   kSurround71  L R C LFE Ls Rs Lrs Rrs
+enum class ChannelLayout : std::uint8_t { kMono, kStereo, kLcr, kSurround51, kSurround71 };
+
+enum class Speaker : std::uint8_t {
+  kLeft,
+  kRight,
+  kCenter,
+  kLfe,
+  kSurroundLeft,
+  kSurroundRight,
+  kRearLeft,
+  kRearRight,
+};
+
+inline constexpr std::size_t kMaxLayoutChannels = 8;
+
+std::size_t ChannelCount(ChannelLayout layout) noexcept;
+// Throws std::out_of_range past ChannelCount(layout).
+Speaker SpeakerAt(ChannelLayout layout, std::size_t channel);
+// -1 for speakers on the left, 1 on the right, 0 for C and LFE.
+int SpeakerSide(Speaker speaker) noexcept;
+
+// Gains from `inputs` channels to `outputs` channels, row-major by output.
+struct ChannelMatrix {
+  std::size_t outputs = 0;
+  std::size_t inputs = 0;
+  std::array<float, kMaxLayoutChannels * kMaxLayoutChannels> gains{};
+
+  float& operator()(std::size_t output, std::size_t input) noexcept {
+    return gains[output * kMaxLayoutChannels + input];
+  }
+  float operator()(std::size_t output, std::size_t input) const noexcept {
+    return gains[output * kMaxLayoutChannels + input];
+  }
+  ChannelMatrix& operator*=(float gain) noexcept;
+};
+
+// Layout conversion: shared speakers pass at unity, a missing centre splits
+// into L/R at -3 dB (and mono takes L/R at -3 dB), missing surrounds fold
+// into the front at -3 dB, missing rears into the surrounds (or the front at
+// -3 dB), and LFE is dropped when the target has none. Identity for equal
+// layouts.
+ChannelMatrix DownmixMatrix(ChannelLayout from, ChannelLayout to) noexcept;
+// Positions a mono source in `to`: the equal-power law between L and R, or
+// between L, C and R (pan -1, 0 and 1) where there is a centre. LFE and the
+// surrounds get nothing; a mono target takes the source at unity.
+ChannelMatrix PanMatrix(ChannelLayout to, float pan) noexcept;
+
+// out(o, n) += sum over i of matrix(o, i) * in(i, n) for min(frames) frames;
+// the views must not overlap and must match the matrix shape. Planar views
+// run a vectorized kernel over the matrix's non-zero terms.
+void MixChannels(const ChannelMatrix& matrix, const ConstAudioBufferView& in,
+                 const AudioBufferView& out) noexcept;
+
+}  // namespace music_create::audio
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "fft.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace music_create::audio {
+
+// Impulse response split into pre-transformed partitions. The first
+// 2 * kTailRatio blocks use `block_size` partitions; anything longer goes to
+// partitions kTailRatio times larger, so a multi-second IR costs a handful of
+// large spectra instead of hundreds of small ones. Immutable once built, so
+// one instance can be shared by any number of convolvers.
+class ConvolutionIr {
+ public:
+  static constexpr std::size_t kTailRatio = 16;
+  static constexpr std::size_t kMinBlockSize = 16;
+  static constexpr std::size_t kMaxBlockSize = 8192;
+
+  // Throws std::invalid_argument for an empty IR or a block size that is not
+  // a power of two in [kMinBlockSize, kMaxBlockSize].
+  ConvolutionIr(const float* ir, std::size_t length, std::size_t block_size);
+
+  std::size_t Length() const noexcept { return length_; }
+  std::size_t BlockSize() const noexcept { return block_size_; }
+  std::size_t TailBlockSize() const noexcept { return block_size_ * kTailRatio; }
+  std::size_t HeadPartitions() const noexcept { return head_partitions_; }
+  std::size_t TailPartitions() const noexcept { return tail_partitions_; }
+
+  // Spectrum of partition `index`: BlockSize() + 1 (head) or TailBlockSize() + 1 (tail) bins.
+  const std::complex<float>* HeadSpectrum(std::size_t index) const noexcept {
+    return head_.data() + index * (block_size_ + 1);
+  }
+  const std::complex<float>* TailSpectrum(std::size_t index) const noexcept {
+    return tail_.data() + index * (TailBlockSize() + 1);
+  }
+
+ private:
+  std::size_t length_;
+  std::size_t block_size_;
+  std::size_t head_partitions_ = 0;
+  std::size_t tail_partitions_ = 0;
+  std::vector<std::complex<float>> head_;
+  std::vector<std::complex<float>> tail_;
+};
+
+// Mono uniformly partitioned overlap-save convolver with a frequency-domain
+// delay line. Output lags input by exactly BlockSize() samples. Tail
+// partitions are scheduled across the kTailRatio head blocks of each tail
+// period (input FFT, a slice of the multiply-accumulates, inverse FFT), so no
+// single block pays for a whole large transform. Process neither locks nor
+// allocates.
+class PartitionedConvolver {
+ public:
+  explicit PartitionedConvolver(std::shared_ptr<const ConvolutionIr> ir);
+
+  const ConvolutionIr& Ir() const noexcept { return *ir_; }
+  std::size_t Latency() const noexcept { return ir_->BlockSize(); }
+
+  // `in` and `out` may alias.
+  void Process(const float* in, float* out, std::size_t frames) noexcept;
+  void Reset() noexcept;
+
+ private:
+  void ProcessBlock() noexcept;
+  void ProcessTail(std::size_t phase) noexcept;
+
+  std::shared_ptr<const ConvolutionIr> ir_;
+  std::size_t block_size_;
+  RealFft head_fft_;
+  std::unique_ptr<RealFft> tail_fft_;
+
+  std::vector<float> input_;   // block being collected
+  std::vector<float> output_;  // result of the previous block
+  std::size_t fill_ = 0;
+  std::size_t block_index_ = 0;
+
+  std::vector<float> head_window_;  // previous block followed by the current one
+  std::vector<std::complex<float>> head_delay_line_;
+  std::size_t head_cursor_ = 0;
+  std::vector<std::complex<float>> head_sum_;
+  std::vector<float> head_time_;
+
+  std::vector<float> tail_window_;
+  std::vector<std::complex<float>> tail_delay_line_;
+  std::size_t tail_cursor_ = 0;
+  std::vector<std::complex<float>> tail_sum_;
+  std::vector<float> tail_time_;
+  std::vector<float> tail_current_;  // tail output of the running period
+  std::vector<float> tail_next_;     // tail output being built for the next period
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_convolution_ir mc_convolution_ir;
+typedef struct mc_convolver mc_convolver;
+
+MC_AUDIO_EXPORT mc_convolution_ir* mc_convolution_ir_create(const float* ir, unsigned long long length,
+                                                            unsigned int block_size);
+// Convolvers created from the IR keep it alive after this call.
+MC_AUDIO_EXPORT void mc_convolution_ir_free(mc_convolution_ir* ir);
+MC_AUDIO_EXPORT unsigned long long mc_convolution_ir_length(const mc_convolution_ir* ir);
+
+MC_AUDIO_EXPORT mc_convolver* mc_convolver_create(const mc_convolution_ir* ir);
+MC_AUDIO_EXPORT void mc_convolver_free(mc_convolver* convolver);
+MC_AUDIO_EXPORT unsigned int mc_convolver_latency(const mc_convolver* convolver);
+MC_AUDIO_EXPORT int mc_convolver_process(mc_convolver* convolver, const float* in, float* out,
+                                         unsigned long long frames);
+MC_AUDIO_EXPORT int mc_convolver_reset(mc_convolver* convolver);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MC_AUDIO_X86_DISPATCH 1
+#define MC_AUDIO_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MC_AUDIO_X86_DISPATCH 0
+#define MC_AUDIO_TARGET(isa)
+#endif
+
+namespace music_create::audio {
+
+struct CpuFeatures {
+  bool sse41 = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+};
+
+inline const CpuFeatures& DetectCpuFeatures() noexcept {
+  static const CpuFeatures features = [] {
+    CpuFeatures detected;
+#if MC_AUDIO_X86_DISPATCH
+    __builtin_cpu_init();
+    detected.sse41 = __builtin_cpu_supports("sse4.1");
+    detected.avx2 = __builtin_cpu_supports("avx2");
+    detected.fma = __builtin_cpu_supports("fma");
+    detected.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+    return detected;
+  }();
+  return features;
+}
+
+}  // namespace music_create::audio
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MC_AUDIO_DENORMALS_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define MC_AUDIO_DENORMALS_FPCR 1
+#endif
+
+namespace music_create::audio {
+
+// Puts the calling thread into a real-time numeric mode for its lifetime:
+// flush-to-zero and denormals-are-zero on x86 (MXCSR), flush-to-zero on
+// AArch64 (FPCR.FZ), nothing elsewhere. Denormal operands cost 10-100x on
+// x86, and decaying filter, envelope and feedback states pass through that
+// range in every silent tail. The previous mode is restored on destruction,
+// so guards nest and can wrap C API entry points that run on a host's
+// thread.
+class ScopedDenormalGuard {
+ public:
+  ScopedDenormalGuard() noexcept : saved_(Read()) { Write(saved_ | kFlushBits); }
+  ~ScopedDenormalGuard() { Write(saved_); }
+
+  ScopedDenormalGuard(const ScopedDenormalGuard&) = delete;
+  ScopedDenormalGuard& operator=(const ScopedDenormalGuard&) = delete;
+
+  // True when the calling thread flushes denormals (always false on
+  // platforms without a supported control register).
+  static bool Active() noexcept { return kFlushBits != 0 && (Read() & kFlushBits) == kFlushBits; }
+
+ private:
+#if defined(MC_AUDIO_DENORMALS_MXCSR)
+  static constexpr std::uint64_t kFlushBits = 0x8040;  // FTZ | DAZ
+  static std::uint64_t Read() noexcept { return _mm_getcsr(); }
+  static void Write(std::uint64_t value) noexcept { _mm_setcsr(static_cast<unsigned int>(value)); }
+#elif defined(MC_AUDIO_DENORMALS_FPCR)
+  static constexpr std::uint64_t kFlushBits = std::uint64_t{1} << 24;  // FZ
+  static std::uint64_t Read() noexcept {
+    std::uint64_t value;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(value));
+    return value;
+  }
+  static void Write(std::uint64_t value) noexcept { __asm__ __volatile__("msr fpcr, %0" : : "r"(value)); }
+#else
+  static constexpr std::uint64_t kFlushBits = 0;
+  static std::uint64_t Read() noexcept { return 0; }
+  static void Write(std::uint64_t) noexcept {}
+#endif
+
+  std::uint64_t saved_;
+};
+
+// Recursive states below this (about -300 dB) are inaudible. Kernels flush
+// their filter, envelope and feedback states with FlushDenormal as they
+// update them, so a silent tail reaches exact zero instead of decaying
+// through the denormal range, even on a thread without the guard. A
+// compare-and-mask per state is far cheaper than one denormal operation.
+inline constexpr float kDenormalFloor = 1e-15f;
+
+inline float FlushDenormal(float value) noexcept { return std::abs(value) < kDenormalFloor ? 0.0f : value; }
+
+}  // namespace music_create::audio
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "audio_export.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+// Synthesis recipes of the preview drum kit; every GM pitch that is not a
+// kick, snare or hi-hat plays the generic percussion tone.
+enum class DrumShape : int {
+  kKick = 0,
+  kSnare,
+  kClosedHat,
+  kOpenHat,
+  kPercussion,
+  kCount,
+};
+
+DrumShape DrumShapeForPitch(int pitch) noexcept;
+
+struct DrumHit {
+  std::int64_t start_sample = 0;
+  std::int64_t length_samples = 0;
+  int pitch = 36;
+  float amplitude = 1.0f;
+};
+
+// Unit-amplitude one-shots, rendered once per shape and extended in
+// kLengthBucket steps when a longer hit arrives. A hit only depends on its
+// shape, a linear gain and how much of the shape it plays, so mixing becomes
+// a scaled add of a cached prefix instead of per-sample sin/exp.
+class DrumOneShotCache {
+ public:
+  static constexpr std::size_t kLengthBucket = 4096;
+
+  // Throws std::invalid_argument for a zero sample rate.
+  explicit DrumOneShotCache(std::uint32_t sample_rate);
+
+  std::uint32_t SampleRate() const noexcept { return sample_rate_; }
+  // At least `length` samples of `shape`; valid until the next call that grows it.
+  const float* Shape(DrumShape shape, std::size_t length);
+  std::size_t CachedSamples() const noexcept;
+
+  // Mixes hits into `out` (mono, `frames` long); hits outside the buffer are clipped.
+  void MixHits(const DrumHit* hits, std::size_t count, float* out, std::size_t frames);
+
+ private:
+  std::uint32_t sample_rate_;
+  std::array<std::vector<float>, static_cast<std::size_t>(DrumShape::kCount)> shapes_;
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_drum_cache mc_drum_cache;
+
+MC_AUDIO_EXPORT mc_drum_cache* mc_drum_cache_create(unsigned int sample_rate);
+MC_AUDIO_EXPORT void mc_drum_cache_free(mc_drum_cache* cache);
+MC_AUDIO_EXPORT unsigned long long mc_drum_cache_samples(const mc_drum_cache* cache);
+MC_AUDIO_EXPORT int mc_drum_cache_render_hits(mc_drum_cache* cache, unsigned long long count,
+                                              const long long* start_sample, const long long* length_samples,
+                                              const int* pitch, const float* amplitude, float* out,
+                                              unsigned long long frames);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "graph_processor.hpp"
+
+#include <cstdint>
+
+namespace music_create::audio {
+
+struct CompressorParams {
+  float threshold_db = -18.0f;
+  float ratio = 3.0f;
+  float attack_ms = 12.0f;
+  float release_ms = 120.0f;
+  float makeup_db = 0.0f;
+};
+
+// Feed-forward peak compressor; one gain for both channels, detected from
+// the louder key channel.
+class Compressor final : public IGraphProcessor {
+ public:
+  Compressor(std::uint32_t sample_rate, const CompressorParams& params);
+
+  void Reset() noexcept override { envelope_ = 0.0f; }
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  float threshold_db_;
+  float threshold_;
+  float inverse_ratio_;
+  float attack_;
+  float release_;
+  float makeup_;
+  float envelope_ = 0.0f;
+};
+
+struct GateParams {
+  float threshold_db = -40.0f;
+  float attack_ms = 2.0f;
+  float release_ms = 120.0f;
+};
+
+// Smoothed on/off gate keyed like Compressor.
+class Gate final : public IGraphProcessor {
+ public:
+  Gate(std::uint32_t sample_rate, const GateParams& params);
+
+  void Reset() noexcept override { envelope_ = gain_ = 0.0f; }
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  float threshold_;
+  float attack_;
+  float release_;
+  float envelope_ = 0.0f;
+  float gain_ = 0.0f;
+};
+
+// exp(-1 / (time_ms * sample_rate / 1000)), the one-pole coefficient of the
+// Python preview chain, read from the OnePoleCoefficient table; 0 for
+// non-positive times.
+float TimeCoefficient(float time_ms, std::uint32_t sample_rate) noexcept;
+float DbToGain(float db) noexcept;
+
+}  // namespace music_create::audio
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace music_create::audio {
+
+// Fast float approximations for per-sample DSP. Each has a maximum error
+// against the libm result in double precision, checked by the sweeps in
+// native/tests/fast_math_accuracy.cpp:
+//
+//   FastLog2     positive normal x            error <= kFastLog2MaxError
+//   FastExp2     x in [-126, 127] (clamped)   rel error <= kFastExp2MaxRelError
+//   FastGainToDb gain > 0 (floored at 1e-30)  error <= kFastGainToDbMaxError dB
+//   FastDbToGain db in [-758, 764] (clamped)  rel error <= kFastDbToGainMaxRelError
+//   FastTanh     any x                        abs error <= kFastTanhMaxError
+//   FastSin      |x| <= 16384                 abs error <= kFastSinMaxError
+//
+// The log2 and dB errors are absolute below magnitude one and relative above,
+// where the float result itself has less absolute resolution; the dB-to-gain
+// bound is dominated by rounding db * log2(10) / 20 for very large |db|.
+// The scalar forms are inline so they vectorize inside callers' loops; the
+// *Block forms run explicit AVX2/FMA kernels when the CPU has them and meet
+// the same bounds.
+inline constexpr float kFastLog2MaxError = 2.0e-7f;
+inline constexpr float kFastExp2MaxRelError = 2.0e-7f;
+inline constexpr float kFastGainToDbMaxError = 5.0e-7f;
+inline constexpr float kFastDbToGainMaxRelError = 4.0e-6f;
+inline constexpr float kFastTanhMaxError = 2.0e-7f;
+inline constexpr float kFastSinMaxError = 5.0e-7f;
+
+namespace fast_math_detail {
+
+inline constexpr float kSqrt2 = 1.41421356237309505f;
+inline constexpr float kTwoOverLn2 = 2.88539008177792681f;  // log2(e) * 2
+inline constexpr float kLog2OfTenOver20 = 0.166096404744368118f;
+inline constexpr float kDbPerLog2 = 6.02059991327962390f;
+inline constexpr float kMinGain = 1e-30f;
+inline constexpr float kInvTwoPi = 0.159154943091895336f;
+// 2*pi split so that turns * kTwoPiHigh is exact for |turns| < 2^16.
+inline constexpr float kTwoPiHigh = 6.28125f;
+inline constexpr float kTwoPiLow = 0.00193530717958647692f;
+inline constexpr float kPi = 3.14159265358979324f;
+inline constexpr float kHalfPi = 1.57079632679489662f;
+
+// 2^f on [-0.5, 0.5]: Taylor series of e^(f ln 2) to degree 7.
+inline constexpr float kExp2Coefficients[] = {1.0f,
+                                              0.693147180559945309f,
+                                              0.240226506959100712f,
+                                              0.0555041086648215800f,
+                                              0.00961812910762847717f,
+                                              0.00133335581464284434f,
+                                              0.000154035303933816100f,
+                                              0.0000152527338040598403f};
+// log2(m) for m in [sqrt(0.5), sqrt(2)] is t * P(t^2) with t = (m - 1) /
+// (m + 1): the atanh series 2 / ln 2 * (t + t^3 / 3 + ... + t^9 / 9).
+inline constexpr float kLog2Coefficients[] = {kTwoOverLn2, 0.961796693925975604f, 0.577078016355585363f,
+                                              0.412198583111132402f, 0.320598897975325201f};
+// sin(r) for r in [-pi/2, pi/2] is r * P(r^2): Taylor series to degree 11.
+inline constexpr float kSinCoefficients[] = {1.0f,
+                                             -0.166666666666666667f,
+                                             0.00833333333333333333f,
+                                             -0.000198412698412698413f,
+                                             2.75573192239858907e-6f,
+                                             -2.50521083854417188e-8f};
+
+template <std::size_t N>
+inline float Horner(float x, const float (&coefficients)[N]) noexcept {
+  float acc = coefficients[N - 1];
+  for (std::size_t i = N - 1; i-- > 0;) {
+    acc = acc * x + coefficients[i];
+  }
+  return acc;
+}
+
+}  // namespace fast_math_detail
+
+inline float FastLog2(float x) noexcept {
+  using namespace fast_math_detail;
+  const auto bits = std::bit_cast<std::uint32_t>(x);
+  float exponent = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+  float mantissa = std::bit_cast<float>((bits & 0x007FFFFFu) | 0x3F800000u);
+  const bool high = mantissa > kSqrt2;
+  mantissa = high ? mantissa * 0.5f : mantissa;
+  exponent += high ? 1.0f : 0.0f;
+  const float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+  return exponent + t * Horner(t * t, kLog2Coefficients);
+}
+
+inline float FastExp2(float x) noexcept {
+  using namespace fast_math_detail;
+  const float clamped = std::clamp(x, -126.0f, 127.0f);
+  const float whole = std::nearbyint(clamped);
+  const auto scale = std::bit_cast<float>(static_cast<std::uint32_t>(static_cast<int>(whole) + 127) << 23);
+  return Horner(clamped - whole, kExp2Coefficients) * scale;
+}
+
+inline float FastGainToDb(float gain) noexcept {
+  return FastLog2(std::max(gain, fast_math_detail::kMinGain)) * fast_math_detail::kDbPerLog2;
+}
+
+inline float FastDbToGain(float db) noexcept { return FastExp2(db * fast_math_detail::kLog2OfTenOver20); }
+
+inline float FastTanh(float x) noexcept {
+  // tanh saturates to 1 in float beyond |x| = 9.
+  const float e = FastExp2(std::clamp(x, -9.0f, 9.0f) * fast_math_detail::kTwoOverLn2);
+  return (e - 1.0f) / (e + 1.0f);
+}
+
+inline float FastSin(float x) noexcept {
+  using namespace fast_math_detail;
+  const float turns = std::nearbyint(x * kInvTwoPi);
+  float r = (x - turns * kTwoPiHigh) - turns * kTwoPiLow;
+  // Fold [-pi, pi] onto [-pi/2, pi/2] with sin(pi - r) = sin(r).
+  r = r > kHalfPi ? kPi - r : r;
+  r = r < -kHalfPi ? -kPi - r : r;
+  return r * Horner(r * r, kSinCoefficients);
+}
+
+// out[i] = Fast*(in[i]); `in` and `out` may alias.
+void FastLog2Block(const float* in, float* out, std::size_t count) noexcept;
+void FastExp2Block(const float* in, float* out, std::size_t count) noexcept;
+void FastGainToDbBlock(const float* in, float* out, std::size_t count) noexcept;
+void FastDbToGainBlock(const float* in, float* out, std::size_t count) noexcept;
+void FastTanhBlock(const float* in, float* out, std::size_t count) noexcept;
+void FastSinBlock(const float* in, float* out, std::size_t count) noexcept;
+
+}  // namespace music_create::audio
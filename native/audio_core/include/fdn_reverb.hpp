@@ -0,0 +1,77 @@
+#pragma once
+
+#include "audio_export.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+struct FdnReverbParams {
+  float mix = 0.0f;  // 0 = dry, 1 = wet only (send use)
+  float decay_seconds = 1.8f;
+  float pre_delay_ms = 10.0f;
+  float damping = 0.4f;  // high-frequency loss inside the loop
+  float size = 0.6f;     // scales every delay line
+};
+
+// Eight-line feedback delay network with a normalized Hadamard feedback
+// matrix and a one-pole damping filter per line. The lines are interleaved in
+// one ring so a frame of all eight taps is a single gather, and the matrix is
+// three add/sub butterflies; the AVX2 kernel keeps the whole network in one
+// register. Changing parameters never reallocates. The damping states and the
+// feedback written back into the lines are flushed below kDenormalFloor, so a
+// decayed tail reaches zero.
+class FdnReverb {
+ public:
+  static constexpr std::size_t kLines = 8;
+  static constexpr float kMaxPreDelayMs = 200.0f;
+
+  // Throws std::invalid_argument for a zero sample rate.
+  explicit FdnReverb(std::uint32_t sample_rate);
+
+  void SetParams(const FdnReverbParams& params) noexcept;
+  const FdnReverbParams& Params() const noexcept { return params_; }
+  // `in` and `out` may alias.
+  void Process(const float* in, float* out, std::size_t frames) noexcept;
+  void Reset() noexcept;
+
+ private:
+  struct State {
+    float* lines = nullptr;  // kLines floats per frame
+    std::uint32_t line_mask = 0;
+    std::uint32_t write = 0;
+    alignas(32) std::array<std::int32_t, kLines> length{};
+    alignas(32) std::array<float, kLines> gain{};
+    alignas(32) std::array<float, kLines> lowpass{};
+    float damping = 0.0f;
+    float* pre_delay = nullptr;
+    std::uint32_t pre_mask = 0;
+    std::uint32_t pre_write = 0;
+    std::uint32_t pre_length = 0;
+    float mix = 0.0f;
+  };
+
+  std::uint32_t sample_rate_;
+  FdnReverbParams params_;
+  std::vector<float> lines_;
+  std::vector<float> pre_delay_;
+  State state_;
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_fdn_reverb mc_fdn_reverb;
+
+MC_AUDIO_EXPORT mc_fdn_reverb* mc_fdn_reverb_create(unsigned int sample_rate);
+MC_AUDIO_EXPORT void mc_fdn_reverb_free(mc_fdn_reverb* reverb);
+MC_AUDIO_EXPORT int mc_fdn_reverb_set_params(mc_fdn_reverb* reverb, float mix, float decay_seconds,
+                                             float pre_delay_ms, float damping, float size);
+MC_AUDIO_EXPORT int mc_fdn_reverb_process(mc_fdn_reverb* reverb, const float* in, float* out,
+                                          unsigned long long frames);
+MC_AUDIO_EXPORT int mc_fdn_reverb_reset(mc_fdn_reverb* reverb);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+// Real-input FFT of a fixed power-of-two size, computed through a half-size
+// complex radix-2 transform. Forward yields the Bins() non-negative
+// frequencies; Inverse is normalized, so Inverse(Forward(x)) == x. Twiddles
+// and scratch are allocated by the constructor; transforms do not allocate.
+// An instance is not safe to use from two threads at once.
+class RealFft {
+ public:
+  // Throws std::invalid_argument unless `size` is a power of two >= 4.
+  explicit RealFft(std::size_t size);
+
+  std::size_t Size() const noexcept { return size_; }
+  std::size_t Bins() const noexcept { return size_ / 2 + 1; }
+
+  void Forward(const float* in, std::complex<float>* out) noexcept;
+  void Inverse(const std::complex<float>* in, float* out) noexcept;
+
+ private:
+  void Transform(std::complex<float>* data, bool inverse) const noexcept;
+
+  std::size_t size_;
+  std::vector<std::uint32_t> bit_reverse_;
+  std::vector<std::complex<float>> twiddles_;       // e^(-2πik/(size/2)), k < size/4
+  std::vector<std::complex<float>> real_twiddles_;  // e^(-2πik/size), k <= size/2
+  std::vector<std::complex<float>> scratch_;
+};
+
+// acc[i] += a[i] * b[i] over `count` complex values; AVX2/FMA or SSE when the
+// CPU has them.
+void ComplexMultiplyAccumulate(const std::complex<float>* a, const std::complex<float>* b,
+                               std::complex<float>* acc, std::size_t count) noexcept;
+
+}  // namespace music_create::audio
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "audio_file_reader.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace music_create::audio {
+
+struct FlacSeekPoint {
+  std::uint64_t sample = 0;
+  std::uint64_t byte_offset = 0;  // relative to the first frame header
+};
+
+// Frame-level FLAC decoder. The file is read through a sliding byte window
+// sized to the largest frame, so memory use does not grow with file length.
+// Seeking uses the SEEKTABLE block plus frames already visited, falling back
+// to bisection over frame headers when neither is close to the target.
+class FlacDecoder final : public IAudioFileReader {
+ public:
+  explicit FlacDecoder(const std::filesystem::path& path);
+
+  const AudioFileInfo& Info() const noexcept override { return info_; }
+  std::uint64_t Position() const noexcept override { return position_; }
+  bool Seek(std::uint64_t frame) override;
+  std::size_t ReadInto(const AudioBufferView& out) override;
+
+  const std::vector<FlacSeekPoint>& SeekPoints() const noexcept { return seek_points_; }
+
+ private:
+  struct FrameHeader {
+    std::uint64_t first_sample = 0;
+    std::uint32_t block_size = 0;
+    std::uint32_t channel_assignment = 0;
+    std::uint32_t bits_per_sample = 0;
+    std::size_t header_bytes = 0;
+  };
+
+  void ParseMetadata();
+  bool FillWindow(std::uint64_t offset, std::size_t min_bytes);
+  bool ParseFrameHeader(const std::uint8_t* data, std::size_t size, FrameHeader* header) const;
+  bool FindFrameAtOrAfter(std::uint64_t offset, std::uint64_t* found_offset, FrameHeader* header);
+  bool DecodeFrameAt(std::uint64_t offset);
+  void RememberFrame(std::uint64_t sample, std::uint64_t offset);
+  FlacSeekPoint NearestKnownFrame(std::uint64_t sample) const;
+  std::uint64_t BisectFrameOffset(std::uint64_t sample, const FlacSeekPoint& lower);
+
+  std::ifstream file_;
+  AudioFileInfo info_{};
+  std::uint32_t min_block_size_ = 0;
+  std::uint32_t max_block_size_ = 0;
+  std::uint32_t max_frame_bytes_ = 0;
+  std::uint64_t first_frame_offset_ = 0;
+  std::uint64_t file_size_ = 0;
+
+  std::vector<FlacSeekPoint> seek_points_;
+  std::vector<FlacSeekPoint> visited_frames_;
+
+  std::vector<std::uint8_t> window_;
+  std::uint64_t window_offset_ = 0;
+
+  std::vector<std::int32_t> decoded_;  // planar, block_size per channel
+  std::vector<std::int32_t> scratch_;
+  std::uint64_t decoded_first_sample_ = 0;
+  std::uint32_t decoded_frames_ = 0;
+  std::uint64_t next_frame_offset_ = 0;
+  std::uint64_t position_ = 0;
+};
+
+}  // namespace music_create::audio
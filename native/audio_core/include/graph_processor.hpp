@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace music_create::audio {
+
+// One effect in a MixGraph node chain, processing planar stereo in place.
+// `key_left`/`key_right` are the detector input: the block buffer of the
+// node routed in as sidechain, or the processor's own channels, in which
+// case they alias `left`/`right` and sample n of the key must be read before
+// sample n is written. Process must not lock or allocate.
+class IGraphProcessor {
+ public:
+  virtual ~IGraphProcessor() = default;
+  // Samples by which the output lags the input.
+  virtual std::size_t Latency() const noexcept { return 0; }
+  virtual void Reset() noexcept {}
+  virtual void Process(float* left, float* right, const float* key_left, const float* key_right,
+                       std::size_t frames) noexcept = 0;
+};
+
+}  // namespace music_create::audio
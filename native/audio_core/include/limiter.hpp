@@ -0,0 +1,76 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "graph_processor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+struct LimiterParams {
+  float ceiling_db = -1.0f;
+  float lookahead_ms = 5.0f;
+  float release_ms = 80.0f;
+};
+
+// Stereo-linked lookahead brickwall limiter. The audio is delayed by the
+// lookahead L; the gain each sample needs is held over L + 1 samples with a
+// monotonic-deque sliding minimum (amortized O(1) per sample), released with
+// a one-pole and averaged over the same L + 1 samples, so the gain ramps down
+// before a peak arrives and never exceeds what the delayed sample needs.
+class Limiter final : public IGraphProcessor {
+ public:
+  // Throws std::invalid_argument for a zero sample rate.
+  Limiter(std::uint32_t sample_rate, const LimiterParams& params);
+
+  std::size_t Latency() const noexcept override { return lookahead_; }
+  void Reset() noexcept override;
+  // Limits in place; the key inputs are ignored.
+  void Process(float* left, float* right, const float* key_left, const float* key_right,
+               std::size_t frames) noexcept override;
+
+ private:
+  // Ring positions below 2 * window_ wrap without a division.
+  std::size_t Wrap(std::size_t position) const noexcept {
+    return position >= window_ ? position - window_ : position;
+  }
+
+  float ceiling_;
+  float release_;
+  std::size_t lookahead_;
+  std::size_t window_;
+  std::uint64_t index_ = 0;
+
+  // Delay line, one slot per lookahead sample and channel (interleaved).
+  std::vector<float> delay_;
+  std::size_t delay_pos_ = 0;
+
+  // Ring of (index, required gain) pairs with increasing gains.
+  std::vector<std::uint64_t> deque_index_;
+  std::vector<float> deque_gain_;
+  std::size_t deque_head_ = 0;
+  std::size_t deque_size_ = 0;
+
+  float released_ = 1.0f;
+  std::vector<float> average_;
+  std::size_t average_pos_ = 0;
+  double average_sum_ = 0.0;
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_limiter mc_limiter;
+
+MC_AUDIO_EXPORT mc_limiter* mc_limiter_create(unsigned int sample_rate, float ceiling_db, float lookahead_ms,
+                                              float release_ms);
+MC_AUDIO_EXPORT void mc_limiter_free(mc_limiter* limiter);
+// Latency in samples (the lookahead).
+MC_AUDIO_EXPORT unsigned int mc_limiter_latency(const mc_limiter* limiter);
+// Limits `left`/`right` in place; a null `right` processes `left` as mono.
+MC_AUDIO_EXPORT int mc_limiter_process(mc_limiter* limiter, float* left, float* right, unsigned long long frames);
+MC_AUDIO_EXPORT int mc_limiter_reset(mc_limiter* limiter);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+// A tempo holding from `beat` (quarter notes from the song start) until the
+// next point.
+struct TempoPoint {
+  double beat = 0.0;
+  double bpm = 120.0;
+};
+
+// A meter from `beat`, which starts a bar: one click per 1/denominator note,
+// the first of each bar accented.
+struct MeterPoint {
+  double beat = 0.0;
+  int numerator = 4;
+  int denominator = 4;
+};
+
+// Click track driven by a tempo map and meter. The accent and normal clicks
+// are synthesized once; Render() adds them at the exact frames the tempo map
+// puts the beats on (rounded to the nearest frame, independent of the block
+// size) and otherwise only counts frames, so it costs next to nothing. A
+// click cuts off the one before it. Render() neither locks nor allocates;
+// not thread safe.
+class Metronome {
+ public:
+  static constexpr float kClickMs = 30.0f;
+
+  // Starts at 120 BPM in 4/4.
+  explicit Metronome(std::uint32_t sample_rate);
+
+  // Throws std::invalid_argument unless both maps start at beat 0 with
+  // increasing beats, tempos lie in (0, 1000] BPM and meters have 1 to 32
+  // beats of a power-of-two note up to a 32nd. Seeks to frame 0.
+  void SetTempoMap(std::vector<TempoPoint> tempo, std::vector<MeterPoint> meter);
+  double BeatToFrame(double beat) const noexcept;
+  double FrameToBeat(double frame) const noexcept;
+
+  // Moves to timeline frame `frame`; a click begun just before it plays on
+  // from the middle.
+  void Seek(std::uint64_t frame) noexcept;
+  // Adds `gain` times the clicks of the next `frames` frames to each of
+  // `channels` outputs and advances; with no channels it only advances.
+  void Render(float* const* out, std::size_t channels, std::size_t frames, float gain) noexcept;
+  std::uint64_t Position() const noexcept { return position_; }
+
+  const std::vector<float>& Click(bool accent) const noexcept { return accent ? accent_ : normal_; }
+
+ private:
+  // Moves the schedule to the click after the current one.
+  void Advance() noexcept;
+  void Locate(std::size_t meter, std::int64_t index) noexcept;
+
+  std::uint32_t sample_rate_;
+  std::vector<float> accent_;
+  std::vector<float> normal_;
+  std::vector<TempoPoint> tempo_;
+  std::vector<double> tempo_frames_;  // timeline frame of each tempo point
+  std::vector<MeterPoint> meter_;
+
+  std::uint64_t position_ = 0;
+  std::size_t meter_index_ = 0;  // schedule: click `click_index_` of meter_[meter_index_]
+  std::int64_t click_index_ = 0;
+  std::uint64_t next_frame_ = 0;
+  bool next_accent_ = true;
+  const std::vector<float>* sounding_ = nullptr;
+  std::size_t sounded_ = 0;  // frames of the sounding click already played
+};
+
+}  // namespace music_create::audio
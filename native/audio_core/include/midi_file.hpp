@@ -0,0 +1,91 @@
+#pragma once
+
+#include "audio_export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace music_create::audio {
+
+// Notes in structure-of-arrays form; ticks are already rescaled to the
+// target resolution requested by the caller.
+struct SmfNoteArrays {
+  std::vector<std::int32_t> start_tick;
+  std::vector<std::int32_t> length_tick;
+  std::vector<std::uint8_t> pitch;
+  std::vector<std::uint8_t> velocity;
+  std::vector<std::uint8_t> channel;
+  std::vector<std::uint16_t> track;
+
+  std::size_t size() const noexcept { return start_tick.size(); }
+  void reserve(std::size_t count);
+  void push_back(std::int32_t start, std::int32_t length, std::uint8_t note, std::uint8_t vel, std::uint8_t ch,
+                 std::uint16_t trk);
+};
+
+struct SmfTempoPoint {
+  std::int32_t tick = 0;
+  std::uint32_t microseconds_per_quarter = 500000;
+};
+
+struct SmfTimeSignature {
+  std::int32_t tick = 0;
+  std::uint8_t numerator = 4;
+  std::uint8_t denominator = 4;
+};
+
+struct SmfData {
+  std::uint32_t ticks_per_beat = 960;
+  std::uint16_t track_count = 0;
+  SmfNoteArrays notes;
+  std::vector<SmfTempoPoint> tempo_map;
+  std::vector<SmfTimeSignature> time_signatures;
+  std::vector<std::string> track_names;
+  // First program change per (track, channel), -1 when the track never sets one.
+  std::vector<std::int16_t> programs;
+
+  std::int16_t Program(std::uint16_t track_index, std::uint8_t channel_index) const noexcept;
+  void SetProgram(std::uint16_t track_index, std::uint8_t channel_index, std::int16_t program);
+};
+
+// Parses format 0/1 files. SMPTE time division is mapped onto beats at 120 BPM.
+// Throws std::runtime_error on malformed input.
+SmfData ParseSmf(const std::uint8_t* data, std::size_t size, std::uint32_t target_ticks_per_beat);
+SmfData ReadSmfFile(const std::filesystem::path& path, std::uint32_t target_ticks_per_beat);
+
+// Writes a format 1 file: a conductor track with tempo/meter, then one track per
+// distinct `track` index in the note arrays.
+std::vector<std::uint8_t> SerializeSmf(const SmfData& data);
+void WriteSmfFile(const std::filesystem::path& path, const SmfData& data);
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_smf mc_smf;
+
+MC_AUDIO_EXPORT mc_smf* mc_smf_read_file_w(const wchar_t* path, unsigned int target_ticks_per_beat);
+MC_AUDIO_EXPORT mc_smf* mc_smf_read_memory(const unsigned char* data, unsigned long long size,
+                                           unsigned int target_ticks_per_beat);
+MC_AUDIO_EXPORT mc_smf* mc_smf_create(unsigned int ticks_per_beat);
+MC_AUDIO_EXPORT void mc_smf_free(mc_smf* smf);
+MC_AUDIO_EXPORT unsigned int mc_smf_ticks_per_beat(const mc_smf* smf);
+MC_AUDIO_EXPORT unsigned int mc_smf_track_count(const mc_smf* smf);
+MC_AUDIO_EXPORT const char* mc_smf_track_name(const mc_smf* smf, unsigned int track);
+MC_AUDIO_EXPORT int mc_smf_program(const mc_smf* smf, unsigned int track, unsigned int channel);
+MC_AUDIO_EXPORT unsigned long long mc_smf_note_count(const mc_smf* smf);
+MC_AUDIO_EXPORT int mc_smf_copy_notes(const mc_smf* smf, int* start_tick, int* length_tick, unsigned char* pitch,
+                                      unsigned char* velocity, unsigned char* channel, unsigned short* track);
+MC_AUDIO_EXPORT unsigned int mc_smf_tempo_count(const mc_smf* smf);
+MC_AUDIO_EXPORT int mc_smf_copy_tempo_map(const mc_smf* smf, int* tick, unsigned int* microseconds_per_quarter);
+// 0 without adding any note when a track index exceeds 0xFFFE.
+MC_AUDIO_EXPORT int mc_smf_add_notes(mc_smf* smf, unsigned long long count, const int* start_tick,
+                                     const int* length_tick, const unsigned char* pitch, const unsigned char* velocity,
+                                     const unsigned char* channel, const unsigned short* track);
+MC_AUDIO_EXPORT int mc_smf_add_tempo(mc_smf* smf, int tick, unsigned int microseconds_per_quarter);
+MC_AUDIO_EXPORT int mc_smf_set_track(mc_smf* smf, unsigned int track, const char* name, int channel, int program);
+MC_AUDIO_EXPORT int mc_smf_write_file_w(const mc_smf* smf, const wchar_t* path);
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "channel_layout.hpp"
+#include "graph_processor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace music_create::audio {
+
+// Mixer graph of track and bus nodes. Every node runs input gain, its
+// processor chain, pre-fader sends, fader/pan, post-fader sends and then sums
+// into the master bus (node kMaster). Compile() orders the nodes so each one
+// runs after everything that feeds it, including the nodes its processors key
+// from, and allocates one block buffer per node; a sidechain reads the source
+// node's buffer of the current block directly, copying it only when latency
+// compensation has to delay the key.
+//
+// Nodes are stereo unless SetLayout() gives them another ChannelLayout. Pan
+// is the equal-power law of the preview chain on stereo tracks and a balance
+// control on buses and multichannel tracks (C and LFE keep the fader gain);
+// a mono node is panned into the layout it feeds. Where layouts differ, sums
+// go through DownmixMatrix/PanMatrix gains precomputed by Compile(), so a
+// surround stem bus folds into a stereo master (or a stereo track spreads
+// into a 5.1 master) without a separate render path. Stereo processors run
+// once per channel pair in layout order (L/R, C/LFE, Ls/Rs, ...), the last
+// channel of an odd layout paired with a copy of itself.
+class MixGraph {
+ public:
+  using NodeId = int;
+  using ProcessorFactory = std::function<std::unique_ptr<IGraphProcessor>()>;
+  static constexpr NodeId kMaster = 0;
+  static constexpr NodeId kNoNode = -1;
+  static constexpr float kLevelGlideMs = 10.0f;
+
+  // Throws std::invalid_argument for a zero sample rate or block size.
+  explicit MixGraph(std::uint32_t sample_rate, std::size_t max_block = 512);
+  ~MixGraph();
+
+  std::uint32_t SampleRate() const noexcept { return sample_rate_; }
+  std::size_t MaxBlock() const noexcept { return max_block_; }
+  std::size_t NodeCount() const noexcept { return nodes_.size(); }
+  bool Compiled() const noexcept { return compiled_; }
+  // Processing order of the last Compile().
+  const std::vector<NodeId>& Order() const noexcept { return order_; }
+
+  NodeId AddTrack();
+  NodeId AddBus();
+  // Throws std::out_of_range for unknown nodes. On an uncompiled graph the
+  // levels apply at once; on a compiled one they glide there per sample (a
+  // one-pole over kLevelGlideMs in dB and pan) during the next Process()
+  // calls, without a new Compile(). Reset() ends a glide.
+  void SetLevels(NodeId node, float input_gain_db, float fader_db, float pan);
+  // The setters below require a new Compile() and throw std::out_of_range
+  // for unknown nodes.
+  void SetLayout(NodeId node, ChannelLayout layout);
+  ChannelLayout Layout(NodeId node) const;
+  bool IsBus(NodeId node) const;
+  // Throws std::invalid_argument unless `target` is a bus other than `source`.
+  void AddSend(NodeId source, NodeId target, float level_db, bool pre_fader);
+  // Appends to the node's chain; with a `sidechain` node the processor keys
+  // from that node's output instead of its own signal (pair k of the node
+  // keys from pair k of the source, or its last pair). The factory makes one
+  // processor per channel pair; the first is made at once, so invalid
+  // parameters throw here.
+  void AddProcessor(NodeId node, ProcessorFactory factory, NodeId sidechain = kNoNode);
+
+  // Throws std::runtime_error when routing or sidechains form a cycle.
+  // Also compensates processor latency: every summing point (bus inputs,
+  // the master) and every sidechain key gets its paths delayed to the
+  // latest one, so all of them arrive aligned.
+  void Compile();
+  // Latency of the master output relative to the track inputs, and of a
+  // node's output (after its chain); 0 until compiled. NodeLatency throws
+  // std::out_of_range for unknown nodes.
+  std::size_t Latency() const noexcept;
+  std::size_t NodeLatency(NodeId node) const;
+  // `inputs` holds one planar pointer per channel of every node, node by
+  // node (2 * NodeCount() when all nodes are stereo); bus entries are ignored
+  // and a null track input is silence. Writes one pointer per channel of the
+  // master layout to `outputs`. Returns false if not compiled.
+  bool Process(const float* const* inputs, float* const* outputs, std::size_t frames) noexcept;
+  void Reset() noexcept;
+
+ private:
+  class CompensationDelay;
+  struct Node;
+
+  Node& At(NodeId node);
+  void CompensateLatency();
+  void BuildMatrices(Node& node);
+  void ProcessBlock(const float* const* inputs, std::size_t offset, std::size_t frames) noexcept;
+  void RunChain(Node& node, std::size_t frames) noexcept;
+  void SumInto(Node& source, Node& target, const ChannelMatrix& matrix, CompensationDelay& delay,
+               std::size_t frames) noexcept;
+  // Block views over the scratch: delayed copies, then one pairing channel.
+  AudioBufferView ScratchView(std::size_t channels, std::size_t frames) noexcept {
+    return {scratch_.data(), channels, frames, max_block_, 1};
+  }
+  float* ScratchPartner() noexcept { return scratch_.data() + kMaxLayoutChannels * max_block_; }
+
+  std::uint32_t sample_rate_;
+  std::size_t max_block_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::vector<NodeId> order_;
+  float glide_;                 // per-sample level glide coefficient
+  std::vector<float> scratch_;  // delayed copies on their way to a sum or key
+  bool compiled_ = false;
+};
+
+}  // namespace music_create::audio
+
+struct mc_mix_graph {
+  mc_mix_graph(std::uint32_t sample_rate, std::size_t max_block) : graph(sample_rate, max_block) {}
+
+  music_create::audio::MixGraph graph;
+};
+
+extern "C" {
+
+typedef struct mc_mix_graph mc_mix_graph;
+
+MC_AUDIO_EXPORT mc_mix_graph* mc_mix_graph_create(unsigned int sample_rate, unsigned int max_block);
+MC_AUDIO_EXPORT void mc_mix_graph_free(mc_mix_graph* graph);
+// Node ids are returned in creation order after the master bus (0); -1 on failure.
+MC_AUDIO_EXPORT int mc_mix_graph_add_node(mc_mix_graph* graph, int is_bus);
+// `layout` is 0 mono, 1 stereo (the default), 2 LCR, 3 5.1 or 4 7.1, in
+// SMPTE channel order; requires a new compile.
+MC_AUDIO_EXPORT int mc_mix_graph_set_layout(mc_mix_graph* graph, int node, int layout);
+// Also valid on a compiled graph: the levels glide there while processing.
+MC_AUDIO_EXPORT int mc_mix_graph_set_levels(mc_mix_graph* graph, int node, float input_gain_db, float fader_db,
+                                            float pan);
+MC_AUDIO_EXPORT int mc_mix_graph_add_send(mc_mix_graph* graph, int source, int target, float level_db, int pre_fader);
+MC_AUDIO_EXPORT int mc_mix_graph_add_eq(mc_mix_graph* graph, int node, float low_gain_db, float mid_gain_db,
+                                        float high_gain_db, float low_freq_hz, float high_freq_hz);
+// `sidechain` is the keying node, or -1 for the processor's own input.
+MC_AUDIO_EXPORT int mc_mix_graph_add_compressor(mc_mix_graph* graph, int node, float threshold_db, float ratio,
+                                                float attack_ms, float release_ms, float makeup_db, int sidechain);
+MC_AUDIO_EXPORT int mc_mix_graph_add_gate(mc_mix_graph* graph, int node, float threshold_db, float attack_ms,
+                                          float release_ms, int sidechain);
+MC_AUDIO_EXPORT int mc_mix_graph_add_saturator(mc_mix_graph* graph, int node, float drive, float mix,
+                                               unsigned int oversampling);
+MC_AUDIO_EXPORT int mc_mix_graph_add_reverb(mc_mix_graph* graph, int node, float mix, float decay_seconds,
+                                            float pre_delay_ms, float damping, float size);
+MC_AUDIO_EXPORT int mc_mix_graph_add_delay(mc_mix_graph* graph, int node, float mix, float time_beats,
+                                           float tempo_bpm, float feedback, float damping);
+MC_AUDIO_EXPORT int mc_mix_graph_add_limiter(mc_mix_graph* graph, int node, float ceiling_db, float lookahead_ms,
+                                             float release_ms);
+MC_AUDIO_EXPORT int mc_mix_graph_compile(mc_mix_graph* graph);
+// Compensated latency in samples of the master output, or of one node's
+// output; -1 before a successful compile or for unknown nodes.
+MC_AUDIO_EXPORT long long mc_mix_graph_latency(const mc_mix_graph* graph);
+MC_AUDIO_EXPORT long long mc_mix_graph_node_latency(const mc_mix_graph* graph, int node);
+// Stereo master only; `inputs` as in MixGraph::Process.
+MC_AUDIO_EXPORT int mc_mix_graph_process(mc_mix_graph* graph, const float* const* inputs, float* left, float* right,
+                                         unsigned long long frames);
+// One output pointer per channel of the master layout.
+MC_AUDIO_EXPORT int mc_mix_graph_process_channels(mc_mix_graph* graph, const float* const* inputs,
+                                                  float* const* outputs, unsigned long long frames);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "note_store.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+// Note fields gathered into contiguous columns so edit kernels run as
+// straight loops over the selection.
+struct NoteColumns {
+  std::vector<NoteId> ids;
+  std::vector<std::uint32_t> generation;  // NoteStore::Generation of each id when gathered
+  std::vector<std::int32_t> start_tick;
+  std::vector<std::int32_t> length_tick;
+  std::vector<std::uint8_t> pitch;
+  std::vector<std::uint8_t> velocity;
+  std::vector<std::uint8_t> channel;
+
+  std::size_t size() const noexcept { return ids.size(); }
+};
+
+// Result of one batch edit: the touched notes before and after. Undo/Redo
+// write one side back into the store, skipping notes removed since (their
+// id may already belong to a newer note).
+struct NoteEdit {
+  NoteColumns before;
+  NoteColumns after;
+};
+
+struct QuantizeOptions {
+  std::int32_t step_ticks = 240;
+  float strength = 1.0f;  // 0 keeps timing, 1 snaps fully onto the grid
+  float swing = 0.0f;     // delays odd grid points by swing * step / 2
+  bool quantize_length = true;
+};
+
+struct HumanizeOptions {
+  std::int32_t timing_ticks = 0;
+  std::int32_t length_ticks = 0;
+  std::int32_t velocity_range = 0;
+  std::uint64_t seed = 0;
+};
+
+// Ids that are not live in the store are skipped.
+NoteEdit QuantizeNotes(NoteStore& store, const NoteId* ids, std::size_t count, const QuantizeOptions& options);
+NoteEdit TransposeNotes(NoteStore& store, const NoteId* ids, std::size_t count, int semitones);
+NoteEdit ScaleNoteVelocities(NoteStore& store, const NoteId* ids, std::size_t count, float scale, int offset);
+NoteEdit HumanizeNotes(NoteStore& store, const NoteId* ids, std::size_t count, const HumanizeOptions& options);
+
+// Return the number of notes written back.
+std::size_t UndoNoteEdit(NoteStore& store, const NoteEdit& edit);
+std::size_t RedoNoteEdit(NoteStore& store, const NoteEdit& edit);
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_note_edit mc_note_edit;
+
+MC_AUDIO_EXPORT mc_note_edit* mc_note_store_quantize(mc_note_store* store, unsigned long long count,
+                                                     const unsigned int* ids, int step_ticks, float strength,
+                                                     float swing, int quantize_length);
+MC_AUDIO_EXPORT mc_note_edit* mc_note_store_transpose(mc_note_store* store, unsigned long long count,
+                                                      const unsigned int* ids, int semitones);
+MC_AUDIO_EXPORT mc_note_edit* mc_note_store_scale_velocity(mc_note_store* store, unsigned long long count,
+                                                           const unsigned int* ids, float scale, int offset);
+MC_AUDIO_EXPORT mc_note_edit* mc_note_store_humanize(mc_note_store* store, unsigned long long count,
+                                                     const unsigned int* ids, int timing_ticks, int length_ticks,
+                                                     int velocity_range, unsigned long long seed);
+MC_AUDIO_EXPORT unsigned long long mc_note_edit_size(const mc_note_edit* edit);
+MC_AUDIO_EXPORT int mc_note_edit_undo(mc_note_store* store, const mc_note_edit* edit);
+MC_AUDIO_EXPORT int mc_note_edit_redo(mc_note_store* store, const mc_note_edit* edit);
+MC_AUDIO_EXPORT void mc_note_edit_free(mc_note_edit* edit);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "audio_export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+using NoteId = std::uint32_t;
+
+struct NoteFields {
+  std::int32_t start_tick = 0;
+  std::int32_t length_tick = 1;
+  std::uint8_t pitch = 60;
+  std::uint8_t velocity = 100;
+  std::uint8_t channel = 0;
+};
+
+// Per-clip note storage. Fields live in id-indexed columns; freed ids are
+// reused so ids stay dense. Range queries run on a start-sorted copy of
+// (start, end, pitch) with an implicit augmented interval tree over it, so
+// overlap queries cost O(log n + k). The index is rebuilt lazily on the first
+// query after an edit. Not thread-safe.
+class NoteStore {
+ public:
+  std::size_t size() const noexcept { return live_count_; }
+  bool Contains(NoteId id) const noexcept { return id < alive_.size() && alive_[id] != 0; }
+  const NoteFields& Get(NoteId id) const noexcept { return fields_[id]; }
+  // How often the note under `id` went away; Clear() counts for every id.
+  std::uint32_t Generation(NoteId id) const noexcept { return id < generations_.size() ? generations_[id] : 0; }
+
+  NoteId Add(const NoteFields& note);
+  bool Remove(NoteId id);
+  bool Update(NoteId id, const NoteFields& note);
+  void Clear();
+
+  // Appends ids of notes overlapping [begin, end) whose pitch lies in
+  // [pitch_low, pitch_high], ordered by start tick.
+  void QueryOverlapping(std::int64_t begin, std::int64_t end, std::uint8_t pitch_low, std::uint8_t pitch_high,
+                        std::vector<NoteId>& out) const;
+  // Appends ids of notes starting in [begin, end), ordered by start tick.
+  void QueryStarting(std::int64_t begin, std::int64_t end, std::vector<NoteId>& out) const;
+  // Live ids ordered by (start, pitch, id).
+  const std::vector<NoteId>& SortedIds() const;
+
+ private:
+  void EnsureIndex() const;
+
+  std::vector<NoteFields> fields_;
+  std::vector<std::uint8_t> alive_;
+  std::vector<NoteId> free_ids_;
+  std::vector<std::uint32_t> generations_;  // outlives Clear(), which bumps every entry
+  std::size_t live_count_ = 0;
+
+  mutable bool index_dirty_ = false;
+  mutable std::vector<NoteId> sorted_ids_;
+  mutable std::vector<std::int32_t> sorted_start_;
+  mutable std::vector<std::int64_t> sorted_end_;
+  mutable std::vector<std::uint8_t> sorted_pitch_;
+  mutable std::vector<std::int64_t> subtree_max_end_;
+  mutable int max_level_ = -1;
+};
+
+}  // namespace music_create::audio
+
+struct mc_note_store {
+  music_create::audio::NoteStore store;
+  mutable std::vector<music_create::audio::NoteId> scratch;  // reused by the query calls
+};
+
+extern "C" {
+
+typedef struct mc_note_store mc_note_store;
+
+MC_AUDIO_EXPORT mc_note_store* mc_note_store_create();
+MC_AUDIO_EXPORT void mc_note_store_free(mc_note_store* store);
+MC_AUDIO_EXPORT void mc_note_store_clear(mc_note_store* store);
+MC_AUDIO_EXPORT unsigned long long mc_note_store_size(const mc_note_store* store);
+MC_AUDIO_EXPORT int mc_note_store_add(mc_note_store* store, unsigned long long count, const int* start_tick,
+                                      const int* length_tick, const unsigned char* pitch, const unsigned char* velocity,
+                                      const unsigned char* channel, unsigned int* out_ids);
+MC_AUDIO_EXPORT unsigned long long mc_note_store_remove(mc_note_store* store, unsigned long long count,
+                                                        const unsigned int* ids);
+MC_AUDIO_EXPORT int mc_note_store_update(mc_note_store* store, unsigned int id, int start_tick, int length_tick,
+                                         unsigned char pitch, unsigned char velocity, unsigned char channel);
+MC_AUDIO_EXPORT int mc_note_store_get(const mc_note_store* store, unsigned long long count, const unsigned int* ids,
+                                      int* start_tick, int* length_tick, unsigned char* pitch, unsigned char* velocity,
+                                      unsigned char* channel);
+// Query functions return the total number of matches and write at most
+// `capacity` ids, so callers can retry with a larger buffer.
+MC_AUDIO_EXPORT unsigned long long mc_note_store_query(const mc_note_store* store, long long begin_tick,
+                                                       long long end_tick, unsigned char pitch_low,
+                                                       unsigned char pitch_high, unsigned int* out_ids,
+                                                       unsigned long long capacity);
+MC_AUDIO_EXPORT unsigned long long mc_note_store_query_starting(const mc_note_store* store, long long begin_tick,
+                                                                long long end_tick, unsigned int* out_ids,
+                                                                unsigned long long capacity);
+MC_AUDIO_EXPORT unsigned long long mc_note_store_sorted_ids(const mc_note_store* store, unsigned int* out_ids,
+                                                            unsigned long long capacity);
+}
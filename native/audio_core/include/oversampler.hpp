@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace music_create::audio {
+
+// One 2x step of an oversampling cascade: a linear-phase halfband FIR
+// (Kaiser-windowed sinc, 4 * half_taps - 1 taps) run as two polyphase
+// branches. Every other tap is zero, so one branch is the FIR over
+// 2 * half_taps coefficients and the other a plain delay; both directions
+// have a group delay of Center() samples at the high rate.
+class HalfbandStage {
+ public:
+  // `max_frames` bounds the low-rate frames per call.
+  HalfbandStage(std::size_t half_taps, std::size_t max_frames);
+
+  std::size_t Center() const noexcept { return 2 * half_taps_ - 1; }
+  // Writes 2 * frames high-rate samples.
+  void Upsample(const float* in, float* out, std::size_t frames) noexcept;
+  // Reads 2 * frames high-rate samples and writes `frames`.
+  void Downsample(const float* in, float* out, std::size_t frames) noexcept;
+  void Reset() noexcept;
+
+ private:
+  std::size_t half_taps_;
+  std::vector<float> taps_;  // nonzero branch, reversed for FirBlock
+  // Histories are kept in front of the block that is being filtered.
+  std::vector<float> up_input_;
+  std::vector<float> down_even_;
+  std::vector<float> down_odd_;
+  std::vector<float> branch_;
+};
+
+// Mono 1x/2x/4x/8x oversampler for nonlinear processors: Upsample() returns
+// the high-rate block to process in place, Downsample() filters it back. The
+// round trip is padded to a whole number of base-rate samples, reported by
+// Latency(). Cost is bounded: the stages after the first use shorter filters
+// because their transition bands are wider. Buffers are allocated up front.
+class Oversampler {
+ public:
+  // Throws std::invalid_argument unless factor is 1, 2, 4 or 8 and
+  // max_frames > 0.
+  Oversampler(std::size_t factor, std::size_t max_frames);
+
+  std::size_t Factor() const noexcept { return factor_; }
+  std::size_t Latency() const noexcept { return latency_; }
+  // `frames` must not exceed max_frames.
+  float* Upsample(const float* in, std::size_t frames) noexcept;
+  void Downsample(float* out, std::size_t frames) noexcept;
+  void Reset() noexcept;
+
+ private:
+  std::size_t factor_;
+  std::size_t latency_ = 0;
+  std::vector<HalfbandStage> stages_;
+  std::vector<std::vector<float>> buffers_;  // output of each up stage
+  std::vector<float> pad_;                   // high-rate delay for the rounding
+  std::size_t pad_position_ = 0;
+};
+
+// out[i] = sum_j taps[j] * in[i + j] for i < count; AVX2/FMA or SSE when the
+// CPU has them.
+void FirBlock(const float* in, const float* taps, std::size_t tap_count, float* out, std::size_t count) noexcept;
+
+}  // namespace music_create::audio
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "fast_math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace music_create::audio {
+
+// Lookup tables for parameter-rate curves, generated at compile time, with
+// linear interpolation between entries. They make per-sample parameter
+// smoothing cheap: a fader or pan glide costs a couple of table reads per
+// sample instead of pow/cos/sin. Interpolation errors (checked by
+// native/tests/param_tables_accuracy.cpp):
+//
+//   EqualPowerPan      abs error <= kPanTableMaxError
+//   TableDbToGain      rel error <= kDbTableMaxRelError
+//   OnePoleAlpha       rel error <= kDecayTableMaxRelError
+inline constexpr float kPanTableMaxError = 5.0e-6f;
+inline constexpr float kDbTableMaxRelError = 3.0e-5f;
+inline constexpr float kDecayTableMaxRelError = 8.0e-5f;
+
+namespace param_tables_detail {
+
+inline constexpr double kPi = 3.14159265358979323846;
+inline constexpr double kLn2 = 0.693147180559945309;
+inline constexpr double kLn10Over20 = 0.115129254649702284;
+
+// std::exp and std::cos are not constexpr before C++26; these series are
+// only evaluated while the tables are built.
+constexpr double Expm1Series(double x) {
+  double term = x;
+  double sum = x;
+  for (int k = 2; k < 30; ++k) {
+    term *= x / k;
+    sum += term;
+  }
+  return sum;
+}
+
+// e^x by series on x / 2^16, squared back up; exact to double rounding for
+// the |x| < 64 the tables need.
+constexpr double Exp(double x) {
+  double value = 1.0 + Expm1Series(x / 65536.0);
+  for (int i = 0; i < 16; ++i) {
+    value *= value;
+  }
+  return value;
+}
+
+// 1 - e^-x without cancellation for small x.
+constexpr double OneMinusExpNeg(double x) { return x < 0.5 ? -Expm1Series(-x) : 1.0 - Exp(-x); }
+
+// cos(x) for x in [0, pi / 2].
+constexpr double Cos(double x) {
+  double term = 1.0;
+  double sum = 1.0;
+  for (int k = 1; k < 20; ++k) {
+    term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+template <std::size_t N, typename Fn>
+constexpr std::array<float, N> Tabulate(Fn fn) {
+  std::array<float, N> table{};
+  for (std::size_t i = 0; i < N; ++i) {
+    table[i] = static_cast<float>(fn(static_cast<double>(i)));
+  }
+  return table;
+}
+
+// table[position] with linear interpolation; position must lie within the
+// table.
+template <std::size_t N>
+inline float Interpolate(const std::array<float, N>& table, float position) noexcept {
+  const std::size_t index = std::min(static_cast<std::size_t>(position), N - 2);
+  const float fraction = position - static_cast<float>(index);
+  return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+// cos over [0, pi / 2]; sin is the same table read backwards.
+inline constexpr std::size_t kPanSteps = 256;
+inline constexpr auto kQuarterCosine =
+    Tabulate<kPanSteps + 1>([](double i) { return Cos(i * (kPi / 2.0) / kPanSteps); });
+
+inline constexpr float kDbTableMin = -120.0f;
+inline constexpr float kDbTableMax = 24.0f;
+inline constexpr float kDbStepsPerDb = 8.0f;
+inline constexpr std::size_t kDbSteps = static_cast<std::size_t>((kDbTableMax - kDbTableMin) * kDbStepsPerDb);
+inline constexpr auto kDbGain =
+    Tabulate<kDbSteps + 1>([](double i) { return Exp((kDbTableMin + i / kDbStepsPerDb) * kLn10Over20); });
+
+// 1 - e^(-1 / n) for time constants of n = 2^u samples, u in [-4, 24].
+inline constexpr float kDecayMinLog2 = -4.0f;
+inline constexpr float kDecayMaxLog2 = 24.0f;
+inline constexpr float kDecayStepsPerOctave = 32.0f;
+inline constexpr std::size_t kDecaySteps =
+    static_cast<std::size_t>((kDecayMaxLog2 - kDecayMinLog2) * kDecayStepsPerOctave);
+inline constexpr auto kDecayAlpha = Tabulate<kDecaySteps + 1>([](double i) {
+  return OneMinusExpNeg(Exp(-(kDecayMinLog2 + i / kDecayStepsPerOctave) * kLn2));
+});
+
+}  // namespace param_tables_detail
+
+struct PanGains {
+  float left;
+  float right;
+};
+
+// Equal-power law of the preview chain: cos / sin of (pan + 1) * pi / 4,
+// with pan clamped to [-1, 1].
+inline PanGains EqualPowerPan(float pan) noexcept {
+  using namespace param_tables_detail;
+  const float position = (std::clamp(pan, -1.0f, 1.0f) + 1.0f) * (0.5f * kPanSteps);
+  return {Interpolate(kQuarterCosine, position), Interpolate(kQuarterCosine, kPanSteps - position)};
+}
+
+// 10^(db / 20); table-driven over [kDbTableMin, kDbTableMax], the fast
+// approximation outside it.
+inline float TableDbToGain(float db) noexcept {
+  using namespace param_tables_detail;
+  if (!(db >= kDbTableMin && db <= kDbTableMax)) {
+    return FastDbToGain(db);
+  }
+  return Interpolate(kDbGain, (db - kDbTableMin) * kDbStepsPerDb);
+}
+
+// 1 - e^(-1 / samples), the one-pole smoothing step for a time constant
+// given in samples, to full relative precision even where the coefficient
+// itself rounds to 1 in float; 1 for non-positive times. Time constants
+// beyond the table round to its ends.
+inline float OnePoleAlpha(float samples) noexcept {
+  using namespace param_tables_detail;
+  if (!(samples > 0.0f)) {
+    return 1.0f;
+  }
+  const float octave = std::clamp(FastLog2(samples), kDecayMinLog2, kDecayMaxLog2);
+  return Interpolate(kDecayAlpha, (octave - kDecayMinLog2) * kDecayStepsPerOctave);
+}
+
+// e^(-1 / samples), the matching one-pole coefficient; 0 for non-positive
+// times.
+inline float OnePoleCoefficient(float samples) noexcept { return 1.0f - OnePoleAlpha(samples); }
+
+}  // namespace music_create::audio
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "audio_file_reader.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace music_create::audio {
+
+// Disk side of a streamed sample. Frames below head_frames stay resident with
+// the instrument; the streamer serves frames from head_frames on. Frame
+// numbers are "virtual": with `loop` set they keep counting past loop_end and
+// map back into [loop_start, loop_end).
+struct StreamSource {
+  std::filesystem::path path;
+  std::uint64_t total_frames = 0;
+  std::uint64_t head_frames = 0;
+  bool loop = false;
+  std::uint64_t loop_start = 0;
+  std::uint64_t loop_end = 0;
+
+  std::uint64_t SourceFrame(std::uint64_t virtual_frame) const noexcept;
+  bool Ended(std::uint64_t virtual_frame) const noexcept { return !loop && virtual_frame >= total_frames; }
+};
+
+// Fixed pool of stereo ring buffers kept ahead of playback by one prefetch
+// thread. Acquire, Release and a non-waiting Fetch neither lock nor allocate,
+// so they are safe on the audio thread.
+class SampleStreamer {
+ public:
+  static constexpr std::size_t kDefaultRingFrames = 32768;
+  // The prefetch thread reads in chunks of this size, at most two at a time.
+  static constexpr std::size_t kFillChunkFrames = 4096;
+
+  explicit SampleStreamer(std::size_t slot_count, std::size_t ring_frames = kDefaultRingFrames);
+  ~SampleStreamer();
+  SampleStreamer(const SampleStreamer&) = delete;
+  SampleStreamer& operator=(const SampleStreamer&) = delete;
+
+  // Returns a slot id, or -1 when every slot is busy. `source` must outlive the slot.
+  int Acquire(const StreamSource& source) noexcept { return Acquire(source, source.head_frames); }
+  // Starts the ring at virtual frame `first` instead of head_frames, for
+  // playback cued into the middle of a file.
+  int Acquire(const StreamSource& source, std::uint64_t first) noexcept;
+  void Release(int slot) noexcept;
+
+  // Copies `count` stereo frames starting at virtual frame `first` (>= head_frames)
+  // into `out` and lets the prefetch thread recycle everything before `first`.
+  // Frames past the end of a one-shot read as silence. Without `wait` an
+  // underrun returns false; with it the call blocks until the disk catches up
+  // (offline rendering) and only fails if the file cannot be read. False for
+  // an unknown slot.
+  bool Fetch(int slot, std::uint64_t first, std::size_t count, float* out, bool wait);
+  // Copies frames without moving the reader, so a scrub can read back and
+  // forth inside the ring: false unless [first, first + count) lies between
+  // the acquire or last fetched frame and the fill position. Never waits.
+  bool Peek(int slot, std::uint64_t first, std::size_t count, float* out) const noexcept;
+  // Blocks until frames up to `end` are resident, as far as the ring can
+  // hold them ahead of the last fetch (the end of a one-shot counts as
+  // resident). False on timeout, a read failure or an unknown slot. Not for
+  // the audio thread.
+  bool Prime(int slot, std::uint64_t end, std::chrono::milliseconds timeout);
+
+  std::size_t SlotCount() const noexcept { return slots_.size(); }
+  std::size_t RingFrames() const noexcept { return ring_frames_; }
+  std::size_t ResidentBytes() const noexcept;
+  std::uint64_t Underruns() const noexcept { return underruns_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Slot;
+
+  void Run();
+  bool Fill(Slot& slot);
+  // Waits until the slot's write position reaches `end`; false on a read
+  // failure, shutdown or the deadline.
+  bool AwaitFrames(Slot& slot, std::uint64_t end, std::chrono::steady_clock::time_point deadline);
+
+  std::size_t ring_frames_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::atomic<std::uint64_t> underruns_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> wake_{false};
+  std::mutex mutex_;
+  std::condition_variable wake_cv_;
+  std::condition_variable filled_cv_;
+  std::thread thread_;
+};
+
+}  // namespace music_create::audio
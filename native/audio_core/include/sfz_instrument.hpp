@@ -0,0 +1,154 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "sample_streamer.hpp"
+#include "voice_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace music_create::audio {
+
+enum class SfzLoopMode {
+  kNoLoop,
+  kOneShot,
+  kLoopContinuous,
+  kLoopSustain,
+};
+
+// One <region> after <global>/<master>/<group> opcodes were applied.
+struct SfzRegion {
+  std::filesystem::path sample;
+  int lokey = 0;
+  int hikey = 127;
+  int lovel = 1;
+  int hivel = 127;
+  int pitch_keycenter = 60;
+  int transpose = 0;
+  float tune_cents = 0.0f;
+  float volume_db = 0.0f;
+  float amp_veltrack = 100.0f;
+  float ampeg_attack = 0.0f;
+  float ampeg_release = 0.001f;
+  SfzLoopMode loop_mode = SfzLoopMode::kNoLoop;
+  std::optional<std::uint64_t> loop_start;
+  std::optional<std::uint64_t> loop_end;
+};
+
+// Parses the supported SFZ subset: <control> default_path, <global>, <master>,
+// <group> and <region> headers with key/velocity ranges, tuning, volume,
+// amp envelope attack/release and loop opcodes. Unknown opcodes are ignored;
+// regions without a sample are dropped. Note names use C4 = 60.
+std::vector<SfzRegion> ParseSfz(std::string_view text, const std::filesystem::path& base_dir);
+
+struct SfzNote {
+  std::int64_t start_sample = 0;
+  std::int64_t length_samples = 0;
+  int key = 60;
+  int velocity = 100;
+};
+
+// Sample-player instrument. Only the first kHeadFrames of each sample stay in
+// RAM; voices read the rest through a SampleStreamer slot that the prefetch
+// thread keeps ahead of playback. NoteOn/NoteOff/Render do not lock or
+// allocate; a voice whose stream underruns plays silence until it catches up.
+// When every voice is busy the steal policy picks a victim that fades out, and
+// the new note starts at the next render block boundary.
+class SfzInstrument {
+ public:
+  static constexpr std::size_t kHeadFrames = 16384;
+  static constexpr std::size_t kDefaultVoices = 64;
+
+  // Throws std::runtime_error when the SFZ file or one of its samples cannot be read.
+  SfzInstrument(const std::filesystem::path& sfz_path, std::uint32_t sample_rate,
+                std::size_t max_voices = kDefaultVoices);
+  ~SfzInstrument();
+
+  std::size_t RegionCount() const noexcept { return regions_.size(); }
+  std::size_t ResidentBytes() const noexcept;
+  std::uint64_t Underruns() const noexcept { return streamer_.Underruns(); }
+  VoiceStealPolicy StealPolicy() const noexcept { return steal_policy_; }
+  void SetStealPolicy(VoiceStealPolicy policy) noexcept;
+
+  void NoteOn(int key, int velocity) noexcept;
+  void NoteOff(int key) noexcept;
+  void AllNotesOff() noexcept;
+  // Writes `frames` interleaved stereo frames.
+  void Render(float* stereo, std::size_t frames) noexcept;
+
+  // Offline render of a note list; waits on the disk instead of underrunning.
+  // Voices sounding before the call are cut, and none are left afterwards.
+  void RenderNotes(const SfzNote* notes, std::size_t count, float* stereo, std::size_t frames);
+
+ private:
+  struct Sample {
+    StreamSource source;
+    std::uint32_t sample_rate = 0;
+    std::vector<float> head;  // stereo frames [0, source.head_frames)
+  };
+  struct Voice {
+    bool released = false;
+    bool stolen = false;
+    bool one_shot = false;
+    const Sample* sample = nullptr;
+    int slot = -1;
+    double position = 0.0;
+    double step = 1.0;
+    float gain = 1.0f;
+    float envelope = 1.0f;
+    float attack_step = 1.0f;
+    float release_step = 1.0f;
+  };
+  struct PendingNote {
+    std::size_t region = 0;
+    int key = 0;
+    int velocity = 0;
+    bool released = false;
+  };
+
+  void StartRegion(std::size_t region, int key, int velocity) noexcept;
+  bool TryStartRegion(std::size_t region, int key, int velocity, bool released) noexcept;
+  void StartPending() noexcept;
+  void RenderVoices(float* stereo, std::size_t frames, bool wait);
+  bool RenderVoice(Voice& voice, float* stereo, std::size_t frames, bool wait);
+  void StopVoice(VoicePool<Voice>::Handle handle) noexcept;
+  void StopAllVoices() noexcept;
+
+  std::uint32_t sample_rate_;
+  std::vector<SfzRegion> regions_;
+  std::vector<std::size_t> region_sample_;
+  std::vector<std::unique_ptr<Sample>> samples_;
+  VoicePool<Voice> voices_;
+  std::vector<PendingNote> pending_;
+  std::size_t pending_count_ = 0;
+  VoiceStealPolicy steal_policy_ = VoiceStealPolicy::kOldest;
+  std::vector<float> scratch_;
+  SampleStreamer streamer_;  // declared last: its thread stops before samples_ go away
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_sfz_instrument mc_sfz_instrument;
+
+MC_AUDIO_EXPORT mc_sfz_instrument* mc_sfz_open_w(const wchar_t* path, unsigned int sample_rate,
+                                                 unsigned int max_voices);
+MC_AUDIO_EXPORT void mc_sfz_free(mc_sfz_instrument* instrument);
+MC_AUDIO_EXPORT unsigned int mc_sfz_region_count(const mc_sfz_instrument* instrument);
+MC_AUDIO_EXPORT unsigned long long mc_sfz_resident_bytes(const mc_sfz_instrument* instrument);
+MC_AUDIO_EXPORT unsigned long long mc_sfz_underruns(const mc_sfz_instrument* instrument);
+MC_AUDIO_EXPORT int mc_sfz_note_on(mc_sfz_instrument* instrument, int key, int velocity);
+MC_AUDIO_EXPORT int mc_sfz_note_off(mc_sfz_instrument* instrument, int key);
+MC_AUDIO_EXPORT int mc_sfz_set_steal_policy(mc_sfz_instrument* instrument, int policy);
+MC_AUDIO_EXPORT int mc_sfz_render(mc_sfz_instrument* instrument, float* stereo, unsigned long long frames);
+MC_AUDIO_EXPORT int mc_sfz_render_notes(mc_sfz_instrument* instrument, unsigned long long count,
+                                        const long long* start_sample, const long long* length_samples,
+                                        const int* key, const int* velocity, float* stereo,
+                                        unsigned long long frames);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "audio_export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+struct TempoDelayParams {
+  float mix = 0.0f;
+  float time_beats = 0.5f;
+  float tempo_bpm = 120.0f;
+  float feedback = 0.35f;
+  float damping = 0.2f;  // low-pass on the repeats
+};
+
+// Feedback delay whose time follows the tempo. The delay time is fractional
+// (linear interpolation between two taps); once audio is running it glides
+// towards a new target instead of jumping, so tempo changes do not click. The
+// buffer holds kMaxSeconds; longer settings are clamped.
+class TempoDelay {
+ public:
+  static constexpr float kMaxSeconds = 4.0f;
+
+  // Throws std::invalid_argument for a zero sample rate.
+  explicit TempoDelay(std::uint32_t sample_rate);
+
+  void SetParams(const TempoDelayParams& params) noexcept;
+  const TempoDelayParams& Params() const noexcept { return params_; }
+  double DelaySamples() const noexcept { return delay_; }
+  // `in` and `out` may alias.
+  void Process(const float* in, float* out, std::size_t frames) noexcept;
+  void Reset() noexcept;
+
+ private:
+  std::uint32_t sample_rate_;
+  TempoDelayParams params_;
+  std::vector<float> buffer_;
+  std::uint32_t mask_ = 0;
+  std::uint32_t write_ = 0;
+  double delay_ = 1.0;
+  double target_delay_ = 1.0;
+  bool running_ = false;  // glide only once audio has been processed
+  float damping_ = 0.0f;
+  float lowpass_ = 0.0f;
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_tempo_delay mc_tempo_delay;
+
+MC_AUDIO_EXPORT mc_tempo_delay* mc_tempo_delay_create(unsigned int sample_rate);
+MC_AUDIO_EXPORT void mc_tempo_delay_free(mc_tempo_delay* delay);
+MC_AUDIO_EXPORT int mc_tempo_delay_set_params(mc_tempo_delay* delay, float mix, float time_beats, float tempo_bpm,
+                                              float feedback, float damping);
+MC_AUDIO_EXPORT int mc_tempo_delay_process(mc_tempo_delay* delay, const float* in, float* out,
+                                           unsigned long long frames);
+MC_AUDIO_EXPORT int mc_tempo_delay_reset(mc_tempo_delay* delay);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "fft.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace music_create::audio {
+
+enum class StretchMode : int {
+  // Waveform-similarity overlap-add: moves whole segments, picked where they
+  // line up with what was played, so drums and consonants stay sharp and
+  // stereo stays intact. Best for rhythmic material.
+  kWsola = 0,
+  // Phase vocoder with identity phase locking around spectral peaks: smooth
+  // on sustained tonal material, where WSOLA can flutter, but it smears
+  // transients.
+  kPhaseVocoder = 1,
+};
+
+enum class StretchQuality : int {
+  kRealtime = 0,  // per-clip playback: coarse-to-fine WSOLA search, 4x vocoder overlap
+  kHigh = 1,      // offline: exhaustive search, larger and 8x overlapped vocoder frames
+};
+
+// Changes the duration of one or two channels by `stretch` (output length
+// over input length) and their pitch by `semitones`, independently: the
+// frames are stretched by stretch * pitch factor, then resampled by the pitch
+// factor. Output frame n is aligned with input frame n / stretch.
+//
+// Push input and Pull output; InputNeeded(frames) is exactly what the next
+// Pull(frames) still lacks. Buffers are allocated by the constructor, so
+// Push, Pull and SetStretch neither lock nor allocate. Not thread safe.
+class TimeStretcher {
+ public:
+  static constexpr std::size_t kMaxChannels = 2;
+  static constexpr std::size_t kMaxPullFrames = 4096;
+  static constexpr double kMinStretch = 0.25;
+  static constexpr double kMaxStretch = 4.0;
+  static constexpr float kMaxSemitones = 12.0f;
+
+  // Throws std::invalid_argument for zero or more than kMaxChannels channels
+  // or a zero sample rate.
+  TimeStretcher(std::uint32_t sample_rate, std::size_t channels, StretchMode mode,
+                StretchQuality quality = StretchQuality::kRealtime);
+
+  std::size_t Channels() const noexcept { return channels_; }
+  StretchMode Mode() const noexcept { return mode_; }
+  // Clamped to [kMinStretch, kMaxStretch] and +-kMaxSemitones. Takes effect
+  // from the next hop, so it can follow tempo changes while playing.
+  void SetStretch(double stretch, float semitones) noexcept;
+  double Stretch() const noexcept { return stretch_; }
+
+  // How far the input read runs ahead of the frame aligned with the output,
+  // for sizing read-ahead.
+  std::size_t InputLead() const noexcept;
+  // Input frames to push before Pull(frames) can deliver all of them;
+  // `frames` is capped at kMaxPullFrames.
+  std::size_t InputNeeded(std::size_t frames) const noexcept;
+  // Returns the frames taken, fewer when the input buffer is full.
+  std::size_t Push(const float* const* in, std::size_t frames) noexcept;
+  std::size_t PushSilence(std::size_t frames) noexcept;
+  // Returns the frames written, fewer when the input ran out.
+  std::size_t Pull(float* const* out, std::size_t frames) noexcept;
+  // Forgets all input and output; the next frame pushed is aligned with the
+  // next frame pulled.
+  void Reset() noexcept;
+
+ private:
+  bool InputReady(std::int64_t analysis) const noexcept;
+  void Hop() noexcept;
+  void WsolaFrame(std::int64_t analysis) noexcept;
+  void VocoderFrame(std::int64_t analysis) noexcept;
+  std::int64_t SearchWsola(std::int64_t analysis, std::int64_t natural) noexcept;
+  void CompactInput() noexcept;
+
+  std::size_t channels_;
+  StretchMode mode_;
+  StretchQuality quality_;
+  std::size_t frame_size_;  // analysis and synthesis window
+  std::size_t hop_;         // synthesis hop
+  std::size_t tolerance_;   // WSOLA search radius
+  float ola_scale_;
+  std::vector<float> window_;
+
+  double stretch_ = 1.0;
+  double pitch_ = 1.0;  // resampling step through the stretched frames
+  double analysis_hop_ = 0.0;
+
+  // Input of the stream position input_start_ onwards, in the stretcher's
+  // own frame count (the pushed frames follow frame_size_ / 2 + tolerance_
+  // leading zeros).
+  std::vector<std::vector<float>> input_;
+  std::size_t input_capacity_;
+  std::int64_t input_start_ = 0;
+  std::size_t input_fill_ = 0;
+  double analysis_ = 0.0;  // stream position of the next analysis frame
+  std::int64_t previous_analysis_ = -1;
+  std::int64_t previous_segment_ = -1;  // WSOLA: start of the last segment used
+
+  std::vector<std::vector<float>> overlap_;    // overlap-add accumulator, frame_size_ each
+  std::vector<std::vector<float>> stretched_;  // finished stretched frames
+  std::size_t stretched_fill_ = 0;
+  std::size_t discard_ = 0;  // leading stretched frames before the aligned start
+  // Position in stretched_ of the next output frame, split so that dropping
+  // passed frames leaves the fraction's arithmetic untouched.
+  std::size_t resample_index_ = 1;
+  double resample_fraction_ = 0.0;
+  std::vector<float> mono_;    // WSOLA template and candidates, channels summed
+  std::vector<float> coarse_;  // the same decimated
+
+  std::unique_ptr<RealFft> fft_;  // phase vocoder only
+  std::vector<float> frame_;
+  std::vector<std::complex<float>> spectrum_;
+  std::vector<float> magnitude_;
+  std::vector<float> phase_;
+  std::vector<std::vector<float>> previous_phase_;   // analysis phase per channel
+  std::vector<std::vector<float>> synthesis_phase_;  // per channel
+  std::vector<std::size_t> peaks_;
+};
+
+// Stretches whole planar buffers at StretchQuality::kHigh into
+// round(frames * stretch) frames per channel. Throws like TimeStretcher.
+std::vector<std::vector<float>> StretchOffline(const float* const* in, std::size_t channels, std::size_t frames,
+                                               std::uint32_t sample_rate, double stretch, float semitones,
+                                               StretchMode mode);
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+// Planar in, planar out: `out_frames` frames are written per channel,
+// normally round(frames * stretch). `mode` 0 is WSOLA, 1 the phase vocoder.
+// 1 on success.
+MC_AUDIO_EXPORT int mc_time_stretch_planar(const float* const* in, unsigned int channels, unsigned long long frames,
+                                           unsigned int sample_rate, double stretch, float semitones, int mode,
+                                           float* const* out, unsigned long long out_frames);
+}
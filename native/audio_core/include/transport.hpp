@@ -0,0 +1,297 @@
+#pragma once
+
+#include "audio_export.hpp"
+#include "metronome.hpp"
+#include "mix_graph.hpp"
+#include "sample_streamer.hpp"
+#include "spsc_queue.hpp"
+#include "time_stretch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace music_create::audio {
+
+enum class FadeCurve : int {
+  kLinear = 0,
+  kEqualPower = 1,  // quarter sine: constant power across a crossfade
+  kSCurve = 2,      // smoothstep: eases in and out at both ends
+};
+
+// A fade at one end of a clip, over timeline frames.
+struct ClipFade {
+  std::uint64_t frames = 0;
+  FadeCurve curve = FadeCurve::kEqualPower;
+};
+
+// An audio file placed on a track node of the timeline, in frames.
+struct TransportClip {
+  std::filesystem::path path;
+  MixGraph::NodeId node = MixGraph::kNoNode;
+  std::uint64_t start = 0;   // timeline frame of the clip's first frame
+  std::uint64_t offset = 0;  // first file frame played
+  std::uint64_t length = 0;  // file frames; 0 plays to the end of the file
+  float gain = 1.0f;
+  // Tempo matching: timeline frames per file frame, and a pitch change
+  // independent of it. Other than 1 and 0 the clip plays through a
+  // real-time TimeStretcher.
+  double stretch = 1.0;
+  float semitones = 0.0f;
+  StretchMode stretch_mode = StretchMode::kWsola;
+  ClipFade fade_in{};
+  ClipFade fade_out{};
+};
+
+struct TransportOptions {
+  std::size_t stream_slots = 64;
+  std::size_t ring_frames = SampleStreamer::kDefaultRingFrames;
+  // Audio before the cue point run through the graph so reverb tails,
+  // delay lines and dynamics envelopes are settled when playback starts.
+  float preroll_ms = 500.0f;
+  // Audio past the cue point (and of clips starting within it) made
+  // resident before Cue() returns; playback keeps acquiring clips this far
+  // ahead of the playhead.
+  float lookahead_ms = 250.0f;
+};
+
+// Plays clips through a compiled MixGraph, streaming them from disk with a
+// SampleStreamer. Cue() moves the playhead: it positions a stream on every
+// clip around the new position, waits until the look-ahead window is
+// resident and pre-rolls the graph, so the first Render() after Play()
+// produces the cued audio without touching the disk. Position() counts
+// output frames; Cue() feeds the graph its latency ahead of the cue point,
+// so playback is heard from exactly there.
+//
+// Clip edits are non-destructive: trim (start, offset, length), gain and
+// fades are applied to the streamed frames as they are mixed, and clips
+// overlapping on the same node crossfade over the overlap with equal power,
+// so an edit never rewrites or re-decodes the file.
+//
+// The click follows a tempo map and meter (120 BPM 4/4 until SetClickMap())
+// and is heard while playing, sample-accurate against Position(): it is
+// mixed after the graph, so graph latency does not delay it.
+//
+// Scrubbing: after BeginScrub(), Render() follows the positions posted with
+// ScrubTo() with short Hann-windowed grains, overlapping by half, through
+// the same graph. Each grain is resampled at the drag speed (varispeed,
+// backwards too, up to kMaxScrubRate) and fades out as the drag stops.
+// Grains read the stream rings without advancing them, and a clip re-seeks
+// its stream at most every kScrubReseekMs, so a fast drag across the song
+// costs the prefetch thread a bounded number of seeks; a grain over frames
+// still loading is silent rather than waited for.
+//
+// AddClip, SetClipStretch, SetClipTrim, SetClickMap, Cue, Play, Stop,
+// BeginScrub and EndScrub run on a control thread, never concurrently with
+// Render(). SetClipGain, SetClipFades, ScrubTo() and SetClick() may: gain
+// and fade edits reach Render() through a wait-free queue.
+// Render() neither locks nor allocates. The graph must outlive the transport
+// and stay compiled while it plays.
+class Transport {
+ public:
+  static constexpr float kScrubGrainMs = 25.0f;
+  static constexpr float kScrubGlideMs = 30.0f;  // the grains chase the drag position this fast
+  static constexpr float kMaxScrubRate = 4.0f;
+  static constexpr float kScrubReseekMs = 50.0f;
+  static constexpr std::size_t kLevelQueue = 256;
+
+  // Throws std::invalid_argument when the look-ahead does not fit the
+  // stream rings.
+  explicit Transport(MixGraph& graph, const TransportOptions& options = {});
+  ~Transport();
+  Transport(const Transport&) = delete;
+  Transport& operator=(const Transport&) = delete;
+
+  // Throws std::invalid_argument unless `clip.node` is a track, and
+  // std::runtime_error when the file cannot be opened or its sample rate
+  // differs from the graph's. Takes effect at the next Cue().
+  std::size_t AddClip(const TransportClip& clip);
+  std::size_t ClipCount() const noexcept { return clips_.size(); }
+  // Re-stretches a clip, e.g. after a tempo change; throws
+  // std::out_of_range for an unknown index. Takes effect at the next Cue(),
+  // and playback stays silent until then.
+  void SetClipStretch(std::size_t index, double stretch, float semitones, StretchMode mode);
+  // Moves or trims a clip (`length` 0 plays to the end of the file); takes
+  // effect at the next Cue() and, like SetClipStretch, silences playback
+  // until then. Gain and fades only shape the level: they are heard from the
+  // next Render() block, even while another thread renders. False when
+  // kLevelQueue edits are still waiting for Render(); the edit then takes
+  // effect with the clip's next one or the next Cue(). All throw
+  // std::out_of_range for an unknown index.
+  void SetClipTrim(std::size_t index, std::uint64_t start, std::uint64_t offset, std::uint64_t length);
+  bool SetClipGain(std::size_t index, float gain);
+  bool SetClipFades(std::size_t index, const ClipFade& fade_in, const ClipFade& fade_out);
+
+  // Stops playback and cues `position`. False when the graph is not
+  // compiled, a stream slot was short or the disk did not deliver the
+  // window within `timeout`; playback still works then, but may underrun
+  // at the start.
+  bool Cue(std::uint64_t position, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000));
+  bool Cued() const noexcept { return cued_; }
+  // Starts from the cued position (Cue(0) first if nothing is cued).
+  void Play();
+  void Stop() noexcept { playing_.store(false, std::memory_order_release); }
+  bool Playing() const noexcept { return playing_.load(std::memory_order_acquire); }
+
+  // Throws std::invalid_argument like Metronome::SetTempoMap.
+  void SetClickMap(std::vector<TempoPoint> tempo, std::vector<MeterPoint> meter);
+  void SetClick(bool enabled, float gain) noexcept;
+
+  // Stops playback and starts scrubbing at Position(); false if the graph
+  // is not compiled.
+  bool BeginScrub();
+  // UI thread: posts a drag position through a wait-free queue, of which
+  // Render() takes the latest each block. False when the queue is full.
+  bool ScrubTo(std::uint64_t position) noexcept { return scrub_queue_.Push(position); }
+  // The grains in flight still finish; Play() cues from where the scrub
+  // ended.
+  void EndScrub() noexcept;
+  bool Scrubbing() const noexcept { return scrubbing_; }
+
+  // Writes one pointer per channel of the master layout; silence while
+  // stopped. A clip whose frames are not resident yet plays silence for the
+  // block and counts an underrun. The click goes to the one channel of
+  // `click_output` when given (a performer's headphone bus, say), otherwise
+  // onto the master's first two channels. False if the graph is not
+  // compiled.
+  bool Render(float* const* outputs, std::size_t frames, float* click_output = nullptr) noexcept;
+
+  std::uint64_t Position() const noexcept { return position_.load(std::memory_order_acquire); }
+  std::uint64_t Underruns() const noexcept { return streamer_.Underruns(); }
+
+ private:
+  struct Clip;
+  // A clip's gain and fades as Render() applies them.
+  struct ClipLevel {
+    float gain = 1.0f;
+    ClipFade fade_in;
+    ClipFade fade_out;
+  };
+  struct LevelEdit {
+    std::size_t index = 0;
+    ClipLevel level;
+  };
+
+  // Posts the gain and fades of clips_[index] to Render().
+  bool PostLevel(std::size_t index) noexcept;
+  // Control thread: drops the posted edits and hands every clip its level.
+  void SyncLevels() noexcept;
+  // Recomputes where a clip ends on the timeline from its trim and stretch.
+  void UpdateClipEnd(Clip& clip) noexcept;
+  // Re-derives every clip's automatic crossfades from the overlaps.
+  void ResolveCrossfades() noexcept;
+  void ReleaseStreams() noexcept;
+  // Starts a clip's stream (and its stretcher) at timeline frame `from`.
+  bool OpenStream(Clip& clip, std::uint64_t from) noexcept;
+  void BindInputs();
+  // Streams the clips heard in [first, first + frames) of the input
+  // timeline into the node inputs, acquiring streams for clips starting
+  // before `acquire_until`; with `deadline` set the fetches wait for disk.
+  // False when a clip was left silent.
+  bool FillInputs(std::uint64_t first, std::size_t frames, std::uint64_t acquire_until,
+                  const std::chrono::steady_clock::time_point* deadline) noexcept;
+  // Runs a stretched clip's stream through its stretcher into fetched_;
+  // false (and silence for the missing input) on an underrun.
+  bool PullStretched(Clip& clip, std::size_t frames) noexcept;
+  // Scrub counterparts: the grains in flight summed into the node inputs,
+  // a new one started every half grain while `spawn` is set.
+  void FillScrubInputs(std::size_t frames, bool spawn) noexcept;
+  void SpawnGrain(std::vector<float>& grain) noexcept;
+  // Copies file frames of a clip into peeked_ when its stream holds them,
+  // re-seeking the stream (rate-limited) when they are outside it.
+  bool PeekClip(Clip& clip, std::uint64_t first, std::size_t count) noexcept;
+
+  MixGraph& graph_;
+  std::size_t preroll_frames_;
+  std::size_t lookahead_frames_;
+  std::vector<std::unique_ptr<Clip>> clips_;
+  std::vector<float> inputs_;                // per node channel, one block each
+  std::vector<const float*> input_pointers_;
+  std::vector<float> fetched_;               // interleaved stereo block from a stream
+  std::vector<float> stretch_buffer_;        // planar stereo block into or out of a stretcher
+  std::vector<float> envelope_;              // per-frame clip level of a fading block
+  std::vector<std::vector<float>> discard_;  // pre-roll output
+  std::uint64_t input_frame_ = 0;            // next input timeline frame fed to the graph
+  bool cued_ = false;
+  std::atomic<bool> playing_{false};
+  std::atomic<std::uint64_t> position_{0};
+
+  std::size_t grain_frames_;
+  std::vector<float> grain_window_;
+  std::vector<float> grains_[2];     // per node channel, one windowed grain each
+  std::size_t grain_phase_[2];       // frames of each grain already played
+  std::size_t hop_left_ = 0;         // frames until the next grain starts
+  std::vector<float> peeked_;        // interleaved stereo source span of a grain
+  double scrub_position_ = 0.0;
+  double scrub_target_ = 0.0;
+  double scrub_rate_ = 0.0;
+  double scrub_glide_;
+  std::uint64_t scrub_clock_ = 0;  // frames rendered while scrubbing
+  std::uint64_t reseek_frames_;
+  bool scrubbing_ = false;
+  SpscQueue<std::uint64_t, 256> scrub_queue_;
+  SpscQueue<LevelEdit, kLevelQueue> level_queue_;
+  Metronome metronome_;
+  std::atomic<bool> click_enabled_{false};
+  std::atomic<float> click_gain_{1.0f};
+  SampleStreamer streamer_;  // declared last: its thread stops before clips_ go away
+};
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_transport mc_transport;
+
+// `graph` must outlive the transport. Null on failure.
+MC_AUDIO_EXPORT mc_transport* mc_transport_create(mc_mix_graph* graph, float preroll_ms, float lookahead_ms);
+MC_AUDIO_EXPORT void mc_transport_free(mc_transport* transport);
+// Clip index, or -1 for an unreadable file, a sample rate mismatch or a
+// node that is not a track. `length` 0 plays to the end of the file.
+MC_AUDIO_EXPORT int mc_transport_add_clip_w(mc_transport* transport, const wchar_t* path, int node,
+                                            unsigned long long start, unsigned long long offset,
+                                            unsigned long long length, float gain);
+// `stretch` is timeline frames per file frame; `mode` 0 is WSOLA, 1 the
+// phase vocoder. 0 for an unknown clip or mode.
+MC_AUDIO_EXPORT int mc_transport_set_clip_stretch(mc_transport* transport, int clip, double stretch, float semitones,
+                                                  int mode);
+// Trim takes effect at the next cue, silencing playback until then, and must
+// not run while another thread renders; gain and fades are heard from the
+// next rendered block and are safe while another thread renders. Fade curves: 0 linear,
+// 1 equal power, 2 S-curve. 0 for an unknown clip or curve, or when the
+// gain or fade queue is full (the edit then waits for the next cue).
+MC_AUDIO_EXPORT int mc_transport_set_clip_trim(mc_transport* transport, int clip, unsigned long long start,
+                                               unsigned long long offset, unsigned long long length);
+MC_AUDIO_EXPORT int mc_transport_set_clip_gain(mc_transport* transport, int clip, float gain);
+MC_AUDIO_EXPORT int mc_transport_set_clip_fades(mc_transport* transport, int clip, unsigned long long fade_in_frames,
+                                                int fade_in_curve, unsigned long long fade_out_frames,
+                                                int fade_out_curve);
+// 1 when the window around `position` is resident and the graph pre-rolled.
+MC_AUDIO_EXPORT int mc_transport_cue(mc_transport* transport, unsigned long long position, unsigned int timeout_ms);
+MC_AUDIO_EXPORT int mc_transport_play(mc_transport* transport);
+MC_AUDIO_EXPORT int mc_transport_stop(mc_transport* transport);
+// One output pointer per channel of the master layout.
+MC_AUDIO_EXPORT int mc_transport_render(mc_transport* transport, float* const* outputs, unsigned long long frames);
+// Like mc_transport_render, with the click written to the one channel
+// `click` instead of the master.
+MC_AUDIO_EXPORT int mc_transport_render_with_click(mc_transport* transport, float* const* outputs, float* click,
+                                                   unsigned long long frames);
+// Tempo points (beat in quarter notes, BPM) and meter points (beat,
+// numerator, denominator), both starting at beat 0. 0 for malformed maps.
+MC_AUDIO_EXPORT int mc_transport_set_click_map(mc_transport* transport, const double* tempo_beats,
+                                               const double* tempo_bpm, unsigned int tempo_count,
+                                               const double* meter_beats, const int* meter_numerators,
+                                               const int* meter_denominators, unsigned int meter_count);
+// Safe while another thread renders.
+MC_AUDIO_EXPORT int mc_transport_set_click(mc_transport* transport, int enabled, float gain);
+MC_AUDIO_EXPORT int mc_transport_begin_scrub(mc_transport* transport);
+// Safe from a UI thread while another thread renders; 0 when the queue is full.
+MC_AUDIO_EXPORT int mc_transport_scrub_to(mc_transport* transport, unsigned long long position);
+MC_AUDIO_EXPORT int mc_transport_end_scrub(mc_transport* transport);
+MC_AUDIO_EXPORT unsigned long long mc_transport_position(const mc_transport* transport);
+MC_AUDIO_EXPORT unsigned long long mc_transport_underruns(const mc_transport* transport);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "wavetable.hpp"
+
+#include <cstddef>
+
+namespace music_create::audio {
+
+// Number of voices rendered per instruction. kAuto picks the widest width the
+// CPU supports; an explicit width is lowered to what the CPU supports.
+enum class VoiceLaneWidth : int {
+  kAuto = 0,
+  kScalar = 1,
+  kSse41 = 4,
+  kAvx2 = 8,
+  kAvx512 = 16,
+};
+
+VoiceLaneWidth ResolveVoiceLaneWidth(VoiceLaneWidth requested) noexcept;
+
+// Same mix as RenderToneNotes, but the active voices of each block are packed
+// into structure-of-arrays lanes (phase, increment, envelope state) and run
+// `width` at a time, so cost scales with voices / width.
+void RenderToneNotesParallel(const Wavetable& table, const ToneEnvelope& envelope, float unison_detune,
+                             const ToneNote* notes, std::size_t count, float* out, std::size_t frames,
+                             VoiceLaneWidth width = VoiceLaneWidth::kAuto);
+
+}  // namespace music_create::audio
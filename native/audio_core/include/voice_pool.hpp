@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace music_create::audio {
+
+enum class VoiceStealPolicy : int {
+  kNone = 0,      // a full pool drops the new note
+  kOldest = 1,    // longest-sounding voice
+  kQuietest = 2,  // lowest current level
+  kSameNote = 3,  // oldest voice already playing the note, else the oldest
+};
+
+// Fixed-capacity voice storage for the audio thread. All memory is allocated
+// by the constructor; Allocate and Release are O(1) through intrusive index
+// lists (a free list, the active voices in allocation order and one list per
+// note). Victim selection walks those lists from the oldest voice and stops
+// at the first stealable one, so it is linear in the active voices when most
+// are already being stolen; kQuietest always scans them all. The pool has a
+// single owner thread and takes no locks.
+template <typename Voice>
+class VoicePool {
+ public:
+  using Handle = std::uint32_t;
+  static constexpr Handle kNoVoice = std::numeric_limits<Handle>::max();
+  static constexpr int kNoteCount = 128;
+
+  explicit VoicePool(std::size_t capacity) : nodes_(capacity) {
+    if (capacity == 0 || capacity >= kNoVoice) {
+      throw std::invalid_argument("voice pool capacity out of range");
+    }
+    Reset();
+  }
+
+  std::size_t Capacity() const noexcept { return nodes_.size(); }
+  std::size_t ActiveCount() const noexcept { return active_count_; }
+  bool Full() const noexcept { return free_head_ == kNoVoice; }
+
+  Voice& operator[](Handle handle) noexcept { return nodes_[handle].voice; }
+  const Voice& operator[](Handle handle) const noexcept { return nodes_[handle].voice; }
+  int NoteOf(Handle handle) const noexcept { return nodes_[handle].note; }
+
+  // Takes a voice from the free list and appends it to the active list, or
+  // returns kNoVoice when every voice is sounding.
+  Handle Allocate(int note) noexcept {
+    const Handle handle = free_head_;
+    if (handle == kNoVoice) {
+      return kNoVoice;
+    }
+    Node& node = nodes_[handle];
+    free_head_ = node.next;
+    node.note = ClampNote(note);
+    node.active = true;
+    Link(handle, active_head_, active_tail_, &Node::prev, &Node::next);
+    Link(handle, note_heads_[node.note], note_tails_[node.note], &Node::note_prev, &Node::note_next);
+    ++active_count_;
+    return handle;
+  }
+
+  void Release(Handle handle) noexcept {
+    Node& node = nodes_[handle];
+    if (!node.active) {
+      return;
+    }
+    Unlink(handle, active_head_, active_tail_, &Node::prev, &Node::next);
+    Unlink(handle, note_heads_[node.note], note_tails_[node.note], &Node::note_prev, &Node::note_next);
+    node.active = false;
+    node.next = free_head_;
+    free_head_ = handle;
+    --active_count_;
+  }
+
+  void Reset() noexcept {
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      nodes_[i].active = false;
+      nodes_[i].next = i + 1 < nodes_.size() ? static_cast<Handle>(i + 1) : kNoVoice;
+    }
+    free_head_ = 0;
+    active_head_ = active_tail_ = kNoVoice;
+    note_heads_.fill(kNoVoice);
+    note_tails_.fill(kNoVoice);
+    active_count_ = 0;
+  }
+
+  Handle Oldest() const noexcept { return active_head_; }
+  Handle OldestWithNote(int note) const noexcept { return note_heads_[ClampNote(note)]; }
+
+  // Picks the voice to steal for `note`, skipping voices for which
+  // `stealable(voice)` is false (e.g. ones already fading out). `level(voice)`
+  // is only consulted for kQuietest. Returns kNoVoice if nothing qualifies.
+  template <typename Stealable, typename Level>
+  Handle SelectVictim(VoiceStealPolicy policy, int note, Stealable&& stealable, Level&& level) const noexcept {
+    switch (policy) {
+      case VoiceStealPolicy::kNone:
+        return kNoVoice;
+      case VoiceStealPolicy::kSameNote:
+        for (Handle h = note_heads_[ClampNote(note)]; h != kNoVoice; h = nodes_[h].note_next) {
+          if (stealable(nodes_[h].voice)) {
+            return h;
+          }
+        }
+        [[fallthrough]];
+      case VoiceStealPolicy::kOldest:
+        for (Handle h = active_head_; h != kNoVoice; h = nodes_[h].next) {
+          if (stealable(nodes_[h].voice)) {
+            return h;
+          }
+        }
+        return kNoVoice;
+      case VoiceStealPolicy::kQuietest: {
+        Handle best = kNoVoice;
+        float best_level = std::numeric_limits<float>::infinity();
+        for (Handle h = active_head_; h != kNoVoice; h = nodes_[h].next) {
+          if (!stealable(nodes_[h].voice)) {
+            continue;
+          }
+          const float current = level(nodes_[h].voice);
+          if (current < best_level) {
+            best_level = current;
+            best = h;
+          }
+        }
+        return best;
+      }
+    }
+    return kNoVoice;
+  }
+
+  // Visits active voices oldest first; `fn(handle, voice)` may Release the
+  // voice it is given.
+  template <typename Fn>
+  void ForEachActive(Fn&& fn) {
+    for (Handle h = active_head_; h != kNoVoice;) {
+      const Handle next = nodes_[h].next;
+      fn(h, nodes_[h].voice);
+      h = next;
+    }
+  }
+
+ private:
+  struct Node {
+    Voice voice{};
+    Handle prev = kNoVoice;
+    Handle next = kNoVoice;  // doubles as the free-list link
+    Handle note_prev = kNoVoice;
+    Handle note_next = kNoVoice;
+    int note = 0;
+    bool active = false;
+  };
+
+  static int ClampNote(int note) noexcept { return note < 0 ? 0 : (note >= kNoteCount ? kNoteCount - 1 : note); }
+
+  void Link(Handle handle, Handle& head, Handle& tail, Handle Node::*prev_field, Handle Node::*next_field) noexcept {
+    Node& node = nodes_[handle];
+    node.*prev_field = tail;
+    node.*next_field = kNoVoice;
+    if (tail != kNoVoice) {
+      nodes_[tail].*next_field = handle;
+    } else {
+      head = handle;
+    }
+    tail = handle;
+  }
+
+  void Unlink(Handle handle, Handle& head, Handle& tail, Handle Node::*prev_field, Handle Node::*next_field) noexcept {
+    Node& node = nodes_[handle];
+    const Handle prev = node.*prev_field;
+    const Handle next = node.*next_field;
+    if (prev != kNoVoice) {
+      nodes_[prev].*next_field = next;
+    } else {
+      head = next;
+    }
+    if (next != kNoVoice) {
+      nodes_[next].*prev_field = prev;
+    } else {
+      tail = prev;
+    }
+  }
+
+  std::vector<Node> nodes_;
+  Handle free_head_ = kNoVoice;
+  Handle active_head_ = kNoVoice;
+  Handle active_tail_ = kNoVoice;
+  std::array<Handle, kNoteCount> note_heads_{};
+  std::array<Handle, kNoteCount> note_tails_{};
+  std::size_t active_count_ = 0;
+};
+
+}  // namespace music_create::audio
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "audio_export.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace music_create::audio {
+
+// Single-cycle additive waveform stored once per octave ("mip level"). Level
+// L keeps only the harmonics that stay below Nyquist for every fundamental up
+// to kLowestFundamentalHz * 2^(L + 1), so playback never aliases and each
+// voice costs one interpolated table read per sample whatever the harmonic
+// count.
+class Wavetable {
+ public:
+  static constexpr std::uint32_t kTableBits = 11;
+  static constexpr std::uint32_t kTableSize = 1u << kTableBits;
+  static constexpr std::uint32_t kFractionBits = 32 - kTableBits;
+  static constexpr int kLevelCount = 11;
+  static constexpr double kLowestFundamentalHz = 20.0;
+
+  // `harmonics[i]` is the amplitude of partial i + 1. Throws std::invalid_argument
+  // for an empty harmonic list or a zero sample rate.
+  Wavetable(const float* harmonics, std::size_t count, std::uint32_t sample_rate);
+
+  std::uint32_t SampleRate() const noexcept { return sample_rate_; }
+  int LevelForFrequency(double hz) const noexcept;
+  // kTableSize + 1 samples; the last one repeats the first for interpolation.
+  const float* Level(int level) const noexcept { return tables_.data() + LevelOffset(level); }
+  // All levels back to back, `LevelOffset(level)` floats apart.
+  const float* Data() const noexcept { return tables_.data(); }
+  static constexpr std::size_t LevelOffset(int level) noexcept { return static_cast<std::size_t>(level) * kStride; }
+
+  // 32-bit phase accumulator step for `hz`; the top kTableBits bits index the table.
+  std::uint32_t PhaseIncrement(double hz) const noexcept;
+
+ private:
+  static constexpr std::size_t kStride = kTableSize + 1;
+
+  std::uint32_t sample_rate_;
+  std::vector<float> tables_;
+};
+
+// Linear ADSR shape of the preview synth, in samples. The decay segment is
+// sustain + (1 - sustain) * exp(-(i - attack) * decay_rate / sample_rate) and the
+// release ramps to zero over the last `release_samples` of the note.
+struct ToneEnvelope {
+  std::int64_t attack_samples = 1;
+  float decay_rate = 1.0f;
+  float sustain = 1.0f;
+  std::int64_t release_samples = 1;
+};
+
+struct ToneNote {
+  std::int64_t start_sample = 0;
+  std::int64_t length_samples = 0;
+  float frequency = 440.0f;
+  float amplitude = 1.0f;
+};
+
+inline float ReadWavetable(const float* table, std::uint32_t phase) noexcept {
+  const std::uint32_t index = phase >> Wavetable::kFractionBits;
+  const float fraction =
+      static_cast<float>(phase & ((1u << Wavetable::kFractionBits) - 1)) * (1.0f / (1u << Wavetable::kFractionBits));
+  return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+// Mixes notes into `out` (mono, `frames` long), one note at a time.
+// `unison_detune` > 0 adds a second oscillator at frequency * (1 + unison_detune),
+// each at half level. RenderToneNotesParallel (voice_lanes.hpp) produces the same
+// mix with voices packed into SIMD lanes; this is the reference path.
+void RenderToneNotes(const Wavetable& table, const ToneEnvelope& envelope, float unison_detune, const ToneNote* notes,
+                     std::size_t count, float* out, std::size_t frames);
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+typedef struct mc_wavetable mc_wavetable;
+
+MC_AUDIO_EXPORT mc_wavetable* mc_wavetable_create(const float* harmonics, unsigned int count,
+                                                  unsigned int sample_rate);
+MC_AUDIO_EXPORT void mc_wavetable_free(mc_wavetable* table);
+MC_AUDIO_EXPORT int mc_wavetable_render_notes(const mc_wavetable* table, unsigned long long count,
+                                              const long long* start_sample, const long long* length_samples,
+                                              const float* frequency, const float* amplitude,
+                                              long long attack_samples, float decay_rate, float sustain,
+                                              long long release_samples, float unison_detune, float* out,
+                                              unsigned long long frames, int lane_width);
+}
@@ -0,0 +1,125 @@
+#include "audio_buffer.hpp"
+
+#include "cpu_features.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+using InterleaveFn = void (*)(const float*, const float*, float*, std::size_t) noexcept;
+using DeinterleaveFn = void (*)(const float*, float*, float*, std::size_t) noexcept;
+
+void InterleaveScalar(const float* left, const float* right, float* interleaved, std::size_t frames) noexcept {
+  for (std::size_t i = 0; i < frames; ++i) {
+    interleaved[i * 2] = left[i];
+    interleaved[i * 2 + 1] = right[i];
+  }
+}
+
+void DeinterleaveScalar(const float* interleaved, float* left, float* right, std::size_t frames) noexcept {
+  for (std::size_t i = 0; i < frames; ++i) {
+    left[i] = interleaved[i * 2];
+    right[i] = interleaved[i * 2 + 1];
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+
+// Eight frames per step. unpacklo/hi pair frames within each 128-bit lane
+// and permute2f128 puts the lanes back in frame order; the reverse shuffles
+// even/odd samples per lane and permute4x64 restores the order.
+MC_AUDIO_TARGET("avx2")
+void InterleaveAvx2(const float* left, const float* right, float* interleaved, std::size_t frames) noexcept {
+  std::size_t i = 0;
+  for (; i + 8 <= frames; i += 8) {
+    const __m256 l = _mm256_loadu_ps(left + i);
+    const __m256 r = _mm256_loadu_ps(right + i);
+    const __m256 low = _mm256_unpacklo_ps(l, r);
+    const __m256 high = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(interleaved + i * 2, _mm256_permute2f128_ps(low, high, 0x20));
+    _mm256_storeu_ps(interleaved + i * 2 + 8, _mm256_permute2f128_ps(low, high, 0x31));
+  }
+  InterleaveScalar(left + i, right + i, interleaved + i * 2, frames - i);
+}
+
+MC_AUDIO_TARGET("avx2")
+void DeinterleaveAvx2(const float* interleaved, float* left, float* right, std::size_t frames) noexcept {
+  std::size_t i = 0;
+  for (; i + 8 <= frames; i += 8) {
+    const __m256 a = _mm256_loadu_ps(interleaved + i * 2);
+    const __m256 b = _mm256_loadu_ps(interleaved + i * 2 + 8);
+    const __m256 even = _mm256_shuffle_ps(a, b, 0x88);
+    const __m256 odd = _mm256_shuffle_ps(a, b, 0xDD);
+    _mm256_storeu_ps(left + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), 0xD8)));
+    _mm256_storeu_ps(right + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), 0xD8)));
+  }
+  DeinterleaveScalar(interleaved + i * 2, left + i, right + i, frames - i);
+}
+
+#endif
+
+InterleaveFn SelectInterleave() noexcept {
+#if MC_AUDIO_X86_DISPATCH
+  if (DetectCpuFeatures().avx2) {
+    return InterleaveAvx2;
+  }
+#endif
+  return InterleaveScalar;
+}
+
+DeinterleaveFn SelectDeinterleave() noexcept {
+#if MC_AUDIO_X86_DISPATCH
+  if (DetectCpuFeatures().avx2) {
+    return DeinterleaveAvx2;
+  }
+#endif
+  return DeinterleaveScalar;
+}
+
+}  // namespace
+
+void InterleaveStereo(const float* left, const float* right, float* interleaved, std::size_t frames) noexcept {
+  static const InterleaveFn kernel = SelectInterleave();
+  kernel(left, right, interleaved, frames);
+}
+
+void DeinterleaveStereo(const float* interleaved, float* left, float* right, std::size_t frames) noexcept {
+  static const DeinterleaveFn kernel = SelectDeinterleave();
+  kernel(interleaved, left, right, frames);
+}
+
+void CopyFrames(ConstAudioBufferView source, const AudioBufferView& destination) noexcept {
+  const std::size_t channels = std::min(source.Channels(), destination.Channels());
+  const std::size_t frames = std::min(source.Frames(), destination.Frames());
+  if (channels == 0 || frames == 0) {
+    return;
+  }
+  source = source.SubChannels(0, channels).SubFrames(0, frames);
+  const AudioBufferView target = destination.SubChannels(0, channels).SubFrames(0, frames);
+  if (source.IsInterleaved() && target.IsInterleaved()) {
+    std::memcpy(target.Data(), source.Data(), channels * frames * sizeof(float));
+  } else if (source.IsPlanar() && target.IsPlanar()) {
+    for (std::size_t c = 0; c < channels; ++c) {
+      std::memcpy(&target(c, 0), &source(c, 0), frames * sizeof(float));
+    }
+  } else if (channels == 2 && source.IsInterleaved() && target.IsPlanar()) {
+    DeinterleaveStereo(source.Data(), &target(0, 0), &target(1, 0), frames);
+  } else if (channels == 2 && source.IsPlanar() && target.IsInterleaved()) {
+    InterleaveStereo(&source(0, 0), &source(1, 0), target.Data(), frames);
+  } else {
+    for (std::size_t f = 0; f < frames; ++f) {
+      for (std::size_t c = 0; c < channels; ++c) {
+        target(c, f) = source(c, f);
+      }
+    }
+  }
+}
+
+}  // namespace music_create::audio
@@ -1,9 +1,15 @@
 #include "audio_core.hpp"
 
+#include "audio_file_reader.hpp"
+
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -28,6 +34,55 @@ class IAudioBackend {
 
 namespace {
 
+#ifdef _WIN32
+bool HasRiffSignature(const std::wstring& path) {
+  std::ifstream probe(std::filesystem::path(path), std::ios::binary);
+  char magic[4] = {};
+  return probe.read(magic, 4) && std::memcmp(magic, "RIFF", 4) == 0;
+}
+
+void AppendLittleEndian(std::vector<std::uint8_t>& out, std::uint32_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<std::uint8_t>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+// Decodes a compressed asset into an in-memory 16-bit RIFF image for
+// file-oriented backends that can only play PCM WAV.
+std::vector<std::uint8_t> DecodeToRiffPcm16(IAudioFileReader& reader) {
+  const AudioFileInfo& info = reader.Info();
+  const std::uint32_t data_bytes = static_cast<std::uint32_t>(info.total_frames * info.channels * 2);
+  std::vector<std::uint8_t> image;
+  image.reserve(44 + data_bytes);
+  image.insert(image.end(), {'R', 'I', 'F', 'F'});
+  AppendLittleEndian(image, 36 + data_bytes, 4);
+  image.insert(image.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  AppendLittleEndian(image, 16, 4);
+  AppendLittleEndian(image, 1, 2);
+  AppendLittleEndian(image, info.channels, 2);
+  AppendLittleEndian(image, info.sample_rate, 4);
+  AppendLittleEndian(image, info.sample_rate * info.channels * 2, 4);
+  AppendLittleEndian(image, info.channels * 2, 2);
+  AppendLittleEndian(image, 16, 2);
+  image.insert(image.end(), {'d', 'a', 't', 'a'});
+  AppendLittleEndian(image, data_bytes, 4);
+
+  std::vector<float> block(4096 * static_cast<std::size_t>(info.channels));
+  while (true) {
+    const std::size_t frames = reader.Read(block.data(), 4096);
+    if (frames == 0) {
+      break;
+    }
+    for (std::size_t i = 0; i < frames * info.channels; ++i) {
+      const float clipped = std::clamp(block[i], -1.0f, 1.0f);
+      const auto value = static_cast<std::int16_t>(std::lround(clipped * 32767.0f));
+      AppendLittleEndian(image, static_cast<std::uint16_t>(value), 2);
+    }
+  }
+  return image;
+}
+#endif
+
 class WinMMBackend final : public IAudioBackend {
  public:
   const char* Id() const noexcept override { return "winmm"; }
@@ -68,7 +123,18 @@ class WinMMBackend final : public IAudioBackend {
         return false;
       }
     }
-    return PlaySoundW(path.c_str(), nullptr, SND_FILENAME | SND_ASYNC | SND_NODEFAULT) == TRUE;
+    if (HasRiffSignature(path)) {
+      return PlaySoundW(path.c_str(), nullptr, SND_FILENAME | SND_ASYNC | SND_NODEFAULT) == TRUE;
+    }
+    try {
+      auto reader = OpenAudioFileReader(std::filesystem::path(path));
+      StopPlayback();
+      memory_image_ = DecodeToRiffPcm16(*reader);
+    } catch (...) {
+      return false;
+    }
+    return PlaySoundW(reinterpret_cast<LPCWSTR>(memory_image_.data()), nullptr,
+                      SND_MEMORY | SND_ASYNC | SND_NODEFAULT) == TRUE;
 #else
     (void)path;
     return false;
@@ -85,6 +151,7 @@ class WinMMBackend final : public IAudioBackend {
 
  private:
   bool running_ = false;
+  std::vector<std::uint8_t> memory_image_;
 };
 
 class JuceBackendPlaceholder final : public IAudioBackend {
@@ -0,0 +1,272 @@
+#include "audio_file_reader.hpp"
+
+#include "flac_decoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr std::uint16_t kWaveFormatPcm = 1;
+constexpr std::uint16_t kWaveFormatFloat = 3;
+constexpr std::uint16_t kWaveFormatExtensible = 0xFFFE;
+constexpr std::size_t kWavReadChunkFrames = 4096;
+
+std::uint32_t ReadLittleEndian(const std::uint8_t* data, int bytes) {
+  std::uint32_t value = 0;
+  for (int i = bytes - 1; i >= 0; --i) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+// Copies with the IAudioFileReader channel mapping: output channel c takes
+// source channel min(c, channels - 1).
+void CopyMappedChannels(const ConstAudioBufferView& source, const AudioBufferView& out) noexcept {
+  CopyFrames(source, out);
+  for (std::size_t c = source.Channels(); c < out.Channels(); ++c) {
+    CopyFrames(source.Channel(source.Channels() - 1), out.Channel(c));
+  }
+}
+
+class WavFileReader final : public IAudioFileReader {
+ public:
+  explicit WavFileReader(const std::filesystem::path& path) : file_(path, std::ios::binary) {
+    if (!file_) {
+      throw std::runtime_error("failed to open WAV file");
+    }
+    ParseChunks();
+  }
+
+  const AudioFileInfo& Info() const noexcept override { return info_; }
+  std::uint64_t Position() const noexcept override { return position_; }
+
+  bool Seek(std::uint64_t frame) override {
+    if (frame > info_.total_frames) {
+      return false;
+    }
+    position_ = frame;
+    return true;
+  }
+
+  std::size_t ReadInto(const AudioBufferView& out) override {
+    const std::size_t frame_bytes = static_cast<std::size_t>(block_align_);
+    const std::size_t channels = info_.channels;
+    // A matching interleaved target is converted in place; other layouts go
+    // through one chunk of interleaved scratch.
+    const bool direct = out.IsInterleaved() && out.Channels() == channels;
+    const auto frames = static_cast<std::size_t>(std::min<std::uint64_t>(out.Frames(), info_.total_frames - position_));
+    std::size_t written = 0;
+    while (written < frames) {
+      const std::size_t count = std::min(kWavReadChunkFrames, frames - written);
+      raw_.resize(count * frame_bytes);
+      file_.clear();
+      file_.seekg(static_cast<std::streamoff>(data_offset_ + position_ * frame_bytes), std::ios::beg);
+      if (!file_.read(reinterpret_cast<char*>(raw_.data()), static_cast<std::streamsize>(raw_.size()))) {
+        break;
+      }
+      if (direct) {
+        ConvertFrames(raw_.data(), &out(0, written), count);
+      } else {
+        converted_.resize(count * channels);
+        ConvertFrames(raw_.data(), converted_.data(), count);
+        CopyMappedChannels(ConstAudioBufferView::Interleaved(converted_.data(), channels, count),
+                           out.SubFrames(written, count));
+      }
+      written += count;
+      position_ += count;
+    }
+    return written;
+  }
+
+ private:
+  void ParseChunks() {
+    std::uint8_t riff[12] = {};
+    if (!file_.read(reinterpret_cast<char*>(riff), 12) || std::memcmp(riff, "RIFF", 4) != 0 ||
+        std::memcmp(riff + 8, "WAVE", 4) != 0) {
+      throw std::runtime_error("missing RIFF/WAVE header");
+    }
+    bool has_format = false;
+    while (true) {
+      std::uint8_t chunk[8] = {};
+      if (!file_.read(reinterpret_cast<char*>(chunk), 8)) {
+        break;
+      }
+      const std::uint32_t size = ReadLittleEndian(chunk + 4, 4);
+      const std::uint64_t body = static_cast<std::uint64_t>(file_.tellg());
+      if (std::memcmp(chunk, "fmt ", 4) == 0) {
+        std::vector<std::uint8_t> format(std::max<std::uint32_t>(size, 16));
+        file_.read(reinterpret_cast<char*>(format.data()), size);
+        format_tag_ = static_cast<std::uint16_t>(ReadLittleEndian(format.data(), 2));
+        info_.channels = ReadLittleEndian(format.data() + 2, 2);
+        info_.sample_rate = ReadLittleEndian(format.data() + 4, 4);
+        block_align_ = static_cast<std::uint16_t>(ReadLittleEndian(format.data() + 12, 2));
+        info_.bits_per_sample = ReadLittleEndian(format.data() + 14, 2);
+        if (format_tag_ == kWaveFormatExtensible && size >= 26) {
+          format_tag_ = static_cast<std::uint16_t>(ReadLittleEndian(format.data() + 24, 2));
+        }
+        has_format = true;
+      } else if (std::memcmp(chunk, "data", 4) == 0) {
+        if (!has_format) {
+          throw std::runtime_error("WAV data chunk precedes fmt chunk");
+        }
+        data_offset_ = body;
+        if (block_align_ > 0) {
+          info_.total_frames = size / block_align_;
+        }
+        break;
+      }
+      file_.clear();
+      file_.seekg(static_cast<std::streamoff>(body + size + (size & 1)), std::ios::beg);
+    }
+
+    const std::uint32_t bytes = info_.bits_per_sample / 8;
+    const bool pcm = format_tag_ == kWaveFormatPcm && bytes >= 1 && bytes <= 4;
+    const bool ieee = format_tag_ == kWaveFormatFloat && bytes == 4;
+    if (data_offset_ == 0 || info_.channels == 0 || info_.sample_rate == 0 || (!pcm && !ieee) ||
+        block_align_ != bytes * info_.channels) {
+      throw std::runtime_error("unsupported WAV format");
+    }
+  }
+
+  void ConvertFrames(const std::uint8_t* raw, float* out, std::size_t frames) const {
+    const std::size_t samples = frames * info_.channels;
+    const std::uint32_t bytes = info_.bits_per_sample / 8;
+    if (format_tag_ == kWaveFormatFloat) {
+      std::memcpy(out, raw, samples * sizeof(float));
+      return;
+    }
+    for (std::size_t i = 0; i < samples; ++i, raw += bytes) {
+      switch (bytes) {
+        case 1:
+          out[i] = (static_cast<float>(raw[0]) - 128.0f) / 128.0f;
+          break;
+        case 2:
+          out[i] = static_cast<float>(static_cast<std::int16_t>(ReadLittleEndian(raw, 2))) / 32768.0f;
+          break;
+        case 3:
+          out[i] = static_cast<float>(static_cast<std::int32_t>(ReadLittleEndian(raw, 3) << 8) >> 8) / 8388608.0f;
+          break;
+        default:
+          out[i] = static_cast<float>(static_cast<std::int32_t>(ReadLittleEndian(raw, 4))) / 2147483648.0f;
+          break;
+      }
+    }
+  }
+
+  std::ifstream file_;
+  AudioFileInfo info_{};
+  std::uint16_t format_tag_ = 0;
+  std::uint16_t block_align_ = 0;
+  std::uint64_t data_offset_ = 0;
+  std::uint64_t position_ = 0;
+  std::vector<std::uint8_t> raw_;
+  std::vector<float> converted_;
+};
+
+}  // namespace
+
+std::unique_ptr<IAudioFileReader> OpenWavFileReader(const std::filesystem::path& path) {
+  return std::make_unique<WavFileReader>(path);
+}
+
+std::unique_ptr<IAudioFileReader> OpenAudioFileReader(const std::filesystem::path& path) {
+  std::ifstream probe(path, std::ios::binary);
+  char magic[4] = {};
+  if (!probe || !probe.read(magic, 4)) {
+    throw std::runtime_error("failed to open audio file");
+  }
+  if (std::memcmp(magic, "RIFF", 4) == 0) {
+    return OpenWavFileReader(path);
+  }
+  if (std::memcmp(magic, "fLaC", 4) == 0 || std::memcmp(magic, "ID3", 3) == 0) {
+    return OpenFlacFileReader(path);
+  }
+  throw std::runtime_error("unrecognized audio file format");
+}
+
+}  // namespace music_create::audio
+
+struct mc_audio_file {
+  std::unique_ptr<music_create::audio::IAudioFileReader> reader;
+};
+
+extern "C" {
+
+mc_audio_file* mc_audio_file_open_w(const wchar_t* path) {
+  if (path == nullptr) {
+    return nullptr;
+  }
+  try {
+    auto handle = std::make_unique<mc_audio_file>();
+    handle->reader = music_create::audio::OpenAudioFileReader(std::filesystem::path(path));
+    return handle.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_audio_file_close(mc_audio_file* file) { delete file; }
+
+int mc_audio_file_info(const mc_audio_file* file, unsigned int* sample_rate, unsigned int* channels,
+                       unsigned int* bits_per_sample, unsigned long long* total_frames) {
+  if (file == nullptr) {
+    return 0;
+  }
+  const auto& info = file->reader->Info();
+  if (sample_rate != nullptr) {
+    *sample_rate = info.sample_rate;
+  }
+  if (channels != nullptr) {
+    *channels = info.channels;
+  }
+  if (bits_per_sample != nullptr) {
+    *bits_per_sample = info.bits_per_sample;
+  }
+  if (total_frames != nullptr) {
+    *total_frames = info.total_frames;
+  }
+  return 1;
+}
+
+int mc_audio_file_seek(mc_audio_file* file, unsigned long long frame) {
+  if (file == nullptr) {
+    return 0;
+  }
+  try {
+    return file->reader->Seek(frame) ? 1 : 0;
+  } catch (...) {
+    return 0;
+  }
+}
+
+unsigned long long mc_audio_file_read_f32(mc_audio_file* file, float* interleaved, unsigned long long frames) {
+  if (file == nullptr || interleaved == nullptr) {
+    return 0;
+  }
+  try {
+    return file->reader->Read(interleaved, static_cast<std::size_t>(frames));
+  } catch (...) {
+    return 0;
+  }
+}
+
+unsigned long long mc_audio_file_read_planar_f32(mc_audio_file* file, float* planar, unsigned long long frames) {
+  if (file == nullptr || planar == nullptr) {
+    return 0;
+  }
+  try {
+    const auto count = static_cast<std::size_t>(frames);
+    return file->reader->ReadInto(
+        music_create::audio::AudioBufferView::Planar(planar, file->reader->Info().channels, count));
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
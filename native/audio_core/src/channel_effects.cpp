@@ -0,0 +1,200 @@
+#include "channel_effects.hpp"
+
+#include "denormals.hpp"
+#include "dynamics.hpp"
+#include "fast_math.hpp"
+#include "param_tables.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace music_create::audio {
+
+namespace {
+
+float OnePoleAlpha(float cutoff_hz, std::uint32_t sample_rate) noexcept {
+  if (cutoff_hz <= 0.0f || sample_rate == 0) {
+    return 0.0f;
+  }
+  return OnePoleCoefficient(static_cast<float>(sample_rate / (2.0 * std::numbers::pi * cutoff_hz)));
+}
+
+}  // namespace
+
+ThreeBandEq::ThreeBandEq(std::uint32_t sample_rate, const EqParams& params)
+    : low_gain_(DbToGain(params.low_gain_db)),
+      mid_gain_(DbToGain(params.mid_gain_db)),
+      high_gain_(DbToGain(params.high_gain_db)) {
+  const float low_freq = std::max(20.0f, params.low_freq_hz);
+  const float high_freq = std::max(low_freq + 10.0f, params.high_freq_hz);
+  low_alpha_ = OnePoleAlpha(low_freq, sample_rate);
+  high_alpha_ = OnePoleAlpha(high_freq, sample_rate);
+}
+
+void ThreeBandEq::Reset() noexcept {
+  low_state_.fill(0.0f);
+  high_state_.fill(0.0f);
+}
+
+void ThreeBandEq::Process(float* left, float* right, const float*, const float*, std::size_t frames) noexcept {
+  float* channels[2] = {left, right};
+  for (std::size_t c = 0; c < 2; ++c) {
+    float* samples = channels[c];
+    float low_state = low_state_[c];
+    float high_state = high_state_[c];
+    for (std::size_t n = 0; n < frames; ++n) {
+      const float sample = samples[n];
+      low_state = FlushDenormal((1.0f - low_alpha_) * sample + low_alpha_ * low_state);
+      high_state = FlushDenormal((1.0f - high_alpha_) * sample + high_alpha_ * high_state);
+      const float high = sample - high_state;
+      const float mid = sample - low_state - high;
+      samples[n] = low_state * low_gain_ + mid * mid_gain_ + high * high_gain_;
+    }
+    low_state_[c] = low_state;
+    high_state_[c] = high_state;
+  }
+}
+
+Saturator::Saturator(const SaturatorParams& params)
+    : shape_(1.0f + std::clamp(params.drive, 0.0f, 1.0f) * 8.0f),
+      inverse_normalizer_(1.0f / std::tanh(shape_)),
+      mix_(std::clamp(params.mix, 0.0f, 1.0f)),
+      oversamplers_{Oversampler(params.oversampling, kChunk), Oversampler(params.oversampling, kChunk)} {
+  for (std::vector<float>& ring : dry_delay_) {
+    ring.assign(Latency(), 0.0f);
+  }
+}
+
+void Saturator::Reset() noexcept {
+  for (std::size_t c = 0; c < 2; ++c) {
+    oversamplers_[c].Reset();
+    std::fill(dry_delay_[c].begin(), dry_delay_[c].end(), 0.0f);
+  }
+  dry_position_ = 0;
+}
+
+void Saturator::Shape(float* samples, std::size_t count) const noexcept {
+  for (std::size_t n = 0; n < count; ++n) {
+    samples[n] *= shape_;
+  }
+  FastTanhBlock(samples, samples, count);
+  for (std::size_t n = 0; n < count; ++n) {
+    samples[n] *= inverse_normalizer_;
+  }
+}
+
+void Saturator::Process(float* left, float* right, const float*, const float*, std::size_t frames) noexcept {
+  const std::size_t latency = Latency();
+  if (latency == 0) {
+    for (float* samples : {left, right}) {
+      for (std::size_t n = 0; n < frames; ++n) {
+        const float sample = samples[n];
+        const float wet = FastTanh(sample * shape_) * inverse_normalizer_;
+        samples[n] = sample + (wet - sample) * mix_;
+      }
+    }
+    return;
+  }
+  float* channels[2] = {left, right};
+  for (std::size_t offset = 0; offset < frames; offset += kChunk) {
+    const std::size_t count = std::min(kChunk, frames - offset);
+    std::size_t position = dry_position_;
+    for (std::size_t c = 0; c < 2; ++c) {
+      float* samples = channels[c] + offset;
+      Oversampler& oversampler = oversamplers_[c];
+      Shape(oversampler.Upsample(samples, count), count * oversampler.Factor());
+      oversampler.Downsample(wet_.data(), count);
+      std::vector<float>& ring = dry_delay_[c];
+      position = dry_position_;
+      for (std::size_t n = 0; n < count; ++n) {
+        const float dry = ring[position];
+        ring[position] = samples[n];
+        position = position + 1 == latency ? 0 : position + 1;
+        samples[n] = dry + (wet_[n] - dry) * mix_;
+      }
+    }
+    dry_position_ = position;
+  }
+}
+
+StereoReverb::StereoReverb(std::uint32_t sample_rate, const FdnReverbParams& params)
+    : left_(sample_rate), right_(sample_rate) {
+  left_.SetParams(params);
+  right_.SetParams(params);
+}
+
+void StereoReverb::Reset() noexcept {
+  left_.Reset();
+  right_.Reset();
+}
+
+void StereoReverb::Process(float* left, float* right, const float*, const float*, std::size_t frames) noexcept {
+  left_.Process(left, left, frames);
+  right_.Process(right, right, frames);
+}
+
+StereoDelay::StereoDelay(std::uint32_t sample_rate, const TempoDelayParams& params)
+    : left_(sample_rate), right_(sample_rate) {
+  left_.SetParams(params);
+  right_.SetParams(params);
+}
+
+void StereoDelay::Reset() noexcept {
+  left_.Reset();
+  right_.Reset();
+}
+
+void StereoDelay::Process(float* left, float* right, const float*, const float*, std::size_t frames) noexcept {
+  left_.Process(left, left, frames);
+  right_.Process(right, right, frames);
+}
+
+}  // namespace music_create::audio
+
+struct mc_saturator {
+  explicit mc_saturator(const music_create::audio::SaturatorParams& params) : saturator(params) {}
+
+  music_create::audio::Saturator saturator;
+};
+
+extern "C" {
+
+mc_saturator* mc_saturator_create(float drive, float mix, unsigned int oversampling) {
+  try {
+    return new mc_saturator({drive, mix, oversampling});
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_saturator_free(mc_saturator* saturator) { delete saturator; }
+
+unsigned int mc_saturator_latency(const mc_saturator* saturator) {
+  return saturator == nullptr ? 0 : static_cast<unsigned int>(saturator->saturator.Latency());
+}
+
+int mc_saturator_process(mc_saturator* saturator, float* left, float* right, unsigned long long frames) {
+  if (saturator == nullptr || (frames > 0 && left == nullptr)) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  if (right == nullptr) {
+    // Run the right channel over a scratch copy so mono keeps its own state.
+    std::vector<float> scratch(left, left + frames);
+    saturator->saturator.Process(left, scratch.data(), nullptr, nullptr, static_cast<std::size_t>(frames));
+  } else {
+    saturator->saturator.Process(left, right, nullptr, nullptr, static_cast<std::size_t>(frames));
+  }
+  return 1;
+}
+
+int mc_saturator_reset(mc_saturator* saturator) {
+  if (saturator == nullptr) {
+    return 0;
+  }
+  saturator->saturator.Reset();
+  return 1;
+}
+
+}  // extern "C"
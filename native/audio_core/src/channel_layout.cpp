@@ -0,0 +1,274 @@
+#include "channel_layout.hpp"
+
+#include "cpu_features.hpp"
+#include "param_tables.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr float kMinus3Db = 0.70710678f;
+
+constexpr Speaker kMonoSpeakers[] = {Speaker::kCenter};
+constexpr Speaker kStereoSpeakers[] = {Speaker::kLeft, Speaker::kRight};
+constexpr Speaker kLcrSpeakers[] = {Speaker::kLeft, Speaker::kRight, Speaker::kCenter};
+constexpr Speaker kSurround51Speakers[] = {Speaker::kLeft, Speaker::kRight,        Speaker::kCenter,
+                                           Speaker::kLfe,  Speaker::kSurroundLeft, Speaker::kSurroundRight};
+constexpr Speaker kSurround71Speakers[] = {Speaker::kLeft,     Speaker::kRight,        Speaker::kCenter,
+                                           Speaker::kLfe,      Speaker::kSurroundLeft, Speaker::kSurroundRight,
+                                           Speaker::kRearLeft, Speaker::kRearRight};
+
+struct SpeakerList {
+  const Speaker* speakers;
+  std::size_t count;
+};
+
+SpeakerList Speakers(ChannelLayout layout) noexcept {
+  switch (layout) {
+    case ChannelLayout::kMono:
+      return {kMonoSpeakers, std::size(kMonoSpeakers)};
+    case ChannelLayout::kStereo:
+      return {kStereoSpeakers, std::size(kStereoSpeakers)};
+    case ChannelLayout::kLcr:
+      return {kLcrSpeakers, std::size(kLcrSpeakers)};
+    case ChannelLayout::kSurround51:
+      return {kSurround51Speakers, std::size(kSurround51Speakers)};
+    case ChannelLayout::kSurround71:
+      return {kSurround71Speakers, std::size(kSurround71Speakers)};
+  }
+  return {kStereoSpeakers, std::size(kStereoSpeakers)};
+}
+
+// Channel of `speaker` in `layout`, or count when the layout lacks it.
+std::size_t IndexOf(ChannelLayout layout, Speaker speaker) noexcept {
+  const SpeakerList list = Speakers(layout);
+  return static_cast<std::size_t>(std::find(list.speakers, list.speakers + list.count, speaker) - list.speakers);
+}
+
+// Adds `speaker` of input channel `input` to the matrix at `gain`, folding
+// it towards the front while `to` lacks it. Terminates because only mono
+// lacks L/R and it has C, and every layout without C has L/R.
+void Route(ChannelMatrix& matrix, ChannelLayout to, std::size_t input, Speaker speaker, float gain) noexcept {
+  const std::size_t output = IndexOf(to, speaker);
+  if (output < matrix.outputs) {
+    matrix(output, input) += gain;
+    return;
+  }
+  switch (speaker) {
+    case Speaker::kCenter:
+      Route(matrix, to, input, Speaker::kLeft, gain * kMinus3Db);
+      Route(matrix, to, input, Speaker::kRight, gain * kMinus3Db);
+      break;
+    case Speaker::kLeft:
+    case Speaker::kRight:
+      Route(matrix, to, input, Speaker::kCenter, gain * kMinus3Db);
+      break;
+    case Speaker::kLfe:
+      break;
+    case Speaker::kSurroundLeft:
+      Route(matrix, to, input, Speaker::kLeft, gain * kMinus3Db);
+      break;
+    case Speaker::kSurroundRight:
+      Route(matrix, to, input, Speaker::kRight, gain * kMinus3Db);
+      break;
+    case Speaker::kRearLeft:
+      Route(matrix, to, input, Speaker::kSurroundLeft, gain);
+      break;
+    case Speaker::kRearRight:
+      Route(matrix, to, input, Speaker::kSurroundRight, gain);
+      break;
+  }
+}
+
+struct Term {
+  std::size_t output;
+  std::size_t input;
+  float gain;
+};
+
+using MixFn = void (*)(const Term*, std::size_t, const float* const*, float* const*, std::size_t) noexcept;
+
+// Terms are grouped by output, so each output is loaded and stored once per
+// step while its inputs accumulate.
+void MixScalar(const Term* terms, std::size_t count, const float* const* in, float* const* out,
+               std::size_t frames) noexcept {
+  for (std::size_t first = 0; first < count;) {
+    std::size_t last = first;
+    while (last < count && terms[last].output == terms[first].output) {
+      ++last;
+    }
+    float* target = out[terms[first].output];
+    for (std::size_t n = 0; n < frames; ++n) {
+      float sum = target[n];
+      for (const Term* term = terms + first; term != terms + last; ++term) {
+        sum += term->gain * in[term->input][n];
+      }
+      target[n] = sum;
+    }
+    first = last;
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+
+MC_AUDIO_TARGET("avx2,fma")
+void MixAvx2(const Term* terms, std::size_t count, const float* const* in, float* const* out,
+             std::size_t frames) noexcept {
+  const std::size_t vector_frames = frames & ~std::size_t{7};
+  for (std::size_t first = 0; first < count;) {
+    std::size_t last = first;
+    while (last < count && terms[last].output == terms[first].output) {
+      ++last;
+    }
+    float* target = out[terms[first].output];
+    for (std::size_t n = 0; n < vector_frames; n += 8) {
+      __m256 sum = _mm256_loadu_ps(target + n);
+      for (const Term* term = terms + first; term != terms + last; ++term) {
+        sum = _mm256_fmadd_ps(_mm256_set1_ps(term->gain), _mm256_loadu_ps(in[term->input] + n), sum);
+      }
+      _mm256_storeu_ps(target + n, sum);
+    }
+    first = last;
+  }
+  if (vector_frames < frames) {
+    const float* in_tail[kMaxLayoutChannels];
+    float* out_tail[kMaxLayoutChannels];
+    for (std::size_t c = 0; c < kMaxLayoutChannels; ++c) {
+      in_tail[c] = in[c] == nullptr ? nullptr : in[c] + vector_frames;
+      out_tail[c] = out[c] == nullptr ? nullptr : out[c] + vector_frames;
+    }
+    MixScalar(terms, count, in_tail, out_tail, frames - vector_frames);
+  }
+}
+
+#endif
+
+MixFn SelectMix() noexcept {
+#if MC_AUDIO_X86_DISPATCH
+  if (DetectCpuFeatures().avx2 && DetectCpuFeatures().fma) {
+    return MixAvx2;
+  }
+#endif
+  return MixScalar;
+}
+
+}  // namespace
+
+std::size_t ChannelCount(ChannelLayout layout) noexcept { return Speakers(layout).count; }
+
+Speaker SpeakerAt(ChannelLayout layout, std::size_t channel) {
+  const SpeakerList list = Speakers(layout);
+  if (channel >= list.count) {
+    throw std::out_of_range("channel outside the layout");
+  }
+  return list.speakers[channel];
+}
+
+int SpeakerSide(Speaker speaker) noexcept {
+  switch (speaker) {
+    case Speaker::kLeft:
+    case Speaker::kSurroundLeft:
+    case Speaker::kRearLeft:
+      return -1;
+    case Speaker::kRight:
+    case Speaker::kSurroundRight:
+    case Speaker::kRearRight:
+      return 1;
+    case Speaker::kCenter:
+    case Speaker::kLfe:
+      return 0;
+  }
+  return 0;
+}
+
+ChannelMatrix& ChannelMatrix::operator*=(float gain) noexcept {
+  for (float& value : gains) {
+    value *= gain;
+  }
+  return *this;
+}
+
+ChannelMatrix DownmixMatrix(ChannelLayout from, ChannelLayout to) noexcept {
+  ChannelMatrix matrix;
+  matrix.outputs = ChannelCount(to);
+  matrix.inputs = ChannelCount(from);
+  const SpeakerList list = Speakers(from);
+  for (std::size_t input = 0; input < list.count; ++input) {
+    Route(matrix, to, input, list.speakers[input], 1.0f);
+  }
+  return matrix;
+}
+
+ChannelMatrix PanMatrix(ChannelLayout to, float pan) noexcept {
+  ChannelMatrix matrix;
+  matrix.outputs = ChannelCount(to);
+  matrix.inputs = 1;
+  if (to == ChannelLayout::kMono) {
+    matrix(0, 0) = 1.0f;
+    return matrix;
+  }
+  pan = std::clamp(pan, -1.0f, 1.0f);
+  const std::size_t left = IndexOf(to, Speaker::kLeft);
+  const std::size_t right = IndexOf(to, Speaker::kRight);
+  const std::size_t center = IndexOf(to, Speaker::kCenter);
+  if (center >= matrix.outputs) {
+    const PanGains gains = EqualPowerPan(pan);
+    matrix(left, 0) = gains.left;
+    matrix(right, 0) = gains.right;
+  } else if (pan <= 0.0f) {
+    const PanGains gains = EqualPowerPan(2.0f * pan + 1.0f);
+    matrix(left, 0) = gains.left;
+    matrix(center, 0) = gains.right;
+  } else {
+    const PanGains gains = EqualPowerPan(2.0f * pan - 1.0f);
+    matrix(center, 0) = gains.left;
+    matrix(right, 0) = gains.right;
+  }
+  return matrix;
+}
+
+void MixChannels(const ChannelMatrix& matrix, const ConstAudioBufferView& in, const AudioBufferView& out) noexcept {
+  const std::size_t frames = std::min(in.Frames(), out.Frames());
+  const std::size_t inputs = std::min(matrix.inputs, in.Channels());
+  const std::size_t outputs = std::min(matrix.outputs, out.Channels());
+  Term terms[kMaxLayoutChannels * kMaxLayoutChannels];
+  std::size_t count = 0;
+  for (std::size_t o = 0; o < outputs; ++o) {
+    for (std::size_t i = 0; i < inputs; ++i) {
+      if (matrix(o, i) != 0.0f) {
+        terms[count++] = {o, i, matrix(o, i)};
+      }
+    }
+  }
+  if (count == 0 || frames == 0) {
+    return;
+  }
+  if (!in.IsPlanar() || !out.IsPlanar()) {
+    for (std::size_t t = 0; t < count; ++t) {
+      for (std::size_t n = 0; n < frames; ++n) {
+        out(terms[t].output, n) += terms[t].gain * in(terms[t].input, n);
+      }
+    }
+    return;
+  }
+  const float* in_channels[kMaxLayoutChannels] = {};
+  float* out_channels[kMaxLayoutChannels] = {};
+  for (std::size_t i = 0; i < inputs; ++i) {
+    in_channels[i] = &in(i, 0);
+  }
+  for (std::size_t o = 0; o < outputs; ++o) {
+    out_channels[o] = &out(o, 0);
+  }
+  static const MixFn kernel = SelectMix();
+  kernel(terms, count, in_channels, out_channels, frames);
+}
+
+}  // namespace music_create::audio
@@ -0,0 +1,225 @@
+#include "convolver.hpp"
+
+#include "denormals.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace music_create::audio {
+
+namespace {
+
+// Transforms `count` partitions of `partition` samples starting at `ir[offset]`,
+// each zero-padded to twice its size for overlap-save.
+std::vector<std::complex<float>> TransformPartitions(const float* ir, std::size_t length, std::size_t offset,
+                                                     std::size_t partition, std::size_t count) {
+  RealFft fft(partition * 2);
+  std::vector<std::complex<float>> spectra(count * fft.Bins());
+  std::vector<float> padded(partition * 2);
+  for (std::size_t k = 0; k < count; ++k) {
+    std::fill(padded.begin(), padded.end(), 0.0f);
+    const std::size_t begin = offset + k * partition;
+    const std::size_t end = std::min(length, begin + partition);
+    std::copy(ir + begin, ir + end, padded.begin());
+    fft.Forward(padded.data(), spectra.data() + k * fft.Bins());
+  }
+  return spectra;
+}
+
+}  // namespace
+
+ConvolutionIr::ConvolutionIr(const float* ir, std::size_t length, std::size_t block_size)
+    : length_(length), block_size_(block_size) {
+  if (ir == nullptr || length == 0) {
+    throw std::invalid_argument("impulse response is empty");
+  }
+  if (block_size < kMinBlockSize || block_size > kMaxBlockSize || (block_size & (block_size - 1)) != 0) {
+    throw std::invalid_argument("convolution block size must be a power of two in [16, 8192]");
+  }
+  const std::size_t head_span = TailBlockSize() * 2;
+  if (length > head_span) {
+    head_partitions_ = head_span / block_size;
+    tail_partitions_ = (length - head_span + TailBlockSize() - 1) / TailBlockSize();
+    tail_ = TransformPartitions(ir, length, head_span, TailBlockSize(), tail_partitions_);
+  } else {
+    head_partitions_ = (length + block_size - 1) / block_size;
+  }
+  head_ = TransformPartitions(ir, length, 0, block_size, head_partitions_);
+}
+
+PartitionedConvolver::PartitionedConvolver(std::shared_ptr<const ConvolutionIr> ir)
+    : ir_(std::move(ir)), block_size_(ir_ ? ir_->BlockSize() : 0), head_fft_(block_size_ * 2) {
+  input_.resize(block_size_);
+  output_.resize(block_size_);
+  head_window_.resize(block_size_ * 2);
+  head_delay_line_.resize(ir_->HeadPartitions() * head_fft_.Bins());
+  head_sum_.resize(head_fft_.Bins());
+  head_time_.resize(block_size_ * 2);
+  if (ir_->TailPartitions() > 0) {
+    const std::size_t tail_block = ir_->TailBlockSize();
+    tail_fft_ = std::make_unique<RealFft>(tail_block * 2);
+    tail_window_.resize(tail_block * 2);
+    tail_delay_line_.resize(ir_->TailPartitions() * tail_fft_->Bins());
+    tail_sum_.resize(tail_fft_->Bins());
+    tail_time_.resize(tail_block * 2);
+    tail_current_.resize(tail_block);
+    tail_next_.resize(tail_block);
+  }
+}
+
+void PartitionedConvolver::Reset() noexcept {
+  for (auto* buffer : {&input_, &output_, &head_window_, &tail_window_, &tail_current_, &tail_next_}) {
+    std::fill(buffer->begin(), buffer->end(), 0.0f);
+  }
+  std::fill(head_delay_line_.begin(), head_delay_line_.end(), std::complex<float>{});
+  std::fill(tail_delay_line_.begin(), tail_delay_line_.end(), std::complex<float>{});
+  fill_ = 0;
+  block_index_ = 0;
+  head_cursor_ = 0;
+  tail_cursor_ = 0;
+}
+
+void PartitionedConvolver::Process(const float* in, float* out, std::size_t frames) noexcept {
+  std::size_t done = 0;
+  while (done < frames) {
+    const std::size_t chunk = std::min(frames - done, block_size_ - fill_);
+    // Input first: `in` and `out` may be the same buffer.
+    std::copy(in + done, in + done + chunk, input_.begin() + static_cast<std::ptrdiff_t>(fill_));
+    std::copy(output_.begin() + static_cast<std::ptrdiff_t>(fill_),
+              output_.begin() + static_cast<std::ptrdiff_t>(fill_ + chunk), out + done);
+    fill_ += chunk;
+    done += chunk;
+    if (fill_ == block_size_) {
+      ProcessBlock();
+      fill_ = 0;
+    }
+  }
+}
+
+void PartitionedConvolver::ProcessBlock() noexcept {
+  const std::size_t bins = head_fft_.Bins();
+  const std::size_t partitions = ir_->HeadPartitions();
+
+  std::copy(head_window_.begin() + static_cast<std::ptrdiff_t>(block_size_), head_window_.end(),
+            head_window_.begin());
+  std::copy(input_.begin(), input_.end(), head_window_.begin() + static_cast<std::ptrdiff_t>(block_size_));
+  head_cursor_ = (head_cursor_ + 1) % partitions;
+  head_fft_.Forward(head_window_.data(), head_delay_line_.data() + head_cursor_ * bins);
+
+  std::fill(head_sum_.begin(), head_sum_.end(), std::complex<float>{});
+  for (std::size_t k = 0; k < partitions; ++k) {
+    const std::size_t slot = (head_cursor_ + partitions - k) % partitions;
+    ComplexMultiplyAccumulate(head_delay_line_.data() + slot * bins, ir_->HeadSpectrum(k), head_sum_.data(), bins);
+  }
+  head_fft_.Inverse(head_sum_.data(), head_time_.data());
+  std::copy(head_time_.begin() + static_cast<std::ptrdiff_t>(block_size_), head_time_.end(), output_.begin());
+
+  if (tail_fft_) {
+    ProcessTail(block_index_ % ConvolutionIr::kTailRatio);
+  }
+  ++block_index_;
+}
+
+// Tail period p spans head blocks [p * kTailRatio, (p + 1) * kTailRatio). The
+// tail starts 2 * TailBlockSize() into the IR, so the output of period p + 1
+// only needs input up to the end of period p - 1 and is built during period p:
+// phase 0 transforms that input, phases 1..kTailRatio-1 each take a share of
+// the partitions, and the last phase runs the inverse FFT.
+void PartitionedConvolver::ProcessTail(std::size_t phase) noexcept {
+  const std::size_t tail_block = ir_->TailBlockSize();
+  const std::size_t bins = tail_fft_->Bins();
+  const std::size_t partitions = ir_->TailPartitions();
+  constexpr std::size_t kMacPhases = ConvolutionIr::kTailRatio - 1;
+
+  if (phase == 0) {
+    std::swap(tail_current_, tail_next_);
+    tail_cursor_ = (tail_cursor_ + 1) % partitions;
+    tail_fft_->Forward(tail_window_.data(), tail_delay_line_.data() + tail_cursor_ * bins);
+    std::copy(tail_window_.begin() + static_cast<std::ptrdiff_t>(tail_block), tail_window_.end(),
+              tail_window_.begin());
+    std::fill(tail_sum_.begin(), tail_sum_.end(), std::complex<float>{});
+  } else {
+    const std::size_t first = (phase - 1) * partitions / kMacPhases;
+    const std::size_t last = phase * partitions / kMacPhases;
+    for (std::size_t k = first; k < last; ++k) {
+      const std::size_t slot = (tail_cursor_ + partitions - k) % partitions;
+      ComplexMultiplyAccumulate(tail_delay_line_.data() + slot * bins, ir_->TailSpectrum(k), tail_sum_.data(), bins);
+    }
+    if (phase == kMacPhases) {
+      tail_fft_->Inverse(tail_sum_.data(), tail_time_.data());
+      std::copy(tail_time_.begin() + static_cast<std::ptrdiff_t>(tail_block), tail_time_.end(), tail_next_.begin());
+    }
+  }
+
+  const std::size_t offset = phase * block_size_;
+  std::copy(input_.begin(), input_.end(), tail_window_.begin() + static_cast<std::ptrdiff_t>(tail_block + offset));
+  for (std::size_t i = 0; i < block_size_; ++i) {
+    output_[i] += tail_current_[offset + i];
+  }
+}
+
+}  // namespace music_create::audio
+
+struct mc_convolution_ir {
+  std::shared_ptr<const music_create::audio::ConvolutionIr> ir;
+};
+
+struct mc_convolver {
+  explicit mc_convolver(std::shared_ptr<const music_create::audio::ConvolutionIr> ir) : convolver(std::move(ir)) {}
+
+  music_create::audio::PartitionedConvolver convolver;
+};
+
+extern "C" {
+
+mc_convolution_ir* mc_convolution_ir_create(const float* ir, unsigned long long length, unsigned int block_size) {
+  try {
+    return new mc_convolution_ir{std::make_shared<const music_create::audio::ConvolutionIr>(
+        ir, static_cast<std::size_t>(length), block_size)};
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_convolution_ir_free(mc_convolution_ir* ir) { delete ir; }
+
+unsigned long long mc_convolution_ir_length(const mc_convolution_ir* ir) {
+  return ir == nullptr ? 0 : ir->ir->Length();
+}
+
+mc_convolver* mc_convolver_create(const mc_convolution_ir* ir) {
+  if (ir == nullptr) {
+    return nullptr;
+  }
+  try {
+    return new mc_convolver(ir->ir);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_convolver_free(mc_convolver* convolver) { delete convolver; }
+
+unsigned int mc_convolver_latency(const mc_convolver* convolver) {
+  return convolver == nullptr ? 0 : static_cast<unsigned int>(convolver->convolver.Latency());
+}
+
+int mc_convolver_process(mc_convolver* convolver, const float* in, float* out, unsigned long long frames) {
+  if (convolver == nullptr || (frames > 0 && (in == nullptr || out == nullptr))) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  convolver->convolver.Process(in, out, static_cast<std::size_t>(frames));
+  return 1;
+}
+
+int mc_convolver_reset(mc_convolver* convolver) {
+  if (convolver == nullptr) {
+    return 0;
+  }
+  convolver->convolver.Reset();
+  return 1;
+}
+
+}  // extern "C"
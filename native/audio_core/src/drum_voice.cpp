@@ -0,0 +1,141 @@
+#include "drum_voice.hpp"
+
+#include "denormals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr int kKickPitch = 36;
+constexpr int kSnarePitch = 38;
+constexpr int kClosedHatPitch = 42;
+constexpr int kOpenHatPitch = 46;
+
+double DrumSample(DrumShape shape, double t) noexcept {
+  constexpr double kTwoPi = 2.0 * std::numbers::pi;
+  switch (shape) {
+    case DrumShape::kKick: {
+      const double freq = 90.0 - 40.0 * std::min(t / 0.06, 1.0);
+      return std::sin(kTwoPi * freq * t) * std::exp(-t * 24.0);
+    }
+    case DrumShape::kSnare:
+      return std::sin(kTwoPi * 2200.0 * t) * std::sin(kTwoPi * 3200.0 * t) * std::exp(-t * 36.0);
+    case DrumShape::kClosedHat:
+      return std::sin(kTwoPi * 6200.0 * t) * std::sin(kTwoPi * 7100.0 * t) * std::exp(-t * 70.0);
+    case DrumShape::kOpenHat:
+      return std::sin(kTwoPi * 6200.0 * t) * std::sin(kTwoPi * 7100.0 * t) * std::exp(-t * 24.0);
+    default:
+      return std::sin(kTwoPi * 1400.0 * t) * std::exp(-t * 28.0);
+  }
+}
+
+}  // namespace
+
+DrumShape DrumShapeForPitch(int pitch) noexcept {
+  switch (pitch) {
+    case kKickPitch:
+      return DrumShape::kKick;
+    case kSnarePitch:
+      return DrumShape::kSnare;
+    case kClosedHatPitch:
+      return DrumShape::kClosedHat;
+    case kOpenHatPitch:
+      return DrumShape::kOpenHat;
+    default:
+      return DrumShape::kPercussion;
+  }
+}
+
+DrumOneShotCache::DrumOneShotCache(std::uint32_t sample_rate) : sample_rate_(sample_rate) {
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample_rate must be positive");
+  }
+}
+
+const float* DrumOneShotCache::Shape(DrumShape shape, std::size_t length) {
+  std::vector<float>& samples = shapes_[static_cast<std::size_t>(shape)];
+  if (samples.size() < length) {
+    const std::size_t first = samples.size();
+    samples.resize((length + kLengthBucket - 1) / kLengthBucket * kLengthBucket);
+    for (std::size_t i = first; i < samples.size(); ++i) {
+      samples[i] = static_cast<float>(DrumSample(shape, static_cast<double>(i) / sample_rate_));
+    }
+  }
+  return samples.data();
+}
+
+std::size_t DrumOneShotCache::CachedSamples() const noexcept {
+  std::size_t total = 0;
+  for (const auto& samples : shapes_) {
+    total += samples.size();
+  }
+  return total;
+}
+
+void DrumOneShotCache::MixHits(const DrumHit* hits, std::size_t count, float* out, std::size_t frames) {
+  for (std::size_t n = 0; n < count; ++n) {
+    const DrumHit& hit = hits[n];
+    if (hit.start_sample < 0 || hit.start_sample >= static_cast<std::int64_t>(frames) || hit.length_samples <= 0) {
+      continue;
+    }
+    const auto length = static_cast<std::size_t>(
+        std::min<std::int64_t>(hit.length_samples, static_cast<std::int64_t>(frames) - hit.start_sample));
+    const float* shape = Shape(DrumShapeForPitch(hit.pitch), length);
+    float* dst = out + hit.start_sample;
+    const float gain = hit.amplitude;
+    for (std::size_t i = 0; i < length; ++i) {
+      dst[i] += shape[i] * gain;
+    }
+  }
+}
+
+}  // namespace music_create::audio
+
+struct mc_drum_cache {
+  explicit mc_drum_cache(std::uint32_t sample_rate) : cache(sample_rate) {}
+  music_create::audio::DrumOneShotCache cache;
+};
+
+extern "C" {
+
+mc_drum_cache* mc_drum_cache_create(unsigned int sample_rate) {
+  try {
+    return new mc_drum_cache(sample_rate);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_drum_cache_free(mc_drum_cache* cache) { delete cache; }
+
+unsigned long long mc_drum_cache_samples(const mc_drum_cache* cache) {
+  return cache == nullptr ? 0 : cache->cache.CachedSamples();
+}
+
+int mc_drum_cache_render_hits(mc_drum_cache* cache, unsigned long long count, const long long* start_sample,
+                              const long long* length_samples, const int* pitch, const float* amplitude, float* out,
+                              unsigned long long frames) {
+  if (cache == nullptr || out == nullptr ||
+      (count > 0 &&
+       (start_sample == nullptr || length_samples == nullptr || pitch == nullptr || amplitude == nullptr))) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  try {
+    std::vector<music_create::audio::DrumHit> hits(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < hits.size(); ++i) {
+      hits[i] = {start_sample[i], length_samples[i], pitch[i], amplitude[i]};
+    }
+    cache->cache.MixHits(hits.data(), hits.size(), out, static_cast<std::size_t>(frames));
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
@@ -0,0 +1,68 @@
+#include "dynamics.hpp"
+
+#include "denormals.hpp"
+#include "fast_math.hpp"
+#include "param_tables.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace music_create::audio {
+
+float TimeCoefficient(float time_ms, std::uint32_t sample_rate) noexcept {
+  if (time_ms <= 0.0f || sample_rate == 0) {
+    return 0.0f;
+  }
+  return OnePoleCoefficient(time_ms * 0.001f * static_cast<float>(sample_rate));
+}
+
+float DbToGain(float db) noexcept { return std::pow(10.0f, db / 20.0f); }
+
+Compressor::Compressor(std::uint32_t sample_rate, const CompressorParams& params)
+    : threshold_db_(params.threshold_db),
+      threshold_(DbToGain(params.threshold_db)),
+      inverse_ratio_(1.0f / std::max(params.ratio, 1.0f)),
+      attack_(TimeCoefficient(std::max(params.attack_ms, 0.1f), sample_rate)),
+      release_(TimeCoefficient(std::max(params.release_ms, 0.1f), sample_rate)),
+      makeup_(DbToGain(params.makeup_db)) {}
+
+void Compressor::Process(float* left, float* right, const float* key_left, const float* key_right,
+                         std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n) {
+    const float level = std::max(std::abs(key_left[n]), std::abs(key_right[n])) + 1e-12f;
+    const float coeff = level > envelope_ ? attack_ : release_;
+    envelope_ = coeff * envelope_ + (1.0f - coeff) * level;
+
+    float gain = makeup_;
+    if (envelope_ > threshold_ && threshold_ > 0.0f) {
+      // Runs per sample while compressing; the fast forms are accurate to
+      // well under 0.001 dB.
+      const float over_db = std::max(0.0f, FastGainToDb(envelope_) - threshold_db_);
+      gain *= FastDbToGain(-over_db * (1.0f - inverse_ratio_));
+    }
+    left[n] *= gain;
+    right[n] *= gain;
+  }
+}
+
+Gate::Gate(std::uint32_t sample_rate, const GateParams& params)
+    : threshold_(DbToGain(params.threshold_db)),
+      attack_(TimeCoefficient(std::max(params.attack_ms, 0.1f), sample_rate)),
+      release_(TimeCoefficient(std::max(params.release_ms, 0.1f), sample_rate)) {}
+
+void Gate::Process(float* left, float* right, const float* key_left, const float* key_right,
+                   std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n) {
+    const float level = std::max(std::abs(key_left[n]), std::abs(key_right[n]));
+    const float coeff = level > envelope_ ? attack_ : release_;
+    envelope_ = FlushDenormal(coeff * envelope_ + (1.0f - coeff) * level);
+
+    const float target = envelope_ >= threshold_ ? 1.0f : 0.0f;
+    const float smooth = target > gain_ ? attack_ : release_;
+    gain_ = FlushDenormal(smooth * gain_ + (1.0f - smooth) * target);
+    left[n] *= gain_;
+    right[n] *= gain_;
+  }
+}
+
+}  // namespace music_create::audio
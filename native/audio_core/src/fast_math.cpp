@@ -0,0 +1,145 @@
+#include "fast_math.hpp"
+
+#include "cpu_features.hpp"
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+using namespace fast_math_detail;
+
+template <float (*Fn)(float)>
+void ScalarBlock(const float* in, float* out, std::size_t count) noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = Fn(in[i]);
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+
+// Lane-wise ports of the scalar forms in fast_math.hpp.
+
+template <std::size_t N>
+MC_AUDIO_TARGET("avx2,fma")
+__m256 Horner(__m256 x, const float (&coefficients)[N]) noexcept {
+  __m256 acc = _mm256_set1_ps(coefficients[N - 1]);
+  for (std::size_t i = N - 1; i-- > 0;) {
+    acc = _mm256_fmadd_ps(acc, x, _mm256_set1_ps(coefficients[i]));
+  }
+  return acc;
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+__m256 Exp2Vec(__m256 x) noexcept {
+  const __m256 clamped = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.0f)), _mm256_set1_ps(127.0f));
+  const __m256 whole = _mm256_round_ps(clamped, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  const __m256i biased = _mm256_add_epi32(_mm256_cvtps_epi32(whole), _mm256_set1_epi32(127));
+  const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23));
+  return _mm256_mul_ps(Horner(_mm256_sub_ps(clamped, whole), kExp2Coefficients), scale);
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+__m256 Log2Vec(__m256 x) noexcept {
+  const __m256i bits = _mm256_castps_si256(x);
+  __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+  __m256 mantissa = _mm256_castsi256_ps(
+      _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000)));
+  const __m256 high = _mm256_cmp_ps(mantissa, _mm256_set1_ps(kSqrt2), _CMP_GT_OQ);
+  mantissa = _mm256_blendv_ps(mantissa, _mm256_mul_ps(mantissa, _mm256_set1_ps(0.5f)), high);
+  exponent = _mm256_add_ps(exponent, _mm256_and_ps(high, _mm256_set1_ps(1.0f)));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 t = _mm256_div_ps(_mm256_sub_ps(mantissa, one), _mm256_add_ps(mantissa, one));
+  return _mm256_fmadd_ps(t, Horner(_mm256_mul_ps(t, t), kLog2Coefficients), exponent);
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+__m256 TanhVec(__m256 x) noexcept {
+  const __m256 clamped = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-9.0f)), _mm256_set1_ps(9.0f));
+  const __m256 e = Exp2Vec(_mm256_mul_ps(clamped, _mm256_set1_ps(kTwoOverLn2)));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  return _mm256_div_ps(_mm256_sub_ps(e, one), _mm256_add_ps(e, one));
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+__m256 SinVec(__m256 x) noexcept {
+  const __m256 turns =
+      _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kInvTwoPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_fnmadd_ps(turns, _mm256_set1_ps(kTwoPiHigh), x);
+  r = _mm256_fnmadd_ps(turns, _mm256_set1_ps(kTwoPiLow), r);
+  const __m256 pi = _mm256_set1_ps(kPi);
+  const __m256 half_pi = _mm256_set1_ps(kHalfPi);
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(pi, r), _mm256_cmp_ps(r, half_pi, _CMP_GT_OQ));
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_setzero_ps(), _mm256_add_ps(pi, r)),
+                       _mm256_cmp_ps(r, _mm256_sub_ps(_mm256_setzero_ps(), half_pi), _CMP_LT_OQ));
+  return _mm256_mul_ps(r, Horner(_mm256_mul_ps(r, r), kSinCoefficients));
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+__m256 GainToDbVec(__m256 x) noexcept {
+  return _mm256_mul_ps(Log2Vec(_mm256_max_ps(x, _mm256_set1_ps(kMinGain))), _mm256_set1_ps(kDbPerLog2));
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+__m256 DbToGainVec(__m256 x) noexcept { return Exp2Vec(_mm256_mul_ps(x, _mm256_set1_ps(kLog2OfTenOver20))); }
+
+template <__m256 (*Vec)(__m256), float (*Fn)(float)>
+MC_AUDIO_TARGET("avx2,fma")
+void Avx2Block(const float* in, float* out, std::size_t count) noexcept {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_ps(out + i, Vec(_mm256_loadu_ps(in + i)));
+  }
+  ScalarBlock<Fn>(in + i, out + i, count - i);
+}
+
+#endif
+
+using BlockFn = void (*)(const float*, float*, std::size_t) noexcept;
+
+#if MC_AUDIO_X86_DISPATCH
+#define MC_FAST_MATH_SELECT(vec, fn) \
+  (DetectCpuFeatures().avx2 && DetectCpuFeatures().fma ? Avx2Block<vec, fn> : ScalarBlock<fn>)
+#else
+#define MC_FAST_MATH_SELECT(vec, fn) ScalarBlock<fn>
+#endif
+
+}  // namespace
+
+// Each kernel is picked once, on first use.
+void FastLog2Block(const float* in, float* out, std::size_t count) noexcept {
+  static const BlockFn kernel = MC_FAST_MATH_SELECT(Log2Vec, FastLog2);
+  kernel(in, out, count);
+}
+
+void FastExp2Block(const float* in, float* out, std::size_t count) noexcept {
+  static const BlockFn kernel = MC_FAST_MATH_SELECT(Exp2Vec, FastExp2);
+  kernel(in, out, count);
+}
+
+void FastGainToDbBlock(const float* in, float* out, std::size_t count) noexcept {
+  static const BlockFn kernel = MC_FAST_MATH_SELECT(GainToDbVec, FastGainToDb);
+  kernel(in, out, count);
+}
+
+void FastDbToGainBlock(const float* in, float* out, std::size_t count) noexcept {
+  static const BlockFn kernel = MC_FAST_MATH_SELECT(DbToGainVec, FastDbToGain);
+  kernel(in, out, count);
+}
+
+void FastTanhBlock(const float* in, float* out, std::size_t count) noexcept {
+  static const BlockFn kernel = MC_FAST_MATH_SELECT(TanhVec, FastTanh);
+  kernel(in, out, count);
+}
+
+void FastSinBlock(const float* in, float* out, std::size_t count) noexcept {
+  static const BlockFn kernel = MC_FAST_MATH_SELECT(SinVec, FastSin);
+  kernel(in, out, count);
+}
+
+#undef MC_FAST_MATH_SELECT
+
+}  // namespace music_create::audio
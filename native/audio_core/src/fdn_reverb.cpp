@@ -0,0 +1,231 @@
+#include "fdn_reverb.hpp"
+
+#include "cpu_features.hpp"
+#include "denormals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr std::size_t kLines = FdnReverb::kLines;
+// Mutually prime line lengths at 48 kHz and size 1 (30-58 ms).
+constexpr std::array<double, kLines> kBaseLengths = {1433, 1601, 1867, 2053, 2251, 2399, 2617, 2801};
+constexpr std::array<float, kLines> kInputGains = {0.5f, -0.5f, 0.5f, -0.5f, 0.5f, -0.5f, 0.5f, -0.5f};
+constexpr std::array<float, kLines> kOutputGains = {0.35f, 0.35f, -0.35f, -0.35f, 0.35f, -0.35f, -0.35f, 0.35f};
+constexpr float kHadamardNorm = 0.35355339f;  // 1 / sqrt(8)
+constexpr float kMaxDamping = 0.7f;
+constexpr std::size_t kMinLineLength = 8;
+
+std::uint32_t RingSize(std::size_t frames) {
+  std::uint32_t size = 1;
+  while (size < frames) {
+    size <<= 1;
+  }
+  return size;
+}
+
+template <typename State>
+void ProcessScalar(State& s, const float* in, float* out, std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n) {
+    const float dry = in[n];
+    s.pre_delay[s.pre_write & s.pre_mask] = dry;
+    const float pre = s.pre_delay[(s.pre_write - s.pre_length) & s.pre_mask];
+    ++s.pre_write;
+
+    float taps[kLines];
+    float mixed[kLines];
+    float wet = 0.0f;
+    for (std::size_t i = 0; i < kLines; ++i) {
+      taps[i] = s.lines[((s.write - static_cast<std::uint32_t>(s.length[i])) & s.line_mask) * kLines + i];
+      s.lowpass[i] = FlushDenormal(taps[i] + s.damping * (s.lowpass[i] - taps[i]));
+      mixed[i] = s.lowpass[i] * s.gain[i];
+      wet += taps[i] * kOutputGains[i];
+    }
+    for (std::size_t span = 1; span < kLines; span *= 2) {
+      for (std::size_t i = 0; i < kLines; ++i) {
+        if ((i & span) == 0) {
+          const float a = mixed[i];
+          const float b = mixed[i + span];
+          mixed[i] = a + b;
+          mixed[i + span] = a - b;
+        }
+      }
+    }
+    float* frame = s.lines + (s.write & s.line_mask) * kLines;
+    for (std::size_t i = 0; i < kLines; ++i) {
+      frame[i] = FlushDenormal(mixed[i] * kHadamardNorm + pre * kInputGains[i]);
+    }
+    ++s.write;
+    out[n] = dry + s.mix * (wet - dry);
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+
+template <typename State>
+MC_AUDIO_TARGET("avx2,fma")
+void ProcessAvx2(State& s, const float* in, float* out, std::size_t frames) noexcept {
+  const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256i length = _mm256_load_si256(reinterpret_cast<const __m256i*>(s.length.data()));
+  const __m256i mask = _mm256_set1_epi32(static_cast<int>(s.line_mask));
+  const __m256 gain = _mm256_load_ps(s.gain.data());
+  const __m256 damping = _mm256_set1_ps(s.damping);
+  const __m256 input_gains = _mm256_loadu_ps(kInputGains.data());
+  const __m256 output_gains = _mm256_loadu_ps(kOutputGains.data());
+  const __m256 norm = _mm256_set1_ps(kHadamardNorm);
+  // Butterfly signs: +1 where the lane index has the span bit clear.
+  const __m256 sign1 = _mm256_setr_ps(1, -1, 1, -1, 1, -1, 1, -1);
+  const __m256 sign2 = _mm256_setr_ps(1, 1, -1, -1, 1, 1, -1, -1);
+  const __m256 sign4 = _mm256_setr_ps(1, 1, 1, 1, -1, -1, -1, -1);
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 floor = _mm256_set1_ps(kDenormalFloor);
+  __m256 lowpass = _mm256_load_ps(s.lowpass.data());
+
+  for (std::size_t n = 0; n < frames; ++n) {
+    const float dry = in[n];
+    s.pre_delay[s.pre_write & s.pre_mask] = dry;
+    const float pre = s.pre_delay[(s.pre_write - s.pre_length) & s.pre_mask];
+    ++s.pre_write;
+
+    const __m256i write = _mm256_set1_epi32(static_cast<int>(s.write));
+    const __m256i index =
+        _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_sub_epi32(write, length), mask), 3), lane);
+    const __m256 taps = _mm256_i32gather_ps(s.lines, index, 4);
+    lowpass = _mm256_fmadd_ps(damping, _mm256_sub_ps(lowpass, taps), taps);
+    lowpass = _mm256_and_ps(lowpass, _mm256_cmp_ps(_mm256_and_ps(lowpass, abs_mask), floor, _CMP_GE_OQ));
+    __m256 mixed = _mm256_mul_ps(lowpass, gain);
+    mixed = _mm256_fmadd_ps(mixed, sign1, _mm256_permute_ps(mixed, 0xB1));
+    mixed = _mm256_fmadd_ps(mixed, sign2, _mm256_permute_ps(mixed, 0x4E));
+    mixed = _mm256_fmadd_ps(mixed, sign4, _mm256_permute2f128_ps(mixed, mixed, 1));
+    __m256 frame = _mm256_fmadd_ps(_mm256_set1_ps(pre), input_gains, _mm256_mul_ps(mixed, norm));
+    frame = _mm256_and_ps(frame, _mm256_cmp_ps(_mm256_and_ps(frame, abs_mask), floor, _CMP_GE_OQ));
+    _mm256_storeu_ps(s.lines + (s.write & s.line_mask) * kLines, frame);
+    ++s.write;
+
+    const __m256 weighted = _mm256_mul_ps(taps, output_gains);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(weighted), _mm256_extractf128_ps(weighted, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    const float wet = _mm_cvtss_f32(sum);
+    out[n] = dry + s.mix * (wet - dry);
+  }
+  _mm256_store_ps(s.lowpass.data(), lowpass);
+}
+
+#endif
+
+}  // namespace
+
+FdnReverb::FdnReverb(std::uint32_t sample_rate) : sample_rate_(sample_rate) {
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample rate must be positive");
+  }
+  const double scale = static_cast<double>(sample_rate) / 48000.0;
+  const auto longest = static_cast<std::size_t>(std::lround(kBaseLengths.back() * scale));
+  const std::uint32_t line_frames = RingSize(std::max(longest, kMinLineLength) + 1);
+  const std::uint32_t pre_frames =
+      RingSize(static_cast<std::size_t>(std::ceil(kMaxPreDelayMs * 0.001 * sample_rate)) + 1);
+  lines_.assign(static_cast<std::size_t>(line_frames) * kLines, 0.0f);
+  pre_delay_.assign(pre_frames, 0.0f);
+  state_.lines = lines_.data();
+  state_.line_mask = line_frames - 1;
+  state_.pre_delay = pre_delay_.data();
+  state_.pre_mask = pre_frames - 1;
+  SetParams(params_);
+}
+
+void FdnReverb::SetParams(const FdnReverbParams& params) noexcept {
+  params_ = params;
+  params_.mix = std::clamp(params.mix, 0.0f, 1.0f);
+  params_.decay_seconds = std::clamp(params.decay_seconds, 0.05f, 30.0f);
+  params_.pre_delay_ms = std::clamp(params.pre_delay_ms, 0.0f, kMaxPreDelayMs);
+  params_.damping = std::clamp(params.damping, 0.0f, 1.0f);
+  params_.size = std::clamp(params.size, 0.05f, 1.0f);
+
+  const double scale = params_.size * static_cast<double>(sample_rate_) / 48000.0;
+  for (std::size_t i = 0; i < kLines; ++i) {
+    const auto length = std::max<long>(std::lround(kBaseLengths[i] * scale), static_cast<long>(kMinLineLength));
+    state_.length[i] = static_cast<std::int32_t>(length);
+    // Per-line loss so every line decays by 60 dB in decay_seconds.
+    state_.gain[i] = static_cast<float>(
+        std::pow(10.0, -3.0 * static_cast<double>(length) / (params_.decay_seconds * sample_rate_)));
+  }
+  state_.damping = params_.damping * kMaxDamping;
+  state_.pre_length = static_cast<std::uint32_t>(std::lround(params_.pre_delay_ms * 0.001 * sample_rate_));
+  state_.mix = params_.mix;
+}
+
+void FdnReverb::Process(const float* in, float* out, std::size_t frames) noexcept {
+#if MC_AUDIO_X86_DISPATCH
+  static const bool use_avx2 = DetectCpuFeatures().avx2 && DetectCpuFeatures().fma;
+  if (use_avx2) {
+    ProcessAvx2(state_, in, out, frames);
+    return;
+  }
+#endif
+  ProcessScalar(state_, in, out, frames);
+}
+
+void FdnReverb::Reset() noexcept {
+  std::fill(lines_.begin(), lines_.end(), 0.0f);
+  std::fill(pre_delay_.begin(), pre_delay_.end(), 0.0f);
+  state_.lowpass.fill(0.0f);
+  state_.write = 0;
+  state_.pre_write = 0;
+}
+
+}  // namespace music_create::audio
+
+struct mc_fdn_reverb {
+  explicit mc_fdn_reverb(std::uint32_t sample_rate) : reverb(sample_rate) {}
+
+  music_create::audio::FdnReverb reverb;
+};
+
+extern "C" {
+
+mc_fdn_reverb* mc_fdn_reverb_create(unsigned int sample_rate) {
+  try {
+    return new mc_fdn_reverb(sample_rate);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_fdn_reverb_free(mc_fdn_reverb* reverb) { delete reverb; }
+
+int mc_fdn_reverb_set_params(mc_fdn_reverb* reverb, float mix, float decay_seconds, float pre_delay_ms, float damping,
+                             float size) {
+  if (reverb == nullptr) {
+    return 0;
+  }
+  reverb->reverb.SetParams({mix, decay_seconds, pre_delay_ms, damping, size});
+  return 1;
+}
+
+int mc_fdn_reverb_process(mc_fdn_reverb* reverb, const float* in, float* out, unsigned long long frames) {
+  if (reverb == nullptr || (frames > 0 && (in == nullptr || out == nullptr))) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  reverb->reverb.Process(in, out, static_cast<std::size_t>(frames));
+  return 1;
+}
+
+int mc_fdn_reverb_reset(mc_fdn_reverb* reverb) {
+  if (reverb == nullptr) {
+    return 0;
+  }
+  reverb->reverb.Reset();
+  return 1;
+}
+
+}  // extern "C"
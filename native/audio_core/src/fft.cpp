@@ -0,0 +1,177 @@
+#include "fft.hpp"
+
+#include "cpu_features.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+std::complex<float> Twiddle(std::size_t k, std::size_t n) {
+  const double angle = -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(n);
+  return {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+}
+
+void MultiplyAccumulateScalar(const std::complex<float>* a, const std::complex<float>* b, std::complex<float>* acc,
+                              std::size_t count) noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    const float re = a[i].real() * b[i].real() - a[i].imag() * b[i].imag();
+    const float im = a[i].real() * b[i].imag() + a[i].imag() * b[i].real();
+    acc[i] = {acc[i].real() + re, acc[i].imag() + im};
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+
+MC_AUDIO_TARGET("sse4.1")
+void MultiplyAccumulateSse41(const std::complex<float>* a, const std::complex<float>* b, std::complex<float>* acc,
+                             std::size_t count) noexcept {
+  auto* pa = reinterpret_cast<const float*>(a);
+  auto* pb = reinterpret_cast<const float*>(b);
+  auto* pacc = reinterpret_cast<float*>(acc);
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m128 va = _mm_loadu_ps(pa + i * 2);
+    const __m128 vb = _mm_loadu_ps(pb + i * 2);
+    const __m128 cross = _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 3, 0, 1)), _mm_movehdup_ps(vb));
+    const __m128 product = _mm_addsub_ps(_mm_mul_ps(va, _mm_moveldup_ps(vb)), cross);
+    _mm_storeu_ps(pacc + i * 2, _mm_add_ps(_mm_loadu_ps(pacc + i * 2), product));
+  }
+  MultiplyAccumulateScalar(a + i, b + i, acc + i, count - i);
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+void MultiplyAccumulateAvx2(const std::complex<float>* a, const std::complex<float>* b, std::complex<float>* acc,
+                            std::size_t count) noexcept {
+  auto* pa = reinterpret_cast<const float*>(a);
+  auto* pb = reinterpret_cast<const float*>(b);
+  auto* pacc = reinterpret_cast<float*>(acc);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256 va = _mm256_loadu_ps(pa + i * 2);
+    const __m256 vb = _mm256_loadu_ps(pb + i * 2);
+    const __m256 cross = _mm256_mul_ps(_mm256_permute_ps(va, 0xB1), _mm256_movehdup_ps(vb));
+    const __m256 product = _mm256_fmaddsub_ps(va, _mm256_moveldup_ps(vb), cross);
+    _mm256_storeu_ps(pacc + i * 2, _mm256_add_ps(_mm256_loadu_ps(pacc + i * 2), product));
+  }
+  MultiplyAccumulateScalar(a + i, b + i, acc + i, count - i);
+}
+
+#endif
+
+using MultiplyAccumulateFn = void (*)(const std::complex<float>*, const std::complex<float>*, std::complex<float>*,
+                                      std::size_t) noexcept;
+
+MultiplyAccumulateFn SelectMultiplyAccumulate() noexcept {
+#if MC_AUDIO_X86_DISPATCH
+  const CpuFeatures& cpu = DetectCpuFeatures();
+  if (cpu.avx2 && cpu.fma) {
+    return MultiplyAccumulateAvx2;
+  }
+  if (cpu.sse41) {
+    return MultiplyAccumulateSse41;
+  }
+#endif
+  return MultiplyAccumulateScalar;
+}
+
+}  // namespace
+
+RealFft::RealFft(std::size_t size) : size_(size) {
+  if (size < 4 || (size & (size - 1)) != 0) {
+    throw std::invalid_argument("fft size must be a power of two >= 4");
+  }
+  const std::size_t half = size / 2;
+  int bits = 0;
+  while ((std::size_t{1} << bits) < half) {
+    ++bits;
+  }
+  bit_reverse_.resize(half);
+  for (std::size_t i = 0; i < half; ++i) {
+    std::uint32_t reversed = 0;
+    for (int bit = 0; bit < bits; ++bit) {
+      reversed |= ((i >> bit) & 1u) << (bits - 1 - bit);
+    }
+    bit_reverse_[i] = reversed;
+  }
+  twiddles_.resize(half / 2);
+  for (std::size_t k = 0; k < twiddles_.size(); ++k) {
+    twiddles_[k] = Twiddle(k, half);
+  }
+  real_twiddles_.resize(half + 1);
+  for (std::size_t k = 0; k <= half; ++k) {
+    real_twiddles_[k] = Twiddle(k, size);
+  }
+  scratch_.resize(half);
+}
+
+void RealFft::Transform(std::complex<float>* data, bool inverse) const noexcept {
+  const std::size_t n = size_ / 2;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (i < bit_reverse_[i]) {
+      std::swap(data[i], data[bit_reverse_[i]]);
+    }
+  }
+  for (std::size_t length = 2; length <= n; length *= 2) {
+    const std::size_t half = length / 2;
+    const std::size_t stride = n / length;
+    for (std::size_t start = 0; start < n; start += length) {
+      for (std::size_t j = 0; j < half; ++j) {
+        const std::complex<float> w = inverse ? std::conj(twiddles_[j * stride]) : twiddles_[j * stride];
+        const std::complex<float> even = data[start + j];
+        const std::complex<float> odd = data[start + j + half] * w;
+        data[start + j] = even + odd;
+        data[start + j + half] = even - odd;
+      }
+    }
+  }
+}
+
+void RealFft::Forward(const float* in, std::complex<float>* out) noexcept {
+  const std::size_t half = size_ / 2;
+  for (std::size_t i = 0; i < half; ++i) {
+    scratch_[i] = {in[i * 2], in[i * 2 + 1]};
+  }
+  Transform(scratch_.data(), false);
+  // Split the packed even/odd spectra and combine them with the size-N twiddles.
+  for (std::size_t k = 0; k <= half; ++k) {
+    const std::complex<float> z = scratch_[k % half];
+    const std::complex<float> mirror = std::conj(scratch_[(half - k) % half]);
+    const std::complex<float> even = 0.5f * (z + mirror);
+    const std::complex<float> diff = z - mirror;
+    const std::complex<float> odd{0.5f * diff.imag(), -0.5f * diff.real()};
+    out[k] = even + real_twiddles_[k] * odd;
+  }
+}
+
+void RealFft::Inverse(const std::complex<float>* in, float* out) noexcept {
+  const std::size_t half = size_ / 2;
+  for (std::size_t k = 0; k < half; ++k) {
+    const std::complex<float> mirror = std::conj(in[half - k]);
+    const std::complex<float> even = 0.5f * (in[k] + mirror);
+    const std::complex<float> odd = 0.5f * (in[k] - mirror) * std::conj(real_twiddles_[k]);
+    scratch_[k] = {even.real() - odd.imag(), even.imag() + odd.real()};
+  }
+  Transform(scratch_.data(), true);
+  const float scale = 1.0f / static_cast<float>(half);
+  for (std::size_t i = 0; i < half; ++i) {
+    out[i * 2] = scratch_[i].real() * scale;
+    out[i * 2 + 1] = scratch_[i].imag() * scale;
+  }
+}
+
+void ComplexMultiplyAccumulate(const std::complex<float>* a, const std::complex<float>* b, std::complex<float>* acc,
+                               std::size_t count) noexcept {
+  static const MultiplyAccumulateFn kernel = SelectMultiplyAccumulate();
+  kernel(a, b, acc, count);
+}
+
+}  // namespace music_create::audio
@@ -0,0 +1,750 @@
+#include "flac_decoder.hpp"
+
+#include "cpu_features.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr std::size_t kLpcGuard = 32;
+constexpr std::size_t kWindowChunk = 1 << 16;
+constexpr std::uint64_t kMaxLinearSeekBlocks = 16;
+
+constexpr std::array<std::uint8_t, 256> MakeCrc8Table() {
+  std::array<std::uint8_t, 256> table{};
+  for (unsigned i = 0; i < 256; ++i) {
+    unsigned crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+    }
+    table[i] = static_cast<std::uint8_t>(crc & 0xFF);
+  }
+  return table;
+}
+
+constexpr std::array<std::uint16_t, 256> MakeCrc16Table() {
+  std::array<std::uint16_t, 256> table{};
+  for (unsigned i = 0; i < 256; ++i) {
+    unsigned crc = i << 8;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x8005) : (crc << 1);
+    }
+    table[i] = static_cast<std::uint16_t>(crc & 0xFFFF);
+  }
+  return table;
+}
+
+constexpr auto kCrc8Table = MakeCrc8Table();
+constexpr auto kCrc16Table = MakeCrc16Table();
+
+std::uint8_t Crc8(const std::uint8_t* data, std::size_t size) {
+  std::uint8_t crc = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = kCrc8Table[crc ^ data[i]];
+  }
+  return crc;
+}
+
+std::uint16_t Crc16(const std::uint8_t* data, std::size_t size) {
+  std::uint16_t crc = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = static_cast<std::uint16_t>((crc << 8) ^ kCrc16Table[(crc >> 8) ^ data[i]]);
+  }
+  return crc;
+}
+
+std::uint32_t ReadBigEndian(const std::uint8_t* data, int bytes) {
+  std::uint32_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+class BitReader {
+ public:
+  BitReader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) { Refill(); }
+
+  std::uint32_t ReadBits(unsigned count) {
+    if (count == 0) {
+      return 0;
+    }
+    if (cache_bits_ < count) {
+      Refill();
+    }
+    const auto value = static_cast<std::uint32_t>(cache_ >> (64 - count));
+    cache_ <<= count;
+    cache_bits_ -= count;
+    return value;
+  }
+
+  std::int32_t ReadSigned(unsigned count) {
+    if (count == 0) {
+      return 0;
+    }
+    const std::uint32_t raw = ReadBits(count);
+    const std::uint32_t sign = 1u << (count - 1);
+    return static_cast<std::int32_t>((raw ^ sign) - sign);
+  }
+
+  std::uint32_t ReadUnary() {
+    std::uint32_t zeros = 0;
+    while (cache_ == 0) {
+      zeros += cache_bits_;
+      cache_bits_ = 0;
+      if (Overrun()) {
+        return zeros;
+      }
+      Refill();
+    }
+    const auto leading = static_cast<unsigned>(std::countl_zero(cache_));
+    zeros += leading;
+    cache_ <<= leading;
+    cache_ <<= 1;
+    cache_bits_ -= leading + 1;
+    return zeros;
+  }
+
+  std::int32_t ReadRice(unsigned parameter) {
+    const std::uint32_t quotient = ReadUnary();
+    const std::uint32_t folded = (quotient << parameter) | ReadBits(parameter);
+    return static_cast<std::int32_t>(folded >> 1) ^ -static_cast<std::int32_t>(folded & 1);
+  }
+
+  void AlignToByte() { ReadBits(cache_bits_ % 8); }
+
+  std::size_t BytePosition() const noexcept { return pos_ - (cache_bits_ / 8); }
+
+  bool Overrun() const noexcept { return pos_ * 8 - cache_bits_ > size_ * 8 || pos_ > size_ + 16; }
+
+ private:
+  void Refill() {
+    while (cache_bits_ <= 56) {
+      const std::uint64_t byte = pos_ < size_ ? data_[pos_] : 0;
+      cache_ |= byte << (56 - cache_bits_);
+      cache_bits_ += 8;
+      ++pos_;
+    }
+  }
+
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+  std::uint64_t cache_ = 0;
+  unsigned cache_bits_ = 0;
+};
+
+bool DecodeResidual(BitReader& bits, std::uint32_t block_size, std::uint32_t order, std::int32_t* residual) {
+  const std::uint32_t method = bits.ReadBits(2);
+  if (method > 1) {
+    return false;
+  }
+  const unsigned param_bits = method == 0 ? 4 : 5;
+  const std::uint32_t escape = method == 0 ? 15 : 31;
+  const std::uint32_t partition_order = bits.ReadBits(4);
+  const std::uint32_t partitions = 1u << partition_order;
+  const std::uint32_t partition_size = block_size >> partition_order;
+  if ((partition_size << partition_order) != block_size || partition_size < order) {
+    return false;
+  }
+
+  std::uint32_t out = 0;
+  for (std::uint32_t partition = 0; partition < partitions; ++partition) {
+    const std::uint32_t count = partition == 0 ? partition_size - order : partition_size;
+    const std::uint32_t parameter = bits.ReadBits(param_bits);
+    if (parameter == escape) {
+      const unsigned raw_bits = bits.ReadBits(5);
+      for (std::uint32_t i = 0; i < count; ++i) {
+        residual[out++] = bits.ReadSigned(raw_bits);
+      }
+    } else {
+      for (std::uint32_t i = 0; i < count; ++i) {
+        residual[out++] = bits.ReadRice(parameter);
+      }
+    }
+    if (bits.Overrun()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RestoreFixed(std::int32_t* data, std::uint32_t block_size, std::uint32_t order) {
+  switch (order) {
+    case 1:
+      for (std::uint32_t i = 1; i < block_size; ++i) {
+        data[i] += data[i - 1];
+      }
+      break;
+    case 2:
+      for (std::uint32_t i = 2; i < block_size; ++i) {
+        data[i] += 2 * data[i - 1] - data[i - 2];
+      }
+      break;
+    case 3:
+      for (std::uint32_t i = 3; i < block_size; ++i) {
+        data[i] += 3 * data[i - 1] - 3 * data[i - 2] + data[i - 3];
+      }
+      break;
+    case 4:
+      for (std::uint32_t i = 4; i < block_size; ++i) {
+        data[i] += 4 * data[i - 1] - 6 * data[i - 2] + 4 * data[i - 3] - data[i - 4];
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void RestoreLpcWide(std::int32_t* data, std::uint32_t block_size, const std::int32_t* coeffs, std::uint32_t order,
+                    int shift) {
+  for (std::uint32_t i = order; i < block_size; ++i) {
+    std::int64_t sum = 0;
+    for (std::uint32_t j = 0; j < order; ++j) {
+      sum += static_cast<std::int64_t>(coeffs[j]) * data[i - 1 - j];
+    }
+    data[i] += static_cast<std::int32_t>(sum >> shift);
+  }
+}
+
+void RestoreLpcNarrow(std::int32_t* data, std::uint32_t block_size, const std::int32_t* coeffs, std::uint32_t order,
+                      int shift) {
+  for (std::uint32_t i = order; i < block_size; ++i) {
+    std::int32_t sum = 0;
+    for (std::uint32_t j = 0; j < order; ++j) {
+      sum += coeffs[j] * data[i - 1 - j];
+    }
+    data[i] += sum >> shift;
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+// `reversed` holds the coefficients oldest-lag first, zero padded at the front to
+// a multiple of four, so each prediction is a straight dot product over the
+// padded history that precedes data[i]. The history guard keeps those reads valid.
+MC_AUDIO_TARGET("sse4.1")
+void RestoreLpcNarrowSse41(std::int32_t* data, std::uint32_t block_size, const std::int32_t* reversed,
+                           std::uint32_t padded_order, std::uint32_t order, int shift) {
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+  for (std::uint32_t i = order; i < block_size; ++i) {
+    const std::int32_t* history = data + static_cast<std::ptrdiff_t>(i) - static_cast<std::ptrdiff_t>(padded_order);
+    __m128i acc = _mm_setzero_si128();
+    for (std::uint32_t k = 0; k < padded_order; k += 4) {
+      const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(history + k));
+      const __m128i taps = _mm_loadu_si128(reinterpret_cast<const __m128i*>(reversed + k));
+      acc = _mm_add_epi32(acc, _mm_mullo_epi32(samples, taps));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+    data[i] += _mm_cvtsi128_si32(_mm_sra_epi32(acc, shift_count));
+  }
+}
+#endif
+
+unsigned BitLength(std::uint32_t value) {
+  unsigned length = 0;
+  while (value != 0) {
+    ++length;
+    value >>= 1;
+  }
+  return length;
+}
+
+void RestoreLpc(std::int32_t* data, std::uint32_t block_size, const std::int32_t* coeffs, std::uint32_t order,
+                std::uint32_t precision, std::uint32_t sample_bits, int shift) {
+  const bool narrow = sample_bits + precision + BitLength(order) <= 32;
+  if (!narrow) {
+    RestoreLpcWide(data, block_size, coeffs, order, shift);
+    return;
+  }
+#if MC_AUDIO_X86_DISPATCH
+  if (DetectCpuFeatures().sse41 && order >= 4) {
+    alignas(16) std::int32_t reversed[kLpcGuard] = {};
+    const std::uint32_t padded_order = (order + 3) & ~3u;
+    for (std::uint32_t j = 0; j < order; ++j) {
+      reversed[padded_order - 1 - j] = coeffs[j];
+    }
+    RestoreLpcNarrowSse41(data, block_size, reversed, padded_order, order, shift);
+    return;
+  }
+#endif
+  RestoreLpcNarrow(data, block_size, coeffs, order, shift);
+}
+
+bool DecodeSubframe(BitReader& bits, std::uint32_t block_size, std::uint32_t sample_bits, std::int32_t* data) {
+  if (bits.ReadBits(1) != 0) {
+    return false;
+  }
+  const std::uint32_t type = bits.ReadBits(6);
+  std::uint32_t wasted = 0;
+  if (bits.ReadBits(1) != 0) {
+    wasted = bits.ReadUnary() + 1;
+    if (wasted >= sample_bits) {
+      return false;
+    }
+    sample_bits -= wasted;
+  }
+
+  if (type == 0) {
+    const std::int32_t value = bits.ReadSigned(sample_bits);
+    std::fill(data, data + block_size, value);
+  } else if (type == 1) {
+    for (std::uint32_t i = 0; i < block_size; ++i) {
+      data[i] = bits.ReadSigned(sample_bits);
+    }
+  } else if (type >= 8 && type <= 12) {
+    const std::uint32_t order = type - 8;
+    if (order > block_size) {
+      return false;
+    }
+    for (std::uint32_t i = 0; i < order; ++i) {
+      data[i] = bits.ReadSigned(sample_bits);
+    }
+    if (!DecodeResidual(bits, block_size, order, data + order)) {
+      return false;
+    }
+    RestoreFixed(data, block_size, order);
+  } else if (type >= 32) {
+    const std::uint32_t order = type - 31;
+    if (order > block_size) {
+      return false;
+    }
+    for (std::uint32_t i = 0; i < order; ++i) {
+      data[i] = bits.ReadSigned(sample_bits);
+    }
+    const std::uint32_t precision = bits.ReadBits(4) + 1;
+    if (precision == 16) {
+      return false;
+    }
+    const std::int32_t shift = bits.ReadSigned(5);
+    if (shift < 0) {
+      return false;
+    }
+    std::int32_t coeffs[32];
+    for (std::uint32_t j = 0; j < order; ++j) {
+      coeffs[j] = bits.ReadSigned(precision);
+    }
+    if (!DecodeResidual(bits, block_size, order, data + order)) {
+      return false;
+    }
+    RestoreLpc(data, block_size, coeffs, order, precision, sample_bits, shift);
+  } else {
+    return false;
+  }
+
+  if (wasted > 0) {
+    for (std::uint32_t i = 0; i < block_size; ++i) {
+      data[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(data[i]) << wasted);
+    }
+  }
+  return !bits.Overrun();
+}
+
+}  // namespace
+
+FlacDecoder::FlacDecoder(const std::filesystem::path& path) : file_(path, std::ios::binary) {
+  if (!file_) {
+    throw std::runtime_error("failed to open FLAC file");
+  }
+  file_.seekg(0, std::ios::end);
+  file_size_ = static_cast<std::uint64_t>(file_.tellg());
+  file_.seekg(0, std::ios::beg);
+  ParseMetadata();
+
+  const std::size_t per_channel = kLpcGuard + max_block_size_;
+  decoded_.assign(per_channel * info_.channels, 0);
+  next_frame_offset_ = first_frame_offset_;
+}
+
+void FlacDecoder::ParseMetadata() {
+  std::uint8_t header[10] = {};
+  if (!file_.read(reinterpret_cast<char*>(header), 4)) {
+    throw std::runtime_error("FLAC file is too short");
+  }
+  if (std::memcmp(header, "ID3", 3) == 0) {
+    file_.read(reinterpret_cast<char*>(header + 4), 6);
+    const std::uint32_t tag_size = (static_cast<std::uint32_t>(header[6] & 0x7F) << 21) |
+                                   (static_cast<std::uint32_t>(header[7] & 0x7F) << 14) |
+                                   (static_cast<std::uint32_t>(header[8] & 0x7F) << 7) | (header[9] & 0x7F);
+    const std::uint32_t footer = (header[5] & 0x10) ? 10 : 0;
+    file_.seekg(10 + tag_size + footer, std::ios::beg);
+    file_.read(reinterpret_cast<char*>(header), 4);
+  }
+  if (!file_ || std::memcmp(header, "fLaC", 4) != 0) {
+    throw std::runtime_error("missing fLaC stream marker");
+  }
+
+  bool has_stream_info = false;
+  bool last = false;
+  while (!last) {
+    std::uint8_t block_header[4] = {};
+    if (!file_.read(reinterpret_cast<char*>(block_header), 4)) {
+      throw std::runtime_error("truncated FLAC metadata");
+    }
+    last = (block_header[0] & 0x80) != 0;
+    const std::uint32_t type = block_header[0] & 0x7F;
+    const std::uint32_t length = ReadBigEndian(block_header + 1, 3);
+    std::vector<std::uint8_t> block(length);
+    if (length > 0 && !file_.read(reinterpret_cast<char*>(block.data()), length)) {
+      throw std::runtime_error("truncated FLAC metadata block");
+    }
+
+    if (type == 0) {
+      if (length < 34) {
+        throw std::runtime_error("invalid STREAMINFO block");
+      }
+      min_block_size_ = ReadBigEndian(block.data(), 2);
+      max_block_size_ = ReadBigEndian(block.data() + 2, 2);
+      max_frame_bytes_ = ReadBigEndian(block.data() + 7, 3);
+      info_.sample_rate = ReadBigEndian(block.data() + 10, 3) >> 4;
+      info_.channels = ((block[12] >> 1) & 0x07) + 1;
+      info_.bits_per_sample = (((block[12] & 0x01) << 4) | (block[13] >> 4)) + 1;
+      info_.total_frames = (static_cast<std::uint64_t>(block[13] & 0x0F) << 32) | ReadBigEndian(block.data() + 14, 4);
+      has_stream_info = true;
+    } else if (type == 3) {
+      for (std::uint32_t offset = 0; offset + 18 <= length; offset += 18) {
+        const std::uint64_t sample =
+            (static_cast<std::uint64_t>(ReadBigEndian(block.data() + offset, 4)) << 32) |
+            ReadBigEndian(block.data() + offset + 4, 4);
+        if (sample == ~0ull) {
+          continue;
+        }
+        const std::uint64_t byte_offset =
+            (static_cast<std::uint64_t>(ReadBigEndian(block.data() + offset + 8, 4)) << 32) |
+            ReadBigEndian(block.data() + offset + 12, 4);
+        seek_points_.push_back({sample, byte_offset});
+      }
+    }
+  }
+
+  if (!has_stream_info) {
+    throw std::runtime_error("FLAC stream has no STREAMINFO block");
+  }
+  if (info_.sample_rate == 0 || max_block_size_ < 16 || min_block_size_ > max_block_size_) {
+    throw std::runtime_error("invalid FLAC stream parameters");
+  }
+  if (info_.bits_per_sample < 4 || info_.bits_per_sample > 24) {
+    throw std::runtime_error("unsupported FLAC bit depth");
+  }
+
+  const std::uint32_t verbatim_bound =
+      (max_block_size_ * info_.channels * (info_.bits_per_sample + 1) + 7) / 8 + 32 + info_.channels;
+  max_frame_bytes_ = std::max(max_frame_bytes_, verbatim_bound);
+  first_frame_offset_ = static_cast<std::uint64_t>(file_.tellg());
+  std::sort(seek_points_.begin(), seek_points_.end(),
+            [](const FlacSeekPoint& lhs, const FlacSeekPoint& rhs) { return lhs.sample < rhs.sample; });
+}
+
+bool FlacDecoder::FillWindow(std::uint64_t offset, std::size_t min_bytes) {
+  if (offset >= file_size_) {
+    return false;
+  }
+  const std::uint64_t wanted_end = std::min<std::uint64_t>(offset + min_bytes, file_size_);
+  if (offset >= window_offset_ && wanted_end <= window_offset_ + window_.size()) {
+    return true;
+  }
+  const std::size_t size =
+      static_cast<std::size_t>(std::min<std::uint64_t>(std::max(min_bytes, kWindowChunk), file_size_ - offset));
+  window_.resize(size);
+  file_.clear();
+  file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  if (!file_.read(reinterpret_cast<char*>(window_.data()), static_cast<std::streamsize>(size))) {
+    window_.clear();
+    return false;
+  }
+  window_offset_ = offset;
+  return true;
+}
+
+bool FlacDecoder::ParseFrameHeader(const std::uint8_t* data, std::size_t size, FrameHeader* header) const {
+  if (size < 6 || data[0] != 0xFF || (data[1] & 0xFE) != 0xF8) {
+    return false;
+  }
+  const bool variable_blocking = (data[1] & 0x01) != 0;
+  const std::uint32_t block_code = data[2] >> 4;
+  const std::uint32_t rate_code = data[2] & 0x0F;
+  const std::uint32_t channel_code = data[3] >> 4;
+  const std::uint32_t size_code = (data[3] >> 1) & 0x07;
+  if (block_code == 0 || rate_code == 15 || channel_code > 10 || size_code == 3 || (data[3] & 0x01) != 0) {
+    return false;
+  }
+
+  std::size_t pos = 4;
+  std::uint64_t number = data[pos];
+  int continuation = 0;
+  if ((number & 0x80) == 0) {
+    continuation = 0;
+  } else if ((number & 0xE0) == 0xC0) {
+    number &= 0x1F;
+    continuation = 1;
+  } else if ((number & 0xF0) == 0xE0) {
+    number &= 0x0F;
+    continuation = 2;
+  } else if ((number & 0xF8) == 0xF0) {
+    number &= 0x07;
+    continuation = 3;
+  } else if ((number & 0xFC) == 0xF8) {
+    number &= 0x03;
+    continuation = 4;
+  } else if ((number & 0xFE) == 0xFC) {
+    number &= 0x01;
+    continuation = 5;
+  } else if (number == 0xFE) {
+    number = 0;
+    continuation = 6;
+  } else {
+    return false;
+  }
+  ++pos;
+  if (pos + continuation + 5 > size) {
+    return false;
+  }
+  for (int i = 0; i < continuation; ++i, ++pos) {
+    if ((data[pos] & 0xC0) != 0x80) {
+      return false;
+    }
+    number = (number << 6) | (data[pos] & 0x3F);
+  }
+
+  std::uint32_t block_size = 0;
+  if (block_code == 1) {
+    block_size = 192;
+  } else if (block_code <= 5) {
+    block_size = 576u << (block_code - 2);
+  } else if (block_code == 6) {
+    block_size = data[pos++] + 1u;
+  } else if (block_code == 7) {
+    block_size = ReadBigEndian(data + pos, 2) + 1u;
+    pos += 2;
+  } else {
+    block_size = 256u << (block_code - 8);
+  }
+  if (rate_code == 12) {
+    pos += 1;
+  } else if (rate_code == 13 || rate_code == 14) {
+    pos += 2;
+  }
+  if (pos >= size || Crc8(data, pos) != data[pos]) {
+    return false;
+  }
+
+  static constexpr std::uint32_t kSampleSizes[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+  const std::uint32_t channels = channel_code < 8 ? channel_code + 1 : 2;
+  const std::uint32_t bits = size_code == 0 ? info_.bits_per_sample : kSampleSizes[size_code];
+  if (channels != info_.channels || bits != info_.bits_per_sample || block_size > max_block_size_) {
+    return false;
+  }
+
+  header->first_sample = variable_blocking ? number : number * max_block_size_;
+  header->block_size = block_size;
+  header->channel_assignment = channel_code;
+  header->bits_per_sample = bits;
+  header->header_bytes = pos + 1;
+  return info_.total_frames == 0 || header->first_sample < info_.total_frames;
+}
+
+bool FlacDecoder::FindFrameAtOrAfter(std::uint64_t offset, std::uint64_t* found_offset, FrameHeader* header) {
+  offset = std::max(offset, first_frame_offset_);
+  while (offset + 6 < file_size_) {
+    if (!FillWindow(offset, max_frame_bytes_)) {
+      return false;
+    }
+    const std::uint8_t* base = window_.data() + (offset - window_offset_);
+    const std::size_t available = static_cast<std::size_t>(window_offset_ + window_.size() - offset);
+    const std::size_t scan_end = available > 16 ? available - 16 : 0;
+    for (std::size_t i = 0; i < scan_end; ++i) {
+      if (base[i] == 0xFF && ParseFrameHeader(base + i, available - i, header)) {
+        *found_offset = offset + i;
+        return true;
+      }
+    }
+    if (scan_end == 0) {
+      return false;
+    }
+    offset += scan_end;
+  }
+  return false;
+}
+
+bool FlacDecoder::DecodeFrameAt(std::uint64_t offset) {
+  if (!FillWindow(offset, max_frame_bytes_)) {
+    return false;
+  }
+  const std::uint8_t* data = window_.data() + (offset - window_offset_);
+  const std::size_t available = static_cast<std::size_t>(window_offset_ + window_.size() - offset);
+
+  FrameHeader header;
+  if (!ParseFrameHeader(data, available, &header)) {
+    return false;
+  }
+
+  BitReader bits(data + header.header_bytes, available - header.header_bytes);
+  const std::size_t stride = kLpcGuard + max_block_size_;
+  const std::uint32_t assignment = header.channel_assignment;
+  for (std::uint32_t channel = 0; channel < info_.channels; ++channel) {
+    std::uint32_t sample_bits = header.bits_per_sample;
+    if ((assignment == 8 && channel == 1) || (assignment == 9 && channel == 0) || (assignment == 10 && channel == 1)) {
+      ++sample_bits;
+    }
+    std::int32_t* out = decoded_.data() + channel * stride + kLpcGuard;
+    if (!DecodeSubframe(bits, header.block_size, sample_bits, out)) {
+      return false;
+    }
+  }
+
+  bits.AlignToByte();
+  const std::size_t footer = header.header_bytes + bits.BytePosition();
+  if (footer + 2 > available) {
+    return false;
+  }
+  if (Crc16(data, footer) != ReadBigEndian(data + footer, 2)) {
+    return false;
+  }
+
+  if (assignment >= 8) {
+    std::int32_t* left = decoded_.data() + kLpcGuard;
+    std::int32_t* right = decoded_.data() + stride + kLpcGuard;
+    for (std::uint32_t i = 0; i < header.block_size; ++i) {
+      if (assignment == 8) {
+        right[i] = left[i] - right[i];
+      } else if (assignment == 9) {
+        left[i] += right[i];
+      } else {
+        const std::int32_t side = right[i];
+        const std::int32_t mid = static_cast<std::int32_t>(static_cast<std::uint32_t>(left[i]) << 1) | (side & 1);
+        left[i] = (mid + side) >> 1;
+        right[i] = (mid - side) >> 1;
+      }
+    }
+  }
+
+  decoded_first_sample_ = header.first_sample;
+  decoded_frames_ = header.block_size;
+  next_frame_offset_ = offset + footer + 2;
+  RememberFrame(header.first_sample, offset - first_frame_offset_);
+  return true;
+}
+
+void FlacDecoder::RememberFrame(std::uint64_t sample, std::uint64_t offset) {
+  auto it = std::lower_bound(visited_frames_.begin(), visited_frames_.end(), sample,
+                             [](const FlacSeekPoint& point, std::uint64_t value) { return point.sample < value; });
+  if (it != visited_frames_.end() && it->sample == sample) {
+    return;
+  }
+  visited_frames_.insert(it, FlacSeekPoint{sample, offset});
+}
+
+FlacSeekPoint FlacDecoder::NearestKnownFrame(std::uint64_t sample) const {
+  FlacSeekPoint best{0, 0};
+  const auto consider = [&](const std::vector<FlacSeekPoint>& points) {
+    auto it = std::upper_bound(points.begin(), points.end(), sample,
+                               [](std::uint64_t value, const FlacSeekPoint& point) { return value < point.sample; });
+    if (it != points.begin()) {
+      const FlacSeekPoint& candidate = *(it - 1);
+      if (candidate.sample >= best.sample) {
+        best = candidate;
+      }
+    }
+  };
+  consider(seek_points_);
+  consider(visited_frames_);
+  return best;
+}
+
+std::uint64_t FlacDecoder::BisectFrameOffset(std::uint64_t sample, const FlacSeekPoint& lower) {
+  std::uint64_t best = first_frame_offset_ + lower.byte_offset;
+  std::uint64_t low = best;
+  std::uint64_t high = file_size_;
+  while (high > low && high - low > 2ull * max_frame_bytes_) {
+    const std::uint64_t middle = low + (high - low) / 2;
+    std::uint64_t found = 0;
+    FrameHeader header;
+    if (!FindFrameAtOrAfter(middle, &found, &header) || header.first_sample > sample) {
+      high = middle;
+      continue;
+    }
+    best = found;
+    RememberFrame(header.first_sample, found - first_frame_offset_);
+    if (sample < header.first_sample + header.block_size) {
+      break;
+    }
+    low = found + 1;
+  }
+  return best;
+}
+
+bool FlacDecoder::Seek(std::uint64_t frame) {
+  if (info_.total_frames != 0 && frame > info_.total_frames) {
+    return false;
+  }
+  if (decoded_frames_ > 0 && frame >= decoded_first_sample_ && frame < decoded_first_sample_ + decoded_frames_) {
+    position_ = frame;
+    return true;
+  }
+
+  const FlacSeekPoint lower = NearestKnownFrame(frame);
+  std::uint64_t offset = first_frame_offset_ + lower.byte_offset;
+  if (frame - lower.sample > kMaxLinearSeekBlocks * max_block_size_) {
+    offset = BisectFrameOffset(frame, lower);
+  }
+
+  decoded_frames_ = 0;
+  next_frame_offset_ = offset;
+  position_ = frame;
+  while (decoded_frames_ == 0 || decoded_first_sample_ + decoded_frames_ <= frame) {
+    if (!DecodeFrameAt(next_frame_offset_)) {
+      decoded_frames_ = 0;
+      return info_.total_frames != 0 && frame == info_.total_frames;
+    }
+  }
+  return true;
+}
+
+std::size_t FlacDecoder::ReadInto(const AudioBufferView& out) {
+  const std::size_t frames = out.Frames();
+  const float scale = 1.0f / static_cast<float>(1u << (info_.bits_per_sample - 1));
+  const std::size_t stride = kLpcGuard + max_block_size_;
+  std::size_t written = 0;
+  while (written < frames) {
+    if (decoded_frames_ == 0 || position_ >= decoded_first_sample_ + decoded_frames_) {
+      if (!DecodeFrameAt(next_frame_offset_)) {
+        break;
+      }
+      if (position_ < decoded_first_sample_) {
+        position_ = decoded_first_sample_;
+      }
+      continue;
+    }
+    const auto frame_offset = static_cast<std::size_t>(position_ - decoded_first_sample_);
+    const std::size_t count = std::min<std::size_t>(frames - written, decoded_frames_ - frame_offset);
+    // Subframes are decoded planar, so any output layout is a strided store.
+    for (std::size_t channel = 0; channel < out.Channels(); ++channel) {
+      const std::size_t from = std::min<std::size_t>(channel, info_.channels - 1);
+      const std::int32_t* source = decoded_.data() + from * stride + kLpcGuard + frame_offset;
+      float* dest = &out(channel, written);
+      const std::size_t step = out.FrameStride();
+      for (std::size_t i = 0; i < count; ++i) {
+        dest[i * step] = static_cast<float>(source[i]) * scale;
+      }
+    }
+    written += count;
+    position_ += count;
+  }
+  return written;
+}
+
+std::unique_ptr<IAudioFileReader> OpenFlacFileReader(const std::filesystem::path& path) {
+  return std::make_unique<FlacDecoder>(path);
+}
+
+}  // namespace music_create::audio
@@ -0,0 +1,126 @@
+#include "limiter.hpp"
+
+#include "denormals.hpp"
+#include "dynamics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+Limiter::Limiter(std::uint32_t sample_rate, const LimiterParams& params)
+    : ceiling_(DbToGain(std::clamp(params.ceiling_db, -60.0f, 0.0f))),
+      release_(TimeCoefficient(std::max(params.release_ms, 1.0f), sample_rate)) {
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample rate must be positive");
+  }
+  const double lookahead = std::clamp(params.lookahead_ms, 0.0f, 100.0f) * 0.001 * sample_rate;
+  lookahead_ = std::max<std::size_t>(1, static_cast<std::size_t>(std::lround(lookahead)));
+  window_ = lookahead_ + 1;
+  delay_.resize(lookahead_ * 2);
+  deque_index_.resize(window_);
+  deque_gain_.resize(window_);
+  average_.resize(window_);
+  Reset();
+}
+
+void Limiter::Reset() noexcept {
+  std::fill(delay_.begin(), delay_.end(), 0.0f);
+  std::fill(average_.begin(), average_.end(), 1.0f);
+  delay_pos_ = 0;
+  deque_head_ = 0;
+  deque_size_ = 0;
+  average_pos_ = 0;
+  average_sum_ = static_cast<double>(window_);
+  released_ = 1.0f;
+  index_ = 0;
+}
+
+void Limiter::Process(float* left, float* right, const float*, const float*, std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n, ++index_) {
+    const float peak = std::max(std::abs(left[n]), std::abs(right[n]));
+    const float required = peak > ceiling_ ? ceiling_ / peak : 1.0f;
+
+    // Sliding minimum of the required gain over the last window_ samples.
+    // The expired head goes first, so a full window of rising gains leaves
+    // room for this sample's entry.
+    while (deque_size_ > 0 && deque_gain_[Wrap(deque_head_ + deque_size_ - 1)] >= required) {
+      --deque_size_;
+    }
+    if (deque_size_ > 0 && deque_index_[deque_head_] + window_ <= index_) {
+      deque_head_ = Wrap(deque_head_ + 1);
+      --deque_size_;
+    }
+    const std::size_t slot = Wrap(deque_head_ + deque_size_);
+    deque_index_[slot] = index_;
+    deque_gain_[slot] = required;
+    ++deque_size_;
+    const float held = deque_gain_[deque_head_];
+
+    // Instant attack, one-pole release; stays at or below the held gain.
+    released_ = held < released_ ? held : held + (released_ - held) * release_;
+
+    average_sum_ += released_ - average_[average_pos_];
+    average_[average_pos_] = released_;
+    average_pos_ = Wrap(average_pos_ + 1);
+    const float gain = static_cast<float>(average_sum_ / static_cast<double>(window_));
+
+    float* slot_pair = &delay_[delay_pos_ * 2];
+    const float delayed_left = slot_pair[0];
+    const float delayed_right = slot_pair[1];
+    slot_pair[0] = left[n];
+    slot_pair[1] = right[n];
+    delay_pos_ = delay_pos_ + 1 == lookahead_ ? 0 : delay_pos_ + 1;
+
+    // The clamp only absorbs float rounding in the running average.
+    left[n] = std::clamp(delayed_left * gain, -ceiling_, ceiling_);
+    right[n] = std::clamp(delayed_right * gain, -ceiling_, ceiling_);
+  }
+}
+
+}  // namespace music_create::audio
+
+struct mc_limiter {
+  mc_limiter(std::uint32_t sample_rate, const music_create::audio::LimiterParams& params)
+      : limiter(sample_rate, params) {}
+
+  music_create::audio::Limiter limiter;
+};
+
+extern "C" {
+
+mc_limiter* mc_limiter_create(unsigned int sample_rate, float ceiling_db, float lookahead_ms, float release_ms) {
+  try {
+    return new mc_limiter(sample_rate, {ceiling_db, lookahead_ms, release_ms});
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_limiter_free(mc_limiter* limiter) { delete limiter; }
+
+unsigned int mc_limiter_latency(const mc_limiter* limiter) {
+  return limiter == nullptr ? 0 : static_cast<unsigned int>(limiter->limiter.Latency());
+}
+
+int mc_limiter_process(mc_limiter* limiter, float* left, float* right, unsigned long long frames) {
+  if (limiter == nullptr || (frames > 0 && left == nullptr)) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  // Mono runs as a linked pair whose right channel mirrors the left.
+  limiter->limiter.Process(left, right == nullptr ? left : right, nullptr, nullptr,
+                           static_cast<std::size_t>(frames));
+  return 1;
+}
+
+int mc_limiter_reset(mc_limiter* limiter) {
+  if (limiter == nullptr) {
+    return 0;
+  }
+  limiter->limiter.Reset();
+  return 1;
+}
+
+}  // extern "C"
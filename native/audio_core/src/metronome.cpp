@@ -0,0 +1,148 @@
+#include "metronome.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+constexpr double kMaxBpm = 1000.0;
+constexpr double kBeatEpsilon = 1e-9;
+
+// A sine ping decaying to -60 dB over the click; starting at phase zero it
+// needs no attack ramp.
+std::vector<float> SynthesizeClick(std::uint32_t sample_rate, double hz, float level) {
+  const auto frames = std::max<std::size_t>(
+      static_cast<std::size_t>(Metronome::kClickMs * static_cast<float>(sample_rate) / 1000.0f), 1);
+  std::vector<float> click(frames);
+  for (std::size_t n = 0; n < frames; ++n) {
+    const double decay = std::exp(-6.907755 * static_cast<double>(n) / static_cast<double>(frames));
+    click[n] = static_cast<float>(level * decay * std::sin(kTwoPi * hz * static_cast<double>(n) / sample_rate));
+  }
+  return click;
+}
+
+bool PowerOfTwo(int value) { return value > 0 && (value & (value - 1)) == 0; }
+
+double BeatUnit(const MeterPoint& meter) { return 4.0 / static_cast<double>(meter.denominator); }
+
+}  // namespace
+
+Metronome::Metronome(std::uint32_t sample_rate)
+    : sample_rate_(sample_rate),
+      accent_(SynthesizeClick(sample_rate, 1760.0, 0.5f)),
+      normal_(SynthesizeClick(sample_rate, 880.0, 0.35f)) {
+  if (sample_rate == 0) {
+    throw std::invalid_argument("metronome sample rate must be positive");
+  }
+  SetTempoMap({TempoPoint{}}, {MeterPoint{}});
+}
+
+void Metronome::SetTempoMap(std::vector<TempoPoint> tempo, std::vector<MeterPoint> meter) {
+  if (tempo.empty() || tempo.front().beat != 0.0 || meter.empty() || meter.front().beat != 0.0) {
+    throw std::invalid_argument("tempo and meter maps must start at beat 0");
+  }
+  for (std::size_t i = 0; i < tempo.size(); ++i) {
+    if (!(tempo[i].bpm > 0.0 && tempo[i].bpm <= kMaxBpm) || (i > 0 && !(tempo[i].beat > tempo[i - 1].beat))) {
+      throw std::invalid_argument("tempo points need increasing beats and tempos in (0, 1000] BPM");
+    }
+  }
+  for (std::size_t i = 0; i < meter.size(); ++i) {
+    if (meter[i].numerator < 1 || meter[i].numerator > 32 || !PowerOfTwo(meter[i].denominator) ||
+        meter[i].denominator > 32 || (i > 0 && !(meter[i].beat > meter[i - 1].beat))) {
+      throw std::invalid_argument("meter points need increasing beats and 1-32 beats of a note up to a 32nd");
+    }
+  }
+  tempo_ = std::move(tempo);
+  meter_ = std::move(meter);
+  tempo_frames_.assign(tempo_.size(), 0.0);
+  for (std::size_t i = 1; i < tempo_.size(); ++i) {
+    tempo_frames_[i] = tempo_frames_[i - 1] +
+                       (tempo_[i].beat - tempo_[i - 1].beat) * 60.0 * sample_rate_ / tempo_[i - 1].bpm;
+  }
+  Seek(0);
+}
+
+double Metronome::BeatToFrame(double beat) const noexcept {
+  const auto after = std::upper_bound(tempo_.begin(), tempo_.end(), beat,
+                                      [](double value, const TempoPoint& point) { return value < point.beat; });
+  const auto i = static_cast<std::size_t>(std::max<std::ptrdiff_t>(after - tempo_.begin() - 1, 0));
+  return tempo_frames_[i] + (beat - tempo_[i].beat) * 60.0 * sample_rate_ / tempo_[i].bpm;
+}
+
+double Metronome::FrameToBeat(double frame) const noexcept {
+  const auto after = std::upper_bound(tempo_frames_.begin(), tempo_frames_.end(), frame);
+  const auto i = static_cast<std::size_t>(std::max<std::ptrdiff_t>(after - tempo_frames_.begin() - 1, 0));
+  return tempo_[i].beat + (frame - tempo_frames_[i]) * tempo_[i].bpm / (60.0 * sample_rate_);
+}
+
+void Metronome::Seek(std::uint64_t frame) noexcept {
+  sounding_ = nullptr;
+  sounded_ = 0;
+  // Start the schedule a click's length early to catch one still ringing.
+  const double beat =
+      FrameToBeat(std::max(static_cast<double>(frame) - static_cast<double>(accent_.size()) - 1.0, 0.0));
+  const auto after = std::upper_bound(meter_.begin(), meter_.end(), beat,
+                                      [](double value, const MeterPoint& point) { return value < point.beat; });
+  const auto m = static_cast<std::size_t>(std::max<std::ptrdiff_t>(after - meter_.begin() - 1, 0));
+  const double clicks = std::ceil((beat - meter_[m].beat) / BeatUnit(meter_[m]) - kBeatEpsilon);
+  Locate(m, static_cast<std::int64_t>(std::max(clicks, 0.0)));
+  while (next_frame_ < frame) {
+    const std::vector<float>& click = Click(next_accent_);
+    if (next_frame_ + click.size() > frame) {
+      sounding_ = &click;
+      sounded_ = static_cast<std::size_t>(frame - next_frame_);
+    }
+    Advance();
+  }
+  position_ = frame;
+}
+
+void Metronome::Render(float* const* out, std::size_t channels, std::size_t frames, float gain) noexcept {
+  for (std::size_t done = 0; done < frames;) {
+    const std::uint64_t now = position_ + done;
+    // Clicks rounding onto the same frame: the last one sounds.
+    while (next_frame_ <= now) {
+      sounding_ = &Click(next_accent_);
+      sounded_ = static_cast<std::size_t>(now - next_frame_);
+      Advance();
+    }
+    const auto span = static_cast<std::size_t>(std::min<std::uint64_t>(frames - done, next_frame_ - now));
+    if (sounding_ != nullptr) {
+      const std::size_t count = std::min(span, sounding_->size() - sounded_);
+      const float* click = sounding_->data() + sounded_;
+      for (std::size_t c = 0; c < channels; ++c) {
+        float* target = out[c] + done;
+        for (std::size_t n = 0; n < count; ++n) {
+          target[n] += gain * click[n];
+        }
+      }
+      sounded_ += count;
+      if (sounded_ >= sounding_->size()) {
+        sounding_ = nullptr;
+      }
+    }
+    done += span;
+  }
+  position_ += frames;
+}
+
+void Metronome::Advance() noexcept { Locate(meter_index_, click_index_ + 1); }
+
+void Metronome::Locate(std::size_t meter, std::int64_t index) noexcept {
+  double beat = meter_[meter].beat + static_cast<double>(index) * BeatUnit(meter_[meter]);
+  if (meter + 1 < meter_.size() && beat >= meter_[meter + 1].beat - kBeatEpsilon) {
+    ++meter;
+    index = 0;
+    beat = meter_[meter].beat;
+  }
+  meter_index_ = meter;
+  click_index_ = index;
+  next_frame_ = static_cast<std::uint64_t>(std::llround(BeatToFrame(beat)));
+  next_accent_ = index % meter_[meter].numerator == 0;
+}
+
+}  // namespace music_create::audio
@@ -0,0 +1,663 @@
+#include "midi_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr std::size_t kNoteKeys = 16 * 128;
+constexpr std::uint32_t kNoPending = std::numeric_limits<std::uint32_t>::max();
+
+std::uint32_t ReadBigEndian(const std::uint8_t* data, int bytes) {
+  std::uint32_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+class TickScaler {
+ public:
+  TickScaler(std::int64_t numerator, std::int64_t denominator) : numerator_(numerator), denominator_(denominator) {}
+
+  std::int32_t operator()(std::int64_t tick) const {
+    const std::int64_t scaled = (tick * numerator_ + denominator_ / 2) / denominator_;
+    return static_cast<std::int32_t>(std::min<std::int64_t>(scaled, std::numeric_limits<std::int32_t>::max()));
+  }
+
+ private:
+  std::int64_t numerator_;
+  std::int64_t denominator_;
+};
+
+class TrackParser {
+ public:
+  TrackParser(const std::uint8_t* data, std::size_t size, std::uint16_t track_index, const TickScaler& scale,
+              SmfData& out)
+      : data_(data), size_(size), track_(track_index), scale_(scale), out_(out) {
+    pending_head_.fill(kNoPending);
+    pending_tail_.fill(kNoPending);
+  }
+
+  void Parse() {
+    std::int64_t tick = 0;
+    std::uint8_t running_status = 0;
+    while (pos_ < size_) {
+      tick += ReadVariableLength();
+      std::uint8_t status = Byte();
+      if (status < 0x80) {
+        if (running_status == 0) {
+          throw std::runtime_error("MIDI data byte without running status");
+        }
+        --pos_;
+        status = running_status;
+      }
+
+      if (status < 0xF0) {
+        running_status = status;
+        const std::uint8_t kind = status & 0xF0;
+        const std::uint8_t channel = status & 0x0F;
+        const std::uint8_t first = Byte() & 0x7F;
+        if (kind == 0xC0 || kind == 0xD0) {
+          if (kind == 0xC0 && out_.Program(track_, channel) < 0) {
+            out_.SetProgram(track_, channel, first);
+          }
+          continue;
+        }
+        const std::uint8_t second = Byte() & 0x7F;
+        if (kind == 0x90 && second > 0) {
+          NoteOn(tick, channel, first, second);
+        } else if (kind == 0x80 || kind == 0x90) {
+          NoteOff(tick, channel, first);
+        }
+        continue;
+      }
+
+      running_status = 0;
+      if (status == 0xF0 || status == 0xF7) {
+        Skip(ReadVariableLength());
+        continue;
+      }
+      if (status != 0xFF) {
+        throw std::runtime_error("unexpected MIDI system message in file");
+      }
+      const std::uint8_t type = Byte();
+      const std::uint32_t length = ReadVariableLength();
+      if (pos_ + length > size_) {
+        throw std::runtime_error("truncated MIDI meta event");
+      }
+      const std::uint8_t* payload = data_ + pos_;
+      pos_ += length;
+      if (type == 0x51 && length == 3) {
+        out_.tempo_map.push_back({scale_(tick), ReadBigEndian(payload, 3)});
+      } else if (type == 0x58 && length >= 2) {
+        out_.time_signatures.push_back(
+            {scale_(tick), payload[0], static_cast<std::uint8_t>(1u << std::min<std::uint8_t>(payload[1], 7))});
+      } else if (type == 0x03) {
+        out_.track_names[track_].assign(reinterpret_cast<const char*>(payload), length);
+      } else if (type == 0x2F) {
+        break;
+      }
+    }
+    CloseHangingNotes(tick);
+  }
+
+ private:
+  std::uint8_t Byte() {
+    if (pos_ >= size_) {
+      throw std::runtime_error("truncated MIDI track");
+    }
+    return data_[pos_++];
+  }
+
+  void Skip(std::uint32_t count) {
+    if (pos_ + count > size_) {
+      throw std::runtime_error("truncated MIDI event");
+    }
+    pos_ += count;
+  }
+
+  std::uint32_t ReadVariableLength() {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+      const std::uint8_t byte = Byte();
+      value = (value << 7) | (byte & 0x7F);
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw std::runtime_error("variable-length quantity exceeds four bytes");
+  }
+
+  void NoteOn(std::int64_t tick, std::uint8_t channel, std::uint8_t pitch, std::uint8_t velocity) {
+    const auto index = static_cast<std::uint32_t>(out_.notes.size());
+    out_.notes.push_back(scale_(tick), 0, pitch, velocity, channel, track_);
+    pending_next_.push_back(kNoPending);
+    const std::size_t key = channel * 128u + pitch;
+    if (pending_tail_[key] == kNoPending) {
+      pending_head_[key] = index;
+    } else {
+      pending_next_[pending_tail_[key] - first_note_] = index;
+    }
+    pending_tail_[key] = index;
+  }
+
+  // Overlapping notes of the same key are closed first-in, first-out.
+  void NoteOff(std::int64_t tick, std::uint8_t channel, std::uint8_t pitch) {
+    const std::size_t key = channel * 128u + pitch;
+    const std::uint32_t index = pending_head_[key];
+    if (index == kNoPending) {
+      return;
+    }
+    Close(index, scale_(tick));
+    pending_head_[key] = pending_next_[index - first_note_];
+    if (pending_head_[key] == kNoPending) {
+      pending_tail_[key] = kNoPending;
+    }
+  }
+
+  void Close(std::uint32_t index, std::int32_t end_tick) {
+    out_.notes.length_tick[index] = std::max(end_tick - out_.notes.start_tick[index], 1);
+  }
+
+  void CloseHangingNotes(std::int64_t tick) {
+    const std::int32_t end_tick = scale_(tick);
+    for (std::size_t key = 0; key < kNoteKeys; ++key) {
+      for (std::uint32_t index = pending_head_[key]; index != kNoPending; index = pending_next_[index - first_note_]) {
+        Close(index, end_tick);
+      }
+    }
+  }
+
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+  std::uint16_t track_;
+  const TickScaler& scale_;
+  SmfData& out_;
+  const std::uint32_t first_note_ = static_cast<std::uint32_t>(out_.notes.size());
+  std::array<std::uint32_t, kNoteKeys> pending_head_{};
+  std::array<std::uint32_t, kNoteKeys> pending_tail_{};
+  std::vector<std::uint32_t> pending_next_;
+};
+
+void AppendVariableLength(std::vector<std::uint8_t>& out, std::uint32_t value) {
+  std::uint8_t bytes[4];
+  int count = 0;
+  do {
+    bytes[count++] = static_cast<std::uint8_t>(value & 0x7F);
+    value >>= 7;
+  } while (value != 0 && count < 4);
+  while (count > 1) {
+    out.push_back(bytes[--count] | 0x80);
+  }
+  out.push_back(bytes[0]);
+}
+
+void AppendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; --i) {
+    out.push_back(static_cast<std::uint8_t>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+struct TrackEvent {
+  std::int64_t tick;
+  std::uint8_t order;  // note-offs sort before note-ons on the same tick
+  std::uint8_t status;
+  std::uint8_t data1;
+  std::uint8_t data2;
+  std::int64_t end_tick = 0;
+};
+
+class TrackWriter {
+ public:
+  explicit TrackWriter(std::vector<std::uint8_t>& out) : out_(out) {
+    out_.insert(out_.end(), {'M', 'T', 'r', 'k', 0, 0, 0, 0});
+    length_offset_ = out_.size() - 4;
+  }
+
+  void Meta(std::int64_t tick, std::uint8_t type, const std::uint8_t* payload, std::uint32_t length) {
+    Delta(tick);
+    out_.push_back(0xFF);
+    out_.push_back(type);
+    AppendVariableLength(out_, length);
+    out_.insert(out_.end(), payload, payload + length);
+    running_status_ = 0;
+  }
+
+  void Channel(const TrackEvent& event) {
+    Delta(event.tick);
+    if (event.status != running_status_) {
+      out_.push_back(event.status);
+      running_status_ = event.status;
+    }
+    out_.push_back(event.data1);
+    const std::uint8_t kind = event.status & 0xF0;
+    if (kind != 0xC0 && kind != 0xD0) {
+      out_.push_back(event.data2);
+    }
+  }
+
+  void Finish(std::int64_t tick) {
+    Meta(tick, 0x2F, nullptr, 0);
+    const auto length = static_cast<std::uint32_t>(out_.size() - length_offset_ - 4);
+    for (int i = 0; i < 4; ++i) {
+      out_[length_offset_ + i] = static_cast<std::uint8_t>((length >> (8 * (3 - i))) & 0xFF);
+    }
+  }
+
+ private:
+  void Delta(std::int64_t tick) {
+    AppendVariableLength(out_, static_cast<std::uint32_t>(std::max<std::int64_t>(tick - last_tick_, 0)));
+    last_tick_ = std::max(tick, last_tick_);
+  }
+
+  std::vector<std::uint8_t>& out_;
+  std::size_t length_offset_ = 0;
+  std::int64_t last_tick_ = 0;
+  std::uint8_t running_status_ = 0;
+};
+
+}  // namespace
+
+void SmfNoteArrays::reserve(std::size_t count) {
+  start_tick.reserve(count);
+  length_tick.reserve(count);
+  pitch.reserve(count);
+  velocity.reserve(count);
+  channel.reserve(count);
+  track.reserve(count);
+}
+
+void SmfNoteArrays::push_back(std::int32_t start, std::int32_t length, std::uint8_t note, std::uint8_t vel,
+                              std::uint8_t ch, std::uint16_t trk) {
+  start_tick.push_back(start);
+  length_tick.push_back(length);
+  pitch.push_back(note);
+  velocity.push_back(vel);
+  channel.push_back(ch);
+  track.push_back(trk);
+}
+
+std::int16_t SmfData::Program(std::uint16_t track_index, std::uint8_t channel_index) const noexcept {
+  const std::size_t index = track_index * 16u + (channel_index & 0x0F);
+  return index < programs.size() ? programs[index] : static_cast<std::int16_t>(-1);
+}
+
+void SmfData::SetProgram(std::uint16_t track_index, std::uint8_t channel_index, std::int16_t program) {
+  const std::size_t index = track_index * 16u + (channel_index & 0x0F);
+  if (index >= programs.size()) {
+    programs.resize((track_index + 1u) * 16u, -1);
+  }
+  programs[index] = program;
+}
+
+SmfData ParseSmf(const std::uint8_t* data, std::size_t size, std::uint32_t target_ticks_per_beat) {
+  if (target_ticks_per_beat == 0) {
+    throw std::invalid_argument("target_ticks_per_beat must be non-zero");
+  }
+  if (size < 14 || std::memcmp(data, "MThd", 4) != 0) {
+    throw std::runtime_error("missing MThd header");
+  }
+  const std::uint32_t header_length = ReadBigEndian(data + 4, 4);
+  if (header_length < 6 || 8 + header_length > size) {
+    throw std::runtime_error("invalid MThd length");
+  }
+  const std::uint32_t format = ReadBigEndian(data + 8, 2);
+  const std::uint32_t declared_tracks = ReadBigEndian(data + 10, 2);
+  const std::uint32_t division = ReadBigEndian(data + 12, 2);
+  if (format > 1) {
+    throw std::runtime_error("only SMF format 0 and 1 are supported");
+  }
+
+  std::int64_t source_per_beat = division;
+  std::int64_t numerator = target_ticks_per_beat;
+  if (division & 0x8000) {
+    const int frames = -static_cast<std::int8_t>(division >> 8);
+    const int ticks_per_frame = static_cast<int>(division & 0xFF);
+    source_per_beat = static_cast<std::int64_t>(frames) * ticks_per_frame;
+    numerator *= 2;  // one beat = 0.5 s at 120 BPM
+  }
+  if (source_per_beat <= 0) {
+    throw std::runtime_error("invalid MIDI time division");
+  }
+  const TickScaler scale(numerator, source_per_beat);
+
+  SmfData out;
+  out.ticks_per_beat = target_ticks_per_beat;
+  out.notes.reserve(size / 6);
+  out.track_names.resize(declared_tracks);
+  std::size_t pos = 8 + header_length;
+  std::uint16_t track_index = 0;
+  while (pos + 8 <= size && track_index < declared_tracks) {
+    const std::uint32_t chunk_length = ReadBigEndian(data + pos + 4, 4);
+    const bool is_track = std::memcmp(data + pos, "MTrk", 4) == 0;
+    pos += 8;
+    if (pos + chunk_length > size) {
+      throw std::runtime_error("truncated MTrk chunk");
+    }
+    if (is_track) {
+      TrackParser(data + pos, chunk_length, track_index, scale, out).Parse();
+      ++track_index;
+    }
+    pos += chunk_length;
+  }
+  out.track_count = track_index;
+  out.track_names.resize(track_index);
+  out.programs.resize(track_index * 16u, -1);
+
+  std::stable_sort(out.tempo_map.begin(), out.tempo_map.end(),
+                   [](const SmfTempoPoint& lhs, const SmfTempoPoint& rhs) { return lhs.tick < rhs.tick; });
+  std::vector<SmfTempoPoint> tempo;
+  for (const auto& point : out.tempo_map) {
+    if (!tempo.empty() && tempo.back().tick == point.tick) {
+      tempo.back() = point;
+    } else {
+      tempo.push_back(point);
+    }
+  }
+  if (tempo.empty() || tempo.front().tick != 0) {
+    tempo.insert(tempo.begin(), SmfTempoPoint{});
+  }
+  out.tempo_map = std::move(tempo);
+  std::stable_sort(out.time_signatures.begin(), out.time_signatures.end(),
+                   [](const SmfTimeSignature& lhs, const SmfTimeSignature& rhs) { return lhs.tick < rhs.tick; });
+  return out;
+}
+
+SmfData ReadSmfFile(const std::filesystem::path& path, std::uint32_t target_ticks_per_beat) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("failed to open MIDI file");
+  }
+  const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return ParseSmf(bytes.data(), bytes.size(), target_ticks_per_beat);
+}
+
+std::vector<std::uint8_t> SerializeSmf(const SmfData& data) {
+  if (data.ticks_per_beat == 0 || data.ticks_per_beat > 0x7FFF) {
+    throw std::invalid_argument("ticks_per_beat must be in [1, 32767]");
+  }
+  std::vector<std::uint16_t> tracks(data.notes.track.begin(), data.notes.track.end());
+  for (std::uint16_t index = 0; index < data.track_count; ++index) {
+    tracks.push_back(index);
+  }
+  std::sort(tracks.begin(), tracks.end());
+  tracks.erase(std::unique(tracks.begin(), tracks.end()), tracks.end());
+
+  std::vector<std::uint8_t> out;
+  out.reserve(64 + data.notes.size() * 8);
+  out.insert(out.end(), {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1});
+  AppendBigEndian(out, static_cast<std::uint32_t>(tracks.size() + 1), 2);
+  AppendBigEndian(out, data.ticks_per_beat, 2);
+
+  {
+    TrackWriter conductor(out);
+    std::size_t meter_index = 0;
+    std::int64_t last_tick = 0;
+    const auto write_meter_until = [&](std::int64_t tick) {
+      for (; meter_index < data.time_signatures.size() && data.time_signatures[meter_index].tick <= tick;
+           ++meter_index) {
+        const auto& meter = data.time_signatures[meter_index];
+        std::uint8_t power = 0;
+        while ((1u << power) < meter.denominator && power < 7) {
+          ++power;
+        }
+        const std::uint8_t payload[4] = {meter.numerator, power, 24, 8};
+        conductor.Meta(meter.tick, 0x58, payload, 4);
+        last_tick = std::max<std::int64_t>(last_tick, meter.tick);
+      }
+    };
+    for (const auto& point : data.tempo_map) {
+      write_meter_until(point.tick);
+      const std::uint8_t payload[3] = {static_cast<std::uint8_t>((point.microseconds_per_quarter >> 16) & 0xFF),
+                                       static_cast<std::uint8_t>((point.microseconds_per_quarter >> 8) & 0xFF),
+                                       static_cast<std::uint8_t>(point.microseconds_per_quarter & 0xFF)};
+      conductor.Meta(point.tick, 0x51, payload, 3);
+      last_tick = std::max<std::int64_t>(last_tick, point.tick);
+    }
+    write_meter_until(std::numeric_limits<std::int64_t>::max());
+    conductor.Finish(last_tick);
+  }
+
+  std::vector<TrackEvent> events;
+  for (const std::uint16_t track_index : tracks) {
+    events.clear();
+    std::uint16_t channels_used = 0;
+    for (std::size_t i = 0; i < data.notes.size(); ++i) {
+      if (data.notes.track[i] != track_index) {
+        continue;
+      }
+      const std::uint8_t channel = data.notes.channel[i] & 0x0F;
+      channels_used |= static_cast<std::uint16_t>(1u << channel);
+      const std::int64_t start = data.notes.start_tick[i];
+      const std::int64_t end = start + std::max(data.notes.length_tick[i], 1);
+      events.push_back({start, 1, static_cast<std::uint8_t>(0x90 | channel), data.notes.pitch[i],
+                        std::max<std::uint8_t>(data.notes.velocity[i], 1), end});
+      events.push_back({end, 0, static_cast<std::uint8_t>(0x80 | channel), data.notes.pitch[i], 0});
+    }
+    // Readers pair overlapping notes first-in, first-out, so simultaneous note-ons
+    // go out shortest first to survive a round trip.
+    std::stable_sort(events.begin(), events.end(), [](const TrackEvent& lhs, const TrackEvent& rhs) {
+      if (lhs.tick != rhs.tick) {
+        return lhs.tick < rhs.tick;
+      }
+      return lhs.order != rhs.order ? lhs.order < rhs.order : lhs.end_tick < rhs.end_tick;
+    });
+
+    TrackWriter writer(out);
+    if (track_index < data.track_names.size() && !data.track_names[track_index].empty()) {
+      const std::string& name = data.track_names[track_index];
+      writer.Meta(0, 0x03, reinterpret_cast<const std::uint8_t*>(name.data()), static_cast<std::uint32_t>(name.size()));
+    }
+    for (std::uint8_t channel = 0; channel < 16; ++channel) {
+      const std::int16_t program = data.Program(track_index, channel);
+      if (program >= 0 && (channels_used & (1u << channel)) != 0) {
+        writer.Channel({0, 0, static_cast<std::uint8_t>(0xC0 | channel), static_cast<std::uint8_t>(program & 0x7F), 0});
+      }
+    }
+    for (const auto& event : events) {
+      writer.Channel(event);
+    }
+    writer.Finish(events.empty() ? 0 : events.back().tick);
+  }
+  return out;
+}
+
+void WriteSmfFile(const std::filesystem::path& path, const SmfData& data) {
+  const std::vector<std::uint8_t> bytes = SerializeSmf(data);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file || !file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+    throw std::runtime_error("failed to write MIDI file");
+  }
+}
+
+}  // namespace music_create::audio
+
+struct mc_smf {
+  music_create::audio::SmfData data;
+};
+
+extern "C" {
+
+mc_smf* mc_smf_read_file_w(const wchar_t* path, unsigned int target_ticks_per_beat) {
+  if (path == nullptr) {
+    return nullptr;
+  }
+  try {
+    auto handle = std::make_unique<mc_smf>();
+    handle->data = music_create::audio::ReadSmfFile(std::filesystem::path(path), target_ticks_per_beat);
+    return handle.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+mc_smf* mc_smf_read_memory(const unsigned char* data, unsigned long long size, unsigned int target_ticks_per_beat) {
+  if (data == nullptr) {
+    return nullptr;
+  }
+  try {
+    auto handle = std::make_unique<mc_smf>();
+    handle->data = music_create::audio::ParseSmf(data, static_cast<std::size_t>(size), target_ticks_per_beat);
+    return handle.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+mc_smf* mc_smf_create(unsigned int ticks_per_beat) {
+  if (ticks_per_beat == 0 || ticks_per_beat > 0x7FFF) {
+    return nullptr;
+  }
+  auto* handle = new mc_smf();
+  handle->data.ticks_per_beat = ticks_per_beat;
+  return handle;
+}
+
+void mc_smf_free(mc_smf* smf) { delete smf; }
+
+unsigned int mc_smf_ticks_per_beat(const mc_smf* smf) { return smf == nullptr ? 0 : smf->data.ticks_per_beat; }
+
+unsigned int mc_smf_track_count(const mc_smf* smf) { return smf == nullptr ? 0 : smf->data.track_count; }
+
+const char* mc_smf_track_name(const mc_smf* smf, unsigned int track) {
+  if (smf == nullptr || track >= smf->data.track_names.size()) {
+    return "";
+  }
+  return smf->data.track_names[track].c_str();
+}
+
+int mc_smf_program(const mc_smf* smf, unsigned int track, unsigned int channel) {
+  if (smf == nullptr || track > 0xFFFF) {
+    return -1;
+  }
+  return smf->data.Program(static_cast<std::uint16_t>(track), static_cast<std::uint8_t>(channel));
+}
+
+unsigned long long mc_smf_note_count(const mc_smf* smf) { return smf == nullptr ? 0 : smf->data.notes.size(); }
+
+int mc_smf_copy_notes(const mc_smf* smf, int* start_tick, int* length_tick, unsigned char* pitch,
+                      unsigned char* velocity, unsigned char* channel, unsigned short* track) {
+  if (smf == nullptr) {
+    return 0;
+  }
+  const auto& notes = smf->data.notes;
+  const std::size_t count = notes.size();
+  if (start_tick != nullptr) {
+    std::copy_n(notes.start_tick.data(), count, start_tick);
+  }
+  if (length_tick != nullptr) {
+    std::copy_n(notes.length_tick.data(), count, length_tick);
+  }
+  if (pitch != nullptr) {
+    std::copy_n(notes.pitch.data(), count, pitch);
+  }
+  if (velocity != nullptr) {
+    std::copy_n(notes.velocity.data(), count, velocity);
+  }
+  if (channel != nullptr) {
+    std::copy_n(notes.channel.data(), count, channel);
+  }
+  if (track != nullptr) {
+    std::copy_n(notes.track.data(), count, track);
+  }
+  return 1;
+}
+
+unsigned int mc_smf_tempo_count(const mc_smf* smf) {
+  return smf == nullptr ? 0 : static_cast<unsigned int>(smf->data.tempo_map.size());
+}
+
+int mc_smf_copy_tempo_map(const mc_smf* smf, int* tick, unsigned int* microseconds_per_quarter) {
+  if (smf == nullptr || tick == nullptr || microseconds_per_quarter == nullptr) {
+    return 0;
+  }
+  for (std::size_t i = 0; i < smf->data.tempo_map.size(); ++i) {
+    tick[i] = smf->data.tempo_map[i].tick;
+    microseconds_per_quarter[i] = smf->data.tempo_map[i].microseconds_per_quarter;
+  }
+  return 1;
+}
+
+int mc_smf_add_notes(mc_smf* smf, unsigned long long count, const int* start_tick, const int* length_tick,
+                     const unsigned char* pitch, const unsigned char* velocity, const unsigned char* channel,
+                     const unsigned short* track) {
+  if (smf == nullptr || start_tick == nullptr || length_tick == nullptr || pitch == nullptr || velocity == nullptr ||
+      channel == nullptr || track == nullptr) {
+    return 0;
+  }
+  // Track 0xFFFF has no index + 1 to count it; reject the batch before any
+  // of it lands.
+  for (unsigned long long i = 0; i < count; ++i) {
+    if (track[i] > 0xFFFE) {
+      return 0;
+    }
+  }
+  try {
+    auto& notes = smf->data.notes;
+    notes.reserve(notes.size() + static_cast<std::size_t>(count));
+    for (unsigned long long i = 0; i < count; ++i) {
+      notes.push_back(std::max(start_tick[i], 0), std::max(length_tick[i], 1), pitch[i] & 0x7F, velocity[i] & 0x7F,
+                      channel[i] & 0x0F, track[i]);
+      smf->data.track_count = std::max<std::uint16_t>(smf->data.track_count, static_cast<std::uint16_t>(track[i] + 1));
+    }
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_smf_add_tempo(mc_smf* smf, int tick, unsigned int microseconds_per_quarter) {
+  if (smf == nullptr || tick < 0 || microseconds_per_quarter == 0 || microseconds_per_quarter > 0xFFFFFF) {
+    return 0;
+  }
+  auto& tempo = smf->data.tempo_map;
+  const auto it = std::upper_bound(tempo.begin(), tempo.end(), tick,
+                                   [](int value, const music_create::audio::SmfTempoPoint& point) {
+                                     return value < point.tick;
+                                   });
+  tempo.insert(it, {tick, microseconds_per_quarter});
+  return 1;
+}
+
+int mc_smf_set_track(mc_smf* smf, unsigned int track, const char* name, int channel, int program) {
+  if (smf == nullptr || track > 0xFFFE) {
+    return 0;
+  }
+  auto& data = smf->data;
+  const auto index = static_cast<std::uint16_t>(track);
+  data.track_count = std::max<std::uint16_t>(data.track_count, static_cast<std::uint16_t>(index + 1));
+  if (data.track_names.size() < data.track_count) {
+    data.track_names.resize(data.track_count);
+  }
+  if (name != nullptr) {
+    data.track_names[index] = name;
+  }
+  if (channel >= 0 && channel < 16 && program >= 0 && program < 128) {
+    data.SetProgram(index, static_cast<std::uint8_t>(channel), static_cast<std::int16_t>(program));
+  }
+  return 1;
+}
+
+int mc_smf_write_file_w(const mc_smf* smf, const wchar_t* path) {
+  if (smf == nullptr || path == nullptr) {
+    return 0;
+  }
+  try {
+    music_create::audio::WriteSmfFile(std::filesystem::path(path), smf->data);
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
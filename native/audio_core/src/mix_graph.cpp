@@ -0,0 +1,730 @@
+#include "mix_graph.hpp"
+
+#include "channel_effects.hpp"
+#include "denormals.hpp"
+#include "dynamics.hpp"
+#include "limiter.hpp"
+#include "param_tables.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+// Fixed delay for latency compensation over all channels of a node; sized by
+// Compile() so the audio thread never allocates. `in` and `out` may alias.
+class MixGraph::CompensationDelay {
+ public:
+  std::size_t Delay() const noexcept { return delay_; }
+
+  void Assign(std::size_t delay, std::size_t channels) {
+    delay_ = delay;
+    channels_ = channels;
+    ring_.assign(delay * channels, 0.0f);
+    position_ = 0;
+  }
+
+  void Reset() noexcept {
+    std::fill(ring_.begin(), ring_.end(), 0.0f);
+    position_ = 0;
+  }
+
+  void Process(const ConstAudioBufferView& in, const AudioBufferView& out) noexcept {
+    for (std::size_t n = 0; n < in.Frames(); ++n) {
+      float* slot = &ring_[position_ * channels_];
+      for (std::size_t c = 0; c < channels_; ++c) {
+        const float sample = in(c, n);
+        out(c, n) = slot[c];
+        slot[c] = sample;
+      }
+      position_ = position_ + 1 == delay_ ? 0 : position_ + 1;
+    }
+  }
+
+ private:
+  std::vector<float> ring_;  // interleaved frames
+  std::size_t delay_ = 0;
+  std::size_t channels_ = 0;
+  std::size_t position_ = 0;
+};
+
+struct MixGraph::Node {
+  struct Slot {
+    ProcessorFactory factory;
+    std::vector<std::unique_ptr<IGraphProcessor>> processors;  // one per channel pair
+    NodeId sidechain = kNoNode;
+    CompensationDelay key_delay;
+  };
+  struct Send {
+    NodeId target = kNoNode;
+    float gain = 1.0f;
+    bool pre_fader = false;
+    CompensationDelay delay;
+    ChannelMatrix matrix;  // this layout into the target's, times `gain`
+  };
+
+  struct Levels {
+    float input_gain_db = 0.0f;
+    float fader_db = 0.0f;
+    float pan = 0.0f;
+  };
+
+  // Rows of `ramp`, and the fader/pan gain each channel takes.
+  enum Row : std::size_t { kInputRow, kLeftRow, kRightRow, kCenterRow, kRows };
+
+  bool bus = false;
+  ChannelLayout layout = ChannelLayout::kStereo;
+  Levels target;
+  Levels current;  // glides towards `target` while processing
+  float gains[kRows] = {1.0f, 1.0f, 1.0f, 1.0f};
+  std::vector<float> ramp;  // per-sample gains of a glide, one block per row
+  std::vector<Slot> chain;
+  std::vector<Send> sends;
+  std::vector<float> buffer;  // one block per channel
+
+  // Set by Compile(): the fader row of every channel, where the node's
+  // channels start in the Process() inputs, the master sum matrix, and the
+  // pan a mono node's matrices were built for.
+  Row rows[kMaxLayoutChannels] = {};
+  std::size_t input_offset = 0;
+  ChannelMatrix master_matrix;
+  float matrix_pan = 0.0f;
+
+  // Set by Compile(): latency of the signal entering and leaving the chain,
+  // relative to the track inputs, and the delays that align it.
+  std::size_t input_latency = 0;
+  std::size_t output_latency = 0;
+  CompensationDelay input_delay;   // tracks keyed from a later node
+  CompensationDelay master_delay;  // into the master sum
+
+  std::size_t Channels() const noexcept { return ChannelCount(layout); }
+  float* Channel(std::size_t channel, std::size_t max_block) noexcept { return buffer.data() + channel * max_block; }
+  AudioBufferView View(std::size_t max_block, std::size_t frames) noexcept {
+    return {buffer.data(), Channels(), frames, max_block, 1};
+  }
+
+  bool Gliding() const noexcept {
+    return current.input_gain_db != target.input_gain_db || current.fader_db != target.fader_db ||
+           current.pan != target.pan;
+  }
+
+  void UpdateGains() noexcept {
+    const float fader = TableDbToGain(current.fader_db);
+    gains[kInputRow] = TableDbToGain(current.input_gain_db);
+    gains[kCenterRow] = fader;
+    if (!bus && layout == ChannelLayout::kStereo) {
+      // Equal-power pan law of the Python preview chain.
+      const PanGains pan = EqualPowerPan(current.pan);
+      gains[kLeftRow] = pan.left * fader;
+      gains[kRightRow] = pan.right * fader;
+    } else {
+      // Buses and multichannel tracks carry an image already, so pan is a
+      // balance control. (Mono has no sides; its pan is in the matrices.)
+      gains[kLeftRow] = fader * std::min(1.0f, 1.0f - current.pan);
+      gains[kRightRow] = fader * std::min(1.0f, 1.0f + current.pan);
+    }
+  }
+
+  void SnapLevels() noexcept {
+    current = target;
+    UpdateGains();
+  }
+
+  // Moves `current` one-pole towards `target` every sample and writes the
+  // resulting gains to `ramp`; snaps once the remaining step is inaudible.
+  void Glide(float coefficient, std::size_t frames, std::size_t max_block) noexcept {
+    for (std::size_t n = 0; n < frames; ++n) {
+      current.input_gain_db = target.input_gain_db + (current.input_gain_db - target.input_gain_db) * coefficient;
+      current.fader_db = target.fader_db + (current.fader_db - target.fader_db) * coefficient;
+      current.pan = target.pan + (current.pan - target.pan) * coefficient;
+      UpdateGains();
+      for (std::size_t row = 0; row < kRows; ++row) {
+        ramp[row * max_block + n] = gains[row];
+      }
+    }
+    if (std::abs(current.input_gain_db - target.input_gain_db) < kSnapDb &&
+        std::abs(current.fader_db - target.fader_db) < kSnapDb && std::abs(current.pan - target.pan) < kSnapPan) {
+      SnapLevels();
+    }
+  }
+
+  static constexpr float kSnapDb = 1e-3f;
+  static constexpr float kSnapPan = 1e-4f;
+};
+
+namespace {
+
+void Scale(float* samples, float gain, std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n) {
+    samples[n] *= gain;
+  }
+}
+
+void Multiply(float* samples, const float* gains, std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n) {
+    samples[n] *= gains[n];
+  }
+}
+
+}  // namespace
+
+MixGraph::MixGraph(std::uint32_t sample_rate, std::size_t max_block)
+    : sample_rate_(sample_rate),
+      max_block_(max_block),
+      glide_(OnePoleCoefficient(kLevelGlideMs * 0.001f * static_cast<float>(sample_rate))) {
+  if (sample_rate == 0 || max_block == 0) {
+    throw std::invalid_argument("mix graph needs a sample rate and a block size");
+  }
+  AddBus();  // kMaster
+}
+
+MixGraph::~MixGraph() = default;
+
+MixGraph::NodeId MixGraph::AddTrack() {
+  nodes_.push_back(std::make_unique<Node>());
+  compiled_ = false;
+  const auto node = static_cast<NodeId>(nodes_.size() - 1);
+  SetLevels(node, 0.0f, 0.0f, 0.0f);
+  return node;
+}
+
+MixGraph::NodeId MixGraph::AddBus() {
+  nodes_.push_back(std::make_unique<Node>());
+  nodes_.back()->bus = true;
+  compiled_ = false;
+  return static_cast<NodeId>(nodes_.size() - 1);
+}
+
+MixGraph::Node& MixGraph::At(NodeId node) {
+  if (node < 0 || static_cast<std::size_t>(node) >= nodes_.size()) {
+    throw std::out_of_range("unknown mix graph node");
+  }
+  return *nodes_[static_cast<std::size_t>(node)];
+}
+
+void MixGraph::SetLevels(NodeId node, float input_gain_db, float fader_db, float pan) {
+  Node& target = At(node);
+  target.target = {input_gain_db, fader_db, std::clamp(pan, -1.0f, 1.0f)};
+  if (!compiled_) {
+    target.SnapLevels();
+  }
+}
+
+void MixGraph::SetLayout(NodeId node, ChannelLayout layout) {
+  Node& target = At(node);
+  target.layout = layout;
+  target.SnapLevels();
+  compiled_ = false;
+}
+
+ChannelLayout MixGraph::Layout(NodeId node) const {
+  if (node < 0 || static_cast<std::size_t>(node) >= nodes_.size()) {
+    throw std::out_of_range("unknown mix graph node");
+  }
+  return nodes_[static_cast<std::size_t>(node)]->layout;
+}
+
+bool MixGraph::IsBus(NodeId node) const {
+  if (node < 0 || static_cast<std::size_t>(node) >= nodes_.size()) {
+    throw std::out_of_range("unknown mix graph node");
+  }
+  return nodes_[static_cast<std::size_t>(node)]->bus;
+}
+
+void MixGraph::AddSend(NodeId source, NodeId target, float level_db, bool pre_fader) {
+  Node& from = At(source);
+  if (!At(target).bus || source == target) {
+    throw std::invalid_argument("sends must target another bus");
+  }
+  from.sends.push_back({target, DbToGain(level_db), pre_fader, {}, {}});
+  compiled_ = false;
+}
+
+void MixGraph::AddProcessor(NodeId node, ProcessorFactory factory, NodeId sidechain) {
+  std::unique_ptr<IGraphProcessor> processor = factory ? factory() : nullptr;
+  if (processor == nullptr) {
+    throw std::invalid_argument("processor is null");
+  }
+  Node& target = At(node);
+  if (sidechain != kNoNode) {
+    At(sidechain);
+  }
+  target.chain.push_back({std::move(factory), {}, sidechain == node ? kNoNode : sidechain, {}});
+  target.chain.back().processors.push_back(std::move(processor));
+  compiled_ = false;
+}
+
+void MixGraph::Compile() {
+  // Kahn's algorithm over "must run before" edges: every node feeds the
+  // master, its send targets, and the nodes that key from it.
+  const std::size_t count = nodes_.size();
+  std::vector<std::vector<NodeId>> after(count);
+  std::vector<std::size_t> pending(count, 0);
+  const auto add_edge = [&](NodeId from, NodeId to) {
+    after[static_cast<std::size_t>(from)].push_back(to);
+    ++pending[static_cast<std::size_t>(to)];
+  };
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto id = static_cast<NodeId>(i);
+    if (id != kMaster) {
+      add_edge(id, kMaster);
+    }
+    for (const Node::Send& send : nodes_[i]->sends) {
+      add_edge(id, send.target);
+    }
+    for (const Node::Slot& slot : nodes_[i]->chain) {
+      if (slot.sidechain != kNoNode) {
+        add_edge(slot.sidechain, id);
+      }
+    }
+  }
+
+  std::vector<NodeId> order;
+  order.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (pending[i] == 0) {
+      order.push_back(static_cast<NodeId>(i));
+    }
+  }
+  for (std::size_t head = 0; head < order.size(); ++head) {
+    for (const NodeId next : after[static_cast<std::size_t>(order[head])]) {
+      if (--pending[static_cast<std::size_t>(next)] == 0) {
+        order.push_back(next);
+      }
+    }
+  }
+  if (order.size() != count) {
+    throw std::runtime_error("mix graph routing forms a cycle");
+  }
+
+  std::size_t input_offset = 0;
+  for (auto& node : nodes_) {
+    const std::size_t channels = node->Channels();
+    const std::size_t pairs = (channels + 1) / 2;
+    for (Node::Slot& slot : node->chain) {
+      slot.processors.resize(std::min(slot.processors.size(), pairs));
+      while (slot.processors.size() < pairs) {
+        std::unique_ptr<IGraphProcessor> processor = slot.factory();
+        if (processor == nullptr) {
+          throw std::invalid_argument("processor is null");
+        }
+        slot.processors.push_back(std::move(processor));
+      }
+    }
+    for (std::size_t c = 0; c < channels; ++c) {
+      const int side = SpeakerSide(SpeakerAt(node->layout, c));
+      node->rows[c] = side < 0 ? Node::kLeftRow : side > 0 ? Node::kRightRow : Node::kCenterRow;
+    }
+    node->input_offset = input_offset;
+    input_offset += channels;
+    node->buffer.assign(max_block_ * channels, 0.0f);
+    node->ramp.assign(max_block_ * Node::kRows, 0.0f);
+  }
+  for (auto& node : nodes_) {
+    BuildMatrices(*node);
+  }
+  scratch_.assign(max_block_ * (kMaxLayoutChannels + 1), 0.0f);
+  order_ = std::move(order);
+  CompensateLatency();
+  compiled_ = true;
+}
+
+void MixGraph::BuildMatrices(Node& node) {
+  const auto edge = [&](NodeId target, float gain) {
+    const ChannelLayout to = nodes_[static_cast<std::size_t>(target)]->layout;
+    ChannelMatrix matrix =
+        node.layout == ChannelLayout::kMono ? PanMatrix(to, node.current.pan) : DownmixMatrix(node.layout, to);
+    matrix *= gain;
+    return matrix;
+  };
+  node.master_matrix = edge(kMaster, 1.0f);
+  for (Node::Send& send : node.sends) {
+    send.matrix = edge(send.target, send.gain);
+  }
+  node.matrix_pan = node.current.pan;
+}
+
+void MixGraph::CompensateLatency() {
+  // Every summing point waits for its latest input, and a chain starts late
+  // enough that its sidechain keys are never behind the keyed signal; the
+  // earlier paths get delay lines for the difference.
+  for (auto& node : nodes_) {
+    node->input_latency = 0;
+  }
+  for (const NodeId id : order_) {
+    Node& node = *nodes_[static_cast<std::size_t>(id)];
+    std::size_t prefix = 0;
+    for (const Node::Slot& slot : node.chain) {
+      if (slot.sidechain != kNoNode) {
+        const std::size_t key = nodes_[static_cast<std::size_t>(slot.sidechain)]->output_latency;
+        node.input_latency = std::max(node.input_latency, key > prefix ? key - prefix : 0);
+      }
+      prefix += slot.processors.front()->Latency();
+    }
+    node.output_latency = node.input_latency + prefix;
+    for (const Node::Send& send : node.sends) {
+      Node& target = *nodes_[static_cast<std::size_t>(send.target)];
+      target.input_latency = std::max(target.input_latency, node.output_latency);
+    }
+    if (id != kMaster) {
+      Node& master = *nodes_[kMaster];
+      master.input_latency = std::max(master.input_latency, node.output_latency);
+    }
+  }
+
+  const std::size_t master_latency = nodes_[kMaster]->input_latency;
+  for (auto& node : nodes_) {
+    const std::size_t channels = node->Channels();
+    node->input_delay.Assign(node->bus ? 0 : node->input_latency, channels);
+    node->master_delay.Assign(master_latency - std::min(master_latency, node->output_latency), channels);
+    for (Node::Send& send : node->sends) {
+      send.delay.Assign(nodes_[static_cast<std::size_t>(send.target)]->input_latency - node->output_latency,
+                        channels);
+    }
+    std::size_t prefix = node->input_latency;
+    for (Node::Slot& slot : node->chain) {
+      std::size_t key = prefix;
+      std::size_t key_channels = channels;
+      if (slot.sidechain != kNoNode) {
+        const Node& source = *nodes_[static_cast<std::size_t>(slot.sidechain)];
+        key = source.output_latency;
+        key_channels = source.Channels();
+      }
+      slot.key_delay.Assign(prefix - key, key_channels);
+      prefix += slot.processors.front()->Latency();
+    }
+  }
+}
+
+std::size_t MixGraph::Latency() const noexcept {
+  return compiled_ ? nodes_[kMaster]->output_latency : 0;
+}
+
+std::size_t MixGraph::NodeLatency(NodeId node) const {
+  if (node < 0 || static_cast<std::size_t>(node) >= nodes_.size()) {
+    throw std::out_of_range("unknown mix graph node");
+  }
+  return compiled_ ? nodes_[static_cast<std::size_t>(node)]->output_latency : 0;
+}
+
+bool MixGraph::Process(const float* const* inputs, float* const* outputs, std::size_t frames) noexcept {
+  if (!compiled_) {
+    return false;
+  }
+  Node& master = *nodes_[kMaster];
+  for (std::size_t offset = 0; offset < frames; offset += max_block_) {
+    const std::size_t block = std::min(max_block_, frames - offset);
+    ProcessBlock(inputs, offset, block);
+    for (std::size_t c = 0; c < master.Channels(); ++c) {
+      std::copy_n(master.Channel(c, max_block_), block, outputs[c] + offset);
+    }
+  }
+  return true;
+}
+
+void MixGraph::ProcessBlock(const float* const* inputs, std::size_t offset, std::size_t frames) noexcept {
+  for (auto& node : nodes_) {
+    if (node->bus) {
+      std::fill(node->buffer.begin(), node->buffer.end(), 0.0f);
+    }
+  }
+  for (const NodeId id : order_) {
+    Node& node = *nodes_[static_cast<std::size_t>(id)];
+    const std::size_t channels = node.Channels();
+    if (!node.bus) {
+      for (std::size_t c = 0; c < channels; ++c) {
+        const float* in = inputs == nullptr ? nullptr : inputs[node.input_offset + c];
+        float* out = node.Channel(c, max_block_);
+        if (in == nullptr) {
+          std::fill_n(out, frames, 0.0f);
+        } else {
+          std::copy_n(in + offset, frames, out);
+        }
+      }
+      if (node.input_delay.Delay() > 0) {
+        node.input_delay.Process(node.View(max_block_, frames), node.View(max_block_, frames));
+      }
+    }
+    const bool gliding = node.Gliding();
+    if (gliding) {
+      node.Glide(glide_, frames, max_block_);
+    }
+    for (std::size_t c = 0; c < channels; ++c) {
+      if (gliding) {
+        Multiply(node.Channel(c, max_block_), node.ramp.data() + Node::kInputRow * max_block_, frames);
+      } else {
+        Scale(node.Channel(c, max_block_), node.gains[Node::kInputRow], frames);
+      }
+    }
+
+    RunChain(node, frames);
+
+    if (node.layout == ChannelLayout::kMono && node.current.pan != node.matrix_pan) {
+      // A mono node pans through its sum matrices, so a pan glide moves
+      // them once per block.
+      BuildMatrices(node);
+    }
+    for (bool pre_fader : {true, false}) {
+      for (std::size_t c = 0; !pre_fader && c < channels; ++c) {
+        const Node::Row row = node.rows[c];
+        if (gliding) {
+          Multiply(node.Channel(c, max_block_), node.ramp.data() + row * max_block_, frames);
+        } else {
+          Scale(node.Channel(c, max_block_), node.gains[row], frames);
+        }
+      }
+      for (Node::Send& send : node.sends) {
+        if (send.pre_fader == pre_fader) {
+          SumInto(node, *nodes_[static_cast<std::size_t>(send.target)], send.matrix, send.delay, frames);
+        }
+      }
+    }
+    if (id != kMaster) {
+      SumInto(node, *nodes_[kMaster], node.master_matrix, node.master_delay, frames);
+    }
+  }
+}
+
+void MixGraph::RunChain(Node& node, std::size_t frames) noexcept {
+  const std::size_t channels = node.Channels();
+  for (Node::Slot& slot : node.chain) {
+    AudioBufferView key;
+    if (slot.sidechain != kNoNode) {
+      // Already processed this block: Compile ordered the source first.
+      key = nodes_[static_cast<std::size_t>(slot.sidechain)]->View(max_block_, frames);
+      if (slot.key_delay.Delay() > 0) {
+        const AudioBufferView delayed = ScratchView(key.Channels(), frames);
+        slot.key_delay.Process(key, delayed);
+        key = delayed;
+      }
+    }
+    for (std::size_t pair = 0; pair < slot.processors.size(); ++pair) {
+      float* left = node.Channel(pair * 2, max_block_);
+      float* right = left;
+      if (pair * 2 + 1 < channels) {
+        right = node.Channel(pair * 2 + 1, max_block_);
+      } else {
+        // The odd channel out runs over a copy so it keeps its own state.
+        right = ScratchPartner();
+        std::copy_n(left, frames, right);
+      }
+      const float* key_left = left;
+      const float* key_right = right;
+      if (key.Data() != nullptr) {
+        const std::size_t key_pair = std::min(pair, (key.Channels() - 1) / 2);
+        key_left = &key(key_pair * 2, 0);
+        key_right = key_pair * 2 + 1 < key.Channels() ? &key(key_pair * 2 + 1, 0) : key_left;
+      }
+      slot.processors[pair]->Process(left, right, key_left, key_right, frames);
+    }
+  }
+}
+
+void MixGraph::SumInto(Node& source, Node& target, const ChannelMatrix& matrix, CompensationDelay& delay,
+                       std::size_t frames) noexcept {
+  ConstAudioBufferView signal = source.View(max_block_, frames);
+  if (delay.Delay() > 0) {
+    const AudioBufferView delayed = ScratchView(signal.Channels(), frames);
+    delay.Process(signal, delayed);
+    signal = delayed;
+  }
+  MixChannels(matrix, signal, target.View(max_block_, frames));
+}
+
+void MixGraph::Reset() noexcept {
+  for (auto& node : nodes_) {
+    node->SnapLevels();
+    std::fill(node->buffer.begin(), node->buffer.end(), 0.0f);
+    node->input_delay.Reset();
+    node->master_delay.Reset();
+    for (Node::Send& send : node->sends) {
+      send.delay.Reset();
+    }
+    for (Node::Slot& slot : node->chain) {
+      for (auto& processor : slot.processors) {
+        processor->Reset();
+      }
+      slot.key_delay.Reset();
+    }
+  }
+}
+
+}  // namespace music_create::audio
+
+namespace {
+
+using music_create::audio::MixGraph;
+
+// Runs a graph edit, mapping exceptions to the C API's 0/-1 failure values.
+template <typename Fn>
+int GraphCall(mc_mix_graph* graph, Fn&& fn) {
+  if (graph == nullptr) {
+    return 0;
+  }
+  try {
+    fn(graph->graph);
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+// One processor per channel pair of the node, all built from the same
+// arguments.
+template <typename Processor, typename... Args>
+MixGraph::ProcessorFactory Factory(Args... args) {
+  return [args...] { return std::make_unique<Processor>(args...); };
+}
+
+}  // namespace
+
+extern "C" {
+
+mc_mix_graph* mc_mix_graph_create(unsigned int sample_rate, unsigned int max_block) {
+  try {
+    return new mc_mix_graph(sample_rate, max_block);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_mix_graph_free(mc_mix_graph* graph) { delete graph; }
+
+int mc_mix_graph_add_node(mc_mix_graph* graph, int is_bus) {
+  if (graph == nullptr) {
+    return -1;
+  }
+  try {
+    return is_bus ? graph->graph.AddBus() : graph->graph.AddTrack();
+  } catch (...) {
+    return -1;
+  }
+}
+
+int mc_mix_graph_set_levels(mc_mix_graph* graph, int node, float input_gain_db, float fader_db, float pan) {
+  return GraphCall(graph, [&](MixGraph& g) { g.SetLevels(node, input_gain_db, fader_db, pan); });
+}
+
+int mc_mix_graph_add_send(mc_mix_graph* graph, int source, int target, float level_db, int pre_fader) {
+  return GraphCall(graph, [&](MixGraph& g) { g.AddSend(source, target, level_db, pre_fader != 0); });
+}
+
+int mc_mix_graph_set_layout(mc_mix_graph* graph, int node, int layout) {
+  if (layout < 0 || layout > static_cast<int>(music_create::audio::ChannelLayout::kSurround71)) {
+    return 0;
+  }
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.SetLayout(node, static_cast<music_create::audio::ChannelLayout>(layout));
+  });
+}
+
+int mc_mix_graph_add_eq(mc_mix_graph* graph, int node, float low_gain_db, float mid_gain_db, float high_gain_db,
+                        float low_freq_hz, float high_freq_hz) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node, Factory<music_create::audio::ThreeBandEq>(
+                             g.SampleRate(), music_create::audio::EqParams{low_gain_db, mid_gain_db, high_gain_db,
+                                                                           low_freq_hz, high_freq_hz}));
+  });
+}
+
+int mc_mix_graph_add_compressor(mc_mix_graph* graph, int node, float threshold_db, float ratio, float attack_ms,
+                                float release_ms, float makeup_db, int sidechain) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node,
+                   Factory<music_create::audio::Compressor>(
+                       g.SampleRate(),
+                       music_create::audio::CompressorParams{threshold_db, ratio, attack_ms, release_ms, makeup_db}),
+                   sidechain);
+  });
+}
+
+int mc_mix_graph_add_gate(mc_mix_graph* graph, int node, float threshold_db, float attack_ms, float release_ms,
+                          int sidechain) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node,
+                   Factory<music_create::audio::Gate>(
+                       g.SampleRate(), music_create::audio::GateParams{threshold_db, attack_ms, release_ms}),
+                   sidechain);
+  });
+}
+
+int mc_mix_graph_add_saturator(mc_mix_graph* graph, int node, float drive, float mix, unsigned int oversampling) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node, Factory<music_create::audio::Saturator>(
+                             music_create::audio::SaturatorParams{drive, mix, oversampling}));
+  });
+}
+
+int mc_mix_graph_add_reverb(mc_mix_graph* graph, int node, float mix, float decay_seconds, float pre_delay_ms,
+                            float damping, float size) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node, Factory<music_create::audio::StereoReverb>(
+                             g.SampleRate(),
+                             music_create::audio::FdnReverbParams{mix, decay_seconds, pre_delay_ms, damping, size}));
+  });
+}
+
+int mc_mix_graph_add_delay(mc_mix_graph* graph, int node, float mix, float time_beats, float tempo_bpm, float feedback,
+                           float damping) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node, Factory<music_create::audio::StereoDelay>(
+                             g.SampleRate(),
+                             music_create::audio::TempoDelayParams{mix, time_beats, tempo_bpm, feedback, damping}));
+  });
+}
+
+int mc_mix_graph_add_limiter(mc_mix_graph* graph, int node, float ceiling_db, float lookahead_ms, float release_ms) {
+  return GraphCall(graph, [&](MixGraph& g) {
+    g.AddProcessor(node, Factory<music_create::audio::Limiter>(
+                             g.SampleRate(), music_create::audio::LimiterParams{ceiling_db, lookahead_ms, release_ms}));
+  });
+}
+
+int mc_mix_graph_compile(mc_mix_graph* graph) {
+  return GraphCall(graph, [](MixGraph& g) { g.Compile(); });
+}
+
+long long mc_mix_graph_latency(const mc_mix_graph* graph) {
+  if (graph == nullptr || !graph->graph.Compiled()) {
+    return -1;
+  }
+  return static_cast<long long>(graph->graph.Latency());
+}
+
+long long mc_mix_graph_node_latency(const mc_mix_graph* graph, int node) {
+  if (graph == nullptr || !graph->graph.Compiled()) {
+    return -1;
+  }
+  try {
+    return static_cast<long long>(graph->graph.NodeLatency(node));
+  } catch (...) {
+    return -1;
+  }
+}
+
+int mc_mix_graph_process(mc_mix_graph* graph, const float* const* inputs, float* left, float* right,
+                         unsigned long long frames) {
+  if (graph == nullptr || graph->graph.Layout(MixGraph::kMaster) != music_create::audio::ChannelLayout::kStereo) {
+    return 0;
+  }
+  float* const outputs[2] = {left, right};
+  return mc_mix_graph_process_channels(graph, inputs, outputs, frames);
+}
+
+int mc_mix_graph_process_channels(mc_mix_graph* graph, const float* const* inputs, float* const* outputs,
+                                  unsigned long long frames) {
+  if (graph == nullptr || (frames > 0 && outputs == nullptr)) {
+    return 0;
+  }
+  const std::size_t channels = music_create::audio::ChannelCount(graph->graph.Layout(MixGraph::kMaster));
+  for (std::size_t c = 0; frames > 0 && c < channels; ++c) {
+    if (outputs[c] == nullptr) {
+      return 0;
+    }
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  return graph->graph.Process(inputs, outputs, static_cast<std::size_t>(frames)) ? 1 : 0;
+}
+
+}  // extern "C"
@@ -0,0 +1,255 @@
+#include "note_edit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace music_create::audio {
+
+namespace {
+
+NoteColumns Gather(const NoteStore& store, const NoteId* ids, std::size_t count) {
+  NoteColumns columns;
+  columns.ids.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (store.Contains(ids[i])) {
+      columns.ids.push_back(ids[i]);
+    }
+  }
+  const std::size_t n = columns.ids.size();
+  columns.generation.resize(n);
+  columns.start_tick.resize(n);
+  columns.length_tick.resize(n);
+  columns.pitch.resize(n);
+  columns.velocity.resize(n);
+  columns.channel.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const NoteFields& note = store.Get(columns.ids[i]);
+    columns.generation[i] = store.Generation(columns.ids[i]);
+    columns.start_tick[i] = note.start_tick;
+    columns.length_tick[i] = note.length_tick;
+    columns.pitch[i] = note.pitch;
+    columns.velocity[i] = note.velocity;
+    columns.channel[i] = note.channel;
+  }
+  return columns;
+}
+
+// A note whose id was freed and reused since the gather carries a newer
+// generation, so a snapshot never names the note that took its id.
+std::size_t Scatter(NoteStore& store, const NoteColumns& columns) {
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    if (store.Generation(columns.ids[i]) == columns.generation[i] &&
+        store.Update(columns.ids[i], {columns.start_tick[i], columns.length_tick[i], columns.pitch[i],
+                                      columns.velocity[i], columns.channel[i]})) {
+      ++written;
+    }
+  }
+  return written;
+}
+
+template <typename Kernel>
+NoteEdit ApplyKernel(NoteStore& store, const NoteId* ids, std::size_t count, Kernel&& kernel) {
+  NoteEdit edit;
+  edit.before = Gather(store, ids, count);
+  edit.after = edit.before;
+  kernel(edit.after);
+  Scatter(store, edit.after);
+  return edit;
+}
+
+// Same rounding as composition.quantize.quantize_tick: halfway goes up.
+std::int64_t RoundToStep(std::int64_t value, std::int64_t step) {
+  const std::int64_t remainder = value % step;
+  const std::int64_t lower = value - remainder;
+  return remainder * 2 < step ? lower : lower + step;
+}
+
+std::int64_t SwungGridPoint(std::int64_t index, std::int64_t step, std::int64_t swing_offset) {
+  return index * step + ((index & 1) != 0 ? swing_offset : 0);
+}
+
+std::int64_t NearestGridPoint(std::int64_t tick, std::int64_t step, std::int64_t swing_offset) {
+  if (swing_offset == 0) {
+    return RoundToStep(tick, step);
+  }
+  const std::int64_t base = tick / step;
+  std::int64_t best = SwungGridPoint(base, step, swing_offset);
+  for (const std::int64_t index : {base - 1, base + 1}) {
+    const std::int64_t candidate = SwungGridPoint(index, step, swing_offset);
+    const std::int64_t distance = std::llabs(candidate - tick);
+    const std::int64_t best_distance = std::llabs(best - tick);
+    if (distance < best_distance || (distance == best_distance && candidate > best)) {
+      best = candidate;
+    }
+  }
+  return best;
+}
+
+std::int32_t MoveToward(std::int32_t value, std::int64_t target, float strength) {
+  return static_cast<std::int32_t>(value + std::llround(static_cast<double>(strength) * (target - value)));
+}
+
+std::uint64_t SplitMix64(std::uint64_t& state) {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+std::int32_t UniformOffset(std::uint64_t& state, std::int32_t range) {
+  if (range <= 0) {
+    return 0;
+  }
+  const auto span = static_cast<std::uint64_t>(range) * 2 + 1;
+  return static_cast<std::int32_t>(SplitMix64(state) % span) - range;
+}
+
+}  // namespace
+
+NoteEdit QuantizeNotes(NoteStore& store, const NoteId* ids, std::size_t count, const QuantizeOptions& options) {
+  const std::int64_t step = std::max(options.step_ticks, 1);
+  const float strength = std::clamp(options.strength, 0.0f, 1.0f);
+  const std::int64_t swing_offset =
+      std::llround(std::clamp(options.swing, 0.0f, 1.0f) * static_cast<double>(step) / 2.0);
+  return ApplyKernel(store, ids, count, [&](NoteColumns& notes) {
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      const std::int32_t start = notes.start_tick[i];
+      const std::int64_t target = start <= 0 ? 0 : NearestGridPoint(start, step, swing_offset);
+      notes.start_tick[i] = std::max(MoveToward(start, target, strength), 0);
+    }
+    if (!options.quantize_length) {
+      return;
+    }
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      const std::int32_t length = notes.length_tick[i];
+      const std::int64_t target = std::max(step, RoundToStep(length, step));
+      notes.length_tick[i] = std::max(MoveToward(length, target, strength), 1);
+    }
+  });
+}
+
+NoteEdit TransposeNotes(NoteStore& store, const NoteId* ids, std::size_t count, int semitones) {
+  return ApplyKernel(store, ids, count, [&](NoteColumns& notes) {
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      notes.pitch[i] = static_cast<std::uint8_t>(std::clamp(notes.pitch[i] + semitones, 0, 127));
+    }
+  });
+}
+
+NoteEdit ScaleNoteVelocities(NoteStore& store, const NoteId* ids, std::size_t count, float scale, int offset) {
+  return ApplyKernel(store, ids, count, [&](NoteColumns& notes) {
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      const int scaled = static_cast<int>(std::lround(notes.velocity[i] * scale)) + offset;
+      notes.velocity[i] = static_cast<std::uint8_t>(std::clamp(scaled, 1, 127));
+    }
+  });
+}
+
+// Offsets come from SplitMix64 so a seed reproduces the same edit on every
+// platform, independent of the standard library's distributions.
+NoteEdit HumanizeNotes(NoteStore& store, const NoteId* ids, std::size_t count, const HumanizeOptions& options) {
+  return ApplyKernel(store, ids, count, [&](NoteColumns& notes) {
+    std::uint64_t state = options.seed;
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      notes.start_tick[i] = std::max(notes.start_tick[i] + UniformOffset(state, options.timing_ticks), 0);
+      notes.length_tick[i] = std::max(notes.length_tick[i] + UniformOffset(state, options.length_ticks), 1);
+      const int velocity = notes.velocity[i] + UniformOffset(state, options.velocity_range);
+      notes.velocity[i] = static_cast<std::uint8_t>(std::clamp(velocity, 1, 127));
+    }
+  });
+}
+
+std::size_t UndoNoteEdit(NoteStore& store, const NoteEdit& edit) { return Scatter(store, edit.before); }
+
+std::size_t RedoNoteEdit(NoteStore& store, const NoteEdit& edit) { return Scatter(store, edit.after); }
+
+}  // namespace music_create::audio
+
+struct mc_note_edit {
+  music_create::audio::NoteEdit edit;
+};
+
+namespace {
+
+template <typename Fn>
+mc_note_edit* RunEdit(mc_note_store* store, const unsigned int* ids, Fn&& fn) {
+  if (store == nullptr || ids == nullptr) {
+    return nullptr;
+  }
+  try {
+    auto handle = std::make_unique<mc_note_edit>();
+    handle->edit = fn(store->store);
+    return handle.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+mc_note_edit* mc_note_store_quantize(mc_note_store* store, unsigned long long count, const unsigned int* ids,
+                                     int step_ticks, float strength, float swing, int quantize_length) {
+  if (step_ticks <= 0) {
+    return nullptr;
+  }
+  return RunEdit(store, ids, [&](music_create::audio::NoteStore& notes) {
+    music_create::audio::QuantizeOptions options;
+    options.step_ticks = step_ticks;
+    options.strength = strength;
+    options.swing = swing;
+    options.quantize_length = quantize_length != 0;
+    return music_create::audio::QuantizeNotes(notes, ids, static_cast<std::size_t>(count), options);
+  });
+}
+
+mc_note_edit* mc_note_store_transpose(mc_note_store* store, unsigned long long count, const unsigned int* ids,
+                                      int semitones) {
+  return RunEdit(store, ids, [&](music_create::audio::NoteStore& notes) {
+    return music_create::audio::TransposeNotes(notes, ids, static_cast<std::size_t>(count), semitones);
+  });
+}
+
+mc_note_edit* mc_note_store_scale_velocity(mc_note_store* store, unsigned long long count, const unsigned int* ids,
+                                           float scale, int offset) {
+  return RunEdit(store, ids, [&](music_create::audio::NoteStore& notes) {
+    return music_create::audio::ScaleNoteVelocities(notes, ids, static_cast<std::size_t>(count), scale, offset);
+  });
+}
+
+mc_note_edit* mc_note_store_humanize(mc_note_store* store, unsigned long long count, const unsigned int* ids,
+                                     int timing_ticks, int length_ticks, int velocity_range, unsigned long long seed) {
+  return RunEdit(store, ids, [&](music_create::audio::NoteStore& notes) {
+    music_create::audio::HumanizeOptions options;
+    options.timing_ticks = timing_ticks;
+    options.length_ticks = length_ticks;
+    options.velocity_range = velocity_range;
+    options.seed = seed;
+    return music_create::audio::HumanizeNotes(notes, ids, static_cast<std::size_t>(count), options);
+  });
+}
+
+unsigned long long mc_note_edit_size(const mc_note_edit* edit) { return edit == nullptr ? 0 : edit->edit.after.size(); }
+
+int mc_note_edit_undo(mc_note_store* store, const mc_note_edit* edit) {
+  if (store == nullptr || edit == nullptr) {
+    return 0;
+  }
+  music_create::audio::UndoNoteEdit(store->store, edit->edit);
+  return 1;
+}
+
+int mc_note_edit_redo(mc_note_store* store, const mc_note_edit* edit) {
+  if (store == nullptr || edit == nullptr) {
+    return 0;
+  }
+  music_create::audio::RedoNoteEdit(store->store, edit->edit);
+  return 1;
+}
+
+void mc_note_edit_free(mc_note_edit* edit) { delete edit; }
+
+}  // extern "C"
@@ -0,0 +1,340 @@
+#include "note_store.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr int kLinearScanLevel = 3;
+
+struct QueryFrame {
+  int level;
+  std::int64_t node;
+  bool descended;
+};
+
+}  // namespace
+
+NoteId NoteStore::Add(const NoteFields& note) {
+  NoteId id;
+  if (!free_ids_.empty()) {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+    fields_[id] = note;
+    alive_[id] = 1;
+  } else {
+    id = static_cast<NoteId>(fields_.size());
+    fields_.push_back(note);
+    alive_.push_back(1);
+    if (generations_.size() <= id) {
+      generations_.push_back(0);
+    }
+  }
+  ++live_count_;
+  index_dirty_ = true;
+  return id;
+}
+
+bool NoteStore::Remove(NoteId id) {
+  if (!Contains(id)) {
+    return false;
+  }
+  alive_[id] = 0;
+  ++generations_[id];
+  free_ids_.push_back(id);
+  --live_count_;
+  index_dirty_ = true;
+  return true;
+}
+
+bool NoteStore::Update(NoteId id, const NoteFields& note) {
+  if (!Contains(id)) {
+    return false;
+  }
+  fields_[id] = note;
+  index_dirty_ = true;
+  return true;
+}
+
+void NoteStore::Clear() {
+  fields_.clear();
+  alive_.clear();
+  free_ids_.clear();
+  for (auto& generation : generations_) {
+    ++generation;
+  }
+  live_count_ = 0;
+  index_dirty_ = true;
+}
+
+const std::vector<NoteId>& NoteStore::SortedIds() const {
+  EnsureIndex();
+  return sorted_ids_;
+}
+
+// Builds the implicit interval tree of cgranges (Li, 2019): in the sorted
+// array, a node at index i has level = number of trailing one bits of i, and
+// subtree_max_end_[i] holds the largest end in its subtree.
+void NoteStore::EnsureIndex() const {
+  if (!index_dirty_) {
+    return;
+  }
+  sorted_ids_.clear();
+  sorted_ids_.reserve(live_count_);
+  for (NoteId id = 0; id < alive_.size(); ++id) {
+    if (alive_[id] != 0) {
+      sorted_ids_.push_back(id);
+    }
+  }
+  std::sort(sorted_ids_.begin(), sorted_ids_.end(), [this](NoteId lhs, NoteId rhs) {
+    const NoteFields& a = fields_[lhs];
+    const NoteFields& b = fields_[rhs];
+    if (a.start_tick != b.start_tick) {
+      return a.start_tick < b.start_tick;
+    }
+    return a.pitch != b.pitch ? a.pitch < b.pitch : lhs < rhs;
+  });
+
+  const std::size_t n = sorted_ids_.size();
+  sorted_start_.resize(n);
+  sorted_end_.resize(n);
+  sorted_pitch_.resize(n);
+  subtree_max_end_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const NoteFields& note = fields_[sorted_ids_[i]];
+    sorted_start_[i] = note.start_tick;
+    sorted_end_[i] = static_cast<std::int64_t>(note.start_tick) + std::max(note.length_tick, 1);
+    sorted_pitch_[i] = note.pitch;
+  }
+
+  max_level_ = -1;
+  if (n > 0) {
+    std::int64_t last_index = 0;
+    std::int64_t last_end = 0;
+    for (std::size_t i = 0; i < n; i += 2) {
+      last_index = static_cast<std::int64_t>(i);
+      last_end = subtree_max_end_[i] = sorted_end_[i];
+    }
+    int level = 1;
+    for (; (std::int64_t{1} << level) <= static_cast<std::int64_t>(n); ++level) {
+      const std::int64_t half = std::int64_t{1} << (level - 1);
+      const std::int64_t first = (half << 1) - 1;
+      const std::int64_t step = half << 2;
+      for (std::int64_t i = first; i < static_cast<std::int64_t>(n); i += step) {
+        const std::int64_t left = subtree_max_end_[i - half];
+        const std::int64_t right = i + half < static_cast<std::int64_t>(n) ? subtree_max_end_[i + half] : last_end;
+        subtree_max_end_[i] = std::max({sorted_end_[i], left, right});
+      }
+      last_index = ((last_index >> level) & 1) != 0 ? last_index - half : last_index + half;
+      if (last_index < static_cast<std::int64_t>(n)) {
+        last_end = std::max(last_end, subtree_max_end_[last_index]);
+      }
+    }
+    max_level_ = level - 1;
+  }
+  index_dirty_ = false;
+}
+
+void NoteStore::QueryOverlapping(std::int64_t begin, std::int64_t end, std::uint8_t pitch_low, std::uint8_t pitch_high,
+                                 std::vector<NoteId>& out) const {
+  EnsureIndex();
+  const auto n = static_cast<std::int64_t>(sorted_ids_.size());
+  if (n == 0 || begin >= end) {
+    return;
+  }
+  const auto emit = [&](std::int64_t i) {
+    if (begin < sorted_end_[i] && sorted_pitch_[i] >= pitch_low && sorted_pitch_[i] <= pitch_high) {
+      out.push_back(sorted_ids_[i]);
+    }
+  };
+
+  QueryFrame stack[64];
+  int top = 0;
+  stack[top++] = {max_level_, (std::int64_t{1} << max_level_) - 1, false};
+  while (top > 0) {
+    const QueryFrame frame = stack[--top];
+    if (frame.level <= kLinearScanLevel) {
+      const std::int64_t first = (frame.node >> frame.level) << frame.level;
+      const std::int64_t last = std::min(first + (std::int64_t{1} << (frame.level + 1)) - 1, n);
+      for (std::int64_t i = first; i < last && sorted_start_[i] < end; ++i) {
+        emit(i);
+      }
+    } else if (!frame.descended) {
+      const std::int64_t left = frame.node - (std::int64_t{1} << (frame.level - 1));
+      stack[top++] = {frame.level, frame.node, true};
+      if (left >= n || subtree_max_end_[left] > begin) {
+        stack[top++] = {frame.level - 1, left, false};
+      }
+    } else if (frame.node < n && sorted_start_[frame.node] < end) {
+      emit(frame.node);
+      stack[top++] = {frame.level - 1, frame.node + (std::int64_t{1} << (frame.level - 1)), false};
+    }
+  }
+}
+
+void NoteStore::QueryStarting(std::int64_t begin, std::int64_t end, std::vector<NoteId>& out) const {
+  EnsureIndex();
+  auto it = std::lower_bound(sorted_start_.begin(), sorted_start_.end(), begin,
+                             [](std::int32_t start, std::int64_t value) { return start < value; });
+  for (; it != sorted_start_.end() && *it < end; ++it) {
+    out.push_back(sorted_ids_[static_cast<std::size_t>(it - sorted_start_.begin())]);
+  }
+}
+
+}  // namespace music_create::audio
+
+namespace {
+
+unsigned long long CopyIds(const std::vector<music_create::audio::NoteId>& ids, unsigned int* out_ids,
+                           unsigned long long capacity) {
+  if (out_ids != nullptr) {
+    std::copy_n(ids.begin(), std::min<unsigned long long>(capacity, ids.size()), out_ids);
+  }
+  return ids.size();
+}
+
+}  // namespace
+
+extern "C" {
+
+mc_note_store* mc_note_store_create() { return new mc_note_store(); }
+
+void mc_note_store_free(mc_note_store* store) { delete store; }
+
+void mc_note_store_clear(mc_note_store* store) {
+  if (store != nullptr) {
+    store->store.Clear();
+  }
+}
+
+unsigned long long mc_note_store_size(const mc_note_store* store) {
+  return store == nullptr ? 0 : store->store.size();
+}
+
+int mc_note_store_add(mc_note_store* store, unsigned long long count, const int* start_tick, const int* length_tick,
+                      const unsigned char* pitch, const unsigned char* velocity, const unsigned char* channel,
+                      unsigned int* out_ids) {
+  if (store == nullptr || start_tick == nullptr || length_tick == nullptr || pitch == nullptr || velocity == nullptr) {
+    return 0;
+  }
+  try {
+    for (unsigned long long i = 0; i < count; ++i) {
+      const music_create::audio::NoteFields note{
+          std::max(start_tick[i], 0),
+          std::max(length_tick[i], 1),
+          static_cast<std::uint8_t>(pitch[i] & 0x7F),
+          static_cast<std::uint8_t>(velocity[i] & 0x7F),
+          static_cast<std::uint8_t>(channel == nullptr ? 0 : channel[i] & 0x0F),
+      };
+      const auto id = store->store.Add(note);
+      if (out_ids != nullptr) {
+        out_ids[i] = id;
+      }
+    }
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+unsigned long long mc_note_store_remove(mc_note_store* store, unsigned long long count, const unsigned int* ids) {
+  if (store == nullptr || ids == nullptr) {
+    return 0;
+  }
+  unsigned long long removed = 0;
+  for (unsigned long long i = 0; i < count; ++i) {
+    removed += store->store.Remove(ids[i]) ? 1 : 0;
+  }
+  return removed;
+}
+
+int mc_note_store_update(mc_note_store* store, unsigned int id, int start_tick, int length_tick, unsigned char pitch,
+                         unsigned char velocity, unsigned char channel) {
+  if (store == nullptr) {
+    return 0;
+  }
+  const music_create::audio::NoteFields note{
+      std::max(start_tick, 0),
+      std::max(length_tick, 1),
+      static_cast<std::uint8_t>(pitch & 0x7F),
+      static_cast<std::uint8_t>(velocity & 0x7F),
+      static_cast<std::uint8_t>(channel & 0x0F),
+  };
+  return store->store.Update(id, note) ? 1 : 0;
+}
+
+int mc_note_store_get(const mc_note_store* store, unsigned long long count, const unsigned int* ids, int* start_tick,
+                      int* length_tick, unsigned char* pitch, unsigned char* velocity, unsigned char* channel) {
+  if (store == nullptr || ids == nullptr) {
+    return 0;
+  }
+  for (unsigned long long i = 0; i < count; ++i) {
+    if (!store->store.Contains(ids[i])) {
+      return 0;
+    }
+  }
+  for (unsigned long long i = 0; i < count; ++i) {
+    const auto& note = store->store.Get(ids[i]);
+    if (start_tick != nullptr) {
+      start_tick[i] = note.start_tick;
+    }
+    if (length_tick != nullptr) {
+      length_tick[i] = note.length_tick;
+    }
+    if (pitch != nullptr) {
+      pitch[i] = note.pitch;
+    }
+    if (velocity != nullptr) {
+      velocity[i] = note.velocity;
+    }
+    if (channel != nullptr) {
+      channel[i] = note.channel;
+    }
+  }
+  return 1;
+}
+
+unsigned long long mc_note_store_query(const mc_note_store* store, long long begin_tick, long long end_tick,
+                                       unsigned char pitch_low, unsigned char pitch_high, unsigned int* out_ids,
+                                       unsigned long long capacity) {
+  if (store == nullptr) {
+    return 0;
+  }
+  try {
+    store->scratch.clear();
+    store->store.QueryOverlapping(begin_tick, end_tick, pitch_low, pitch_high, store->scratch);
+    return CopyIds(store->scratch, out_ids, capacity);
+  } catch (...) {
+    return 0;
+  }
+}
+
+unsigned long long mc_note_store_query_starting(const mc_note_store* store, long long begin_tick, long long end_tick,
+                                                unsigned int* out_ids, unsigned long long capacity) {
+  if (store == nullptr) {
+    return 0;
+  }
+  try {
+    store->scratch.clear();
+    store->store.QueryStarting(begin_tick, end_tick, store->scratch);
+    return CopyIds(store->scratch, out_ids, capacity);
+  } catch (...) {
+    return 0;
+  }
+}
+
+unsigned long long mc_note_store_sorted_ids(const mc_note_store* store, unsigned int* out_ids,
+                                            unsigned long long capacity) {
+  if (store == nullptr) {
+    return 0;
+  }
+  try {
+    return CopyIds(store->store.SortedIds(), out_ids, capacity);
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
@@ -0,0 +1,223 @@
+#include "oversampler.hpp"
+
+#include "cpu_features.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+// Halfband lengths per cascade stage; later stages only have to reject the
+// images of an already band-limited signal, so a shorter filter suffices.
+constexpr std::size_t kStageHalfTaps[] = {12, 5, 4};
+constexpr double kKaiserBeta = 8.0;  // about 80 dB stopband
+
+double BesselI0(double x) noexcept {
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+void FirBlockScalar(const float* in, const float* taps, std::size_t tap_count, float* out,
+                    std::size_t count) noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    float acc = 0.0f;
+    for (std::size_t j = 0; j < tap_count; ++j) {
+      acc += taps[j] * in[i + j];
+    }
+    out[i] = acc;
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+
+// Vectorized across outputs: each tap scales a window of consecutive inputs.
+MC_AUDIO_TARGET("sse4.1")
+void FirBlockSse41(const float* in, const float* taps, std::size_t tap_count, float* out, std::size_t count) noexcept {
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 acc = _mm_setzero_ps();
+    for (std::size_t j = 0; j < tap_count; ++j) {
+      acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps[j]), _mm_loadu_ps(in + i + j)));
+    }
+    _mm_storeu_ps(out + i, acc);
+  }
+  FirBlockScalar(in + i, taps, tap_count, out + i, count - i);
+}
+
+MC_AUDIO_TARGET("avx2,fma")
+void FirBlockAvx2(const float* in, const float* taps, std::size_t tap_count, float* out, std::size_t count) noexcept {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 acc = _mm256_setzero_ps();
+    for (std::size_t j = 0; j < tap_count; ++j) {
+      acc = _mm256_fmadd_ps(_mm256_set1_ps(taps[j]), _mm256_loadu_ps(in + i + j), acc);
+    }
+    _mm256_storeu_ps(out + i, acc);
+  }
+  FirBlockScalar(in + i, taps, tap_count, out + i, count - i);
+}
+
+#endif
+
+using FirBlockFn = void (*)(const float*, const float*, std::size_t, float*, std::size_t) noexcept;
+
+FirBlockFn SelectFirBlock() noexcept {
+#if MC_AUDIO_X86_DISPATCH
+  const CpuFeatures& cpu = DetectCpuFeatures();
+  if (cpu.avx2 && cpu.fma) {
+    return FirBlockAvx2;
+  }
+  if (cpu.sse41) {
+    return FirBlockSse41;
+  }
+#endif
+  return FirBlockScalar;
+}
+
+// Keeps the last `history` samples of `buffer` (history + frames long) in
+// front for the next block.
+void ShiftHistory(std::vector<float>& buffer, std::size_t history, std::size_t frames) noexcept {
+  std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(frames), history, buffer.begin());
+}
+
+}  // namespace
+
+void FirBlock(const float* in, const float* taps, std::size_t tap_count, float* out, std::size_t count) noexcept {
+  static const FirBlockFn kernel = SelectFirBlock();
+  kernel(in, taps, tap_count, out, count);
+}
+
+HalfbandStage::HalfbandStage(std::size_t half_taps, std::size_t max_frames) : half_taps_(half_taps) {
+  const std::size_t branch = 2 * half_taps;
+  const double center = static_cast<double>(Center());
+  const double length = static_cast<double>(4 * half_taps - 1);
+  taps_.resize(branch);
+  double sum = 0.0;
+  for (std::size_t j = 0; j < branch; ++j) {
+    // Even taps of the full filter sit at odd distances from the center.
+    const double offset = 2.0 * static_cast<double>(j) - center;
+    const double ratio = offset / ((length - 1.0) / 2.0);
+    const double window = BesselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) /
+                          BesselI0(kKaiserBeta);
+    const double sinc = std::sin(std::numbers::pi * offset / 2.0) / (std::numbers::pi * offset);
+    taps_[j] = static_cast<float>(sinc * window);
+    sum += sinc * window;
+  }
+  // The delay branch contributes 0.5; scale the FIR branch to unity DC gain.
+  for (float& tap : taps_) {
+    tap = static_cast<float>(tap * (0.5 / sum));
+  }
+  // The branch is symmetric, so it is already reversed for FirBlock.
+  up_input_.assign(branch - 1 + max_frames, 0.0f);
+  down_even_.assign(branch - 1 + max_frames, 0.0f);
+  down_odd_.assign(half_taps + max_frames, 0.0f);
+  branch_.assign(max_frames, 0.0f);
+}
+
+void HalfbandStage::Upsample(const float* in, float* out, std::size_t frames) noexcept {
+  const std::size_t history = 2 * half_taps_ - 1;
+  std::copy_n(in, frames, up_input_.begin() + static_cast<std::ptrdiff_t>(history));
+  FirBlock(up_input_.data(), taps_.data(), taps_.size(), branch_.data(), frames);
+  for (std::size_t n = 0; n < frames; ++n) {
+    // Zero stuffing halves the level, hence the factor of two.
+    out[2 * n] = 2.0f * branch_[n];
+    out[2 * n + 1] = up_input_[n + half_taps_];
+  }
+  ShiftHistory(up_input_, history, frames);
+}
+
+void HalfbandStage::Downsample(const float* in, float* out, std::size_t frames) noexcept {
+  const std::size_t even_history = 2 * half_taps_ - 1;
+  for (std::size_t n = 0; n < frames; ++n) {
+    down_even_[even_history + n] = in[2 * n];
+    down_odd_[half_taps_ + n] = in[2 * n + 1];
+  }
+  FirBlock(down_even_.data(), taps_.data(), taps_.size(), out, frames);
+  for (std::size_t n = 0; n < frames; ++n) {
+    out[n] += 0.5f * down_odd_[n];
+  }
+  ShiftHistory(down_even_, even_history, frames);
+  ShiftHistory(down_odd_, half_taps_, frames);
+}
+
+void HalfbandStage::Reset() noexcept {
+  std::fill(up_input_.begin(), up_input_.end(), 0.0f);
+  std::fill(down_even_.begin(), down_even_.end(), 0.0f);
+  std::fill(down_odd_.begin(), down_odd_.end(), 0.0f);
+}
+
+Oversampler::Oversampler(std::size_t factor, std::size_t max_frames) : factor_(factor) {
+  if ((factor != 1 && factor != 2 && factor != 4 && factor != 8) || max_frames == 0) {
+    throw std::invalid_argument("oversampling factor must be 1, 2, 4 or 8");
+  }
+  // Each stage delays by Center() on the way up and again on the way down,
+  // at its own high rate; count that at the top rate and pad to a multiple
+  // of the factor.
+  std::size_t top_latency = 0;
+  std::size_t frames = max_frames;
+  for (std::size_t stage = 0; (std::size_t{2} << stage) <= factor; ++stage) {
+    stages_.emplace_back(kStageHalfTaps[stage], frames);
+    frames *= 2;
+    buffers_.emplace_back(frames, 0.0f);
+    top_latency += 2 * stages_.back().Center() * (factor >> (stage + 1));
+  }
+  if (stages_.empty()) {
+    buffers_.emplace_back(max_frames, 0.0f);
+  }
+  pad_.assign((factor - top_latency % factor) % factor, 0.0f);
+  latency_ = (top_latency + pad_.size()) / factor;
+}
+
+float* Oversampler::Upsample(const float* in, std::size_t frames) noexcept {
+  if (stages_.empty()) {
+    std::copy_n(in, frames, buffers_[0].data());
+    return buffers_[0].data();
+  }
+  const float* source = in;
+  for (std::size_t stage = 0; stage < stages_.size(); ++stage) {
+    stages_[stage].Upsample(source, buffers_[stage].data(), frames << stage);
+    source = buffers_[stage].data();
+  }
+  return buffers_.back().data();
+}
+
+void Oversampler::Downsample(float* out, std::size_t frames) noexcept {
+  if (stages_.empty()) {
+    std::copy_n(buffers_[0].data(), frames, out);
+    return;
+  }
+  float* top = buffers_.back().data();
+  if (!pad_.empty()) {
+    for (std::size_t n = 0; n < frames * factor_; ++n) {
+      std::swap(top[n], pad_[pad_position_]);
+      pad_position_ = pad_position_ + 1 == pad_.size() ? 0 : pad_position_ + 1;
+    }
+  }
+  for (std::size_t stage = stages_.size(); stage-- > 0;) {
+    float* target = stage == 0 ? out : buffers_[stage - 1].data();
+    stages_[stage].Downsample(buffers_[stage].data(), target, frames << stage);
+  }
+}
+
+void Oversampler::Reset() noexcept {
+  for (HalfbandStage& stage : stages_) {
+    stage.Reset();
+  }
+  std::fill(pad_.begin(), pad_.end(), 0.0f);
+  pad_position_ = 0;
+}
+
+}  // namespace music_create::audio
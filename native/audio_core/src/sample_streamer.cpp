@@ -0,0 +1,274 @@
+#include "sample_streamer.hpp"
+
+#include "denormals.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+// Slot state packs the owner generation with the first frame not yet written,
+// so a fill that raced with Release/Acquire fails its publish instead of
+// exposing frames of the previous sample.
+constexpr int kFrameBits = 48;
+constexpr std::uint64_t kFrameMask = (std::uint64_t{1} << kFrameBits) - 1;
+constexpr auto kIdlePoll = std::chrono::milliseconds(2);
+
+constexpr std::uint64_t PackState(std::uint64_t generation, std::uint64_t frame) noexcept {
+  return (generation << kFrameBits) | (frame & kFrameMask);
+}
+
+}  // namespace
+
+std::uint64_t StreamSource::SourceFrame(std::uint64_t virtual_frame) const noexcept {
+  if (!loop || virtual_frame < loop_end) {
+    return virtual_frame;
+  }
+  return loop_start + (virtual_frame - loop_start) % (loop_end - loop_start);
+}
+
+struct SampleStreamer::Slot {
+  explicit Slot(std::size_t ring_frames) : ring(ring_frames * 2, 0.0f) {}
+
+  std::atomic<bool> busy{false};
+  std::atomic<std::uint64_t> state{0};
+  std::atomic<std::uint64_t> read_frame{0};
+  std::atomic<std::uint64_t> failed_generation{~std::uint64_t{0}};
+  std::atomic<const StreamSource*> source{nullptr};
+  std::vector<float> ring;  // stereo frames, virtual frame v at v % ring_frames
+
+  // Prefetch-thread only.
+  std::unique_ptr<IAudioFileReader> reader;
+  const StreamSource* reader_source = nullptr;
+  std::uint64_t reader_generation = ~std::uint64_t{0};
+};
+
+SampleStreamer::SampleStreamer(std::size_t slot_count, std::size_t ring_frames) : ring_frames_(ring_frames) {
+  if (slot_count == 0 || ring_frames < kFillChunkFrames * 2) {
+    throw std::invalid_argument("streamer needs at least one slot and two fill chunks of ring");
+  }
+  slots_.reserve(slot_count);
+  for (std::size_t i = 0; i < slot_count; ++i) {
+    slots_.push_back(std::make_unique<Slot>(ring_frames));
+  }
+  thread_ = std::thread([this] { Run(); });
+}
+
+SampleStreamer::~SampleStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_.store(true);
+  }
+  wake_cv_.notify_all();
+  filled_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+int SampleStreamer::Acquire(const StreamSource& source, std::uint64_t first) noexcept {
+  for (std::size_t i = 0; i < slots_.size(); ++i) {
+    Slot& slot = *slots_[i];
+    bool expected = false;
+    if (!slot.busy.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      continue;
+    }
+    const std::uint64_t generation = (slot.state.load(std::memory_order_relaxed) >> kFrameBits) + 1;
+    slot.source.store(&source, std::memory_order_relaxed);
+    slot.read_frame.store(first, std::memory_order_relaxed);
+    slot.state.store(PackState(generation, first), std::memory_order_release);
+    wake_.store(true, std::memory_order_release);
+    return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void SampleStreamer::Release(int slot) noexcept {
+  if (slot < 0 || static_cast<std::size_t>(slot) >= slots_.size()) {
+    return;
+  }
+  slots_[static_cast<std::size_t>(slot)]->busy.store(false, std::memory_order_release);
+}
+
+bool SampleStreamer::Fetch(int slot_id, std::uint64_t first, std::size_t count, float* out, bool wait) {
+  if (slot_id < 0 || static_cast<std::size_t>(slot_id) >= slots_.size()) {
+    return false;
+  }
+  Slot& slot = *slots_[static_cast<std::size_t>(slot_id)];
+  const StreamSource& source = *slot.source.load(std::memory_order_relaxed);
+  slot.read_frame.store(first, std::memory_order_release);
+
+  // Frames past a one-shot's end are silence and never come from disk.
+  const std::uint64_t wanted_end = first + count;
+  const std::uint64_t disk_end = source.loop ? wanted_end : std::clamp(source.total_frames, first, wanted_end);
+  if (count > ring_frames_) {
+    return false;
+  }
+
+  if (disk_end > first && (slot.state.load(std::memory_order_acquire) & kFrameMask) < disk_end) {
+    if (!wait) {
+      underruns_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (!AwaitFrames(slot, disk_end, std::chrono::steady_clock::time_point::max())) {
+      return false;
+    }
+  }
+
+  std::uint64_t frame = first;
+  for (; frame < disk_end; ++frame) {
+    const std::size_t at = static_cast<std::size_t>(frame % ring_frames_) * 2;
+    out[(frame - first) * 2] = slot.ring[at];
+    out[(frame - first) * 2 + 1] = slot.ring[at + 1];
+  }
+  std::fill(out + (disk_end - first) * 2, out + count * 2, 0.0f);
+  return true;
+}
+
+bool SampleStreamer::Peek(int slot_id, std::uint64_t first, std::size_t count, float* out) const noexcept {
+  if (slot_id < 0 || static_cast<std::size_t>(slot_id) >= slots_.size() || count > ring_frames_) {
+    return false;
+  }
+  const Slot& slot = *slots_[static_cast<std::size_t>(slot_id)];
+  if (!slot.busy.load(std::memory_order_acquire)) {
+    return false;
+  }
+  const StreamSource& source = *slot.source.load(std::memory_order_relaxed);
+  const std::uint64_t wanted_end = first + count;
+  const std::uint64_t disk_end = source.loop ? wanted_end : std::clamp(source.total_frames, first, wanted_end);
+  if (first < slot.read_frame.load(std::memory_order_acquire) ||
+      (disk_end > first && (slot.state.load(std::memory_order_acquire) & kFrameMask) < disk_end)) {
+    return false;
+  }
+  for (std::uint64_t frame = first; frame < disk_end; ++frame) {
+    const std::size_t at = static_cast<std::size_t>(frame % ring_frames_) * 2;
+    out[(frame - first) * 2] = slot.ring[at];
+    out[(frame - first) * 2 + 1] = slot.ring[at + 1];
+  }
+  std::fill(out + (disk_end - first) * 2, out + count * 2, 0.0f);
+  return true;
+}
+
+bool SampleStreamer::Prime(int slot_id, std::uint64_t end, std::chrono::milliseconds timeout) {
+  if (slot_id < 0 || static_cast<std::size_t>(slot_id) >= slots_.size()) {
+    return false;
+  }
+  Slot& slot = *slots_[static_cast<std::size_t>(slot_id)];
+  const StreamSource& source = *slot.source.load(std::memory_order_relaxed);
+  // Fill only tops the ring up by whole chunks, so the last chunk of space
+  // behind the reader may never be written.
+  end = std::min(end, slot.read_frame.load(std::memory_order_acquire) + ring_frames_ - kFillChunkFrames);
+  if (!source.loop) {
+    end = std::min(end, source.total_frames);
+  }
+  return AwaitFrames(slot, end, std::chrono::steady_clock::now() + timeout);
+}
+
+bool SampleStreamer::AwaitFrames(Slot& slot, std::uint64_t end, std::chrono::steady_clock::time_point deadline) {
+  std::uint64_t state = slot.state.load(std::memory_order_acquire);
+  while ((state & kFrameMask) < end) {
+    if (slot.failed_generation.load(std::memory_order_acquire) == (state >> kFrameBits) || stop_.load() ||
+        std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    wake_.store(true, std::memory_order_release);
+    wake_cv_.notify_one();
+    std::unique_lock<std::mutex> lock(mutex_);
+    filled_cv_.wait_for(lock, kIdlePoll);
+    state = slot.state.load(std::memory_order_acquire);
+  }
+  return true;
+}
+
+std::size_t SampleStreamer::ResidentBytes() const noexcept {
+  return slots_.size() * ring_frames_ * 2 * sizeof(float);
+}
+
+void SampleStreamer::Run() {
+  const ScopedDenormalGuard guard;
+  while (!stop_.load(std::memory_order_acquire)) {
+    bool progressed = false;
+    for (auto& slot : slots_) {
+      progressed = Fill(*slot) || progressed;
+    }
+    if (progressed) {
+      filled_cv_.notify_all();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_cv_.wait_for(lock, kIdlePoll, [this] {
+      return stop_.load(std::memory_order_acquire) || wake_.exchange(false, std::memory_order_acq_rel);
+    });
+  }
+}
+
+bool SampleStreamer::Fill(Slot& slot) {
+  if (!slot.busy.load(std::memory_order_acquire)) {
+    return false;
+  }
+  const std::uint64_t state = slot.state.load(std::memory_order_acquire);
+  const std::uint64_t generation = state >> kFrameBits;
+  const std::uint64_t write = state & kFrameMask;
+  const StreamSource* source = slot.source.load(std::memory_order_relaxed);
+  if (source == nullptr || slot.failed_generation.load(std::memory_order_relaxed) == generation ||
+      source->Ended(write)) {
+    return false;
+  }
+  const std::uint64_t read = std::min(slot.read_frame.load(std::memory_order_acquire), write);
+  const std::uint64_t space = ring_frames_ - (write - read);
+  if (space < kFillChunkFrames) {
+    return false;
+  }
+
+  if (slot.reader_generation != generation) {
+    slot.reader_generation = generation;
+    if (slot.reader_source != source || slot.reader == nullptr) {
+      slot.reader.reset();
+      slot.reader_source = source;
+      try {
+        slot.reader = OpenAudioFileReader(source->path);
+      } catch (...) {
+        slot.failed_generation.store(generation, std::memory_order_release);
+        filled_cv_.notify_all();
+        return false;
+      }
+    }
+  }
+
+  IAudioFileReader& reader = *slot.reader;
+  std::uint64_t target = write + std::min<std::uint64_t>(space, kFillChunkFrames * 2);
+  if (!source->loop) {
+    target = std::min(target, source->total_frames);
+  }
+  std::uint64_t frame = write;
+  while (frame < target) {
+    const std::uint64_t source_frame = source->SourceFrame(frame);
+    const std::uint64_t run_end = source->loop ? source->loop_end : source->total_frames;
+    const auto at = static_cast<std::size_t>(frame % ring_frames_);
+    // Runs stop at the loop end and at the ring wrap, so each one decodes
+    // straight into the ring.
+    const auto run = static_cast<std::size_t>(
+        std::min({target - frame, run_end - source_frame, static_cast<std::uint64_t>(ring_frames_ - at)}));
+    if (reader.Position() != source_frame && !reader.Seek(source_frame)) {
+      break;
+    }
+    const std::size_t got = reader.ReadInto(AudioBufferView::Interleaved(slot.ring.data() + at * 2, 2, run));
+    frame += got;
+    if (got < run) {
+      break;
+    }
+  }
+  if (frame < target) {
+    slot.failed_generation.store(generation, std::memory_order_release);
+  }
+  if (frame == write) {
+    return false;
+  }
+  std::uint64_t expected = state;
+  return slot.state.compare_exchange_strong(expected, PackState(generation, frame), std::memory_order_acq_rel);
+}
+
+}  // namespace music_create::audio
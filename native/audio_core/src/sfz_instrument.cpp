@@ -0,0 +1,667 @@
+#include "sfz_instrument.hpp"
+
+#include "denormals.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr std::size_t kRenderBlockFrames = 256;
+constexpr double kMaxStep = 16.0;
+// A stolen voice fades out within one render block, so the note waiting for
+// it starts at the next block boundary.
+constexpr float kStealFadeFrames = 128.0f;
+
+using OpcodeList = std::vector<std::pair<std::string, std::string>>;
+
+std::string StripComments(std::string_view text) {
+  std::string out;
+  out.reserve(text.size());
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '/' && i + 1 < text.size() && text[i + 1] == '/') {
+      while (i < text.size() && text[i] != '\n') {
+        ++i;
+      }
+      out.push_back('\n');
+    } else if (text[i] == '/' && i + 1 < text.size() && text[i + 1] == '*') {
+      const std::size_t close = text.find("*/", i + 2);
+      i = close == std::string_view::npos ? text.size() : close + 1;
+      out.push_back(' ');
+    } else {
+      out.push_back(text[i]);
+    }
+  }
+  return out;
+}
+
+bool IsOpcodeChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_'; }
+
+// Paths may contain spaces: the value runs to the end of the line or to the
+// next "name=" token, whichever comes first.
+std::string ReadPathValue(const std::string& text, std::size_t& i) {
+  const std::size_t line_end = std::min(text.find_first_of("\r\n", i), text.size());
+  std::size_t end = line_end;
+  for (std::size_t p = i; p < line_end; ++p) {
+    if (text[p] == '<') {
+      end = p;
+      break;
+    }
+    if (!std::isspace(static_cast<unsigned char>(text[p]))) {
+      continue;
+    }
+    std::size_t q = p;
+    while (q < line_end && std::isspace(static_cast<unsigned char>(text[q]))) {
+      ++q;
+    }
+    std::size_t name_end = q;
+    while (name_end < line_end && IsOpcodeChar(text[name_end])) {
+      ++name_end;
+    }
+    if (name_end > q && name_end < line_end && text[name_end] == '=') {
+      end = p;
+      break;
+    }
+  }
+  std::string value = text.substr(i, end - i);
+  while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+    value.pop_back();
+  }
+  i = end;
+  return value;
+}
+
+int ParseKey(const std::string& value) {
+  if (value.empty()) {
+    throw std::runtime_error("empty key value");
+  }
+  if (std::isdigit(static_cast<unsigned char>(value[0])) || value[0] == '-') {
+    return std::clamp(std::stoi(value), 0, 127);
+  }
+  static constexpr int kSemitones[] = {9, 11, 0, 2, 4, 5, 7};  // a b c d e f g
+  const int letter = std::tolower(static_cast<unsigned char>(value[0])) - 'a';
+  if (letter < 0 || letter > 6) {
+    throw std::runtime_error("invalid note name: " + value);
+  }
+  int semitone = kSemitones[letter];
+  std::size_t pos = 1;
+  if (pos < value.size() && value[pos] == '#') {
+    ++semitone;
+    ++pos;
+  } else if (pos < value.size() && value[pos] == 'b') {
+    --semitone;
+    ++pos;
+  }
+  const int octave = std::stoi(value.substr(pos));
+  return std::clamp((octave + 1) * 12 + semitone, 0, 127);
+}
+
+float ParseFloat(const std::string& value) { return std::strtof(value.c_str(), nullptr); }
+
+void ApplyOpcode(SfzRegion& region, const std::string& name, const std::string& value) {
+  if (name == "sample") {
+    std::string path = value;
+    std::replace(path.begin(), path.end(), '\\', '/');
+    region.sample = path;
+  } else if (name == "key") {
+    region.lokey = region.hikey = region.pitch_keycenter = ParseKey(value);
+  } else if (name == "lokey") {
+    region.lokey = ParseKey(value);
+  } else if (name == "hikey") {
+    region.hikey = ParseKey(value);
+  } else if (name == "pitch_keycenter") {
+    region.pitch_keycenter = ParseKey(value);
+  } else if (name == "lovel") {
+    region.lovel = std::clamp(std::stoi(value), 0, 127);
+  } else if (name == "hivel") {
+    region.hivel = std::clamp(std::stoi(value), 0, 127);
+  } else if (name == "transpose") {
+    region.transpose = std::stoi(value);
+  } else if (name == "tune") {
+    region.tune_cents = ParseFloat(value);
+  } else if (name == "volume") {
+    region.volume_db = ParseFloat(value);
+  } else if (name == "amp_veltrack") {
+    region.amp_veltrack = std::clamp(ParseFloat(value), -100.0f, 100.0f);
+  } else if (name == "ampeg_attack") {
+    region.ampeg_attack = std::max(ParseFloat(value), 0.0f);
+  } else if (name == "ampeg_release") {
+    region.ampeg_release = std::max(ParseFloat(value), 0.0f);
+  } else if (name == "loop_mode" || name == "loopmode") {
+    if (value == "one_shot") {
+      region.loop_mode = SfzLoopMode::kOneShot;
+    } else if (value == "loop_continuous") {
+      region.loop_mode = SfzLoopMode::kLoopContinuous;
+    } else if (value == "loop_sustain") {
+      region.loop_mode = SfzLoopMode::kLoopSustain;
+    } else {
+      region.loop_mode = SfzLoopMode::kNoLoop;
+    }
+  } else if (name == "loop_start" || name == "loopstart") {
+    region.loop_start = std::stoull(value);
+  } else if (name == "loop_end" || name == "loopend") {
+    region.loop_end = std::stoull(value);
+  }
+}
+
+std::string ReadTextFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("cannot open sfz file");
+  }
+  std::ostringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+}  // namespace
+
+std::vector<SfzRegion> ParseSfz(std::string_view source, const std::filesystem::path& base_dir) {
+  const std::string text = StripComments(source);
+  std::vector<SfzRegion> regions;
+  OpcodeList global;
+  OpcodeList master;
+  OpcodeList group;
+  OpcodeList region;
+  std::string default_path;
+  std::string header;
+
+  const auto flush_region = [&] {
+    if (header != "region") {
+      return;
+    }
+    SfzRegion parsed;
+    for (const OpcodeList* scope : {&global, &master, &group, &region}) {
+      for (const auto& [name, value] : *scope) {
+        ApplyOpcode(parsed, name, value);
+      }
+    }
+    if (!parsed.sample.empty()) {
+      std::string prefix = default_path;
+      std::replace(prefix.begin(), prefix.end(), '\\', '/');
+      parsed.sample = base_dir / std::filesystem::path(prefix + parsed.sample.string());
+      regions.push_back(std::move(parsed));
+    }
+    region.clear();
+  };
+
+  std::size_t i = 0;
+  while (i < text.size()) {
+    if (std::isspace(static_cast<unsigned char>(text[i]))) {
+      ++i;
+      continue;
+    }
+    if (text[i] == '<') {
+      const std::size_t close = text.find('>', i);
+      if (close == std::string::npos) {
+        throw std::runtime_error("unterminated sfz header");
+      }
+      flush_region();
+      header = text.substr(i + 1, close - i - 1);
+      if (header == "global") {
+        global.clear();
+        master.clear();
+        group.clear();
+      } else if (header == "master") {
+        master.clear();
+        group.clear();
+      } else if (header == "group") {
+        group.clear();
+      }
+      i = close + 1;
+      continue;
+    }
+    std::size_t name_end = i;
+    while (name_end < text.size() && IsOpcodeChar(text[name_end])) {
+      ++name_end;
+    }
+    if (name_end == i || name_end >= text.size() || text[name_end] != '=') {
+      // Directives such as #define and stray tokens are skipped.
+      while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) {
+        ++i;
+      }
+      continue;
+    }
+    std::string name = text.substr(i, name_end - i);
+    i = name_end + 1;
+    std::string value;
+    if (name == "sample" || name == "default_path") {
+      value = ReadPathValue(text, i);
+    } else {
+      const std::size_t start = i;
+      while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) && text[i] != '<') {
+        ++i;
+      }
+      value = text.substr(start, i - start);
+    }
+    if (header == "control") {
+      if (name == "default_path") {
+        default_path = value;
+      }
+    } else if (header == "global") {
+      global.emplace_back(std::move(name), std::move(value));
+    } else if (header == "master") {
+      master.emplace_back(std::move(name), std::move(value));
+    } else if (header == "group") {
+      group.emplace_back(std::move(name), std::move(value));
+    } else if (header == "region") {
+      region.emplace_back(std::move(name), std::move(value));
+    }
+  }
+  flush_region();
+  return regions;
+}
+
+SfzInstrument::SfzInstrument(const std::filesystem::path& sfz_path, std::uint32_t sample_rate, std::size_t max_voices)
+    : sample_rate_(sample_rate),
+      voices_(std::max<std::size_t>(max_voices, 1)),
+      pending_(std::max<std::size_t>(max_voices, 1)),
+      scratch_((static_cast<std::size_t>(kRenderBlockFrames * kMaxStep) + 4) * 2),
+      streamer_(std::max<std::size_t>(max_voices, 1)) {
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample_rate must be positive");
+  }
+  regions_ = ParseSfz(ReadTextFile(sfz_path), sfz_path.parent_path());
+
+  std::map<std::string, std::size_t> sample_index;
+  region_sample_.reserve(regions_.size());
+  for (const SfzRegion& region : regions_) {
+    const bool loops =
+        region.loop_mode == SfzLoopMode::kLoopContinuous || region.loop_mode == SfzLoopMode::kLoopSustain;
+    std::string key = region.sample.string();
+    if (loops) {
+      key += '|' + std::to_string(region.loop_start.value_or(0)) + '|' +
+             std::to_string(region.loop_end.value_or(~0ull));
+    }
+    if (auto found = sample_index.find(key); found != sample_index.end()) {
+      region_sample_.push_back(found->second);
+      continue;
+    }
+
+    auto reader = OpenAudioFileReader(region.sample);
+    const AudioFileInfo& info = reader->Info();
+    auto sample = std::make_unique<Sample>();
+    sample->sample_rate = info.sample_rate;
+    StreamSource& source = sample->source;
+    source.path = region.sample;
+    source.total_frames = info.total_frames;
+    if (loops && info.total_frames > 0) {
+      // SFZ loop_end names the last frame inside the loop.
+      const std::uint64_t loop_end = std::min<std::uint64_t>(region.loop_end.value_or(info.total_frames - 1) + 1,
+                                                             info.total_frames);
+      const std::uint64_t loop_start = region.loop_start.value_or(0);
+      if (loop_start < loop_end) {
+        source.loop = true;
+        source.loop_start = loop_start;
+        source.loop_end = loop_end;
+      }
+    }
+    source.head_frames = std::min<std::uint64_t>(source.total_frames, kHeadFrames);
+    if (source.loop && source.total_frames > kHeadFrames) {
+      source.head_frames = std::min(source.head_frames, source.loop_end);
+    }
+
+    // The head is decoded straight into its stereo layout (mono doubled).
+    sample->head.resize(static_cast<std::size_t>(source.head_frames) * 2);
+    const std::size_t got = reader->ReadInto(
+        AudioBufferView::Interleaved(sample->head.data(), 2, static_cast<std::size_t>(source.head_frames)));
+    source.head_frames = got;
+    sample->head.resize(got * 2);
+    if (got == source.total_frames && source.loop) {
+      source.loop_end = std::min(source.loop_end, static_cast<std::uint64_t>(got));
+    }
+
+    sample_index.emplace(std::move(key), samples_.size());
+    region_sample_.push_back(samples_.size());
+    samples_.push_back(std::move(sample));
+  }
+}
+
+SfzInstrument::~SfzInstrument() = default;
+
+std::size_t SfzInstrument::ResidentBytes() const noexcept {
+  std::size_t bytes = streamer_.ResidentBytes() + scratch_.size() * sizeof(float);
+  for (const auto& sample : samples_) {
+    bytes += sample->head.size() * sizeof(float);
+  }
+  return bytes;
+}
+
+void SfzInstrument::NoteOn(int key, int velocity) noexcept {
+  if (velocity <= 0) {
+    NoteOff(key);
+    return;
+  }
+  for (std::size_t r = 0; r < regions_.size(); ++r) {
+    const SfzRegion& region = regions_[r];
+    if (key >= region.lokey && key <= region.hikey && velocity >= region.lovel && velocity <= region.hivel) {
+      StartRegion(r, key, velocity);
+    }
+  }
+}
+
+void SfzInstrument::NoteOff(int key) noexcept {
+  voices_.ForEachActive([&](VoicePool<Voice>::Handle handle, Voice& voice) {
+    if (voices_.NoteOf(handle) == key && !voice.one_shot) {
+      voice.released = true;
+    }
+  });
+  // A note still waiting for a stolen voice starts already in its release.
+  for (std::size_t i = 0; i < pending_count_; ++i) {
+    if (pending_[i].key == key) {
+      pending_[i].released = true;
+    }
+  }
+}
+
+void SfzInstrument::AllNotesOff() noexcept {
+  voices_.ForEachActive([](VoicePool<Voice>::Handle, Voice& voice) { voice.released = true; });
+  for (std::size_t i = 0; i < pending_count_; ++i) {
+    pending_[i].released = true;
+  }
+}
+
+void SfzInstrument::StartRegion(std::size_t region_index, int key, int velocity) noexcept {
+  if (TryStartRegion(region_index, key, velocity, false)) {
+    return;
+  }
+  const auto victim = voices_.SelectVictim(
+      steal_policy_, key, [](const Voice& voice) { return !voice.stolen; },
+      [](const Voice& voice) { return voice.gain * voice.envelope; });
+  if (victim == VoicePool<Voice>::kNoVoice || pending_count_ == pending_.size()) {
+    return;
+  }
+  Voice& stolen = voices_[victim];
+  stolen.stolen = true;
+  stolen.released = true;
+  stolen.release_step = std::max(stolen.release_step, 1.0f / kStealFadeFrames);
+  pending_[pending_count_++] = {region_index, key, velocity, false};
+}
+
+bool SfzInstrument::TryStartRegion(std::size_t region_index, int key, int velocity, bool released) noexcept {
+  const SfzRegion& region = regions_[region_index];
+  const Sample& sample = *samples_[region_sample_[region_index]];
+  const auto handle = voices_.Allocate(key);
+  if (handle == VoicePool<Voice>::kNoVoice) {
+    return false;
+  }
+  int slot = -1;
+  if (sample.source.loop ? sample.source.loop_end > sample.source.head_frames
+                         : sample.source.total_frames > sample.source.head_frames) {
+    slot = streamer_.Acquire(sample.source);
+    if (slot < 0) {
+      voices_.Release(handle);
+      return false;
+    }
+  }
+
+  Voice& voice = voices_[handle];
+  voice = Voice{};
+  voice.one_shot = region.loop_mode == SfzLoopMode::kOneShot;
+  voice.released = released && !voice.one_shot;
+  voice.sample = &sample;
+  voice.slot = slot;
+  const double semitones = key - region.pitch_keycenter + region.transpose + region.tune_cents / 100.0;
+  voice.step = std::min(std::exp2(semitones / 12.0) * sample.sample_rate / sample_rate_, kMaxStep);
+  const float velocity_curve = static_cast<float>(velocity * velocity) / (127.0f * 127.0f);
+  const float veltrack = region.amp_veltrack / 100.0f;
+  voice.gain = std::pow(10.0f, region.volume_db / 20.0f) * (1.0f - veltrack * (1.0f - velocity_curve));
+  const float attack_samples = region.ampeg_attack * static_cast<float>(sample_rate_);
+  voice.envelope = attack_samples >= 1.0f ? 0.0f : 1.0f;
+  voice.attack_step = attack_samples >= 1.0f ? 1.0f / attack_samples : 1.0f;
+  voice.release_step = 1.0f / std::max(region.ampeg_release * static_cast<float>(sample_rate_), 1.0f);
+  return true;
+}
+
+void SfzInstrument::StartPending() noexcept {
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < pending_count_; ++i) {
+    const PendingNote& note = pending_[i];
+    if (!TryStartRegion(note.region, note.key, note.velocity, note.released)) {
+      pending_[kept++] = note;
+    }
+  }
+  pending_count_ = kept;
+}
+
+void SfzInstrument::StopVoice(VoicePool<Voice>::Handle handle) noexcept {
+  Voice& voice = voices_[handle];
+  if (voice.slot >= 0) {
+    streamer_.Release(voice.slot);
+    voice.slot = -1;
+  }
+  voices_.Release(handle);
+}
+
+void SfzInstrument::StopAllVoices() noexcept {
+  voices_.ForEachActive([this](VoicePool<Voice>::Handle handle, Voice&) { StopVoice(handle); });
+  pending_count_ = 0;
+}
+
+bool SfzInstrument::RenderVoice(Voice& voice, float* stereo, std::size_t frames, bool wait) {
+  const Sample& sample = *voice.sample;
+  const StreamSource& source = sample.source;
+  const auto first = static_cast<std::uint64_t>(voice.position);
+  const auto last = static_cast<std::uint64_t>(voice.position + voice.step * static_cast<double>(frames - 1)) + 1;
+  const auto span = static_cast<std::size_t>(last - first + 1);
+
+  // Gather the source frames this block touches into scratch_ (stereo).
+  const std::uint64_t direct_end = source.loop ? std::min(source.head_frames, source.loop_end) : source.head_frames;
+  const std::size_t from_head =
+      first < direct_end ? static_cast<std::size_t>(std::min<std::uint64_t>(direct_end - first, span)) : 0;
+  std::copy_n(sample.head.data() + first * 2, from_head * 2, scratch_.data());
+  if (from_head < span) {
+    const std::uint64_t tail_first = first + from_head;
+    const std::size_t tail = span - from_head;
+    float* dst = scratch_.data() + from_head * 2;
+    if (voice.slot >= 0) {
+      if (!streamer_.Fetch(voice.slot, tail_first, tail, dst, wait)) {
+        if (wait) {
+          return false;
+        }
+        std::fill_n(dst, tail * 2, 0.0f);
+      }
+    } else {
+      for (std::size_t f = 0; f < tail; ++f) {
+        const std::uint64_t v = tail_first + f;
+        const bool audible = source.loop || v < source.head_frames;
+        const std::uint64_t at = source.SourceFrame(v);
+        dst[f * 2] = audible ? sample.head[at * 2] : 0.0f;
+        dst[f * 2 + 1] = audible ? sample.head[at * 2 + 1] : 0.0f;
+      }
+    }
+  }
+
+  double position = voice.position - static_cast<double>(first);
+  float envelope = voice.envelope;
+  for (std::size_t i = 0; i < frames; ++i) {
+    if (voice.released) {
+      envelope -= voice.release_step;
+      if (envelope <= 0.0f) {
+        return false;
+      }
+    } else if (envelope < 1.0f) {
+      envelope = std::min(envelope + voice.attack_step, 1.0f);
+    }
+    const auto index = static_cast<std::size_t>(position);
+    const auto fraction = static_cast<float>(position - static_cast<double>(index));
+    const float* a = scratch_.data() + index * 2;
+    const float level = voice.gain * envelope;
+    stereo[i * 2] += (a[0] + (a[2] - a[0]) * fraction) * level;
+    stereo[i * 2 + 1] += (a[1] + (a[3] - a[1]) * fraction) * level;
+    position += voice.step;
+  }
+  voice.envelope = envelope;
+  voice.position += voice.step * static_cast<double>(frames);
+  return source.loop || voice.position < static_cast<double>(source.total_frames);
+}
+
+void SfzInstrument::RenderVoices(float* stereo, std::size_t frames, bool wait) {
+  for (std::size_t offset = 0; offset < frames; offset += kRenderBlockFrames) {
+    const std::size_t block = std::min(kRenderBlockFrames, frames - offset);
+    if (pending_count_ > 0) {
+      StartPending();
+    }
+    voices_.ForEachActive([&](VoicePool<Voice>::Handle handle, Voice& voice) {
+      if (!RenderVoice(voice, stereo + offset * 2, block, wait)) {
+        StopVoice(handle);
+      }
+    });
+  }
+}
+
+void SfzInstrument::Render(float* stereo, std::size_t frames) noexcept {
+  std::fill_n(stereo, frames * 2, 0.0f);
+  RenderVoices(stereo, frames, false);
+}
+
+void SfzInstrument::SetStealPolicy(VoiceStealPolicy policy) noexcept { steal_policy_ = policy; }
+
+void SfzInstrument::RenderNotes(const SfzNote* notes, std::size_t count, float* stereo, std::size_t frames) {
+  struct Event {
+    std::int64_t at;
+    bool on;
+    int key;
+    int velocity;
+  };
+  std::vector<Event> events;
+  events.reserve(count * 2);
+  for (std::size_t n = 0; n < count; ++n) {
+    const SfzNote& note = notes[n];
+    if (note.length_samples <= 0) {
+      continue;
+    }
+    events.push_back({note.start_sample, true, note.key, note.velocity});
+    events.push_back({note.start_sample + note.length_samples, false, note.key, 0});
+  }
+  // Note-offs sort before note-ons at the same time so repeated notes retrigger.
+  std::stable_sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) {
+    return lhs.at != rhs.at ? lhs.at < rhs.at : (!lhs.on && rhs.on);
+  });
+
+  StopAllVoices();
+  std::fill_n(stereo, frames * 2, 0.0f);
+  std::size_t cursor = 0;
+  for (const Event& event : events) {
+    const auto at = static_cast<std::size_t>(std::clamp<std::int64_t>(event.at, 0, static_cast<std::int64_t>(frames)));
+    if (at > cursor) {
+      RenderVoices(stereo + cursor * 2, at - cursor, true);
+      cursor = at;
+    }
+    if (event.at >= static_cast<std::int64_t>(frames)) {
+      break;
+    }
+    if (event.on) {
+      NoteOn(event.key, event.velocity);
+    } else {
+      NoteOff(event.key);
+    }
+  }
+  if (cursor < frames) {
+    RenderVoices(stereo + cursor * 2, frames - cursor, true);
+  }
+  StopAllVoices();
+}
+
+}  // namespace music_create::audio
+
+struct mc_sfz_instrument {
+  std::unique_ptr<music_create::audio::SfzInstrument> instrument;
+};
+
+extern "C" {
+
+mc_sfz_instrument* mc_sfz_open_w(const wchar_t* path, unsigned int sample_rate, unsigned int max_voices) {
+  if (path == nullptr) {
+    return nullptr;
+  }
+  try {
+    auto handle = std::make_unique<mc_sfz_instrument>();
+    handle->instrument = std::make_unique<music_create::audio::SfzInstrument>(
+        std::filesystem::path(path), sample_rate,
+        max_voices == 0 ? music_create::audio::SfzInstrument::kDefaultVoices : max_voices);
+    return handle.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_sfz_free(mc_sfz_instrument* instrument) { delete instrument; }
+
+unsigned int mc_sfz_region_count(const mc_sfz_instrument* instrument) {
+  return instrument == nullptr ? 0 : static_cast<unsigned int>(instrument->instrument->RegionCount());
+}
+
+unsigned long long mc_sfz_resident_bytes(const mc_sfz_instrument* instrument) {
+  return instrument == nullptr ? 0 : instrument->instrument->ResidentBytes();
+}
+
+unsigned long long mc_sfz_underruns(const mc_sfz_instrument* instrument) {
+  return instrument == nullptr ? 0 : instrument->instrument->Underruns();
+}
+
+int mc_sfz_note_on(mc_sfz_instrument* instrument, int key, int velocity) {
+  if (instrument == nullptr) {
+    return 0;
+  }
+  instrument->instrument->NoteOn(key, velocity);
+  return 1;
+}
+
+int mc_sfz_note_off(mc_sfz_instrument* instrument, int key) {
+  if (instrument == nullptr) {
+    return 0;
+  }
+  instrument->instrument->NoteOff(key);
+  return 1;
+}
+
+int mc_sfz_set_steal_policy(mc_sfz_instrument* instrument, int policy) {
+  if (instrument == nullptr || policy < 0 ||
+      policy > static_cast<int>(music_create::audio::VoiceStealPolicy::kSameNote)) {
+    return 0;
+  }
+  instrument->instrument->SetStealPolicy(static_cast<music_create::audio::VoiceStealPolicy>(policy));
+  return 1;
+}
+
+int mc_sfz_render(mc_sfz_instrument* instrument, float* stereo, unsigned long long frames) {
+  if (instrument == nullptr || stereo == nullptr) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  instrument->instrument->Render(stereo, static_cast<std::size_t>(frames));
+  return 1;
+}
+
+int mc_sfz_render_notes(mc_sfz_instrument* instrument, unsigned long long count, const long long* start_sample,
+                        const long long* length_samples, const int* key, const int* velocity, float* stereo,
+                        unsigned long long frames) {
+  if (instrument == nullptr || stereo == nullptr ||
+      (count > 0 && (start_sample == nullptr || length_samples == nullptr || key == nullptr || velocity == nullptr))) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  try {
+    std::vector<music_create::audio::SfzNote> notes(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      notes[i] = {start_sample[i], length_samples[i], key[i], velocity[i]};
+    }
+    instrument->instrument->RenderNotes(notes.data(), notes.size(), stereo, static_cast<std::size_t>(frames));
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
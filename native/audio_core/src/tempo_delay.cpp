@@ -0,0 +1,123 @@
+#include "tempo_delay.hpp"
+
+#include "denormals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr double kGlide = 0.001;  // per-sample approach to a new delay time
+constexpr float kMaxDamping = 0.85f;
+constexpr float kMaxFeedback = 0.95f;
+
+}  // namespace
+
+TempoDelay::TempoDelay(std::uint32_t sample_rate) : sample_rate_(sample_rate) {
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample rate must be positive");
+  }
+  const auto frames = static_cast<std::size_t>(std::ceil(kMaxSeconds * sample_rate)) + 2;
+  std::uint32_t size = 1;
+  while (size < frames) {
+    size <<= 1;
+  }
+  buffer_.assign(size, 0.0f);
+  mask_ = size - 1;
+  SetParams(params_);
+}
+
+void TempoDelay::SetParams(const TempoDelayParams& params) noexcept {
+  params_ = params;
+  params_.mix = std::clamp(params.mix, 0.0f, 1.0f);
+  params_.time_beats = std::max(params.time_beats, 0.0f);
+  params_.tempo_bpm = std::clamp(params.tempo_bpm, 20.0f, 400.0f);
+  params_.feedback = std::clamp(params.feedback, 0.0f, kMaxFeedback);
+  params_.damping = std::clamp(params.damping, 0.0f, 1.0f);
+
+  const double seconds = params_.time_beats * 60.0 / params_.tempo_bpm;
+  target_delay_ = std::clamp(seconds * sample_rate_, 1.0, static_cast<double>(kMaxSeconds) * sample_rate_);
+  if (!running_) {
+    delay_ = target_delay_;
+  }
+  damping_ = params_.damping * kMaxDamping;
+}
+
+void TempoDelay::Process(const float* in, float* out, std::size_t frames) noexcept {
+  const float mix = params_.mix;
+  const float feedback = params_.feedback;
+  running_ = running_ || frames > 0;
+  for (std::size_t n = 0; n < frames; ++n) {
+    delay_ += (target_delay_ - delay_) * kGlide;
+    const auto whole = static_cast<std::uint32_t>(delay_);
+    const auto fraction = static_cast<float>(delay_ - whole);
+    const float near = buffer_[(write_ - whole) & mask_];
+    const float far = buffer_[(write_ - whole - 1) & mask_];
+    const float delayed = near + fraction * (far - near);
+
+    const float dry = in[n];
+    lowpass_ = FlushDenormal(delayed + damping_ * (lowpass_ - delayed));
+    buffer_[write_ & mask_] = FlushDenormal(dry + lowpass_ * feedback);
+    ++write_;
+    out[n] = dry + mix * (delayed - dry);
+  }
+}
+
+void TempoDelay::Reset() noexcept {
+  std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+  write_ = 0;
+  lowpass_ = 0.0f;
+  delay_ = target_delay_;
+  running_ = false;
+}
+
+}  // namespace music_create::audio
+
+struct mc_tempo_delay {
+  explicit mc_tempo_delay(std::uint32_t sample_rate) : delay(sample_rate) {}
+
+  music_create::audio::TempoDelay delay;
+};
+
+extern "C" {
+
+mc_tempo_delay* mc_tempo_delay_create(unsigned int sample_rate) {
+  try {
+    return new mc_tempo_delay(sample_rate);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_tempo_delay_free(mc_tempo_delay* delay) { delete delay; }
+
+int mc_tempo_delay_set_params(mc_tempo_delay* delay, float mix, float time_beats, float tempo_bpm, float feedback,
+                              float damping) {
+  if (delay == nullptr) {
+    return 0;
+  }
+  delay->delay.SetParams({mix, time_beats, tempo_bpm, feedback, damping});
+  return 1;
+}
+
+int mc_tempo_delay_process(mc_tempo_delay* delay, const float* in, float* out, unsigned long long frames) {
+  if (delay == nullptr || (frames > 0 && (in == nullptr || out == nullptr))) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  delay->delay.Process(in, out, static_cast<std::size_t>(frames));
+  return 1;
+}
+
+int mc_tempo_delay_reset(mc_tempo_delay* delay) {
+  if (delay == nullptr) {
+    return 0;
+  }
+  delay->delay.Reset();
+  return 1;
+}
+
+}  // extern "C"
@@ -0,0 +1,496 @@
+#include "time_stretch.hpp"
+
+#include "denormals.hpp"
+#include "fast_math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+constexpr float kPiF = 3.14159265f;
+constexpr float kTwoPiF = 6.28318531f;
+constexpr float kHalfPiF = 1.57079633f;
+constexpr double kMinFrameRatio = 0.125;  // stretch * pitch factor bounds
+constexpr double kMaxFrameRatio = 8.0;
+constexpr std::size_t kCoarseStep = 4;
+
+std::size_t PowerOfTwoAtLeast(double frames) {
+  std::size_t size = 256;
+  while (static_cast<double>(size) < frames) {
+    size *= 2;
+  }
+  return size;
+}
+
+// Within about 1e-5 rad, which the phase vocoder cannot hear.
+float FastAtan2(float y, float x) noexcept {
+  const float ax = std::abs(x);
+  const float ay = std::abs(y);
+  const float big = std::max(ax, ay);
+  if (big == 0.0f) {
+    return 0.0f;
+  }
+  const float a = std::min(ax, ay) / big;
+  const float s = a * a;
+  float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+  r = ay > ax ? kHalfPiF - r : r;
+  r = x < 0.0f ? kPiF - r : r;
+  return y < 0.0f ? -r : r;
+}
+
+float WrapPhase(float phase) noexcept { return phase - kTwoPiF * std::nearbyint(phase * (1.0f / kTwoPiF)); }
+
+// 4-point cubic Hermite between p1 and p2.
+float Hermite(float p0, float p1, float p2, float p3, float t) noexcept {
+  const float c1 = 0.5f * (p2 - p0);
+  const float c2 = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+  const float c3 = 0.5f * (p3 - p0) + 1.5f * (p1 - p2);
+  return ((c3 * t + c2) * t + c1) * t + p1;
+}
+
+float Dot(const float* a, const float* b, std::size_t count) noexcept {
+  float sum = 0.0f;
+  for (std::size_t n = 0; n < count; ++n) {
+    sum += a[n] * b[n];
+  }
+  return sum;
+}
+
+}  // namespace
+
+TimeStretcher::TimeStretcher(std::uint32_t sample_rate, std::size_t channels, StretchMode mode, StretchQuality quality)
+    : channels_(channels), mode_(mode), quality_(quality) {
+  if (channels == 0 || channels > kMaxChannels) {
+    throw std::invalid_argument("time stretcher takes one or two channels");
+  }
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample rate must be positive");
+  }
+  const bool high = quality == StretchQuality::kHigh;
+  if (mode == StretchMode::kWsola) {
+    // ~20 ms segments, half overlapped, searched +-5 ms.
+    frame_size_ = PowerOfTwoAtLeast(sample_rate * 0.02);
+    hop_ = frame_size_ / 2;
+    tolerance_ = frame_size_ / 4;
+    ola_scale_ = 2.0f * static_cast<float>(hop_) / static_cast<float>(frame_size_);
+  } else {
+    // ~40 ms frames (twice that offline) resolve low notes; the squared
+    // Hann windows overlap-add to 3/8 of the frame per hop.
+    frame_size_ = PowerOfTwoAtLeast(sample_rate * 0.04) * (high ? 2 : 1);
+    hop_ = frame_size_ / (high ? 8 : 4);
+    tolerance_ = 0;
+    ola_scale_ = static_cast<float>(hop_) / (0.375f * static_cast<float>(frame_size_));
+  }
+  window_.resize(frame_size_);
+  for (std::size_t n = 0; n < frame_size_; ++n) {
+    window_[n] = static_cast<float>(0.5 - 0.5 * std::cos(kTwoPi * static_cast<double>(n) / frame_size_));
+  }
+
+  // The most input one Pull can need: every hop of the largest pull at the
+  // highest pitch, each advancing the analysis by the largest step, plus a
+  // frame, the search span, and room for a push while the head is kept.
+  const double max_pitch = std::exp2(kMaxSemitones / 12.0);
+  const auto hops = static_cast<std::size_t>(std::ceil(kMaxPullFrames * max_pitch / hop_)) + 2;
+  const auto max_analysis_hop = static_cast<std::size_t>(std::ceil(hop_ / kMinFrameRatio));
+  input_capacity_ = hops * max_analysis_hop + frame_size_ + 2 * tolerance_ + hop_ + kMaxPullFrames;
+  input_.assign(channels_, std::vector<float>(input_capacity_));
+  overlap_.assign(channels_, std::vector<float>(frame_size_));
+  stretched_.assign(channels_, std::vector<float>(hop_ * 2 + 8));
+  if (mode == StretchMode::kWsola) {
+    mono_.resize(2 * tolerance_ + 2 * hop_);
+    coarse_.resize(mono_.size() / kCoarseStep + 1);
+  } else {
+    fft_ = std::make_unique<RealFft>(frame_size_);
+    frame_.resize(frame_size_);
+    spectrum_.resize(fft_->Bins());
+    magnitude_.resize(fft_->Bins());
+    phase_.resize(fft_->Bins());
+    previous_phase_.assign(channels_, std::vector<float>(fft_->Bins()));
+    synthesis_phase_.assign(channels_, std::vector<float>(fft_->Bins()));
+    peaks_.reserve(fft_->Bins());
+  }
+  SetStretch(1.0, 0.0f);
+  Reset();
+}
+
+void TimeStretcher::SetStretch(double stretch, float semitones) noexcept {
+  stretch_ = std::clamp(stretch, kMinStretch, kMaxStretch);
+  pitch_ = std::exp2(std::clamp(semitones, -kMaxSemitones, kMaxSemitones) / 12.0);
+  analysis_hop_ = static_cast<double>(hop_) / std::clamp(stretch_ * pitch_, kMinFrameRatio, kMaxFrameRatio);
+}
+
+void TimeStretcher::Reset() noexcept {
+  // Leading zeros put the centre of the first analysis frame on the first
+  // pushed frame, with the search span before it.
+  const std::size_t lead = frame_size_ / 2 + tolerance_;
+  for (auto& channel : input_) {
+    std::fill_n(channel.begin(), lead, 0.0f);
+  }
+  input_start_ = 0;
+  input_fill_ = lead;
+  analysis_ = static_cast<double>(tolerance_);
+  previous_analysis_ = -1;
+  previous_segment_ = -1;
+  for (auto& channel : overlap_) {
+    std::fill(channel.begin(), channel.end(), 0.0f);
+  }
+  // One zero frame of history for the interpolator; the first synthesis
+  // frame starts half a frame before the aligned output.
+  for (auto& channel : stretched_) {
+    channel[0] = 0.0f;
+  }
+  stretched_fill_ = 1;
+  discard_ = frame_size_ / 2;
+  resample_index_ = 1;
+  resample_fraction_ = 0.0;
+}
+
+std::size_t TimeStretcher::InputLead() const noexcept {
+  return frame_size_ / 2 + tolerance_ + static_cast<std::size_t>(std::ceil(analysis_hop_)) + hop_;
+}
+
+std::size_t TimeStretcher::InputNeeded(std::size_t frames) const noexcept {
+  frames = std::min(frames, kMaxPullFrames);
+  if (frames == 0) {
+    return 0;
+  }
+  // Replays the arithmetic Pull and Hop will do, so the count is exact.
+  std::size_t last = resample_index_;
+  double fraction = resample_fraction_;
+  for (std::size_t n = 1; n < frames; ++n) {
+    fraction += pitch_;
+    const double whole = std::floor(fraction);
+    last += static_cast<std::size_t>(whole);
+    fraction -= whole;
+  }
+  const auto needed = static_cast<std::int64_t>(last) + 3;
+  std::int64_t missing = needed - static_cast<std::int64_t>(stretched_fill_) + static_cast<std::int64_t>(discard_);
+  if (missing <= 0) {
+    return 0;
+  }
+  double analysis = analysis_;
+  for (; missing > static_cast<std::int64_t>(hop_); missing -= static_cast<std::int64_t>(hop_)) {
+    analysis += analysis_hop_;
+  }
+  const std::int64_t end = std::llround(analysis) + static_cast<std::int64_t>(frame_size_ + tolerance_);
+  const std::int64_t have = input_start_ + static_cast<std::int64_t>(input_fill_);
+  return end > have ? static_cast<std::size_t>(end - have) : 0;
+}
+
+std::size_t TimeStretcher::Push(const float* const* in, std::size_t frames) noexcept {
+  if (input_fill_ + frames > input_capacity_) {
+    CompactInput();
+  }
+  const std::size_t count = std::min(frames, input_capacity_ - input_fill_);
+  for (std::size_t c = 0; c < channels_; ++c) {
+    std::copy_n(in[c], count, input_[c].begin() + static_cast<std::ptrdiff_t>(input_fill_));
+  }
+  input_fill_ += count;
+  return count;
+}
+
+std::size_t TimeStretcher::PushSilence(std::size_t frames) noexcept {
+  if (input_fill_ + frames > input_capacity_) {
+    CompactInput();
+  }
+  const std::size_t count = std::min(frames, input_capacity_ - input_fill_);
+  for (auto& channel : input_) {
+    std::fill_n(channel.begin() + static_cast<std::ptrdiff_t>(input_fill_), count, 0.0f);
+  }
+  input_fill_ += count;
+  return count;
+}
+
+std::size_t TimeStretcher::Pull(float* const* out, std::size_t frames) noexcept {
+  for (std::size_t n = 0; n < frames; ++n) {
+    while (resample_index_ + 2 >= stretched_fill_) {
+      if (!InputReady(std::llround(analysis_))) {
+        return n;
+      }
+      if (stretched_fill_ + hop_ > stretched_[0].size()) {
+        // Drop the frames the interpolator has passed.
+        const std::size_t drop = resample_index_ - 1;
+        for (auto& channel : stretched_) {
+          std::memmove(channel.data(), channel.data() + drop, (stretched_fill_ - drop) * sizeof(float));
+        }
+        stretched_fill_ -= drop;
+        resample_index_ -= drop;
+      }
+      Hop();
+    }
+    const auto t = static_cast<float>(resample_fraction_);
+    for (std::size_t c = 0; c < channels_; ++c) {
+      const float* y = stretched_[c].data() + resample_index_;
+      out[c][n] = Hermite(y[-1], y[0], y[1], y[2], t);
+    }
+    resample_fraction_ += pitch_;
+    const double whole = std::floor(resample_fraction_);
+    resample_index_ += static_cast<std::size_t>(whole);
+    resample_fraction_ -= whole;
+  }
+  return frames;
+}
+
+bool TimeStretcher::InputReady(std::int64_t analysis) const noexcept {
+  return analysis + static_cast<std::int64_t>(frame_size_ + tolerance_) <=
+         input_start_ + static_cast<std::int64_t>(input_fill_);
+}
+
+void TimeStretcher::Hop() noexcept {
+  const std::int64_t analysis = std::llround(analysis_);
+  if (mode_ == StretchMode::kWsola) {
+    WsolaFrame(analysis);
+  } else {
+    VocoderFrame(analysis);
+  }
+  previous_analysis_ = analysis;
+  analysis_ += analysis_hop_;
+
+  // The first hop_ frames of the accumulator are complete.
+  const std::size_t skip = std::min(discard_, hop_);
+  discard_ -= skip;
+  for (std::size_t c = 0; c < channels_; ++c) {
+    float* overlap = overlap_[c].data();
+    std::copy(overlap + skip, overlap + hop_, stretched_[c].begin() + static_cast<std::ptrdiff_t>(stretched_fill_));
+    std::memmove(overlap, overlap + hop_, (frame_size_ - hop_) * sizeof(float));
+    std::fill(overlap + frame_size_ - hop_, overlap + frame_size_, 0.0f);
+  }
+  stretched_fill_ += hop_ - skip;
+}
+
+void TimeStretcher::WsolaFrame(std::int64_t analysis) noexcept {
+  const std::int64_t segment = previous_segment_ < 0 || tolerance_ == 0
+                                   ? analysis
+                                   : SearchWsola(analysis, previous_segment_ + static_cast<std::int64_t>(hop_));
+  previous_segment_ = segment;
+  const auto at = static_cast<std::size_t>(segment - input_start_);
+  for (std::size_t c = 0; c < channels_; ++c) {
+    const float* in = input_[c].data() + at;
+    float* overlap = overlap_[c].data();
+    for (std::size_t n = 0; n < frame_size_; ++n) {
+      overlap[n] += ola_scale_ * window_[n] * in[n];
+    }
+  }
+}
+
+std::int64_t TimeStretcher::SearchWsola(std::int64_t analysis, std::int64_t natural) noexcept {
+  // The segment that would have followed the last one is the template; the
+  // candidate around the analysis position that matches its first half
+  // best continues the waveform without a seam.
+  const std::size_t length = hop_;
+  const std::size_t span = 2 * tolerance_ + length;
+  float* reference = mono_.data();
+  float* candidates = reference + length;
+  const auto natural_at = static_cast<std::size_t>(natural - input_start_);
+  const auto first_at = static_cast<std::size_t>(analysis - static_cast<std::int64_t>(tolerance_) - input_start_);
+  for (std::size_t n = 0; n < length; ++n) {
+    reference[n] = input_[0][natural_at + n];
+  }
+  for (std::size_t n = 0; n < span; ++n) {
+    candidates[n] = input_[0][first_at + n];
+  }
+  if (channels_ == 2) {
+    for (std::size_t n = 0; n < length; ++n) {
+      reference[n] += input_[1][natural_at + n];
+    }
+    for (std::size_t n = 0; n < span; ++n) {
+      candidates[n] += input_[1][first_at + n];
+    }
+  }
+
+  std::size_t best = tolerance_;
+  float best_score = -1e30f;
+  std::size_t fine_from = 0;
+  std::size_t fine_to = 2 * tolerance_;
+  if (quality_ == StretchQuality::kRealtime) {
+    // Coarse pass over 4x decimated (box-filtered) signals, then a fine one
+    // around the winner.
+    float* coarse_reference = coarse_.data();
+    const std::size_t coarse_length = length / kCoarseStep;
+    const std::size_t coarse_span = span / kCoarseStep;
+    float* coarse_candidates = coarse_reference + coarse_length;
+    for (std::size_t j = 0; j < coarse_length; ++j) {
+      const float* r = reference + j * kCoarseStep;
+      coarse_reference[j] = r[0] + r[1] + r[2] + r[3];
+    }
+    for (std::size_t j = 0; j < coarse_span; ++j) {
+      const float* r = candidates + j * kCoarseStep;
+      coarse_candidates[j] = r[0] + r[1] + r[2] + r[3];
+    }
+    std::size_t coarse_best = 0;
+    for (std::size_t j = 0; j + coarse_length <= coarse_span; ++j) {
+      const float score = Dot(coarse_reference, coarse_candidates + j, coarse_length);
+      if (score > best_score) {
+        best_score = score;
+        coarse_best = j;
+      }
+    }
+    fine_from = coarse_best * kCoarseStep - std::min(coarse_best * kCoarseStep, kCoarseStep - 1);
+    fine_to = std::min(coarse_best * kCoarseStep + kCoarseStep - 1, 2 * tolerance_);
+    best_score = -1e30f;
+  }
+  for (std::size_t offset = fine_from; offset <= fine_to; ++offset) {
+    const float score = Dot(reference, candidates + offset, length);
+    if (score > best_score) {
+      best_score = score;
+      best = offset;
+    }
+  }
+  return analysis - static_cast<std::int64_t>(tolerance_) + static_cast<std::int64_t>(best);
+}
+
+void TimeStretcher::VocoderFrame(std::int64_t analysis) noexcept {
+  const std::size_t bins = fft_->Bins();
+  const auto at = static_cast<std::size_t>(analysis - input_start_);
+  const bool first = previous_analysis_ < 0;
+  const auto analysis_hop = static_cast<float>(first ? 0 : analysis - previous_analysis_);
+  const float bin_step = kTwoPiF / static_cast<float>(frame_size_);
+  for (std::size_t c = 0; c < channels_; ++c) {
+    const float* in = input_[c].data() + at;
+    for (std::size_t n = 0; n < frame_size_; ++n) {
+      frame_[n] = window_[n] * in[n];
+    }
+    fft_->Forward(frame_.data(), spectrum_.data());
+    for (std::size_t k = 0; k < bins; ++k) {
+      magnitude_[k] = std::abs(spectrum_[k]);
+      phase_[k] = FastAtan2(spectrum_[k].imag(), spectrum_[k].real());
+    }
+    float* previous = previous_phase_[c].data();
+    float* synthesis = synthesis_phase_[c].data();
+    if (first || analysis_hop <= 0.0f) {
+      std::copy_n(phase_.data(), bins, synthesis);
+    } else {
+      // Peaks advance at their measured frequency; the bins around each
+      // peak keep their phase offset to it (identity phase locking), which
+      // keeps partials coherent instead of phasey.
+      peaks_.clear();
+      for (std::size_t k = 2; k + 2 < bins; ++k) {
+        const float m = magnitude_[k];
+        if (m > magnitude_[k - 1] && m >= magnitude_[k + 1] && m > magnitude_[k - 2] && m >= magnitude_[k + 2]) {
+          peaks_.push_back(k);
+        }
+      }
+      const float hop = static_cast<float>(hop_);
+      const auto advance = [&](std::size_t k) {
+        const float expected = bin_step * static_cast<float>(k);
+        const float deviation = WrapPhase(phase_[k] - previous[k] - expected * analysis_hop);
+        synthesis[k] = WrapPhase(synthesis[k] + (expected + deviation / analysis_hop) * hop);
+      };
+      if (peaks_.empty()) {
+        for (std::size_t k = 0; k < bins; ++k) {
+          advance(k);
+        }
+      } else {
+        for (const std::size_t k : peaks_) {
+          advance(k);
+        }
+        std::size_t region = 0;
+        for (std::size_t k = 0; k < bins; ++k) {
+          while (region + 1 < peaks_.size() && k > (peaks_[region] + peaks_[region + 1]) / 2) {
+            ++region;
+          }
+          const std::size_t peak = peaks_[region];
+          if (k != peak) {
+            synthesis[k] = WrapPhase(synthesis[peak] + phase_[k] - phase_[peak]);
+          }
+        }
+      }
+    }
+    std::copy_n(phase_.data(), bins, previous);
+    for (std::size_t k = 0; k < bins; ++k) {
+      spectrum_[k] = {magnitude_[k] * FastSin(synthesis[k] + kHalfPiF), magnitude_[k] * FastSin(synthesis[k])};
+    }
+    fft_->Inverse(spectrum_.data(), frame_.data());
+    float* overlap = overlap_[c].data();
+    for (std::size_t n = 0; n < frame_size_; ++n) {
+      overlap[n] += ola_scale_ * window_[n] * frame_[n];
+    }
+  }
+}
+
+void TimeStretcher::CompactInput() noexcept {
+  // Everything before the next analysis frame's search span, and before
+  // WSOLA's natural continuation of the last segment, is spent.
+  std::int64_t keep = static_cast<std::int64_t>(std::floor(analysis_)) - static_cast<std::int64_t>(tolerance_);
+  if (previous_segment_ >= 0) {
+    keep = std::min(keep, previous_segment_ + static_cast<std::int64_t>(hop_));
+  }
+  const auto drop = static_cast<std::size_t>(
+      std::clamp<std::int64_t>(keep - input_start_, 0, static_cast<std::int64_t>(input_fill_)));
+  if (drop == 0) {
+    return;
+  }
+  for (auto& channel : input_) {
+    std::memmove(channel.data(), channel.data() + drop, (input_fill_ - drop) * sizeof(float));
+  }
+  input_start_ += static_cast<std::int64_t>(drop);
+  input_fill_ -= drop;
+}
+
+std::vector<std::vector<float>> StretchOffline(const float* const* in, std::size_t channels, std::size_t frames,
+                                               std::uint32_t sample_rate, double stretch, float semitones,
+                                               StretchMode mode) {
+  TimeStretcher stretcher(sample_rate, channels, mode, StretchQuality::kHigh);
+  stretcher.SetStretch(stretch, semitones);
+  const auto total = static_cast<std::size_t>(std::llround(static_cast<double>(frames) * stretcher.Stretch()));
+  std::vector<std::vector<float>> out(channels, std::vector<float>(total));
+  const float* from[TimeStretcher::kMaxChannels] = {};
+  float* to[TimeStretcher::kMaxChannels] = {};
+  std::size_t read = 0;
+  for (std::size_t written = 0; written < total;) {
+    const std::size_t chunk = std::min(total - written, TimeStretcher::kMaxPullFrames);
+    // Past the end of the input the frames still in flight drain on silence.
+    for (std::size_t need = stretcher.InputNeeded(chunk); need > 0;) {
+      std::size_t pushed;
+      if (read < frames) {
+        for (std::size_t c = 0; c < channels; ++c) {
+          from[c] = in[c] + read;
+        }
+        pushed = stretcher.Push(from, std::min(need, frames - read));
+        read += pushed;
+      } else {
+        pushed = stretcher.PushSilence(need);
+      }
+      need -= std::min(need, pushed);
+    }
+    for (std::size_t c = 0; c < channels; ++c) {
+      to[c] = out[c].data() + written;
+    }
+    written += stretcher.Pull(to, chunk);
+  }
+  return out;
+}
+
+}  // namespace music_create::audio
+
+extern "C" {
+
+int mc_time_stretch_planar(const float* const* in, unsigned int channels, unsigned long long frames,
+                           unsigned int sample_rate, double stretch, float semitones, int mode, float* const* out,
+                           unsigned long long out_frames) {
+  if (in == nullptr || out == nullptr || (mode != 0 && mode != 1)) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  try {
+    const auto stretched = music_create::audio::StretchOffline(in, channels, static_cast<std::size_t>(frames),
+                                                               sample_rate, stretch, semitones,
+                                                               static_cast<music_create::audio::StretchMode>(mode));
+    for (std::size_t c = 0; c < channels; ++c) {
+      const std::size_t count = std::min<std::size_t>(stretched[c].size(), static_cast<std::size_t>(out_frames));
+      std::copy_n(stretched[c].begin(), count, out[c]);
+      std::fill(out[c] + count, out[c] + out_frames, 0.0f);
+    }
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
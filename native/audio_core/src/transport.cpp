@@ -0,0 +1,879 @@
+#include "transport.hpp"
+
+#include "audio_file_reader.hpp"
+#include "channel_layout.hpp"
+#include "denormals.hpp"
+#include "param_tables.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace music_create::audio {
+
+namespace {
+
+std::size_t MsToFrames(float ms, std::uint32_t sample_rate) {
+  return static_cast<std::size_t>(std::max(ms, 0.0f) * static_cast<float>(sample_rate) / 1000.0f);
+}
+
+constexpr double kTwoPi = 6.283185307179586;
+constexpr std::uint64_t kNoAnchor = std::numeric_limits<std::uint64_t>::max();
+// Drag speed (in playback rates) from which grains play at full level; a
+// slower drag fades them, a held mouse is silent.
+constexpr double kFullLevelScrubRate = 0.25;
+
+// 4-point cubic Hermite between p1 and p2.
+float Hermite(float p0, float p1, float p2, float p3, float t) noexcept {
+  const float c1 = 0.5f * (p2 - p0);
+  const float c2 = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+  const float c3 = 0.5f * (p3 - p0) + 1.5f * (p1 - p2);
+  return ((c3 * t + c2) * t + c1) * t + p1;
+}
+
+// Rising gain `done` frames into a fade of `frames`, taken at the frame's
+// centre so that a fade-out over the same frames mirrors it exactly: linear
+// fades then sum to unity amplitude and equal-power ones to unity power.
+float FadeGain(FadeCurve curve, std::uint64_t done, std::uint64_t frames) noexcept {
+  if (done >= frames) {
+    return 1.0f;
+  }
+  const float x = (static_cast<float>(done) + 0.5f) / static_cast<float>(frames);
+  switch (curve) {
+    case FadeCurve::kLinear:
+      return x;
+    case FadeCurve::kSCurve:
+      return x * x * (3.0f - 2.0f * x);
+    case FadeCurve::kEqualPower:
+      break;
+  }
+  return EqualPowerPan(2.0f * x - 1.0f).right;
+}
+
+}  // namespace
+
+struct Transport::Clip {
+  TransportClip clip;
+  StreamSource source;
+  std::uint64_t end = 0;    // timeline frame after the last one played
+  std::size_t input = 0;    // first channel of the node in the graph inputs
+  std::size_t channels = 0;
+  int slot = -1;
+  std::unique_ptr<TimeStretcher> stretcher;  // only for stretched or pitch-shifted clips
+  std::uint64_t read = 0;                    // next file frame fed to the stretcher
+  std::uint64_t anchor = kNoAnchor;          // file frame a scrub stream was acquired at
+  std::uint64_t reseek_at = 0;               // scrub clock before which it may not re-seek
+  std::uint64_t crossfade_in = 0;            // automatic equal-power fades over overlaps
+  std::uint64_t crossfade_out = 0;
+  ClipLevel level;                           // Render()'s copy of the gain and fades
+
+  double FilePosition(double timeline_frame) const noexcept {
+    return static_cast<double>(clip.offset) + (timeline_frame - static_cast<double>(clip.start)) / clip.stretch;
+  }
+  std::uint64_t FileFrame(std::uint64_t timeline_frame) const noexcept {
+    if (clip.stretch == 1.0) {
+      return clip.offset + (timeline_frame - clip.start);
+    }
+    return static_cast<std::uint64_t>(std::floor(FilePosition(static_cast<double>(timeline_frame))));
+  }
+  // Read-ahead of the stream past FileFrame(t) for output up to t.
+  std::uint64_t Lead() const noexcept { return stretcher ? stretcher->InputLead() : 0; }
+
+  // Whether a fade touches timeline frames [from, to) of the clip.
+  bool Fading(std::uint64_t from, std::uint64_t to) const noexcept {
+    return from < clip.start + std::max(level.fade_in.frames, crossfade_in) ||
+           to + std::max(level.fade_out.frames, crossfade_out) > end;
+  }
+  // Gain of timeline frame `frame` within [clip.start, end).
+  float Level(std::uint64_t frame) const noexcept {
+    const std::uint64_t since = frame - clip.start;
+    const std::uint64_t until = end - frame - 1;
+    return level.gain * FadeGain(level.fade_in.curve, since, level.fade_in.frames) *
+           FadeGain(level.fade_out.curve, until, level.fade_out.frames) *
+           FadeGain(FadeCurve::kEqualPower, since, crossfade_in) *
+           FadeGain(FadeCurve::kEqualPower, until, crossfade_out);
+  }
+};
+
+Transport::Transport(MixGraph& graph, const TransportOptions& options)
+    : graph_(graph),
+      preroll_frames_(MsToFrames(options.preroll_ms, graph.SampleRate())),
+      lookahead_frames_(MsToFrames(options.lookahead_ms, graph.SampleRate())),
+      fetched_(graph.MaxBlock() * 2),
+      stretch_buffer_(graph.MaxBlock() * 2),
+      envelope_(graph.MaxBlock()),
+      grain_frames_(std::max<std::size_t>(MsToFrames(kScrubGrainMs, graph.SampleRate()) & ~std::size_t{1}, 2)),
+      grain_window_(grain_frames_),
+      peeked_((static_cast<std::size_t>(kMaxScrubRate / TimeStretcher::kMinStretch) * grain_frames_ + 4) * 2),
+      scrub_glide_(1.0 - std::exp(-1000.0 / (kScrubGlideMs * graph.SampleRate()))),
+      reseek_frames_(MsToFrames(kScrubReseekMs, graph.SampleRate())),
+      metronome_(graph.SampleRate()),
+      streamer_(options.stream_slots, options.ring_frames) {
+  if (lookahead_frames_ + graph.MaxBlock() + SampleStreamer::kFillChunkFrames * 2 > options.ring_frames) {
+    throw std::invalid_argument("transport look-ahead does not fit the stream rings");
+  }
+  if (peeked_.size() / 2 + SampleStreamer::kFillChunkFrames > options.ring_frames) {
+    throw std::invalid_argument("scrub grains do not fit the stream rings");
+  }
+  grain_phase_[0] = grain_phase_[1] = grain_frames_;  // none in flight
+  // Periodic Hann: grains a half grain apart sum to unity.
+  for (std::size_t n = 0; n < grain_frames_; ++n) {
+    grain_window_[n] = static_cast<float>(0.5 - 0.5 * std::cos(kTwoPi * static_cast<double>(n) / grain_frames_));
+  }
+}
+
+Transport::~Transport() = default;
+
+std::size_t Transport::AddClip(const TransportClip& clip) {
+  if (graph_.IsBus(clip.node)) {
+    throw std::invalid_argument("clips play on track nodes");
+  }
+  const AudioFileInfo info = OpenAudioFileReader(clip.path)->Info();
+  if (info.sample_rate != graph_.SampleRate()) {
+    throw std::runtime_error("clip sample rate differs from the mix graph");
+  }
+  auto state = std::make_unique<Clip>();
+  state->clip = clip;
+  state->level = {clip.gain, clip.fade_in, clip.fade_out};
+  state->source.path = clip.path;
+  state->source.total_frames = info.total_frames;
+  clips_.push_back(std::move(state));
+  SetClipStretch(clips_.size() - 1, clip.stretch, clip.semitones, clip.stretch_mode);
+  return clips_.size() - 1;
+}
+
+void Transport::SetClipStretch(std::size_t index, double stretch, float semitones, StretchMode mode) {
+  Clip& clip = *clips_.at(index);
+  clip.stretcher.reset();
+  clip.clip.stretch = 1.0;
+  clip.clip.semitones = 0.0f;
+  clip.clip.stretch_mode = mode;
+  if (stretch != 1.0 || semitones != 0.0f) {
+    clip.stretcher = std::make_unique<TimeStretcher>(graph_.SampleRate(), 2, mode);
+    clip.stretcher->SetStretch(stretch, semitones);
+    clip.clip.stretch = clip.stretcher->Stretch();
+    clip.clip.semitones = semitones;
+  }
+  UpdateClipEnd(clip);
+  ResolveCrossfades();
+  cued_ = false;
+}
+
+void Transport::SetClipTrim(std::size_t index, std::uint64_t start, std::uint64_t offset, std::uint64_t length) {
+  Clip& clip = *clips_.at(index);
+  clip.clip.start = start;
+  clip.clip.offset = offset;
+  clip.clip.length = length;
+  UpdateClipEnd(clip);
+  ResolveCrossfades();
+  cued_ = false;
+}
+
+bool Transport::SetClipGain(std::size_t index, float gain) {
+  clips_.at(index)->clip.gain = gain;
+  return PostLevel(index);
+}
+
+bool Transport::SetClipFades(std::size_t index, const ClipFade& fade_in, const ClipFade& fade_out) {
+  Clip& clip = *clips_.at(index);
+  clip.clip.fade_in = fade_in;
+  clip.clip.fade_out = fade_out;
+  return PostLevel(index);
+}
+
+bool Transport::PostLevel(std::size_t index) noexcept {
+  const TransportClip& clip = clips_[index]->clip;
+  return level_queue_.Push({index, {clip.gain, clip.fade_in, clip.fade_out}});
+}
+
+void Transport::SyncLevels() noexcept {
+  LevelEdit stale;
+  while (level_queue_.Pop(stale)) {
+  }
+  for (auto& clip : clips_) {
+    clip->level = {clip->clip.gain, clip->clip.fade_in, clip->clip.fade_out};
+  }
+}
+
+void Transport::UpdateClipEnd(Clip& clip) noexcept {
+  const std::uint64_t total = clip.source.total_frames;
+  const std::uint64_t available = total - std::min(clip.clip.offset, total);
+  const std::uint64_t frames = clip.clip.length == 0 ? available : std::min(clip.clip.length, available);
+  clip.end =
+      clip.clip.start + static_cast<std::uint64_t>(std::llround(static_cast<double>(frames) * clip.clip.stretch));
+}
+
+void Transport::ResolveCrossfades() noexcept {
+  // Where a later clip on the same node starts inside an earlier one and
+  // outlasts it, the earlier fades out and the later in over the overlap.
+  // A clip wholly inside another is layered on it and mixes at full level.
+  for (auto& clip : clips_) {
+    clip->crossfade_in = clip->crossfade_out = 0;
+  }
+  for (auto& earlier : clips_) {
+    for (auto& later : clips_) {
+      if (later->clip.node != earlier->clip.node || later->clip.start <= earlier->clip.start ||
+          later->clip.start >= earlier->end || later->end <= earlier->end) {
+        continue;
+      }
+      const std::uint64_t overlap = earlier->end - later->clip.start;
+      earlier->crossfade_out = std::max(earlier->crossfade_out, overlap);
+      later->crossfade_in = std::max(later->crossfade_in, overlap);
+    }
+  }
+}
+
+bool Transport::Cue(std::uint64_t position, std::chrono::milliseconds timeout) {
+  Stop();
+  cued_ = false;
+  scrubbing_ = false;
+  grain_phase_[0] = grain_phase_[1] = grain_frames_;
+  SyncLevels();
+  if (!graph_.Compiled()) {
+    return false;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  BindInputs();
+  ReleaseStreams();
+  graph_.Reset();
+
+  // Feeding the graph its latency ahead of `position` makes the first
+  // rendered output frame the cued one.
+  const std::uint64_t target = position + graph_.Latency();
+  const std::size_t block = graph_.MaxBlock();
+  std::vector<float*> discard(discard_.size());
+  for (std::size_t c = 0; c < discard_.size(); ++c) {
+    discard[c] = discard_[c].data();
+  }
+  bool ok = true;
+  for (std::uint64_t frame = position - std::min<std::uint64_t>(position, preroll_frames_); frame < target;) {
+    const auto frames = static_cast<std::size_t>(std::min<std::uint64_t>(block, target - frame));
+    ok = FillInputs(frame, frames, frame + frames + lookahead_frames_, &deadline) && ok;
+    graph_.Process(input_pointers_.data(), discard.data(), frames);
+    frame += frames;
+  }
+
+  // Streams for every clip heard in the look-ahead window, including the
+  // ones the pre-roll never reached.
+  const std::uint64_t window_end = target + lookahead_frames_;
+  for (auto& clip : clips_) {
+    if (clip->clip.start >= window_end || clip->end <= target) {
+      continue;
+    }
+    if (clip->slot < 0) {
+      OpenStream(*clip, std::max(target, clip->clip.start));
+    }
+    const auto left =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    ok = clip->slot >= 0 &&
+         streamer_.Prime(clip->slot, clip->FileFrame(std::min(clip->end, window_end)) + clip->Lead(),
+                         std::max(left, std::chrono::milliseconds(0))) &&
+         ok;
+  }
+  input_frame_ = target;
+  metronome_.Seek(position);
+  position_.store(position, std::memory_order_release);
+  cued_ = true;
+  return ok;
+}
+
+void Transport::Play() {
+  if (!cued_) {
+    Cue(Position());
+  }
+  playing_.store(true, std::memory_order_release);
+}
+
+void Transport::SetClickMap(std::vector<TempoPoint> tempo, std::vector<MeterPoint> meter) {
+  metronome_.SetTempoMap(std::move(tempo), std::move(meter));
+  metronome_.Seek(Position());
+}
+
+void Transport::SetClick(bool enabled, float gain) noexcept {
+  click_gain_.store(gain, std::memory_order_relaxed);
+  click_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool Transport::BeginScrub() {
+  Stop();
+  if (!graph_.Compiled()) {
+    return false;
+  }
+  if (!cued_) {
+    BindInputs();
+    graph_.Reset();
+  }
+  cued_ = false;
+  // Streams are re-acquired around the grains as they need them.
+  ReleaseStreams();
+  SyncLevels();
+  for (auto& clip : clips_) {
+    clip->anchor = kNoAnchor;
+    clip->reseek_at = 0;
+  }
+  for (auto& grain : grains_) {
+    grain.assign(input_pointers_.size() * grain_frames_, 0.0f);
+  }
+  grain_phase_[0] = grain_phase_[1] = grain_frames_;
+  hop_left_ = 0;
+  std::uint64_t stale = 0;
+  while (scrub_queue_.Pop(stale)) {
+  }
+  scrub_position_ = scrub_target_ = static_cast<double>(Position());
+  scrub_rate_ = 0.0;
+  scrub_clock_ = 0;
+  scrubbing_ = true;
+  return true;
+}
+
+void Transport::EndScrub() noexcept { scrubbing_ = false; }
+
+bool Transport::Render(float* const* outputs, std::size_t frames, float* click_output) noexcept {
+  if (!graph_.Compiled()) {
+    return false;
+  }
+  const std::size_t channels = ChannelCount(graph_.Layout(MixGraph::kMaster));
+  if (click_output != nullptr) {
+    std::fill_n(click_output, frames, 0.0f);
+  }
+  LevelEdit edit;
+  while (level_queue_.Pop(edit)) {
+    clips_[edit.index]->level = edit.level;
+  }
+  const bool grains = grain_phase_[0] < grain_frames_ || grain_phase_[1] < grain_frames_;
+  if (scrubbing_ || grains) {
+    const std::size_t block = graph_.MaxBlock();
+    float* block_outputs[kMaxLayoutChannels] = {};
+    for (std::size_t offset = 0; offset < frames; offset += block) {
+      const std::size_t count = std::min(block, frames - offset);
+      FillScrubInputs(count, scrubbing_);
+      for (std::size_t c = 0; c < channels; ++c) {
+        block_outputs[c] = outputs[c] + offset;
+      }
+      graph_.Process(input_pointers_.data(), block_outputs, count);
+    }
+    position_.store(static_cast<std::uint64_t>(std::llround(std::max(scrub_position_, 0.0))),
+                    std::memory_order_release);
+    return true;
+  }
+  if (!Playing() || !cued_) {
+    for (std::size_t c = 0; c < channels; ++c) {
+      std::fill_n(outputs[c], frames, 0.0f);
+    }
+    return true;
+  }
+  const std::size_t block = graph_.MaxBlock();
+  float* block_outputs[kMaxLayoutChannels] = {};
+  for (std::size_t offset = 0; offset < frames; offset += block) {
+    const std::size_t count = std::min(block, frames - offset);
+    FillInputs(input_frame_, count, input_frame_ + count + lookahead_frames_, nullptr);
+    for (std::size_t c = 0; c < channels; ++c) {
+      block_outputs[c] = outputs[c] + offset;
+    }
+    graph_.Process(input_pointers_.data(), block_outputs, count);
+    input_frame_ += count;
+  }
+  // The click keeps counting while muted, so unmuting lands on the beat.
+  if (!click_enabled_.load(std::memory_order_relaxed)) {
+    metronome_.Render(nullptr, 0, frames, 0.0f);
+  } else if (click_output != nullptr) {
+    metronome_.Render(&click_output, 1, frames, click_gain_.load(std::memory_order_relaxed));
+  } else {
+    metronome_.Render(outputs, std::min<std::size_t>(channels, 2), frames, click_gain_.load(std::memory_order_relaxed));
+  }
+  position_.fetch_add(frames, std::memory_order_acq_rel);
+  return true;
+}
+
+void Transport::ReleaseStreams() noexcept {
+  for (auto& clip : clips_) {
+    streamer_.Release(clip->slot);
+    clip->slot = -1;
+  }
+}
+
+bool Transport::OpenStream(Clip& clip, std::uint64_t from) noexcept {
+  clip.read = clip.FileFrame(from);
+  clip.slot = streamer_.Acquire(clip.source, clip.read);
+  if (clip.stretcher) {
+    clip.stretcher->Reset();
+  }
+  return clip.slot >= 0;
+}
+
+void Transport::BindInputs() {
+  const std::size_t block = graph_.MaxBlock();
+  std::vector<std::size_t> offsets(graph_.NodeCount() + 1, 0);
+  for (std::size_t node = 0; node < graph_.NodeCount(); ++node) {
+    offsets[node + 1] = offsets[node] + ChannelCount(graph_.Layout(static_cast<MixGraph::NodeId>(node)));
+  }
+  inputs_.assign(offsets.back() * block, 0.0f);
+  input_pointers_.resize(offsets.back());
+  for (std::size_t channel = 0; channel < offsets.back(); ++channel) {
+    input_pointers_[channel] = inputs_.data() + channel * block;
+  }
+  for (auto& clip : clips_) {
+    const auto node = static_cast<std::size_t>(clip->clip.node);
+    clip->input = offsets[node];
+    clip->channels = offsets[node + 1] - offsets[node];
+  }
+  discard_.assign(ChannelCount(graph_.Layout(MixGraph::kMaster)), std::vector<float>(block));
+}
+
+bool Transport::FillInputs(std::uint64_t first, std::size_t frames, std::uint64_t acquire_until,
+                           const std::chrono::steady_clock::time_point* deadline) noexcept {
+  const std::size_t block = graph_.MaxBlock();
+  std::fill(inputs_.begin(), inputs_.end(), 0.0f);
+  bool ok = true;
+  for (auto& clip : clips_) {
+    if (clip->end <= first) {
+      if (clip->slot >= 0) {
+        streamer_.Release(clip->slot);
+        clip->slot = -1;
+      }
+      continue;
+    }
+    if (clip->clip.start >= acquire_until) {
+      continue;
+    }
+    const std::uint64_t from = std::max(first, clip->clip.start);
+    if (clip->slot < 0 && !OpenStream(*clip, from)) {
+      ok = false;
+      continue;
+    }
+    const std::uint64_t to = std::min(first + frames, clip->end);
+    if (from >= to) {
+      continue;  // starts later; only its stream is started now
+    }
+    const auto count = static_cast<std::size_t>(to - from);
+    if (deadline != nullptr) {
+      const auto left =
+          std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+      bool resident = false;
+      try {
+        resident = streamer_.Prime(clip->slot, clip->FileFrame(to) + clip->Lead(),
+                                   std::max(left, std::chrono::milliseconds(0)));
+      } catch (...) {
+      }
+      if (!resident) {
+        ok = false;
+        continue;
+      }
+    }
+    if (clip->stretcher) {
+      ok = PullStretched(*clip, count) && ok;
+    } else {
+      bool fetched = false;
+      try {
+        fetched = streamer_.Fetch(clip->slot, clip->FileFrame(from), count, fetched_.data(), false);
+      } catch (...) {
+      }
+      if (!fetched) {
+        ok = false;
+        continue;
+      }
+    }
+    // Stream frames are stereo; a mono node takes the left side, which is
+    // the file itself for mono files, and wider layouts get L/R only.
+    // Away from its fades a clip mixes at its constant gain.
+    const auto at = static_cast<std::size_t>(from - first);
+    const bool fading = clip->Fading(from, to);
+    if (fading) {
+      for (std::size_t n = 0; n < count; ++n) {
+        envelope_[n] = clip->Level(from + n);
+      }
+    }
+    for (std::size_t c = 0; c < std::min<std::size_t>(clip->channels, 2); ++c) {
+      float* target = inputs_.data() + (clip->input + c) * block + at;
+      if (fading) {
+        for (std::size_t n = 0; n < count; ++n) {
+          target[n] += envelope_[n] * fetched_[n * 2 + c];
+        }
+      } else {
+        const float gain = clip->level.gain;
+        for (std::size_t n = 0; n < count; ++n) {
+          target[n] += gain * fetched_[n * 2 + c];
+        }
+      }
+    }
+  }
+  return ok;
+}
+
+bool Transport::PullStretched(Clip& clip, std::size_t frames) noexcept {
+  // The stream is read in order; a block the disk missed is fed as silence
+  // so the stretcher stays aligned with the timeline.
+  TimeStretcher& stretcher = *clip.stretcher;
+  const std::size_t block = graph_.MaxBlock();
+  float* planar[] = {stretch_buffer_.data(), stretch_buffer_.data() + block};
+  bool ok = true;
+  for (std::size_t need = stretcher.InputNeeded(frames); need > 0;) {
+    const std::size_t count = std::min(need, block);
+    bool fetched = false;
+    try {
+      fetched = streamer_.Fetch(clip.slot, clip.read, count, fetched_.data(), false);
+    } catch (...) {
+    }
+    if (fetched) {
+      for (std::size_t n = 0; n < count; ++n) {
+        planar[0][n] = fetched_[n * 2];
+        planar[1][n] = fetched_[n * 2 + 1];
+      }
+      stretcher.Push(planar, count);
+    } else {
+      stretcher.PushSilence(count);
+      ok = false;
+    }
+    clip.read += count;
+    need -= count;
+  }
+  stretcher.Pull(planar, frames);
+  for (std::size_t n = 0; n < frames; ++n) {
+    fetched_[n * 2] = planar[0][n];
+    fetched_[n * 2 + 1] = planar[1][n];
+  }
+  return ok;
+}
+
+void Transport::FillScrubInputs(std::size_t frames, bool spawn) noexcept {
+  // Only the latest drag position matters; older ones are stale.
+  std::uint64_t target = 0;
+  while (scrub_queue_.Pop(target)) {
+    scrub_target_ = static_cast<double>(target);
+  }
+  const std::size_t block = graph_.MaxBlock();
+  std::fill(inputs_.begin(), inputs_.end(), 0.0f);
+  for (std::size_t n = 0; n < frames;) {
+    if (hop_left_ == 0) {
+      if (spawn) {
+        const int free = grain_phase_[0] >= grain_frames_ ? 0 : 1;
+        SpawnGrain(grains_[free]);
+        grain_phase_[free] = 0;
+      }
+      hop_left_ = grain_frames_ / 2;
+    }
+    const std::size_t span = std::min(frames - n, hop_left_);
+    for (int g = 0; g < 2; ++g) {
+      const std::size_t phase = grain_phase_[g];
+      if (phase >= grain_frames_) {
+        continue;
+      }
+      const std::size_t count = std::min(span, grain_frames_ - phase);
+      for (std::size_t channel = 0; channel < input_pointers_.size(); ++channel) {
+        const float* source = grains_[g].data() + channel * grain_frames_ + phase;
+        float* target_samples = inputs_.data() + channel * block + n;
+        for (std::size_t k = 0; k < count; ++k) {
+          target_samples[k] += source[k];
+        }
+      }
+      grain_phase_[g] = phase + count;
+    }
+    if (spawn) {
+      scrub_position_ = std::max(scrub_position_ + scrub_rate_ * static_cast<double>(span), 0.0);
+    }
+    scrub_clock_ += span;
+    hop_left_ -= span;
+    n += span;
+  }
+}
+
+void Transport::SpawnGrain(std::vector<float>& grain) noexcept {
+  std::fill(grain.begin(), grain.end(), 0.0f);
+  // The grains glide after the drag position: the rate is the one-pole step
+  // towards it, so a fast drag plays faster (and higher), a held one stops.
+  const double rate = std::clamp((scrub_target_ - scrub_position_) * scrub_glide_, -static_cast<double>(kMaxScrubRate),
+                                 static_cast<double>(kMaxScrubRate));
+  scrub_rate_ = rate;
+  const auto level = static_cast<float>(std::min(1.0, std::abs(rate) / kFullLevelScrubRate));
+  if (level < 1e-3f) {
+    return;
+  }
+  const double start = scrub_position_;
+  const double last = start + rate * static_cast<double>(grain_frames_ - 1);
+  for (auto& clip : clips_) {
+    // The grain's span of the clip in file frames (a stretched clip is read
+    // at its stretched rate; pitch shifts do not apply while scrubbing),
+    // with the frame before and the two after that the interpolator touches.
+    const double clip_first = std::max(std::min(start, last), static_cast<double>(clip->clip.start));
+    const double clip_last = std::min(std::max(start, last), static_cast<double>(clip->end));
+    if (clip_first > clip_last || clip->end <= clip->clip.start) {
+      continue;
+    }
+    const auto file_first = static_cast<std::int64_t>(clip->clip.offset);
+    const auto file_end = static_cast<std::int64_t>(clip->FileFrame(clip->end));
+    const auto from = std::max(static_cast<std::int64_t>(std::floor(clip->FilePosition(clip_first))) - 1, file_first);
+    const auto to = std::min(static_cast<std::int64_t>(std::floor(clip->FilePosition(clip_last))) + 3, file_end);
+    if (from >= to) {
+      continue;
+    }
+    const auto count = std::min(static_cast<std::size_t>(to - from), peeked_.size() / 2);
+    if (!PeekClip(*clip, static_cast<std::uint64_t>(from), count)) {
+      continue;  // still loading: this part of the grain stays silent
+    }
+    const auto sample = [&](std::int64_t frame, std::size_t c) {
+      return frame >= from && frame < from + static_cast<std::int64_t>(count)
+                 ? peeked_[static_cast<std::size_t>(frame - from) * 2 + c]
+                 : 0.0f;
+    };
+    // The clip's fades follow the grain across the timeline.
+    const auto clip_end = static_cast<double>(clip->end - 1);
+    const bool fading = clip->Fading(static_cast<std::uint64_t>(clip_first), static_cast<std::uint64_t>(clip_last) + 1);
+    const auto gain = [&](std::size_t k) {
+      if (!fading) {
+        return level * clip->level.gain;
+      }
+      const double frame =
+          std::clamp(start + rate * static_cast<double>(k), static_cast<double>(clip->clip.start), clip_end);
+      return level * clip->Level(static_cast<std::uint64_t>(frame));
+    };
+    const double file_start = clip->FilePosition(start);
+    const double file_rate = rate / clip->clip.stretch;
+    for (std::size_t c = 0; c < std::min<std::size_t>(clip->channels, 2); ++c) {
+      float* out = grain.data() + (clip->input + c) * grain_frames_;
+      for (std::size_t k = 0; k < grain_frames_; ++k) {
+        const double at = file_start + file_rate * static_cast<double>(k);
+        const auto frame = static_cast<std::int64_t>(std::floor(at));
+        const auto t = static_cast<float>(at - static_cast<double>(frame));
+        const float value =
+            Hermite(sample(frame - 1, c), sample(frame, c), sample(frame + 1, c), sample(frame + 2, c), t);
+        out[k] += gain(k) * grain_window_[k] * value;
+      }
+    }
+  }
+}
+
+bool Transport::PeekClip(Clip& clip, std::uint64_t first, std::size_t count) noexcept {
+  // A scrub stream never fetches, so its ring keeps everything from the
+  // anchor up to a ring's worth ahead and grains move freely inside.
+  const std::size_t window = streamer_.RingFrames() - SampleStreamer::kFillChunkFrames;
+  if (clip.slot >= 0 && first >= clip.anchor && first + count <= clip.anchor + window) {
+    return streamer_.Peek(clip.slot, first, count, peeked_.data());
+  }
+  if (scrub_clock_ < clip.reseek_at) {
+    return false;
+  }
+  // Re-seek centred on the grain so a drag either way stays inside.
+  streamer_.Release(clip.slot);
+  const std::uint64_t centre = first + count / 2;
+  clip.anchor = std::max(clip.clip.offset, centre - std::min<std::uint64_t>(centre, window / 2));
+  clip.slot = streamer_.Acquire(clip.source, clip.anchor);
+  clip.reseek_at = scrub_clock_ + reseek_frames_;
+  if (clip.slot < 0) {
+    clip.anchor = kNoAnchor;
+  }
+  return false;
+}
+
+}  // namespace music_create::audio
+
+struct mc_transport {
+  mc_transport(music_create::audio::MixGraph& graph, const music_create::audio::TransportOptions& options)
+      : transport(graph, options) {}
+
+  music_create::audio::Transport transport;
+};
+
+extern "C" {
+
+mc_transport* mc_transport_create(mc_mix_graph* graph, float preroll_ms, float lookahead_ms) {
+  if (graph == nullptr) {
+    return nullptr;
+  }
+  try {
+    music_create::audio::TransportOptions options;
+    options.preroll_ms = preroll_ms;
+    options.lookahead_ms = lookahead_ms;
+    return new mc_transport(graph->graph, options);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_transport_free(mc_transport* transport) { delete transport; }
+
+int mc_transport_add_clip_w(mc_transport* transport, const wchar_t* path, int node, unsigned long long start,
+                            unsigned long long offset, unsigned long long length, float gain) {
+  if (transport == nullptr || path == nullptr) {
+    return -1;
+  }
+  try {
+    return static_cast<int>(transport->transport.AddClip({.path = std::filesystem::path(path),
+                                                          .node = node,
+                                                          .start = start,
+                                                          .offset = offset,
+                                                          .length = length,
+                                                          .gain = gain}));
+  } catch (...) {
+    return -1;
+  }
+}
+
+int mc_transport_set_clip_stretch(mc_transport* transport, int clip, double stretch, float semitones, int mode) {
+  if (transport == nullptr || clip < 0 || (mode != 0 && mode != 1)) {
+    return 0;
+  }
+  try {
+    transport->transport.SetClipStretch(static_cast<std::size_t>(clip), stretch, semitones,
+                                        static_cast<music_create::audio::StretchMode>(mode));
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_set_clip_trim(mc_transport* transport, int clip, unsigned long long start, unsigned long long offset,
+                               unsigned long long length) {
+  if (transport == nullptr || clip < 0) {
+    return 0;
+  }
+  try {
+    transport->transport.SetClipTrim(static_cast<std::size_t>(clip), start, offset, length);
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_set_clip_gain(mc_transport* transport, int clip, float gain) {
+  if (transport == nullptr || clip < 0) {
+    return 0;
+  }
+  try {
+    return transport->transport.SetClipGain(static_cast<std::size_t>(clip), gain) ? 1 : 0;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_set_clip_fades(mc_transport* transport, int clip, unsigned long long fade_in_frames, int fade_in_curve,
+                                unsigned long long fade_out_frames, int fade_out_curve) {
+  if (transport == nullptr || clip < 0 || fade_in_curve < 0 || fade_in_curve > 2 || fade_out_curve < 0 ||
+      fade_out_curve > 2) {
+    return 0;
+  }
+  try {
+    return transport->transport.SetClipFades(
+               static_cast<std::size_t>(clip),
+               {fade_in_frames, static_cast<music_create::audio::FadeCurve>(fade_in_curve)},
+               {fade_out_frames, static_cast<music_create::audio::FadeCurve>(fade_out_curve)})
+               ? 1
+               : 0;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_cue(mc_transport* transport, unsigned long long position, unsigned int timeout_ms) {
+  if (transport == nullptr) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  try {
+    return transport->transport.Cue(position, std::chrono::milliseconds(timeout_ms)) ? 1 : 0;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_play(mc_transport* transport) {
+  if (transport == nullptr) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  try {
+    transport->transport.Play();
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_stop(mc_transport* transport) {
+  if (transport == nullptr) {
+    return 0;
+  }
+  transport->transport.Stop();
+  return 1;
+}
+
+int mc_transport_render(mc_transport* transport, float* const* outputs, unsigned long long frames) {
+  if (transport == nullptr || (frames > 0 && outputs == nullptr)) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  return transport->transport.Render(outputs, static_cast<std::size_t>(frames)) ? 1 : 0;
+}
+
+int mc_transport_render_with_click(mc_transport* transport, float* const* outputs, float* click,
+                                   unsigned long long frames) {
+  if (transport == nullptr || (frames > 0 && (outputs == nullptr || click == nullptr))) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  return transport->transport.Render(outputs, static_cast<std::size_t>(frames), click) ? 1 : 0;
+}
+
+int mc_transport_set_click_map(mc_transport* transport, const double* tempo_beats, const double* tempo_bpm,
+                               unsigned int tempo_count, const double* meter_beats, const int* meter_numerators,
+                               const int* meter_denominators, unsigned int meter_count) {
+  if (transport == nullptr || (tempo_count > 0 && (tempo_beats == nullptr || tempo_bpm == nullptr)) ||
+      (meter_count > 0 && (meter_beats == nullptr || meter_numerators == nullptr || meter_denominators == nullptr))) {
+    return 0;
+  }
+  try {
+    std::vector<music_create::audio::TempoPoint> tempo(tempo_count);
+    for (unsigned int i = 0; i < tempo_count; ++i) {
+      tempo[i] = {tempo_beats[i], tempo_bpm[i]};
+    }
+    std::vector<music_create::audio::MeterPoint> meter(meter_count);
+    for (unsigned int i = 0; i < meter_count; ++i) {
+      meter[i] = {meter_beats[i], meter_numerators[i], meter_denominators[i]};
+    }
+    transport->transport.SetClickMap(std::move(tempo), std::move(meter));
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_set_click(mc_transport* transport, int enabled, float gain) {
+  if (transport == nullptr) {
+    return 0;
+  }
+  transport->transport.SetClick(enabled != 0, gain);
+  return 1;
+}
+
+int mc_transport_begin_scrub(mc_transport* transport) {
+  if (transport == nullptr) {
+    return 0;
+  }
+  try {
+    return transport->transport.BeginScrub() ? 1 : 0;
+  } catch (...) {
+    return 0;
+  }
+}
+
+int mc_transport_scrub_to(mc_transport* transport, unsigned long long position) {
+  return transport != nullptr && transport->transport.ScrubTo(position) ? 1 : 0;
+}
+
+int mc_transport_end_scrub(mc_transport* transport) {
+  if (transport == nullptr) {
+    return 0;
+  }
+  transport->transport.EndScrub();
+  return 1;
+}
+
+unsigned long long mc_transport_position(const mc_transport* transport) {
+  return transport == nullptr ? 0 : transport->transport.Position();
+}
+
+unsigned long long mc_transport_underruns(const mc_transport* transport) {
+  return transport == nullptr ? 0 : transport->transport.Underruns();
+}
+
+}  // extern "C"
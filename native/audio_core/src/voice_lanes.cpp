@@ -0,0 +1,441 @@
+#include "voice_lanes.hpp"
+
+#include "cpu_features.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if MC_AUDIO_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace music_create::audio {
+
+namespace {
+
+constexpr std::size_t kBlockFrames = 128;
+constexpr std::size_t kMaxLaneWidth = 16;
+constexpr std::uint32_t kFractionMask = (1u << Wavetable::kFractionBits) - 1;
+constexpr float kFractionScale = 1.0f / static_cast<float>(1u << Wavetable::kFractionBits);
+
+struct PendingVoice {
+  std::int64_t start;
+  std::int32_t total;
+  std::int32_t rendered;
+  std::uint32_t increment;
+  std::int32_t table_offset;
+  float gain;
+};
+
+struct LaneParams {
+  const float* tables;
+  std::int32_t attack;
+  float inv_attack;
+  float sustain;
+  float decay_step;
+  float inv_release;
+};
+
+// Structure-of-arrays voice state. Entries past `count` up to the padded size
+// are inert lanes (rendered = 0) so kernels never need a scalar tail.
+struct VoiceLanes {
+  std::vector<std::uint32_t> phase;
+  std::vector<std::uint32_t> increment;
+  std::vector<std::int32_t> table_offset;
+  std::vector<std::int32_t> index;  // samples since note start, negative before it
+  std::vector<std::int32_t> rendered;
+  std::vector<std::int32_t> total;
+  std::vector<std::int32_t> release_start;
+  std::vector<float> gain;
+  std::vector<float> decay;
+  std::size_t count = 0;
+
+  void Reserve(std::size_t voices) {
+    const std::size_t capacity = voices + kMaxLaneWidth;
+    for (auto* column : {&phase, &increment}) {
+      column->reserve(capacity);
+    }
+    for (auto* column : {&table_offset, &index, &rendered, &total, &release_start}) {
+      column->reserve(capacity);
+    }
+    gain.reserve(capacity);
+    decay.reserve(capacity);
+  }
+
+  void Push(const PendingVoice& voice, std::int64_t block_start, std::int32_t release) {
+    Resize(count + 1);
+    phase[count] = 0;
+    increment[count] = voice.increment;
+    table_offset[count] = voice.table_offset;
+    index[count] = static_cast<std::int32_t>(block_start - voice.start);
+    rendered[count] = voice.rendered;
+    total[count] = voice.total;
+    release_start[count] = voice.total - release;
+    gain[count] = voice.gain;
+    decay[count] = 1.0f;
+    ++count;
+  }
+
+  void RemoveFinished() {
+    std::size_t write = 0;
+    for (std::size_t read = 0; read < count; ++read) {
+      if (index[read] >= rendered[read]) {
+        continue;
+      }
+      if (write != read) {
+        phase[write] = phase[read];
+        increment[write] = increment[read];
+        table_offset[write] = table_offset[read];
+        index[write] = index[read];
+        rendered[write] = rendered[read];
+        total[write] = total[read];
+        release_start[write] = release_start[read];
+        gain[write] = gain[read];
+        decay[write] = decay[read];
+      }
+      ++write;
+    }
+    count = write;
+  }
+
+  std::size_t Pad(std::size_t width) {
+    const std::size_t padded = (count + width - 1) / width * width;
+    Resize(padded);
+    for (std::size_t lane = count; lane < padded; ++lane) {
+      phase[lane] = 0;
+      increment[lane] = 0;
+      table_offset[lane] = 0;
+      index[lane] = 0;
+      rendered[lane] = 0;
+      total[lane] = 0;
+      release_start[lane] = 0;
+      gain[lane] = 0.0f;
+      decay[lane] = 0.0f;
+    }
+    return padded;
+  }
+
+ private:
+  void Resize(std::size_t size) {
+    if (phase.size() >= size) {
+      return;
+    }
+    phase.resize(size);
+    increment.resize(size);
+    table_offset.resize(size);
+    index.resize(size);
+    rendered.resize(size);
+    total.resize(size);
+    release_start.resize(size);
+    gain.resize(size);
+    decay.resize(size);
+  }
+};
+
+void RenderLanesScalar(VoiceLanes& lanes, std::size_t padded, const LaneParams& params, float* out,
+                       std::size_t frames) {
+  for (std::size_t lane = 0; lane < padded; ++lane) {
+    const float* wave = params.tables + lanes.table_offset[lane];
+    std::uint32_t phase = lanes.phase[lane];
+    std::int32_t i = lanes.index[lane];
+    float decay = lanes.decay[lane];
+    for (std::size_t s = 0; s < frames; ++s, ++i) {
+      if (i < 0 || i >= lanes.rendered[lane]) {
+        continue;
+      }
+      float env;
+      if (i < params.attack) {
+        env = static_cast<float>(i) * params.inv_attack;
+      } else {
+        env = params.sustain + (1.0f - params.sustain) * decay;
+        decay *= params.decay_step;
+        if (i > lanes.release_start[lane]) {
+          env *= static_cast<float>(lanes.total[lane] - i) * params.inv_release;
+        }
+      }
+      out[s] += ReadWavetable(wave, phase) * lanes.gain[lane] * env;
+      phase += lanes.increment[lane];
+    }
+    lanes.phase[lane] = phase;
+    lanes.index[lane] = i;
+    lanes.decay[lane] = decay;
+  }
+}
+
+#if MC_AUDIO_X86_DISPATCH
+MC_AUDIO_TARGET("sse4.1")
+void RenderLanesSse41(VoiceLanes& lanes, std::size_t padded, const LaneParams& params, float* out,
+                      std::size_t frames) {
+  const __m128i minus_one = _mm_set1_epi32(-1);
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i attack = _mm_set1_epi32(params.attack);
+  const __m128i fraction_mask = _mm_set1_epi32(static_cast<int>(kFractionMask));
+  const __m128 inv_attack = _mm_set1_ps(params.inv_attack);
+  const __m128 sustain = _mm_set1_ps(params.sustain);
+  const __m128 sustain_span = _mm_set1_ps(1.0f - params.sustain);
+  const __m128 decay_step = _mm_set1_ps(params.decay_step);
+  const __m128 inv_release = _mm_set1_ps(params.inv_release);
+  const __m128 fraction_scale = _mm_set1_ps(kFractionScale);
+  alignas(16) std::int32_t offsets[4];
+
+  for (std::size_t base = 0; base < padded; base += 4) {
+    __m128i phase = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.phase[base]));
+    __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.index[base]));
+    __m128 decay = _mm_loadu_ps(&lanes.decay[base]);
+    const __m128i increment = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.increment[base]));
+    const __m128i table_offset = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.table_offset[base]));
+    const __m128i rendered = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.rendered[base]));
+    const __m128i total = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.total[base]));
+    const __m128i release_start = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lanes.release_start[base]));
+    const __m128 gain = _mm_loadu_ps(&lanes.gain[base]);
+
+    for (std::size_t s = 0; s < frames; ++s) {
+      const __m128i active = _mm_and_si128(_mm_cmpgt_epi32(i, minus_one), _mm_cmpgt_epi32(rendered, i));
+      const __m128i in_attack = _mm_cmpgt_epi32(attack, i);
+      const __m128 env_attack = _mm_mul_ps(_mm_cvtepi32_ps(i), inv_attack);
+      __m128 env_decay = _mm_add_ps(sustain, _mm_mul_ps(sustain_span, decay));
+      const __m128 release = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(total, i)), inv_release);
+      env_decay = _mm_blendv_ps(env_decay, _mm_mul_ps(env_decay, release),
+                                _mm_castsi128_ps(_mm_cmpgt_epi32(i, release_start)));
+      const __m128 env = _mm_blendv_ps(env_decay, env_attack, _mm_castsi128_ps(in_attack));
+      decay = _mm_blendv_ps(decay, _mm_mul_ps(decay, decay_step),
+                            _mm_castsi128_ps(_mm_andnot_si128(in_attack, active)));
+
+      _mm_store_si128(reinterpret_cast<__m128i*>(offsets),
+                      _mm_add_epi32(_mm_srli_epi32(phase, Wavetable::kFractionBits), table_offset));
+      const __m128 a = _mm_setr_ps(params.tables[offsets[0]], params.tables[offsets[1]], params.tables[offsets[2]],
+                                   params.tables[offsets[3]]);
+      const __m128 b = _mm_setr_ps(params.tables[offsets[0] + 1], params.tables[offsets[1] + 1],
+                                   params.tables[offsets[2] + 1], params.tables[offsets[3] + 1]);
+      const __m128 fraction = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(phase, fraction_mask)), fraction_scale);
+      const __m128 sample = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction));
+      __m128 mixed = _mm_and_ps(_mm_mul_ps(_mm_mul_ps(sample, gain), env), _mm_castsi128_ps(active));
+      mixed = _mm_add_ps(mixed, _mm_movehl_ps(mixed, mixed));
+      mixed = _mm_add_ss(mixed, _mm_shuffle_ps(mixed, mixed, 0x55));
+      out[s] += _mm_cvtss_f32(mixed);
+
+      phase = _mm_add_epi32(phase, _mm_and_si128(increment, active));
+      i = _mm_add_epi32(i, one);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&lanes.phase[base]), phase);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&lanes.index[base]), i);
+    _mm_storeu_ps(&lanes.decay[base], decay);
+  }
+}
+
+MC_AUDIO_TARGET("avx2")
+void RenderLanesAvx2(VoiceLanes& lanes, std::size_t padded, const LaneParams& params, float* out,
+                     std::size_t frames) {
+  const __m256i minus_one = _mm256_set1_epi32(-1);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i attack = _mm256_set1_epi32(params.attack);
+  const __m256i fraction_mask = _mm256_set1_epi32(static_cast<int>(kFractionMask));
+  const __m256 inv_attack = _mm256_set1_ps(params.inv_attack);
+  const __m256 sustain = _mm256_set1_ps(params.sustain);
+  const __m256 sustain_span = _mm256_set1_ps(1.0f - params.sustain);
+  const __m256 decay_step = _mm256_set1_ps(params.decay_step);
+  const __m256 inv_release = _mm256_set1_ps(params.inv_release);
+  const __m256 fraction_scale = _mm256_set1_ps(kFractionScale);
+
+  for (std::size_t base = 0; base < padded; base += 8) {
+    __m256i phase = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.phase[base]));
+    __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.index[base]));
+    __m256 decay = _mm256_loadu_ps(&lanes.decay[base]);
+    const __m256i increment = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.increment[base]));
+    const __m256i table_offset = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.table_offset[base]));
+    const __m256i rendered = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.rendered[base]));
+    const __m256i total = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.total[base]));
+    const __m256i release_start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&lanes.release_start[base]));
+    const __m256 gain = _mm256_loadu_ps(&lanes.gain[base]);
+
+    for (std::size_t s = 0; s < frames; ++s) {
+      const __m256i active = _mm256_and_si256(_mm256_cmpgt_epi32(i, minus_one), _mm256_cmpgt_epi32(rendered, i));
+      const __m256i in_attack = _mm256_cmpgt_epi32(attack, i);
+      const __m256 env_attack = _mm256_mul_ps(_mm256_cvtepi32_ps(i), inv_attack);
+      __m256 env_decay = _mm256_add_ps(sustain, _mm256_mul_ps(sustain_span, decay));
+      const __m256 release = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(total, i)), inv_release);
+      env_decay = _mm256_blendv_ps(env_decay, _mm256_mul_ps(env_decay, release),
+                                   _mm256_castsi256_ps(_mm256_cmpgt_epi32(i, release_start)));
+      const __m256 env = _mm256_blendv_ps(env_decay, env_attack, _mm256_castsi256_ps(in_attack));
+      decay = _mm256_blendv_ps(decay, _mm256_mul_ps(decay, decay_step),
+                               _mm256_castsi256_ps(_mm256_andnot_si256(in_attack, active)));
+
+      const __m256i offsets = _mm256_add_epi32(_mm256_srli_epi32(phase, Wavetable::kFractionBits), table_offset);
+      const __m256 a = _mm256_i32gather_ps(params.tables, offsets, 4);
+      const __m256 b = _mm256_i32gather_ps(params.tables + 1, offsets, 4);
+      const __m256 fraction = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(phase, fraction_mask)), fraction_scale);
+      const __m256 sample = _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), fraction));
+      const __m256 mixed = _mm256_and_ps(_mm256_mul_ps(_mm256_mul_ps(sample, gain), env), _mm256_castsi256_ps(active));
+      __m128 half = _mm_add_ps(_mm256_castps256_ps128(mixed), _mm256_extractf128_ps(mixed, 1));
+      half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+      half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 0x55));
+      out[s] += _mm_cvtss_f32(half);
+
+      phase = _mm256_add_epi32(phase, _mm256_and_si256(increment, active));
+      i = _mm256_add_epi32(i, one);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&lanes.phase[base]), phase);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&lanes.index[base]), i);
+    _mm256_storeu_ps(&lanes.decay[base], decay);
+  }
+}
+
+MC_AUDIO_TARGET("avx512f")
+void RenderLanesAvx512(VoiceLanes& lanes, std::size_t padded, const LaneParams& params, float* out,
+                       std::size_t frames) {
+  const __m512i minus_one = _mm512_set1_epi32(-1);
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i attack = _mm512_set1_epi32(params.attack);
+  const __m512i fraction_mask = _mm512_set1_epi32(static_cast<int>(kFractionMask));
+  const __m512 inv_attack = _mm512_set1_ps(params.inv_attack);
+  const __m512 sustain = _mm512_set1_ps(params.sustain);
+  const __m512 sustain_span = _mm512_set1_ps(1.0f - params.sustain);
+  const __m512 decay_step = _mm512_set1_ps(params.decay_step);
+  const __m512 inv_release = _mm512_set1_ps(params.inv_release);
+  const __m512 fraction_scale = _mm512_set1_ps(kFractionScale);
+
+  for (std::size_t base = 0; base < padded; base += 16) {
+    __m512i phase = _mm512_loadu_si512(&lanes.phase[base]);
+    __m512i i = _mm512_loadu_si512(&lanes.index[base]);
+    __m512 decay = _mm512_loadu_ps(&lanes.decay[base]);
+    const __m512i increment = _mm512_loadu_si512(&lanes.increment[base]);
+    const __m512i table_offset = _mm512_loadu_si512(&lanes.table_offset[base]);
+    const __m512i rendered = _mm512_loadu_si512(&lanes.rendered[base]);
+    const __m512i total = _mm512_loadu_si512(&lanes.total[base]);
+    const __m512i release_start = _mm512_loadu_si512(&lanes.release_start[base]);
+    const __m512 gain = _mm512_loadu_ps(&lanes.gain[base]);
+
+    for (std::size_t s = 0; s < frames; ++s) {
+      const __mmask16 active = _mm512_cmpgt_epi32_mask(i, minus_one) & _mm512_cmpgt_epi32_mask(rendered, i);
+      const __mmask16 in_attack = _mm512_cmpgt_epi32_mask(attack, i);
+      const __m512 env_attack = _mm512_mul_ps(_mm512_cvtepi32_ps(i), inv_attack);
+      __m512 env_decay = _mm512_add_ps(sustain, _mm512_mul_ps(sustain_span, decay));
+      const __m512 release = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_sub_epi32(total, i)), inv_release);
+      env_decay = _mm512_mask_mul_ps(env_decay, _mm512_cmpgt_epi32_mask(i, release_start), env_decay, release);
+      const __m512 env = _mm512_mask_blend_ps(in_attack, env_decay, env_attack);
+      decay = _mm512_mask_mul_ps(decay, static_cast<__mmask16>(~in_attack & active), decay, decay_step);
+
+      const __m512i offsets = _mm512_add_epi32(_mm512_srli_epi32(phase, Wavetable::kFractionBits), table_offset);
+      const __m512 a = _mm512_i32gather_ps(offsets, params.tables, 4);
+      const __m512 b = _mm512_i32gather_ps(offsets, params.tables + 1, 4);
+      const __m512 fraction = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_and_si512(phase, fraction_mask)), fraction_scale);
+      const __m512 sample = _mm512_add_ps(a, _mm512_mul_ps(_mm512_sub_ps(b, a), fraction));
+      out[s] += _mm512_reduce_add_ps(_mm512_maskz_mul_ps(active, _mm512_mul_ps(sample, gain), env));
+
+      phase = _mm512_mask_add_epi32(phase, active, phase, increment);
+      i = _mm512_add_epi32(i, one);
+    }
+    _mm512_storeu_si512(&lanes.phase[base], phase);
+    _mm512_storeu_si512(&lanes.index[base], i);
+    _mm512_storeu_ps(&lanes.decay[base], decay);
+  }
+}
+#endif
+
+}  // namespace
+
+VoiceLaneWidth ResolveVoiceLaneWidth(VoiceLaneWidth requested) noexcept {
+  const CpuFeatures& cpu = DetectCpuFeatures();
+  VoiceLaneWidth best = VoiceLaneWidth::kScalar;
+#if MC_AUDIO_X86_DISPATCH
+  if (cpu.avx512f) {
+    best = VoiceLaneWidth::kAvx512;
+  } else if (cpu.avx2) {
+    best = VoiceLaneWidth::kAvx2;
+  } else if (cpu.sse41) {
+    best = VoiceLaneWidth::kSse41;
+  }
+#else
+  (void)cpu;
+#endif
+  if (requested == VoiceLaneWidth::kAuto) {
+    return best;
+  }
+  return static_cast<int>(requested) < static_cast<int>(best) ? requested : best;
+}
+
+void RenderToneNotesParallel(const Wavetable& table, const ToneEnvelope& envelope, float unison_detune,
+                             const ToneNote* notes, std::size_t count, float* out, std::size_t frames,
+                             VoiceLaneWidth width) {
+  const VoiceLaneWidth resolved = ResolveVoiceLaneWidth(width);
+  const auto lane_width = static_cast<std::size_t>(resolved);
+  const bool unison = unison_detune > 0.0f;
+  const float voice_gain = unison ? 0.5f : 1.0f;
+
+  std::vector<PendingVoice> pending;
+  pending.reserve(unison ? count * 2 : count);
+  for (std::size_t n = 0; n < count; ++n) {
+    const ToneNote& note = notes[n];
+    if (note.start_sample < 0 || note.start_sample >= static_cast<std::int64_t>(frames) || note.length_samples <= 0) {
+      continue;
+    }
+    const std::int64_t rendered =
+        std::min<std::int64_t>(note.length_samples, static_cast<std::int64_t>(frames) - note.start_sample);
+    const double upper_hz = note.frequency * (1.0 + std::max(unison_detune, 0.0f));
+    const auto offset = static_cast<std::int32_t>(Wavetable::LevelOffset(table.LevelForFrequency(upper_hz)));
+    const auto total = static_cast<std::int32_t>(std::min<std::int64_t>(note.length_samples, INT32_MAX));
+    const float gain = note.amplitude * voice_gain;
+    pending.push_back({note.start_sample, total, static_cast<std::int32_t>(rendered),
+                       table.PhaseIncrement(note.frequency), offset, gain});
+    if (unison) {
+      pending.push_back({note.start_sample, total, static_cast<std::int32_t>(rendered), table.PhaseIncrement(upper_hz),
+                         offset, gain});
+    }
+  }
+  std::stable_sort(pending.begin(), pending.end(),
+                   [](const PendingVoice& lhs, const PendingVoice& rhs) { return lhs.start < rhs.start; });
+
+  const auto attack = static_cast<std::int32_t>(std::clamp<std::int64_t>(envelope.attack_samples, 1, INT32_MAX));
+  const auto release = static_cast<std::int32_t>(std::clamp<std::int64_t>(envelope.release_samples, 1, INT32_MAX));
+  const double decay_per_sample = static_cast<double>(envelope.decay_rate) / table.SampleRate();
+  const LaneParams params{table.Data(),
+                          attack,
+                          1.0f / static_cast<float>(attack),
+                          envelope.sustain,
+                          static_cast<float>(std::exp(-decay_per_sample)),
+                          1.0f / static_cast<float>(release)};
+
+  VoiceLanes lanes;
+  lanes.Reserve(std::min<std::size_t>(pending.size(), 1024));
+  std::size_t next = 0;
+  for (std::size_t block_start = 0; block_start < frames; block_start += kBlockFrames) {
+    const std::size_t block_frames = std::min(kBlockFrames, frames - block_start);
+    while (next < pending.size() && pending[next].start < static_cast<std::int64_t>(block_start + block_frames)) {
+      lanes.Push(pending[next++], static_cast<std::int64_t>(block_start), release);
+    }
+    if (lanes.count == 0) {
+      if (next == pending.size()) {
+        break;
+      }
+      continue;
+    }
+    // Re-anchor the recursive decay each block so float error cannot accumulate over long notes.
+    for (std::size_t lane = 0; lane < lanes.count; ++lane) {
+      const std::int32_t i = lanes.index[lane];
+      lanes.decay[lane] = i > attack ? static_cast<float>(std::exp(-decay_per_sample * (i - attack))) : 1.0f;
+    }
+    const std::size_t padded = lanes.Pad(lane_width);
+    float* block_out = out + block_start;
+    switch (resolved) {
+#if MC_AUDIO_X86_DISPATCH
+      case VoiceLaneWidth::kAvx512:
+        RenderLanesAvx512(lanes, padded, params, block_out, block_frames);
+        break;
+      case VoiceLaneWidth::kAvx2:
+        RenderLanesAvx2(lanes, padded, params, block_out, block_frames);
+        break;
+      case VoiceLaneWidth::kSse41:
+        RenderLanesSse41(lanes, padded, params, block_out, block_frames);
+        break;
+#endif
+      default:
+        RenderLanesScalar(lanes, padded, params, block_out, block_frames);
+        break;
+    }
+    lanes.RemoveFinished();
+  }
+}
+
+}  // namespace music_create::audio
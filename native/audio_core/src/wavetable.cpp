@@ -0,0 +1,164 @@
+#include "wavetable.hpp"
+
+#include "denormals.hpp"
+#include "voice_lanes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+namespace music_create::audio {
+
+Wavetable::Wavetable(const float* harmonics, std::size_t count, std::uint32_t sample_rate)
+    : sample_rate_(sample_rate), tables_(static_cast<std::size_t>(kLevelCount) * kStride, 0.0f) {
+  if (harmonics == nullptr || count == 0) {
+    throw std::invalid_argument("wavetable needs at least one harmonic");
+  }
+  if (sample_rate == 0) {
+    throw std::invalid_argument("sample_rate must be positive");
+  }
+  const double nyquist = sample_rate * 0.5;
+  std::vector<double> cycle(kTableSize);
+  for (int level = 0; level < kLevelCount; ++level) {
+    const double highest_fundamental = kLowestFundamentalHz * std::ldexp(1.0, level + 1);
+    std::fill(cycle.begin(), cycle.end(), 0.0);
+    for (std::size_t h = 1; h <= count; ++h) {
+      if (h > 1 && static_cast<double>(h) * highest_fundamental >= nyquist) {
+        break;
+      }
+      const double amplitude = harmonics[h - 1];
+      if (amplitude == 0.0) {
+        continue;
+      }
+      for (std::uint32_t n = 0; n < kTableSize; ++n) {
+        // Reduce h * n modulo the table first so high partials keep full precision.
+        const auto wrapped = static_cast<std::uint32_t>((h * n) & (kTableSize - 1));
+        cycle[n] += amplitude * std::sin(2.0 * std::numbers::pi * wrapped / kTableSize);
+      }
+    }
+    float* table = tables_.data() + static_cast<std::size_t>(level) * kStride;
+    for (std::uint32_t n = 0; n < kTableSize; ++n) {
+      table[n] = static_cast<float>(cycle[n]);
+    }
+    table[kTableSize] = table[0];
+  }
+}
+
+int Wavetable::LevelForFrequency(double hz) const noexcept {
+  if (!(hz > kLowestFundamentalHz * 2.0)) {
+    return 0;
+  }
+  const int level = static_cast<int>(std::ceil(std::log2(hz / kLowestFundamentalHz))) - 1;
+  return std::clamp(level, 0, kLevelCount - 1);
+}
+
+std::uint32_t Wavetable::PhaseIncrement(double hz) const noexcept {
+  const double cycles_per_sample = std::max(hz, 0.0) / sample_rate_;
+  return static_cast<std::uint32_t>(static_cast<std::uint64_t>(std::llround(cycles_per_sample * 4294967296.0)));
+}
+
+void RenderToneNotes(const Wavetable& table, const ToneEnvelope& envelope, float unison_detune, const ToneNote* notes,
+                     std::size_t count, float* out, std::size_t frames) {
+  const std::int64_t attack = std::max<std::int64_t>(envelope.attack_samples, 1);
+  const std::int64_t release = std::max<std::int64_t>(envelope.release_samples, 1);
+  const double decay_step = std::exp(-static_cast<double>(envelope.decay_rate) / table.SampleRate());
+  const float sustain = envelope.sustain;
+  const bool unison = unison_detune > 0.0f;
+  const float voice_gain = unison ? 0.5f : 1.0f;
+
+  for (std::size_t n = 0; n < count; ++n) {
+    const ToneNote& note = notes[n];
+    if (note.start_sample < 0 || note.start_sample >= static_cast<std::int64_t>(frames) || note.length_samples <= 0) {
+      continue;
+    }
+    const std::int64_t total = note.length_samples;
+    const std::int64_t rendered = std::min<std::int64_t>(total, static_cast<std::int64_t>(frames) - note.start_sample);
+    const double upper_hz = note.frequency * (1.0 + std::max(unison_detune, 0.0f));
+    const float* wave = table.Level(table.LevelForFrequency(upper_hz));
+    const std::uint32_t increment = table.PhaseIncrement(note.frequency);
+    const std::uint32_t unison_increment = table.PhaseIncrement(upper_hz);
+    const float gain = note.amplitude * voice_gain;
+    float* dst = out + note.start_sample;
+
+    std::uint32_t phase = 0;
+    std::uint32_t unison_phase = 0;
+    double decay_term = 1.0;
+    const std::int64_t release_start = total - release;
+    for (std::int64_t i = 0; i < rendered; ++i) {
+      float env;
+      if (i < attack) {
+        env = static_cast<float>(i) / static_cast<float>(attack);
+      } else {
+        env = sustain + (1.0f - sustain) * static_cast<float>(decay_term);
+        decay_term *= decay_step;
+        if (i > release_start) {
+          env *= static_cast<float>(total - i) / static_cast<float>(release);
+        }
+      }
+      float sample = ReadWavetable(wave, phase);
+      if (unison) {
+        sample += ReadWavetable(wave, unison_phase);
+        unison_phase += unison_increment;
+      }
+      dst[i] += sample * gain * env;
+      phase += increment;
+    }
+  }
+}
+
+}  // namespace music_create::audio
+
+struct mc_wavetable {
+  explicit mc_wavetable(music_create::audio::Wavetable value) : table(std::move(value)) {}
+  music_create::audio::Wavetable table;
+};
+
+extern "C" {
+
+mc_wavetable* mc_wavetable_create(const float* harmonics, unsigned int count, unsigned int sample_rate) {
+  try {
+    return new mc_wavetable(music_create::audio::Wavetable(harmonics, count, sample_rate));
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mc_wavetable_free(mc_wavetable* table) { delete table; }
+
+int mc_wavetable_render_notes(const mc_wavetable* table, unsigned long long count, const long long* start_sample,
+                              const long long* length_samples, const float* frequency, const float* amplitude,
+                              long long attack_samples, float decay_rate, float sustain, long long release_samples,
+                              float unison_detune, float* out, unsigned long long frames, int lane_width) {
+  if (table == nullptr || out == nullptr ||
+      (count > 0 &&
+       (start_sample == nullptr || length_samples == nullptr || frequency == nullptr || amplitude == nullptr))) {
+    return 0;
+  }
+  if (lane_width != 0 && lane_width != 1 && lane_width != 4 && lane_width != 8 && lane_width != 16) {
+    return 0;
+  }
+  const music_create::audio::ScopedDenormalGuard guard;
+  try {
+    std::vector<music_create::audio::ToneNote> notes(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < notes.size(); ++i) {
+      notes[i] = {start_sample[i], length_samples[i], frequency[i], amplitude[i]};
+    }
+    const music_create::audio::ToneEnvelope envelope{attack_samples, decay_rate, sustain, release_samples};
+    if (lane_width == 1) {
+      music_create::audio::RenderToneNotes(table->table, envelope, unison_detune, notes.data(), notes.size(), out,
+                                           static_cast<std::size_t>(frames));
+    } else {
+      music_create::audio::RenderToneNotesParallel(table->table, envelope, unison_detune, notes.data(), notes.size(),
+                                                   out, static_cast<std::size_t>(frames),
+                                                   static_cast<music_create::audio::VoiceLaneWidth>(lane_width));
+    }
+    return 1;
+  } catch (...) {
+    return 0;
+  }
+}
+
+}  // extern "C"
@@ -0,0 +1,162 @@
+// Checks CopyFrames and the stereo interleave kernels against element-wise
+// copies for every pairing of interleaved, planar and strided views, over
+// frame counts around the vector width, then reads a WAV file through
+// IAudioFileReader::ReadInto into planar, narrower and wider views and
+// compares them with the interleaved Read.
+
+#include "audio_buffer.hpp"
+#include "audio_file_reader.hpp"
+#include "wav_fixture.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+enum class Layout { kInterleaved, kPlanar, kStrided };
+
+const char* Name(Layout layout) {
+  switch (layout) {
+    case Layout::kInterleaved:
+      return "interleaved";
+    case Layout::kPlanar:
+      return "planar";
+    case Layout::kStrided:
+      return "strided";
+  }
+  return "?";
+}
+
+// A view over `storage`; kStrided uses every other channel of an
+// interleaved buffer twice as wide.
+AudioBufferView MakeView(std::vector<float>& storage, Layout layout, std::size_t channels, std::size_t frames) {
+  switch (layout) {
+    case Layout::kInterleaved:
+      storage.assign(channels * frames, 0.0f);
+      return AudioBufferView::Interleaved(storage.data(), channels, frames);
+    case Layout::kPlanar:
+      storage.assign(channels * frames, 0.0f);
+      return AudioBufferView::Planar(storage.data(), channels, frames);
+    case Layout::kStrided:
+      storage.assign(channels * 2 * frames, 0.0f);
+      return {storage.data(), channels, frames, 2, channels * 2};
+  }
+  return {};
+}
+
+float Pattern(std::size_t channel, std::size_t frame) { return static_cast<float>(channel * 100000 + frame + 1); }
+
+bool CheckCopies() {
+  const Layout layouts[] = {Layout::kInterleaved, Layout::kPlanar, Layout::kStrided};
+  bool ok = true;
+  for (std::size_t channels = 1; channels <= 6; ++channels) {
+    for (std::size_t frames : {0, 1, 7, 8, 9, 15, 16, 17, 31, 1000}) {
+      for (Layout from : layouts) {
+        for (Layout to : layouts) {
+          std::vector<float> source_storage;
+          std::vector<float> target_storage;
+          const AudioBufferView source = MakeView(source_storage, from, channels, frames);
+          const AudioBufferView target = MakeView(target_storage, to, channels, frames);
+          for (std::size_t c = 0; c < channels; ++c) {
+            for (std::size_t f = 0; f < frames; ++f) {
+              source(c, f) = Pattern(c, f);
+            }
+          }
+          CopyFrames(source, target);
+          std::size_t wrong = 0;
+          for (std::size_t c = 0; c < channels; ++c) {
+            for (std::size_t f = 0; f < frames; ++f) {
+              wrong += target(c, f) != Pattern(c, f);
+            }
+          }
+          if (wrong != 0) {
+            std::printf("CopyFrames %s -> %s, %zu channels x %zu frames: %zu wrong  FAIL\n", Name(from), Name(to),
+                        channels, frames, wrong);
+            ok = false;
+          }
+        }
+      }
+    }
+  }
+  std::printf("CopyFrames layouts  %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+bool CheckStereoKernels() {
+  bool ok = true;
+  for (std::size_t frames = 0; frames <= 67; ++frames) {
+    std::vector<float> left(frames);
+    std::vector<float> right(frames);
+    for (std::size_t f = 0; f < frames; ++f) {
+      left[f] = Pattern(0, f);
+      right[f] = Pattern(1, f);
+    }
+    std::vector<float> interleaved(frames * 2, 0.0f);
+    InterleaveStereo(left.data(), right.data(), interleaved.data(), frames);
+    std::vector<float> left_back(frames, 0.0f);
+    std::vector<float> right_back(frames, 0.0f);
+    DeinterleaveStereo(interleaved.data(), left_back.data(), right_back.data(), frames);
+    for (std::size_t f = 0; f < frames; ++f) {
+      ok = ok && interleaved[f * 2] == left[f] && interleaved[f * 2 + 1] == right[f];
+    }
+    ok = ok && left_back == left && right_back == right;
+  }
+  std::printf("stereo kernels      %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+// 16-bit PCM; sample (c, f) = (c * 4000 + f * 3) % 65536 as a signed value.
+std::filesystem::path WriteWav(std::uint32_t channels, std::uint32_t frames) {
+  const auto sample = [](std::uint32_t c, std::uint32_t f) {
+    return static_cast<std::int16_t>((c * 4000 + f * 3) % 65536);
+  };
+  return tests::WriteWav("mc_audio_buffer_layouts_" + std::to_string(channels) + ".wav", 48000, channels, frames,
+                         sample);
+}
+
+bool CheckReaderViews() {
+  constexpr std::uint32_t kFrames = 10000;  // more than one WAV read chunk
+  bool ok = true;
+  for (std::uint32_t channels : {1u, 2u, 3u}) {
+    const std::filesystem::path path = WriteWav(channels, kFrames);
+    std::vector<float> expected(static_cast<std::size_t>(channels) * kFrames);
+    OpenAudioFileReader(path)->Read(expected.data(), kFrames);
+    for (std::size_t out_channels : {1, 2, 4}) {
+      for (Layout layout : {Layout::kInterleaved, Layout::kPlanar, Layout::kStrided}) {
+        std::vector<float> storage;
+        const AudioBufferView out = MakeView(storage, layout, out_channels, kFrames);
+        const std::size_t got = OpenAudioFileReader(path)->ReadInto(out);
+        std::size_t wrong = got == kFrames ? 0 : 1;
+        for (std::size_t c = 0; c < out_channels; ++c) {
+          const std::size_t from = std::min<std::size_t>(c, channels - 1);
+          for (std::size_t f = 0; f < kFrames; ++f) {
+            wrong += out(c, f) != expected[f * channels + from];
+          }
+        }
+        if (wrong != 0) {
+          std::printf("ReadInto %u-channel file -> %zu-channel %s view: %zu wrong  FAIL\n", channels, out_channels,
+                      Name(layout), wrong);
+          ok = false;
+        }
+      }
+    }
+    std::filesystem::remove(path);
+  }
+  std::printf("reader views        %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = CheckCopies();
+  ok = CheckStereoKernels() && ok;
+  ok = CheckReaderViews() && ok;
+  return ok ? 0 : 1;
+}
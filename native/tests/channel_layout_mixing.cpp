@@ -0,0 +1,136 @@
+// Checks the layout matrices (known downmix coefficients, constant-power
+// panning across every layout) and MixChannels for every layout pair over
+// planar and interleaved views, against a double-precision reference.
+
+#include "channel_layout.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+constexpr ChannelLayout kLayouts[] = {ChannelLayout::kMono, ChannelLayout::kStereo, ChannelLayout::kLcr,
+                                      ChannelLayout::kSurround51, ChannelLayout::kSurround71};
+constexpr float kMinus3Db = 0.70710678f;
+constexpr float kTolerance = 1e-5f;
+
+bool Near(float value, float expected) { return std::abs(value - expected) <= kTolerance; }
+
+bool CheckDownmix() {
+  bool ok = true;
+  const auto expect = [&](const char* what, bool pass) {
+    if (!pass) {
+      std::printf("downmix %s  FAIL\n", what);
+      ok = false;
+    }
+  };
+  // 5.1 -> stereo: L = L + 0.707 C + 0.707 Ls, LFE dropped.
+  const ChannelMatrix to_stereo = DownmixMatrix(ChannelLayout::kSurround51, ChannelLayout::kStereo);
+  expect("5.1 -> stereo", to_stereo.outputs == 2 && to_stereo.inputs == 6 && Near(to_stereo(0, 0), 1.0f) &&
+                              Near(to_stereo(0, 1), 0.0f) && Near(to_stereo(0, 2), kMinus3Db) &&
+                              Near(to_stereo(0, 3), 0.0f) && Near(to_stereo(0, 4), kMinus3Db) &&
+                              Near(to_stereo(1, 5), kMinus3Db) && Near(to_stereo(1, 4), 0.0f));
+  // 7.1 -> 5.1 folds the rears into the surrounds.
+  const ChannelMatrix to_51 = DownmixMatrix(ChannelLayout::kSurround71, ChannelLayout::kSurround51);
+  expect("7.1 -> 5.1", Near(to_51(4, 6), 1.0f) && Near(to_51(5, 7), 1.0f) && Near(to_51(3, 3), 1.0f));
+  // Stereo -> mono at -3 dB per side; mono -> stereo is the centred pan.
+  const ChannelMatrix to_mono = DownmixMatrix(ChannelLayout::kStereo, ChannelLayout::kMono);
+  expect("stereo -> mono", Near(to_mono(0, 0), kMinus3Db) && Near(to_mono(0, 1), kMinus3Db));
+  const ChannelMatrix from_mono = DownmixMatrix(ChannelLayout::kMono, ChannelLayout::kStereo);
+  expect("mono -> stereo", Near(from_mono(0, 0), kMinus3Db) && Near(from_mono(1, 0), kMinus3Db));
+  for (ChannelLayout layout : kLayouts) {
+    const ChannelMatrix identity = DownmixMatrix(layout, layout);
+    for (std::size_t o = 0; o < identity.outputs; ++o) {
+      for (std::size_t i = 0; i < identity.inputs; ++i) {
+        expect("identity", Near(identity(o, i), o == i ? 1.0f : 0.0f));
+      }
+    }
+  }
+  std::printf("downmix matrices   %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+bool CheckPan() {
+  bool ok = true;
+  for (ChannelLayout layout : kLayouts) {
+    for (int step = -20; step <= 20; ++step) {
+      const float pan = static_cast<float>(step) / 20.0f;
+      const ChannelMatrix matrix = PanMatrix(layout, pan);
+      double power = 0.0;
+      for (std::size_t o = 0; o < matrix.outputs; ++o) {
+        power += static_cast<double>(matrix(o, 0)) * matrix(o, 0);
+        if (matrix(o, 0) != 0.0f && (SpeakerAt(layout, o) == Speaker::kLfe || o >= 4)) {
+          ok = false;  // only the front speakers take a panned source
+        }
+      }
+      ok = ok && std::abs(power - 1.0) < 2e-5;
+    }
+  }
+  // Hard left lands on L alone, centre on C where there is one.
+  const ChannelMatrix left = PanMatrix(ChannelLayout::kSurround51, -1.0f);
+  const ChannelMatrix centre = PanMatrix(ChannelLayout::kSurround51, 0.0f);
+  ok = ok && Near(left(0, 0), 1.0f) && Near(left(2, 0), 0.0f) && Near(centre(2, 0), 1.0f) && Near(centre(0, 0), 0.0f);
+  std::printf("pan matrices       %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+bool CheckMix() {
+  bool ok = true;
+  for (ChannelLayout from : kLayouts) {
+    for (ChannelLayout to : kLayouts) {
+      ChannelMatrix matrix = DownmixMatrix(from, to);
+      matrix *= 0.5f;
+      for (std::size_t frames : {1, 7, 8, 9, 63, 512}) {
+        for (bool interleaved : {false, true}) {
+          const std::size_t inputs = matrix.inputs;
+          const std::size_t outputs = matrix.outputs;
+          std::vector<float> in_storage(inputs * frames);
+          std::vector<float> out_storage(outputs * frames);
+          const AudioBufferView in = interleaved ? AudioBufferView::Interleaved(in_storage.data(), inputs, frames)
+                                                 : AudioBufferView::Planar(in_storage.data(), inputs, frames);
+          const AudioBufferView out = interleaved ? AudioBufferView::Interleaved(out_storage.data(), outputs, frames)
+                                                  : AudioBufferView::Planar(out_storage.data(), outputs, frames);
+          for (std::size_t n = 0; n < frames; ++n) {
+            for (std::size_t i = 0; i < inputs; ++i) {
+              in(i, n) = std::sin(0.37f * static_cast<float>(n) + static_cast<float>(i));
+            }
+            for (std::size_t o = 0; o < outputs; ++o) {
+              out(o, n) = 0.25f * static_cast<float>(o);
+            }
+          }
+          MixChannels(matrix, in, out);
+          double worst = 0.0;
+          for (std::size_t n = 0; n < frames; ++n) {
+            for (std::size_t o = 0; o < outputs; ++o) {
+              double expected = 0.25 * static_cast<double>(o);
+              for (std::size_t i = 0; i < inputs; ++i) {
+                expected += static_cast<double>(matrix(o, i)) * in(i, n);
+              }
+              worst = std::max(worst, std::abs(out(o, n) - expected));
+            }
+          }
+          if (worst > kTolerance) {
+            std::printf("MixChannels %zu -> %zu channels, %zu frames, %s: error %.3g  FAIL\n", inputs, outputs, frames,
+                        interleaved ? "interleaved" : "planar", worst);
+            ok = false;
+          }
+        }
+      }
+    }
+  }
+  std::printf("MixChannels        %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = CheckDownmix();
+  ok = CheckPan() && ok;
+  ok = CheckMix() && ok;
+  return ok ? 0 : 1;
+}
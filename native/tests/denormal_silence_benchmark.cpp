@@ -0,0 +1,163 @@
+// Feeds banks of recursive processors two seconds of noise and then a long
+// silent tail, long enough for their filter, envelope and feedback states to
+// decay through the denormal range, and times every quarter second of audio.
+// Each window keeps its cheapest time over kAttempts runs, which strips out
+// preemption and timer noise; the case fails if the median tail window costs
+// more than kMaxTailRatio times the median signal window. Runs once under
+// ScopedDenormalGuard and once without it, where only the kernels' own
+// flushing keeps the tail cheap.
+
+#include "channel_effects.hpp"
+#include "denormals.hpp"
+#include "dynamics.hpp"
+#include "fdn_reverb.hpp"
+#include "tempo_delay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+constexpr std::uint32_t kSampleRate = 48000;
+constexpr std::size_t kBlock = 512;
+constexpr std::size_t kWindow = kSampleRate / 4;
+constexpr int kSignalWindows = 8;
+constexpr int kTailWindows = 48;
+constexpr std::size_t kInstances = 32;
+constexpr int kAttempts = 3;
+constexpr double kMaxTailRatio = 1.5;
+
+// Runs a mono processor on the left channel.
+template <typename Processor>
+class MonoAdapter final : public IGraphProcessor {
+ public:
+  explicit MonoAdapter(std::unique_ptr<Processor> processor) : processor_(std::move(processor)) {}
+
+  void Process(float* left, float*, const float*, const float*, std::size_t frames) noexcept override {
+    processor_->Process(left, left, frames);
+  }
+
+ private:
+  std::unique_ptr<Processor> processor_;
+};
+
+struct Case {
+  const char* name;
+  std::unique_ptr<IGraphProcessor> (*make)();
+};
+
+const Case kCases[] = {
+    {"ThreeBandEq",
+     []() -> std::unique_ptr<IGraphProcessor> {
+       return std::make_unique<ThreeBandEq>(kSampleRate, EqParams{3.0f, -2.0f, 4.0f, 200.0f, 4000.0f});
+     }},
+    {"Compressor",
+     []() -> std::unique_ptr<IGraphProcessor> {
+       return std::make_unique<Compressor>(kSampleRate, CompressorParams{-30.0f, 4.0f, 5.0f, 200.0f, 0.0f});
+     }},
+    {"Gate",
+     []() -> std::unique_ptr<IGraphProcessor> {
+       return std::make_unique<Gate>(kSampleRate, GateParams{-30.0f, 1.0f, 120.0f});
+     }},
+    {"FdnReverb",
+     []() -> std::unique_ptr<IGraphProcessor> {
+       auto reverb = std::make_unique<FdnReverb>(kSampleRate);
+       reverb->SetParams({1.0f, 0.5f, 10.0f, 0.4f, 0.6f});
+       return std::make_unique<MonoAdapter<FdnReverb>>(std::move(reverb));
+     }},
+    {"TempoDelay",
+     []() -> std::unique_ptr<IGraphProcessor> {
+       auto delay = std::make_unique<TempoDelay>(kSampleRate);
+       delay->SetParams({1.0f, 0.25f, 120.0f, 0.3f, 0.2f});
+       return std::make_unique<MonoAdapter<TempoDelay>>(std::move(delay));
+     }},
+};
+
+// Seconds spent on each window of audio: kSignalWindows of noise, then the
+// tail, through kInstances processors.
+std::vector<double> TimeWindows(const Case& c) {
+  std::vector<std::unique_ptr<IGraphProcessor>> bank;
+  for (std::size_t i = 0; i < kInstances; ++i) {
+    bank.push_back(c.make());
+  }
+  std::vector<float> noise_left(kBlock);
+  std::vector<float> noise_right(kBlock);
+  std::vector<float> left(kBlock);
+  std::vector<float> right(kBlock);
+  std::uint32_t seed = 12345;
+  std::vector<double> costs;
+  for (int window = 0; window < kSignalWindows + kTailWindows; ++window) {
+    const bool signal = window < kSignalWindows;
+    double elapsed = 0.0;
+    for (std::size_t done = 0; done < kWindow; done += kBlock) {
+      const std::size_t frames = std::min(kBlock, kWindow - done);
+      for (std::size_t n = 0; n < frames; ++n) {
+        seed = seed * 1664525u + 1013904223u;
+        noise_left[n] = signal ? static_cast<float>(seed >> 8) / 8388608.0f - 1.0f : 0.0f;
+        noise_right[n] = -noise_left[n];
+      }
+      for (const auto& processor : bank) {
+        std::copy_n(noise_left.begin(), frames, left.begin());
+        std::copy_n(noise_right.begin(), frames, right.begin());
+        const auto start = std::chrono::steady_clock::now();
+        processor->Process(left.data(), right.data(), left.data(), right.data(), frames);
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+    }
+    costs.push_back(elapsed);
+  }
+  return costs;
+}
+
+bool Run(bool guarded) {
+  bool ok = true;
+  for (const Case& c : kCases) {
+    // The cheapest of the attempts for each window: preemption only ever
+    // adds time, a denormal stall slows the window in every attempt.
+    std::vector<double> costs(kSignalWindows + kTailWindows, 1e9);
+    for (int attempt = 0; attempt < kAttempts; ++attempt) {
+      std::vector<double> attempt_costs;
+      if (guarded) {
+        const ScopedDenormalGuard guard;
+        attempt_costs = TimeWindows(c);
+      } else {
+        attempt_costs = TimeWindows(c);
+      }
+      for (std::size_t w = 0; w < costs.size(); ++w) {
+        costs[w] = std::min(costs[w], attempt_costs[w]);
+      }
+    }
+    std::sort(costs.begin(), costs.begin() + kSignalWindows);
+    std::sort(costs.begin() + kSignalWindows, costs.end());
+    const double signal = costs[kSignalWindows / 2];
+    const double tail = costs[kSignalWindows + kTailWindows / 2];
+    const double ratio = tail / signal;
+    const bool pass = ratio <= kMaxTailRatio;
+    std::printf("%-8s %-12s signal %7.3f ms  tail %7.3f ms  worst %7.3f ms  ratio %5.2f  %s\n",
+                guarded ? "guarded" : "kernels", c.name, signal * 1e3, tail * 1e3, costs.back() * 1e3, ratio,
+                pass ? "ok" : "FAIL");
+    ok = ok && pass;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  bool supported = false;
+  {
+    const ScopedDenormalGuard guard;
+    supported = ScopedDenormalGuard::Active();
+  }
+  std::printf("denormal guard %s on this platform\n", supported ? "supported" : "unsupported");
+  bool ok = Run(true);
+  ok = Run(false) && ok;
+  return ok ? 0 : 1;
+}
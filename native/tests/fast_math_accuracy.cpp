@@ -0,0 +1,151 @@
+// Checks every Fast* approximation in fast_math.hpp, scalar and block form,
+// against libm in double precision and fails if an error exceeds the bound
+// the header documents. One binade per function is swept exhaustively, which
+// covers every mantissa (log2, dB) or every fraction of the reduced argument
+// (exp2, tanh, sin); the rest of each domain is strided.
+
+#include "fast_math.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+using ScalarFn = float (*)(float);
+using BlockFn = void (*)(const float*, float*, std::size_t) noexcept;
+using ReferenceFn = double (*)(double);
+
+enum class Metric {
+  kAbsolute,
+  kRelative,
+  // Absolute below magnitude one, relative above: results of log2 and dB
+  // grow with the input's exponent and lose absolute resolution with it.
+  kMixed,
+};
+
+// Every positive float in [lo, hi) whose bit pattern is a multiple of
+// `stride` ulps from lo, optionally mirrored to negative values.
+struct Range {
+  float lo;
+  float hi;
+  std::uint32_t stride;
+  bool mirrored;
+};
+
+struct Function {
+  const char* name;
+  ScalarFn scalar;
+  BlockFn block;
+  ReferenceFn reference;
+  Metric metric;
+  float bound;
+  std::vector<Range> ranges;
+};
+
+constexpr std::size_t kChunk = 4096;
+
+double Error(double value, double expected, Metric metric) {
+  const double difference = std::abs(value - expected);
+  switch (metric) {
+    case Metric::kAbsolute:
+      return difference;
+    case Metric::kRelative:
+      return difference / std::abs(expected);
+    case Metric::kMixed:
+      return difference / std::max(1.0, std::abs(expected));
+  }
+  return difference;
+}
+
+struct Result {
+  double scalar_error = 0.0;
+  double block_error = 0.0;
+  float worst_input = 0.0f;
+  std::uint64_t count = 0;
+};
+
+void CheckChunk(const Function& function, const std::vector<float>& in, std::vector<float>& out, Result& result) {
+  function.block(in.data(), out.data(), in.size());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    const double expected = function.reference(in[i]);
+    const double scalar_error = Error(function.scalar(in[i]), expected, function.metric);
+    const double block_error = Error(out[i], expected, function.metric);
+    if (scalar_error > result.scalar_error) {
+      result.scalar_error = scalar_error;
+      result.worst_input = in[i];
+    }
+    result.block_error = std::max(result.block_error, block_error);
+  }
+  result.count += in.size();
+}
+
+Result Sweep(const Function& function) {
+  Result result;
+  std::vector<float> in;
+  std::vector<float> out(kChunk);
+  in.reserve(kChunk);
+  for (const Range& range : function.ranges) {
+    const auto first = std::bit_cast<std::uint32_t>(range.lo);
+    const auto last = std::bit_cast<std::uint32_t>(range.hi);
+    for (int sign = 0; sign < (range.mirrored ? 2 : 1); ++sign) {
+      for (std::uint64_t bits = first; bits < last; bits += range.stride) {
+        const float x = std::bit_cast<float>(static_cast<std::uint32_t>(bits));
+        in.push_back(sign ? -x : x);
+        if (in.size() == kChunk) {
+          CheckChunk(function, in, out, result);
+          in.clear();
+        }
+      }
+    }
+  }
+  if (!in.empty()) {
+    CheckChunk(function, in, out, result);
+  }
+  return result;
+}
+
+double ReferenceLog2(double x) { return std::log2(x); }
+double ReferenceExp2(double x) { return std::exp2(std::clamp(x, -126.0, 127.0)); }
+double ReferenceGainToDb(double gain) { return 20.0 * std::log10(std::max(gain, 1e-30)); }
+double ReferenceDbToGain(double db) { return std::pow(10.0, db / 20.0); }
+double ReferenceTanh(double x) { return std::tanh(x); }
+double ReferenceSin(double x) { return std::sin(x); }
+
+}  // namespace
+
+int main() {
+  const float max_normal = std::numeric_limits<float>::max();
+  const float min_normal = std::numeric_limits<float>::min();
+  const std::vector<Function> functions = {
+      {"FastLog2", FastLog2, FastLog2Block, ReferenceLog2, Metric::kMixed, kFastLog2MaxError,
+       {{1.0f, 2.0f, 1, false}, {min_normal, max_normal, 1021, false}}},
+      {"FastExp2", FastExp2, FastExp2Block, ReferenceExp2, Metric::kRelative, kFastExp2MaxRelError,
+       {{0.5f, 1.0f, 1, true}, {min_normal, 128.0f, 1021, true}}},
+      {"FastGainToDb", FastGainToDb, FastGainToDbBlock, ReferenceGainToDb, Metric::kMixed, kFastGainToDbMaxError,
+       {{0.5f, 1.0f, 1, false}, {min_normal, max_normal, 1021, false}}},
+      {"FastDbToGain", FastDbToGain, FastDbToGainBlock, ReferenceDbToGain, Metric::kRelative,
+       kFastDbToGainMaxRelError, {{8.0f, 16.0f, 1, true}, {min_normal, 758.0f, 1021, true}}},
+      {"FastTanh", FastTanh, FastTanhBlock, ReferenceTanh, Metric::kAbsolute, kFastTanhMaxError,
+       {{0.5f, 1.0f, 1, true}, {min_normal, max_normal, 1021, true}}},
+      {"FastSin", FastSin, FastSinBlock, ReferenceSin, Metric::kAbsolute, kFastSinMaxError,
+       {{2.0f, 4.0f, 1, true}, {min_normal, 16384.0f, 1021, true}}},
+  };
+
+  bool failed = false;
+  for (const Function& function : functions) {
+    const Result result = Sweep(function);
+    const bool ok = result.scalar_error <= function.bound && result.block_error <= function.bound;
+    std::printf("%-13s %11llu inputs  scalar %.3g  block %.3g  bound %.3g  worst x %.9g  %s\n", function.name,
+                static_cast<unsigned long long>(result.count), result.scalar_error, result.block_error,
+                static_cast<double>(function.bound), static_cast<double>(result.worst_input), ok ? "ok" : "FAIL");
+    failed = failed || !ok;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+// Drives the limiter with 20-60 Hz sines 18 dB over its ceiling at the
+// default 5 ms lookahead. Past each crest the required gain rises for far
+// longer than the lookahead window, so the sliding-minimum deque fills to the
+// whole window on every half cycle. Checks the output holds the ceiling and
+// settles just below it.
+
+#include "limiter.hpp"
+
+#include "dynamics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+constexpr std::uint32_t kSampleRate = 48000;
+constexpr std::size_t kBlock = 512;
+constexpr std::size_t kFrames = kSampleRate * 2;
+constexpr double kTwoPi = 6.283185307179586;
+
+}  // namespace
+
+int main() {
+  const LimiterParams params;
+  const float ceiling = DbToGain(params.ceiling_db);
+  const double amplitude = ceiling * std::pow(10.0, 18.0 / 20.0);
+  bool ok = true;
+  for (const double hz : {20.0, 30.0, 40.0, 60.0}) {
+    Limiter limiter(kSampleRate, params);
+    std::vector<float> left(kFrames);
+    for (std::size_t n = 0; n < kFrames; ++n) {
+      left[n] = static_cast<float>(amplitude * std::sin(kTwoPi * hz * static_cast<double>(n) / kSampleRate));
+    }
+    std::vector<float> right = left;
+    for (std::size_t offset = 0; offset < kFrames; offset += kBlock) {
+      const std::size_t frames = std::min(kBlock, kFrames - offset);
+      limiter.Process(left.data() + offset, right.data() + offset, nullptr, nullptr, frames);
+    }
+
+    // The last second, well after the first crest pulled the gain down.
+    float peak = 0.0f;
+    for (std::size_t n = kSampleRate; n < kFrames; ++n) {
+      peak = std::max({peak, std::abs(left[n]), std::abs(right[n])});
+    }
+    const bool pass = peak <= ceiling && peak > ceiling * DbToGain(-0.5f);
+    std::printf("%2.0f Hz sine 18 dB over a %.1f dB ceiling: peak %.2f dB  %s\n", hz, params.ceiling_db,
+                20.0 * std::log10(peak), pass ? "ok" : "FAIL");
+    ok = pass && ok;
+  }
+  std::printf("limiter hot bass  %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// Clicks through a tempo change and two meter changes in random block sizes
+// and checks every click lands on the frame the tempo map puts its beat on,
+// accented on each bar line, that seeking into a click plays its tail, that
+// malformed maps are rejected, and that ten minutes of clicks cost a
+// negligible share of one core.
+
+#include "metronome.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+constexpr std::uint32_t kSampleRate = 48000;
+constexpr std::size_t kFrames = kSampleRate * 20;
+
+struct Expected {
+  std::uint64_t frame;
+  bool accent;
+};
+
+// 4/4 at 120 BPM for two bars, then 90 BPM: two bars of 6/8 (eighth-note
+// clicks, three quarters a bar) and 3/4 from beat 14 on.
+std::vector<Expected> ExpectedClicks() {
+  const auto seconds = [](double beat) { return beat < 8.0 ? beat * 0.5 : 4.0 + (beat - 8.0) * 60.0 / 90.0; };
+  std::vector<Expected> clicks;
+  const auto add = [&](double beat, bool accent) {
+    clicks.push_back({static_cast<std::uint64_t>(std::llround(seconds(beat) * kSampleRate)), accent});
+  };
+  for (int k = 0; k < 8; ++k) {
+    add(k, k % 4 == 0);
+  }
+  for (int k = 0; k < 12; ++k) {
+    add(8.0 + 0.5 * k, k % 6 == 0);
+  }
+  for (int k = 0; seconds(14.0 + k) * kSampleRate < kFrames; ++k) {
+    add(14.0 + k, k % 3 == 0);
+  }
+  return clicks;
+}
+
+std::vector<float> Reference(const Metronome& metronome, const std::vector<Expected>& clicks) {
+  std::vector<float> out(kFrames, 0.0f);
+  for (const Expected& click : clicks) {
+    const std::vector<float>& samples = metronome.Click(click.accent);
+    for (std::size_t n = 0; n < samples.size() && click.frame + n < kFrames; ++n) {
+      out[click.frame + n] = samples[n];
+    }
+  }
+  return out;
+}
+
+void SetMap(Metronome& metronome) {
+  metronome.SetTempoMap({{0.0, 120.0}, {8.0, 90.0}}, {{0.0, 4, 4}, {8.0, 6, 8}, {14.0, 3, 4}});
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+  Metronome metronome(kSampleRate);
+  SetMap(metronome);
+  const auto clicks = ExpectedClicks();
+  const auto reference = Reference(metronome, clicks);
+
+  // Block sizes must not move a click by a single frame.
+  std::vector<float> out(kFrames, 0.0f);
+  std::mt19937 random(5);
+  std::uniform_int_distribution<std::size_t> sizes(1, 2048);
+  for (std::size_t done = 0; done < kFrames;) {
+    const std::size_t frames = std::min(sizes(random), kFrames - done);
+    float* outputs[] = {out.data() + done};
+    metronome.Render(outputs, 1, frames, 1.0f);
+    done += frames;
+  }
+  double error = 0.0;
+  for (std::size_t n = 0; n < kFrames; ++n) {
+    error = std::max(error, static_cast<double>(std::abs(out[n] - reference[n])));
+  }
+  std::printf("%zu clicks through 4/4, 6/8 and 3/4 at 120 and 90 BPM: max error %.1e  %s\n", clicks.size(), error,
+              error == 0.0 ? "ok" : "FAIL");
+  ok = error == 0.0 && ok;
+
+  // Seeking 100 frames into the downbeat of the 6/8 bar plays on from there.
+  const std::uint64_t seek = clicks[8].frame + 100;
+  metronome.Seek(seek);
+  std::vector<float> tail(kSampleRate, 0.0f);
+  float* tail_outputs[] = {tail.data()};
+  metronome.Render(tail_outputs, 1, tail.size(), 1.0f);
+  double seek_error = 0.0;
+  for (std::size_t n = 0; n < tail.size(); ++n) {
+    seek_error = std::max(seek_error, static_cast<double>(std::abs(tail[n] - reference[seek + n])));
+  }
+  std::printf("seek into a click: max error %.1e  %s\n", seek_error, seek_error == 0.0 ? "ok" : "FAIL");
+  ok = seek_error == 0.0 && ok;
+
+  int rejected = 0;
+  const std::vector<std::vector<TempoPoint>> bad_tempos = {
+      {}, {{1.0, 120.0}}, {{0.0, 0.0}}, {{0.0, 120.0}, {0.0, 90.0}}};
+  for (const auto& tempo : bad_tempos) {
+    try {
+      metronome.SetTempoMap(tempo, {{0.0, 4, 4}});
+    } catch (const std::invalid_argument&) {
+      ++rejected;
+    }
+  }
+  for (const MeterPoint meter : {MeterPoint{0.0, 0, 4}, MeterPoint{0.0, 4, 3}, MeterPoint{0.0, 4, 64}}) {
+    try {
+      metronome.SetTempoMap({{0.0, 120.0}}, {meter});
+    } catch (const std::invalid_argument&) {
+      ++rejected;
+    }
+  }
+  std::printf("malformed maps rejected: %d of 7  %s\n", rejected, rejected == 7 ? "ok" : "FAIL");
+  ok = rejected == 7 && ok;
+
+  // Ten minutes of stereo clicks in 256-frame blocks; the best of two runs
+  // counts, so a preempted run cannot fail it.
+  SetMap(metronome);
+  const std::size_t seconds = 600;
+  std::vector<std::vector<float>> block(2, std::vector<float>(256));
+  float* block_outputs[] = {block[0].data(), block[1].data()};
+  double load = 1e9;
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    metronome.Seek(0);
+    const auto started = std::chrono::steady_clock::now();
+    for (std::size_t done = 0; done < kSampleRate * seconds; done += 256) {
+      metronome.Render(block_outputs, 2, 256, 0.5f);
+    }
+    load = std::min(load, std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() / seconds);
+  }
+  std::printf("ten minutes of clicks cost %.4f%% of one core  %s\n", load * 100.0, load < 1e-3 ? "ok" : "FAIL");
+  ok = load < 1e-3 && ok;
+
+  std::printf("metronome click timing  %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+// Checks the interpolated lookups in param_tables.hpp against libm in double
+// precision over dense grids of their domains and fails if an error exceeds
+// the bound the header documents.
+
+#include "param_tables.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+
+namespace {
+
+using namespace music_create::audio;
+
+bool Report(const char* name, long long count, double error, double bound, double worst) {
+  const bool ok = error <= bound;
+  std::printf("%-18s %9lld inputs  error %.3g  bound %.3g  worst x %.9g  %s\n", name, count, error, bound, worst,
+              ok ? "ok" : "FAIL");
+  return ok;
+}
+
+bool CheckPan() {
+  constexpr long long kCount = 2000001;
+  double error = 0.0;
+  double worst = 0.0;
+  for (long long i = 0; i < kCount; ++i) {
+    const float pan = static_cast<float>(-1.0 + 2.0 * static_cast<double>(i) / (kCount - 1));
+    const double angle = (static_cast<double>(pan) + 1.0) * std::numbers::pi / 4.0;
+    const PanGains gains = EqualPowerPan(pan);
+    const double e = std::max(std::abs(gains.left - std::cos(angle)), std::abs(gains.right - std::sin(angle)));
+    if (e > error) {
+      error = e;
+      worst = pan;
+    }
+  }
+  return Report("EqualPowerPan", kCount, error, kPanTableMaxError, worst);
+}
+
+bool CheckDb() {
+  // 1/10000 dB over the table plus a margin on either side, which falls back
+  // to FastDbToGain.
+  constexpr long long kFirst = -1300000;
+  constexpr long long kLast = 300000;
+  double error = 0.0;
+  double worst = 0.0;
+  for (long long i = kFirst; i <= kLast; ++i) {
+    const float db = static_cast<float>(static_cast<double>(i) * 1e-4);
+    const double expected = std::pow(10.0, static_cast<double>(db) / 20.0);
+    const double e = std::abs(TableDbToGain(db) - expected) / expected;
+    if (e > error) {
+      error = e;
+      worst = db;
+    }
+  }
+  return Report("TableDbToGain", kLast - kFirst + 1, error, kDbTableMaxRelError, worst);
+}
+
+bool CheckDecay() {
+  // Time constants from 1/16 sample to 2^24 samples, 4096 per octave.
+  constexpr long long kCount = 28 * 4096 + 1;
+  double error = 0.0;
+  double worst = 0.0;
+  for (long long i = 0; i < kCount; ++i) {
+    const float samples = static_cast<float>(std::exp2(-4.0 + static_cast<double>(i) / 4096.0));
+    const double expected = -std::expm1(-1.0 / static_cast<double>(samples));
+    const double e = std::abs(OnePoleAlpha(samples) - expected) / expected;
+    if (e > error) {
+      error = e;
+      worst = samples;
+    }
+  }
+  return Report("OnePoleAlpha", kCount, error, kDecayTableMaxRelError, worst);
+}
+
+}  // namespace
+
+int main() {
+  bool ok = CheckPan();
+  ok = CheckDb() && ok;
+  ok = CheckDecay() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// Cues a transport into the middle of two streamed clips on a graph with a
+// reverb and a lookahead limiter, then checks that playback starts without a
+// single stream underrun, lands on the cued frame despite the limiter
+// latency, and matches a continuous render from the top once the pre-roll
+// has settled the reverb (a cold start without pre-roll does not).
+
+#include "channel_effects.hpp"
+#include "limiter.hpp"
+#include "mix_graph.hpp"
+#include "transport.hpp"
+#include "wav_fixture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+constexpr std::uint32_t kSampleRate = 48000;
+constexpr std::size_t kBlock = 256;
+constexpr std::uint32_t kClipFrames = kSampleRate * 3;
+constexpr std::uint64_t kFirstStart = 1000;
+constexpr std::uint64_t kCue = kSampleRate * 3 / 2;
+constexpr std::uint64_t kSecondStart = kCue + kSampleRate / 10;  // starts just after the cue point
+// Within the 250 ms look-ahead Cue() makes resident: the test renders far
+// faster than real time, so later blocks may legitimately outrun the disk.
+constexpr std::size_t kPlayFrames = kBlock * 40;
+
+// 16-bit stereo; the test reads the samples back through the same rounding.
+std::int16_t Sample(int clip, std::size_t channel, std::uint32_t frame) {
+  const double hz = clip == 0 ? 220.0 : 330.0;
+  const double phase = 2.0 * 3.14159265358979 * hz * frame / kSampleRate + static_cast<double>(channel);
+  return static_cast<std::int16_t>(std::lround(6000.0 * std::sin(phase)));
+}
+
+std::filesystem::path WriteClip(int clip) {
+  return tests::WriteWav("mc_transport_cue_" + std::to_string(clip) + ".wav", kSampleRate, 2, kClipFrames,
+                         [clip](std::uint32_t c, std::uint32_t f) { return Sample(clip, c, f); });
+}
+
+// Reverb on the first track, limiter on the master: the tail needs pre-roll
+// and the limiter adds latency the transport has to absorb.
+std::unique_ptr<MixGraph> MakeGraph() {
+  auto graph = std::make_unique<MixGraph>(kSampleRate, kBlock);
+  const MixGraph::NodeId first = graph->AddTrack();
+  graph->AddTrack();
+  graph->AddProcessor(first, [] {
+    return std::make_unique<StereoReverb>(kSampleRate, FdnReverbParams{0.5f, 0.25f, 5.0f, 0.4f, 0.5f});
+  });
+  graph->AddProcessor(MixGraph::kMaster, [] {
+    return std::make_unique<Limiter>(kSampleRate, LimiterParams{-0.5f, 5.0f, 80.0f});
+  });
+  graph->Compile();
+  return graph;
+}
+
+// The whole timeline rendered in one pass, aligned with the input.
+std::vector<std::vector<float>> RenderContinuous(std::size_t frames) {
+  auto graph = MakeGraph();
+  const std::size_t total = frames + graph->Latency();
+  std::vector<std::vector<float>> tracks(4, std::vector<float>(total, 0.0f));
+  const std::uint64_t starts[] = {kFirstStart, kSecondStart};
+  for (int clip = 0; clip < 2; ++clip) {
+    for (std::uint32_t f = 0; f < kClipFrames && starts[clip] + f < total; ++f) {
+      for (std::size_t c = 0; c < 2; ++c) {
+        tracks[clip * 2 + c][starts[clip] + f] = static_cast<float>(Sample(clip, c, f)) / 32768.0f;
+      }
+    }
+  }
+  // Inputs are node by node: the master's two channels come first.
+  const float* inputs[] = {nullptr, nullptr, tracks[0].data(), tracks[1].data(), tracks[2].data(), tracks[3].data()};
+  std::vector<std::vector<float>> out(2, std::vector<float>(total));
+  float* outputs[] = {out[0].data(), out[1].data()};
+  graph->Process(inputs, outputs, total);
+  for (auto& channel : out) {
+    channel.erase(channel.begin(), channel.begin() + static_cast<std::ptrdiff_t>(graph->Latency()));
+  }
+  return out;
+}
+
+struct Playback {
+  bool cued = false;
+  double cue_ms = 0.0;
+  std::uint64_t underruns = 0;
+  std::vector<std::vector<float>> out;
+};
+
+Playback PlayFromCue(float preroll_ms, const std::filesystem::path (&paths)[2]) {
+  auto graph = MakeGraph();
+  TransportOptions options;
+  options.preroll_ms = preroll_ms;
+  Transport transport(*graph, options);
+  transport.AddClip({.path = paths[0], .node = 1, .start = kFirstStart});
+  transport.AddClip({.path = paths[1], .node = 2, .start = kSecondStart});
+  // Jump around first, as users do.
+  transport.Cue(kSampleRate / 2);
+  Playback playback;
+  const auto started = std::chrono::steady_clock::now();
+  playback.cued = transport.Cue(kCue);
+  playback.cue_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+  const std::uint64_t underruns = transport.Underruns();
+  transport.Play();
+  playback.out.assign(2, std::vector<float>(kPlayFrames));
+  for (std::size_t offset = 0; offset < kPlayFrames; offset += kBlock) {
+    float* outputs[] = {playback.out[0].data() + offset, playback.out[1].data() + offset};
+    transport.Render(outputs, kBlock);
+  }
+  playback.underruns = transport.Underruns() - underruns;
+  return playback;
+}
+
+double MaxError(const Playback& playback, const std::vector<std::vector<float>>& reference) {
+  double worst = 0.0;
+  for (std::size_t c = 0; c < 2; ++c) {
+    for (std::size_t n = 0; n < kPlayFrames; ++n) {
+      worst = std::max(worst, std::abs(static_cast<double>(playback.out[c][n]) - reference[c][kCue + n]));
+    }
+  }
+  return worst;
+}
+
+}  // namespace
+
+int main() {
+  const std::filesystem::path paths[] = {WriteClip(0), WriteClip(1)};
+  const auto reference = RenderContinuous(kCue + kPlayFrames);
+  const Playback warm = PlayFromCue(500.0f, paths);
+  const Playback cold = PlayFromCue(0.0f, paths);
+  const double warm_error = MaxError(warm, reference);
+  const double cold_error = MaxError(cold, reference);
+  for (const Playback* playback : {&warm, &cold}) {
+    std::printf("%s cue %.1f ms (%s), %llu underruns after play\n", playback == &warm ? "pre-rolled" : "cold",
+                playback->cue_ms, playback->cued ? "resident" : "timed out",
+                static_cast<unsigned long long>(playback->underruns));
+  }
+  std::printf("max error vs continuous render: pre-rolled %.2e, cold %.2e\n", warm_error, cold_error);
+  for (const auto& path : paths) {
+    std::filesystem::remove(path);
+  }
+  const bool ok = warm.cued && cold.cued && warm.underruns == 0 && cold.underruns == 0 && warm_error < 1e-4 &&
+                  cold_error > warm_error * 10.0;
+  std::printf("transport cue start  %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// Scrubs a streamed 441 Hz clip the way a mouse drag does, posting
+// positions at block rate while rendering in real time, and checks that the
+// grains play it varispeed (an octave up at twice the drag speed, also
+// backwards), fall silent when the drag holds still, and keep up with a
+// second thread firing random jumps across the clip without a slow block.
+
+#include "mix_graph.hpp"
+#include "transport.hpp"
+#include "wav_fixture.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+constexpr std::uint32_t kSampleRate = 48000;
+constexpr std::size_t kBlock = 256;
+constexpr std::uint32_t kClipFrames = kSampleRate * 10;
+constexpr std::uint64_t kClipStart = 4800;
+constexpr double kHz = 441.0;
+constexpr auto kBlockTime = std::chrono::microseconds(1000000 * kBlock / kSampleRate);
+
+std::filesystem::path WriteClip() {
+  return tests::WriteWav("mc_transport_scrub.wav", kSampleRate, 2, kClipFrames, [](std::uint32_t, std::uint32_t f) {
+    return static_cast<std::int16_t>(std::lround(8000.0 * std::sin(6.283185307179586 * kHz * f / kSampleRate)));
+  });
+}
+
+struct Scrubber {
+  Transport& transport;
+  std::vector<float> left{};
+  double worst_block_ms = 0.0;
+
+  // Renders `blocks` blocks paced like an audio callback, posting a drag
+  // position from `drag` (block index -> frame) before each one.
+  template <typename Drag>
+  void Run(std::size_t blocks, Drag drag) {
+    std::vector<float> right(kBlock);
+    auto next = std::chrono::steady_clock::now();
+    for (std::size_t b = 0; b < blocks; ++b) {
+      if (const std::int64_t position = drag(b); position >= 0) {
+        transport.ScrubTo(static_cast<std::uint64_t>(position));
+      }
+      left.resize(left.size() + kBlock);
+      float* outputs[] = {left.data() + left.size() - kBlock, right.data()};
+      const auto started = std::chrono::steady_clock::now();
+      transport.Render(outputs, kBlock);
+      const std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - started;
+      worst_block_ms = std::max(worst_block_ms, took.count());
+      next += kBlockTime;
+      std::this_thread::sleep_until(next);
+    }
+  }
+
+  // Rising zero crossings per second over the last `frames` frames.
+  double Pitch(std::size_t frames) const {
+    int crossings = 0;
+    for (std::size_t n = left.size() - frames + 1; n < left.size(); ++n) {
+      crossings += left[n - 1] < 0.0f && left[n] >= 0.0f ? 1 : 0;
+    }
+    return crossings * static_cast<double>(kSampleRate) / static_cast<double>(frames);
+  }
+
+  double Rms(std::size_t frames) const {
+    double sum = 0.0;
+    for (std::size_t n = left.size() - frames; n < left.size(); ++n) {
+      sum += static_cast<double>(left[n]) * left[n];
+    }
+    return std::sqrt(sum / static_cast<double>(frames));
+  }
+};
+
+}  // namespace
+
+int main() {
+  const auto path = WriteClip();
+  bool ok = true;
+  {
+    MixGraph graph(kSampleRate, kBlock);
+    const MixGraph::NodeId track = graph.AddTrack();
+    graph.Compile();
+    Transport transport(graph);
+    transport.AddClip({.path = path, .node = track, .start = kClipStart});
+    transport.Cue(kSampleRate * 2);
+    ok = transport.BeginScrub() && ok;
+    Scrubber scrubber{transport};
+
+    // Drags at one and two times playback speed, then backwards; the pitch
+    // is measured once the grains caught up with the drag.
+    const double speeds[] = {1.0, 2.0, -1.0};
+    for (const double speed : speeds) {
+      const auto from = static_cast<double>(transport.Position());
+      scrubber.Run(120, [&](std::size_t b) {
+        return static_cast<std::int64_t>(from + speed * static_cast<double>((b + 1) * kBlock));
+      });
+      const double pitch = scrubber.Pitch(kBlock * 60);
+      const double expected = kHz * std::abs(speed);
+      std::printf("drag x%+.0f: %.1f Hz (expected %.1f)\n", speed, pitch, expected);
+      ok = std::abs(pitch - expected) < expected * 0.05 && ok;
+    }
+
+    // Holding the mouse still glides to a stop and fades out.
+    const std::uint64_t held = transport.Position();
+    scrubber.Run(60, [&](std::size_t) { return static_cast<std::int64_t>(held); });
+    const double held_rms = scrubber.Rms(kBlock * 10);
+    std::printf("held: rms %.2e, position %llu of %llu\n", held_rms,
+                static_cast<unsigned long long>(transport.Position()), static_cast<unsigned long long>(held));
+    ok = held_rms < 1e-4 && transport.Position() + 2 >= held && transport.Position() <= held + 2 && ok;
+
+    // A UI thread flinging the playhead around while audio keeps rendering:
+    // posting never blocks and no block takes anywhere near its budget.
+    std::atomic<bool> flinging{true};
+    std::atomic<int> posted{0};
+    double worst_post_us = 0.0;
+    std::thread ui([&] {
+      std::mt19937 random(7);
+      std::uniform_int_distribution<std::uint64_t> anywhere(0, kClipStart + kClipFrames);
+      while (flinging.load()) {
+        const auto started = std::chrono::steady_clock::now();
+        posted += transport.ScrubTo(anywhere(random)) ? 1 : 0;
+        const std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - started;
+        worst_post_us = std::max(worst_post_us, took.count());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    });
+    scrubber.worst_block_ms = 0.0;
+    scrubber.Run(200, [](std::size_t) { return -1; });
+    flinging.store(false);
+    ui.join();
+    std::printf("flinging: %d positions posted, worst post %.1f us, worst block %.2f ms of %.2f\n", posted.load(),
+                worst_post_us, scrubber.worst_block_ms, kBlockTime.count() / 1000.0);
+    ok = posted > 100 && worst_post_us < 1000.0 && scrubber.worst_block_ms < kBlockTime.count() / 1000.0 && ok;
+
+    // The streams survived the storm: a drag afterwards is heard again.
+    const auto settle = static_cast<double>(kClipStart + kSampleRate * 5);
+    scrubber.Run(100,
+                 [&](std::size_t b) { return static_cast<std::int64_t>(settle + static_cast<double>(b * kBlock)); });
+    const double after_rms = scrubber.Rms(kBlock * 40);
+    std::printf("drag after flinging: rms %.3f\n", after_rms);
+    ok = after_rms > 0.05 && ok;
+
+    transport.EndScrub();
+    scrubber.Run(10, [](std::size_t) { return -1; });
+    ok = !transport.Scrubbing() && scrubber.Rms(kBlock * 4) == 0.0 && ok;
+  }
+  std::filesystem::remove(path);
+  std::printf("transport scrub grains  %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// Fills a four-voice pool and checks each stealing policy picks the voice it
+// promises, skipping voices that are no longer stealable, and that released
+// voices go back through the free list and out of the active and per-note
+// lists.
+
+#include "voice_pool.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using namespace music_create::audio;
+
+struct TestVoice {
+  float level = 0.0f;
+  bool releasing = false;  // already being stolen: not stealable again
+};
+
+using Pool = VoicePool<TestVoice>;
+
+bool Check(const char* what, bool pass) {
+  std::printf("%-44s %s\n", what, pass ? "ok" : "FAIL");
+  return pass;
+}
+
+Pool::Handle Select(const Pool& pool, VoiceStealPolicy policy, int note) {
+  return pool.SelectVictim(
+      policy, note, [](const TestVoice& voice) { return !voice.releasing; },
+      [](const TestVoice& voice) { return voice.level; });
+}
+
+std::vector<Pool::Handle> ActiveOrder(Pool& pool) {
+  std::vector<Pool::Handle> order;
+  pool.ForEachActive([&](Pool::Handle handle, TestVoice&) { order.push_back(handle); });
+  return order;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+  Pool pool(4);
+  const float levels[] = {0.5f, 0.2f, 0.9f, 0.1f};
+  const int notes[] = {60, 62, 60, 64};
+  Pool::Handle voices[4];
+  for (int i = 0; i < 4; ++i) {
+    voices[i] = pool.Allocate(notes[i]);
+    pool[voices[i]].level = levels[i];
+  }
+  ok = Check("a full pool hands out no voice", pool.Full() && pool.Allocate(65) == Pool::kNoVoice) && ok;
+
+  const auto picks = [&](const char* what, VoiceStealPolicy policy, int note, Pool::Handle expected) {
+    ok = Check(what, Select(pool, policy, note) == expected) && ok;
+  };
+  picks("kNone steals nothing", VoiceStealPolicy::kNone, 60, Pool::kNoVoice);
+  picks("kOldest takes the first voice", VoiceStealPolicy::kOldest, 65, voices[0]);
+  picks("kSameNote takes the oldest on the note", VoiceStealPolicy::kSameNote, 60, voices[0]);
+  picks("kSameNote falls back to the oldest", VoiceStealPolicy::kSameNote, 65, voices[0]);
+  picks("kQuietest takes the lowest level", VoiceStealPolicy::kQuietest, 65, voices[3]);
+
+  // Voices already being stolen are passed over.
+  pool[voices[0]].releasing = true;
+  pool[voices[3]].releasing = true;
+  picks("kOldest skips a stolen voice", VoiceStealPolicy::kOldest, 65, voices[1]);
+  picks("kSameNote skips a stolen voice", VoiceStealPolicy::kSameNote, 60, voices[2]);
+  picks("kSameNote falls back past a stolen voice", VoiceStealPolicy::kSameNote, 65, voices[1]);
+  picks("kQuietest skips a stolen voice", VoiceStealPolicy::kQuietest, 65, voices[1]);
+  pool[voices[1]].releasing = true;
+  pool[voices[2]].releasing = true;
+  bool none = true;
+  for (const auto policy : {VoiceStealPolicy::kOldest, VoiceStealPolicy::kQuietest, VoiceStealPolicy::kSameNote}) {
+    none = Select(pool, policy, 60) == Pool::kNoVoice && none;
+  }
+  ok = Check("nothing stealable, no victim", none) && ok;
+
+  // A released voice leaves the active and note lists and is reused next,
+  // joining the active list as its newest voice.
+  pool.Release(voices[0]);
+  pool.Release(voices[0]);
+  ok = Check("release frees one voice", pool.ActiveCount() == 3 && !pool.Full()) && ok;
+  ok = Check("the note list moves on", pool.OldestWithNote(60) == voices[2] && pool.Oldest() == voices[1]) && ok;
+  const Pool::Handle reused = pool.Allocate(67);
+  ok = Check("the freed voice is reused", reused == voices[0] && pool.NoteOf(reused) == 67) && ok;
+  const std::vector<Pool::Handle> expected = {voices[1], voices[2], voices[3], voices[0]};
+  ok = Check("the reused voice is the newest", ActiveOrder(pool) == expected) && ok;
+
+  // The free list hands voices back last released first.
+  pool.Release(voices[2]);
+  pool.Release(voices[1]);
+  const Pool::Handle first = pool.Allocate(60);
+  const Pool::Handle second = pool.Allocate(60);
+  const bool lifo = first == voices[1] && second == voices[2] && pool.OldestWithNote(60) == voices[1];
+  ok = Check("the free list is last in, first out", lifo && pool.Full()) && ok;
+
+  pool.Reset();
+  const bool empty = pool.ActiveCount() == 0 && pool.Oldest() == Pool::kNoVoice && ActiveOrder(pool).empty();
+  ok = Check("reset empties the pool", empty && pool.OldestWithNote(60) == Pool::kNoVoice) && ok;
+
+  bool rejected = false;
+  try {
+    Pool zero(0);
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  ok = Check("a zero-voice pool is rejected", rejected) && ok;
+
+  std::printf("voice pool policies  %s\n", ok ? "ok" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// 16-bit PCM WAV files the tests write to the temp directory and read back
+// through the native readers or the transport's streams.
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace music_create::audio::tests {
+
+inline void AppendLittleEndian(std::vector<char>& out, std::uint32_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+// Writes `frames` frames of `channels` interleaved channels to `name` in the
+// temp directory; `sample(channel, frame)` returns each std::int16_t value.
+template <typename SampleFn>
+std::filesystem::path WriteWav(const std::string& name, std::uint32_t sample_rate, std::uint32_t channels,
+                               std::uint32_t frames, SampleFn sample) {
+  std::vector<char> image = {'R', 'I', 'F', 'F'};
+  const std::uint32_t data_bytes = channels * frames * 2;
+  AppendLittleEndian(image, 36 + data_bytes, 4);
+  image.insert(image.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  AppendLittleEndian(image, 16, 4);
+  AppendLittleEndian(image, 1, 2);
+  AppendLittleEndian(image, channels, 2);
+  AppendLittleEndian(image, sample_rate, 4);
+  AppendLittleEndian(image, sample_rate * channels * 2, 4);
+  AppendLittleEndian(image, channels * 2, 2);
+  AppendLittleEndian(image, 16, 2);
+  image.insert(image.end(), {'d', 'a', 't', 'a'});
+  AppendLittleEndian(image, data_bytes, 4);
+  image.reserve(image.size() + data_bytes);
+  for (std::uint32_t f = 0; f < frames; ++f) {
+    for (std::uint32_t c = 0; c < channels; ++c) {
+      AppendLittleEndian(image, static_cast<std::uint16_t>(sample(c, f)), 2);
+    }
+  }
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream(path, std::ios::binary).write(image.data(), static_cast<std::streamsize>(image.size()));
+  return path;
+}
+
+}  // namespace music_create::audio::tests
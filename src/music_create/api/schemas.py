@@ -32,6 +32,7 @@ class SuggestionCandidate(BaseModel):
     score: float
     reason: str
     param_updates: dict[str, dict[str, float]]
+    send_levels: dict[str, float] = Field(default_factory=dict)
 
 
 class SuggestResponse(BaseModel):
@@ -75,6 +75,7 @@ def create_app(
                     score=item.score,
                     reason=item.reason,
                     param_updates={k.value: v for k, v in item.param_updates.items()},
+                    send_levels=dict(item.send_levels),
                 )
                 for item in suggestions
             ]
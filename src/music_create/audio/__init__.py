@@ -2,6 +2,7 @@
 
 from music_create.audio.mix_render import is_track_processing_active, render_track_preview_wav
 from music_create.audio.native_engine import NativeAudioEngine
+from music_create.audio.native_reader import NativeAudioFileReader, load_audio_mono_float32
 from music_create.audio.repository import WaveformRepository, WaveformTrackData
 from music_create.audio.wav_loader import load_wav_mono_float32
 
@@ -9,7 +10,9 @@ __all__ = [
     "is_track_processing_active",
     "render_track_preview_wav",
     "NativeAudioEngine",
+    "NativeAudioFileReader",
     "WaveformRepository",
     "WaveformTrackData",
+    "load_audio_mono_float32",
     "load_wav_mono_float32",
 ]
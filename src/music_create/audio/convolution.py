@@ -0,0 +1,130 @@
+"""Partitioned FFT convolution reverb for send buses, backed by the native `mc_convolver_*` API."""
+
+from __future__ import annotations
+
+import ctypes
+from pathlib import Path
+from typing import Sequence
+
+from music_create.audio.native_engine import load_native_library
+from music_create.audio.native_reader import load_audio_planar_float32
+from music_create.mixing.mixer_graph import SendState
+
+DEFAULT_BLOCK_SIZE = 256
+
+
+class ConvolutionIr:
+    """Impulse response transformed once; every reverb built from it shares the spectra."""
+
+    def __init__(
+        self,
+        samples: Sequence[float],
+        block_size: int = DEFAULT_BLOCK_SIZE,
+        dll_path: str | Path | None = None,
+    ) -> None:
+        self._handle: int | None = None
+        lib = load_native_library(dll_path)
+        if lib is None:
+            raise RuntimeError("native audio core is not available")
+        _declare_convolution_api(lib)
+        count = len(samples)
+        handle = lib.mc_convolution_ir_create((ctypes.c_float * count)(*samples), count, int(block_size))
+        if not handle:
+            raise ValueError("impulse response is empty or block size is not a power of two in [16, 8192]")
+        self._lib = lib
+        self._handle = handle
+        self.block_size = int(block_size)
+        self.length = count
+
+    @classmethod
+    def from_file(
+        cls,
+        path: str | Path,
+        channel: int = 0,
+        block_size: int = DEFAULT_BLOCK_SIZE,
+        dll_path: str | Path | None = None,
+    ) -> ConvolutionIr:
+        _, planar = load_audio_planar_float32(path, dll_path=dll_path)
+        return cls(planar[min(max(channel, 0), len(planar) - 1)], block_size=block_size, dll_path=dll_path)
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_convolution_ir_free(self._handle)
+            self._handle = None
+
+    def __del__(self) -> None:
+        self.close()
+
+
+class ConvolutionReverb:
+    """Streaming mono convolver; output lags input by `latency` samples (one block)."""
+
+    def __init__(self, ir: ConvolutionIr) -> None:
+        self._handle: int | None = None
+        if ir._handle is None:
+            raise RuntimeError("impulse response is closed")
+        handle = ir._lib.mc_convolver_create(ir._handle)
+        if not handle:
+            raise RuntimeError("failed to create convolver")
+        self._lib = ir._lib
+        self._handle = handle
+        self.latency = int(self._lib.mc_convolver_latency(handle))
+
+    def process(self, samples: Sequence[float]) -> list[float]:
+        if self._handle is None:
+            raise RuntimeError("convolver is closed")
+        count = len(samples)
+        buffer = (ctypes.c_float * count)(*samples)
+        if not self._lib.mc_convolver_process(self._handle, buffer, buffer, count):
+            raise RuntimeError("convolution failed")
+        return list(buffer)
+
+    def reset(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_convolver_reset(self._handle)
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_convolver_free(self._handle)
+            self._handle = None
+
+    def __del__(self) -> None:
+        self.close()
+
+
+def render_convolution_send(dry: Sequence[float], send: SendState, ir: ConvolutionIr) -> list[float]:
+    """Offline wet return of `dry` through `send` into a convolution bus.
+
+    The block latency is removed and the reverb tail is kept, so the result is
+    `len(dry) + ir.length - 1` samples aligned with the dry signal.
+    """
+    reverb = ConvolutionReverb(ir)
+    try:
+        gain = 10.0 ** (send.level_db / 20.0)
+        padded = [sample * gain for sample in dry]
+        padded.extend([0.0] * (ir.length - 1 + reverb.latency))
+        return reverb.process(padded)[reverb.latency :]
+    finally:
+        reverb.close()
+
+
+def _declare_convolution_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_convolution_ir_create.argtypes = [ctypes.POINTER(ctypes.c_float), ctypes.c_ulonglong, ctypes.c_uint]
+    lib.mc_convolution_ir_create.restype = ctypes.c_void_p
+    lib.mc_convolution_ir_free.argtypes = [ctypes.c_void_p]
+    lib.mc_convolution_ir_free.restype = None
+    lib.mc_convolver_create.argtypes = [ctypes.c_void_p]
+    lib.mc_convolver_create.restype = ctypes.c_void_p
+    lib.mc_convolver_free.argtypes = [ctypes.c_void_p]
+    lib.mc_convolver_free.restype = None
+    lib.mc_convolver_latency.argtypes = [ctypes.c_void_p]
+    lib.mc_convolver_latency.restype = ctypes.c_uint
+    lib.mc_convolver_process.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_convolver_process.restype = ctypes.c_int
+    lib.mc_convolver_reset.argtypes = [ctypes.c_void_p]
+    lib.mc_convolver_reset.restype = ctypes.c_int
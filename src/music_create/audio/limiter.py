@@ -0,0 +1,60 @@
+"""Native lookahead brickwall limiter (`mc_limiter_*`)."""
+
+from __future__ import annotations
+
+import ctypes
+from typing import Sequence
+
+from music_create.audio.native_engine import load_native_library
+
+
+def render_limiter(
+    channels: Sequence[Sequence[float]],
+    sample_rate: int,
+    params: dict[str, float],
+) -> list[list[float]] | None:
+    """Limit one or two equal-length channels (stereo-linked) through a fresh native limiter.
+
+    The lookahead latency is compensated, so the output lines up with the input.
+    Returns None when the native core is unavailable.
+    """
+    lib = load_native_library()
+    if lib is None:
+        return None
+    _declare_limiter_api(lib)
+    handle = lib.mc_limiter_create(
+        int(sample_rate),
+        params.get("ceiling_db", -1.0),
+        params.get("lookahead_ms", 5.0),
+        params.get("release_ms", 80.0),
+    )
+    if not handle:
+        return None
+    try:
+        latency = lib.mc_limiter_latency(handle)
+        count = len(channels[0]) + latency
+        buffers = [(ctypes.c_float * count)(*channel) for channel in channels[:2]]
+        right = buffers[1] if len(buffers) > 1 else None
+        if not lib.mc_limiter_process(handle, buffers[0], right, count):
+            return None
+        return [list(buffer)[latency:] for buffer in buffers]
+    finally:
+        lib.mc_limiter_free(handle)
+
+
+def _declare_limiter_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_limiter_create.argtypes = [ctypes.c_uint, ctypes.c_float, ctypes.c_float, ctypes.c_float]
+    lib.mc_limiter_create.restype = ctypes.c_void_p
+    lib.mc_limiter_free.argtypes = [ctypes.c_void_p]
+    lib.mc_limiter_free.restype = None
+    lib.mc_limiter_latency.argtypes = [ctypes.c_void_p]
+    lib.mc_limiter_latency.restype = ctypes.c_uint
+    lib.mc_limiter_process.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_limiter_process.restype = ctypes.c_int
+    lib.mc_limiter_reset.argtypes = [ctypes.c_void_p]
+    lib.mc_limiter_reset.restype = ctypes.c_int
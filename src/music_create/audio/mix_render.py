@@ -4,14 +4,33 @@ from __future__ import annotations
 
 import math
 import wave
+from collections import deque
 from dataclasses import dataclass
 from pathlib import Path
+from typing import Mapping
 
+from music_create.audio.limiter import render_limiter
+from music_create.audio.native_reader import is_native_only_format, load_audio_planar_float32
+from music_create.audio.saturator import render_saturator
+from music_create.audio.time_effects import render_fdn_reverb, render_tempo_delay
 from music_create.mixing.fx import EFFECT_SPECS
 from music_create.mixing.mixer_graph import MixerTrackState
-from music_create.mixing.models import BuiltinEffectType
+from music_create.mixing.models import BuiltinEffectType, ChannelLayout
 
 _EPSILON = 1e-6
+_DEFAULT_TEMPO_BPM = 120.0
+
+# Reference constants of the native FDN reverb (fdn_reverb.cpp).
+_FDN_BASE_LENGTHS = (1433, 1601, 1867, 2053, 2251, 2399, 2617, 2801)
+_FDN_INPUT_GAINS = (0.5, -0.5, 0.5, -0.5, 0.5, -0.5, 0.5, -0.5)
+_FDN_OUTPUT_GAINS = (0.35, 0.35, -0.35, -0.35, 0.35, -0.35, -0.35, 0.35)
+_FDN_HADAMARD_NORM = 1.0 / math.sqrt(8.0)
+_FDN_MAX_DAMPING = 0.7
+_DELAY_MAX_SECONDS = 4.0
+_DELAY_MAX_DAMPING = 0.85
+_LAYOUTS_BY_CHANNEL_COUNT = {len(layout.speakers): layout for layout in ChannelLayout}
+_LEFT_SPEAKERS = frozenset({"L", "Ls", "Lrs"})
+_RIGHT_SPEAKERS = frozenset({"R", "Rs", "Rrs"})
 
 
 @dataclass(slots=True)
@@ -23,7 +42,11 @@ class _WaveBuffer:
     samples: list[list[float]]
 
 
-def is_track_processing_active(track_state: MixerTrackState) -> bool:
+def is_track_processing_active(
+    track_state: MixerTrackState, buses: Mapping[str, MixerTrackState] | None = None
+) -> bool:
+    if buses and any(send.target_bus_id in buses for send in track_state.sends):
+        return True
     if abs(track_state.input_gain_db) > _EPSILON:
         return True
     if abs(track_state.fader_db) > _EPSILON:
@@ -46,24 +69,34 @@ def render_track_preview_wav(
     source_path: str | Path,
     target_path: str | Path,
     track_state: MixerTrackState,
+    tempo_bpm: float = _DEFAULT_TEMPO_BPM,
+    buses: Mapping[str, MixerTrackState] | None = None,
 ) -> Path:
+    """Render `track_state` over the source, plus the returns of its sends into `buses`.
+
+    Each send feeds its bus, e.g. the shared reverb of `SEND_EFFECT_BUSES`,
+    and the bus output is mixed back in, so the preview sounds like the
+    track soloed in place.
+    """
     source = Path(source_path)
     target = Path(target_path)
     if not source.exists():
         raise FileNotFoundError(str(source))
 
     target.parent.mkdir(parents=True, exist_ok=True)
-    if not is_track_processing_active(track_state):
+    if not is_track_processing_active(track_state, buses) and not is_native_only_format(source):
         target.write_bytes(source.read_bytes())
         return target
 
     buffer = _read_wav(source)
-    processed = _process_track(buffer, track_state)
+    processed = _process_track(buffer, track_state, tempo_bpm, buses or {})
     _write_wav(target, processed)
     return target
 
 
 def _read_wav(path: Path) -> _WaveBuffer:
+    if is_native_only_format(path):
+        return _read_native(path)
     with wave.open(str(path), "rb") as wav:
         channels = wav.getnchannels()
         sample_width = wav.getsampwidth()
@@ -96,6 +129,18 @@ def _read_wav(path: Path) -> _WaveBuffer:
     )
 
 
+def _read_native(path: Path) -> _WaveBuffer:
+    sample_rate, samples = load_audio_planar_float32(path)
+    frame_count = min((len(channel) for channel in samples), default=0)
+    return _WaveBuffer(
+        sample_rate=sample_rate,
+        channels=len(samples),
+        sample_width=3,
+        frame_count=frame_count,
+        samples=samples,
+    )
+
+
 def _write_wav(path: Path, buffer: _WaveBuffer) -> None:
     with wave.open(str(path), "wb") as wav:
         wav.setnchannels(buffer.channels)
@@ -114,7 +159,12 @@ def _write_wav(path: Path, buffer: _WaveBuffer) -> None:
         wav.writeframes(bytes(frames))
 
 
-def _process_track(buffer: _WaveBuffer, track_state: MixerTrackState) -> _WaveBuffer:
+def _process_track(
+    buffer: _WaveBuffer,
+    track_state: MixerTrackState,
+    tempo_bpm: float = _DEFAULT_TEMPO_BPM,
+    buses: Mapping[str, MixerTrackState] | None = None,
+) -> _WaveBuffer:
     processed: list[list[float]] = []
     input_gain = _db_to_gain(track_state.input_gain_db)
 
@@ -122,11 +172,17 @@ def _process_track(buffer: _WaveBuffer, track_state: MixerTrackState) -> _WaveBu
     comp_params = track_state.fx_chain.effects[BuiltinEffectType.COMPRESSOR].parameters
     gate_params = track_state.fx_chain.effects[BuiltinEffectType.GATE].parameters
     sat_params = track_state.fx_chain.effects[BuiltinEffectType.SATURATOR].parameters
+    reverb_params = _effect_params(track_state, BuiltinEffectType.REVERB)
+    delay_params = _effect_params(track_state, BuiltinEffectType.DELAY)
+    limiter_params = _effect_params(track_state, BuiltinEffectType.LIMITER)
 
     eq_active = _effect_active(BuiltinEffectType.EQ, eq_params)
     comp_active = _effect_active(BuiltinEffectType.COMPRESSOR, comp_params)
     gate_active = _effect_active(BuiltinEffectType.GATE, gate_params)
     sat_active = _effect_active(BuiltinEffectType.SATURATOR, sat_params)
+    delay_active = delay_params.get("mix", 0.0) > _EPSILON
+    reverb_active = reverb_params.get("mix", 0.0) > _EPSILON
+    limiter_active = _effect_active(BuiltinEffectType.LIMITER, limiter_params)
 
     for channel in buffer.samples:
         samples = [sample * input_gain for sample in channel]
@@ -138,9 +194,31 @@ def _process_track(buffer: _WaveBuffer, track_state: MixerTrackState) -> _WaveBu
             samples = _apply_gate(samples, buffer.sample_rate, gate_params)
         if sat_active:
             samples = _apply_saturator(samples, sat_params)
+        if delay_active:
+            samples = _apply_delay(samples, buffer.sample_rate, delay_params, tempo_bpm)
+        if reverb_active:
+            samples = _apply_reverb(samples, buffer.sample_rate, reverb_params)
         processed.append(samples)
+    if limiter_active:
+        processed = _apply_limiter(processed, buffer.sample_rate, limiter_params)
 
+    pre_fader = [list(channel) for channel in processed] if any(send.pre_fader for send in track_state.sends) else []
     _apply_output_gain_and_pan(processed, track_state)
+    # Send returns, tapped like the native graph: before or after fader and pan.
+    returns: list[list[float]] = []
+    for send in track_state.sends:
+        bus = (buses or {}).get(send.target_bus_id)
+        if bus is None:
+            continue
+        send_gain = _db_to_gain(send.level_db)
+        tap = pre_fader if send.pre_fader else processed
+        fed = [[sample * send_gain for sample in channel] for channel in tap]
+        bus_buffer = _WaveBuffer(buffer.sample_rate, buffer.channels, buffer.sample_width, buffer.frame_count, fed)
+        returns.append(_process_track(bus_buffer, bus, tempo_bpm).samples)
+    for wet in returns:
+        for channel, wet_channel in zip(processed, wet):
+            for index, sample in enumerate(wet_channel):
+                channel[index] += sample
     for channel in processed:
         for index, sample in enumerate(channel):
             channel[index] = _clip(sample)
@@ -154,6 +232,44 @@ def _process_track(buffer: _WaveBuffer, track_state: MixerTrackState) -> _WaveBu
     )
 
 
+# Processing order of the preview chain (and of the native mixdown graph).
+EFFECT_CHAIN_ORDER: tuple[BuiltinEffectType, ...] = (
+    BuiltinEffectType.EQ,
+    BuiltinEffectType.COMPRESSOR,
+    BuiltinEffectType.GATE,
+    BuiltinEffectType.SATURATOR,
+    BuiltinEffectType.DELAY,
+    BuiltinEffectType.REVERB,
+    BuiltinEffectType.LIMITER,
+)
+_TIME_BASED_EFFECTS = frozenset({BuiltinEffectType.DELAY, BuiltinEffectType.REVERB})
+
+
+def active_effect_chain(track_state: MixerTrackState) -> list[tuple[BuiltinEffectType, dict[str, float]]]:
+    """Effects that change the signal, in processing order.
+
+    Dynamics with a sidechain source count as active even at default settings.
+    """
+    chain: list[tuple[BuiltinEffectType, dict[str, float]]] = []
+    for effect_type in EFFECT_CHAIN_ORDER:
+        params = _effect_params(track_state, effect_type)
+        if effect_type in _TIME_BASED_EFFECTS:
+            active = params.get("mix", 0.0) > _EPSILON
+        else:
+            active = _effect_active(effect_type, params) or effect_type in track_state.sidechains
+        if active:
+            chain.append((effect_type, params))
+    return chain
+
+
+def _effect_params(track_state: MixerTrackState, effect_type: BuiltinEffectType) -> dict[str, float]:
+    # Chains saved before an effect existed fall back to its (inactive) defaults.
+    state = track_state.fx_chain.effects.get(effect_type)
+    if state is not None:
+        return state.parameters
+    return {param.param_id: param.default for param in EFFECT_SPECS[effect_type].parameters}
+
+
 def _effect_active(effect_type: BuiltinEffectType, params: dict[str, float]) -> bool:
     defaults = {param.param_id: param.default for param in EFFECT_SPECS[effect_type].parameters}
     for param_id, default_value in defaults.items():
@@ -240,6 +356,9 @@ def _apply_saturator(samples: list[float], params: dict[str, float]) -> list[flo
     mix = min(max(params.get("mix", 0.0), 0.0), 1.0)
     if mix <= _EPSILON:
         return samples
+    native = render_saturator(samples, params)
+    if native is not None:
+        return native
 
     shape = 1.0 + (drive * 8.0)
     normalizer = math.tanh(shape)
@@ -253,29 +372,151 @@ def _apply_saturator(samples: list[float], params: dict[str, float]) -> list[flo
     return out
 
 
+def _apply_delay(samples: list[float], sample_rate: int, params: dict[str, float], tempo_bpm: float) -> list[float]:
+    native = render_tempo_delay(samples, sample_rate, params, tempo_bpm)
+    if native is not None:
+        return native
+
+    mix = min(max(params.get("mix", 0.0), 0.0), 1.0)
+    feedback = min(max(params.get("feedback", 0.35), 0.0), 0.95)
+    damping = min(max(params.get("damping", 0.2), 0.0), 1.0) * _DELAY_MAX_DAMPING
+    tempo = min(max(tempo_bpm, 20.0), 400.0)
+    seconds = max(params.get("time_beats", 0.5), 0.0) * 60.0 / tempo
+    delay = min(max(seconds * sample_rate, 1.0), _DELAY_MAX_SECONDS * sample_rate)
+
+    size = 1 << (math.ceil(_DELAY_MAX_SECONDS * sample_rate) + 1).bit_length()
+    mask = size - 1
+    ring = [0.0] * size
+    whole = int(delay)
+    fraction = delay - whole
+    lowpass = 0.0
+    out: list[float] = []
+    for write, sample in enumerate(samples):
+        near = ring[(write - whole) & mask]
+        far = ring[(write - whole - 1) & mask]
+        delayed = near + fraction * (far - near)
+        lowpass = delayed + damping * (lowpass - delayed)
+        ring[write & mask] = sample + lowpass * feedback
+        out.append(sample + mix * (delayed - sample))
+    return out
+
+
+def _apply_reverb(samples: list[float], sample_rate: int, params: dict[str, float]) -> list[float]:
+    native = render_fdn_reverb(samples, sample_rate, params)
+    if native is not None:
+        return native
+
+    mix = min(max(params.get("mix", 0.0), 0.0), 1.0)
+    decay = min(max(params.get("decay_s", 1.8), 0.05), 30.0)
+    damping = min(max(params.get("damping", 0.4), 0.0), 1.0) * _FDN_MAX_DAMPING
+    size = min(max(params.get("size", 0.6), 0.05), 1.0)
+    # floor(x + 0.5) mirrors the native lround; round() would pick the even neighbour on ties.
+    pre_length = math.floor(min(max(params.get("pre_delay_ms", 10.0), 0.0), 200.0) * 0.001 * sample_rate + 0.5)
+
+    scale = size * sample_rate / 48000.0
+    lengths = [max(math.floor(base * scale + 0.5), 8) for base in _FDN_BASE_LENGTHS]
+    gains = [10.0 ** (-3.0 * length / (decay * sample_rate)) for length in lengths]
+    lines = [[0.0] * length for length in lengths]
+    positions = [0] * len(lines)
+    lowpass = [0.0] * len(lines)
+    pre_ring = [0.0] * max(pre_length, 1)
+    pre_position = 0
+
+    out: list[float] = []
+    for sample in samples:
+        if pre_length == 0:
+            pre = sample
+        else:
+            pre = pre_ring[pre_position]
+            pre_ring[pre_position] = sample
+            pre_position = (pre_position + 1) % pre_length
+
+        taps = [line[position] for line, position in zip(lines, positions)]
+        mixed: list[float] = []
+        wet = 0.0
+        for index, tap in enumerate(taps):
+            lowpass[index] = tap + damping * (lowpass[index] - tap)
+            mixed.append(lowpass[index] * gains[index])
+            wet += tap * _FDN_OUTPUT_GAINS[index]
+        span = 1
+        while span < len(mixed):
+            for index in range(len(mixed)):
+                if index & span == 0:
+                    a, b = mixed[index], mixed[index + span]
+                    mixed[index], mixed[index + span] = a + b, a - b
+            span *= 2
+        for index, line in enumerate(lines):
+            line[positions[index]] = mixed[index] * _FDN_HADAMARD_NORM + pre * _FDN_INPUT_GAINS[index]
+            positions[index] = (positions[index] + 1) % len(line)
+        out.append(sample + mix * (wet - sample))
+    return out
+
+
+def _apply_limiter(channels: list[list[float]], sample_rate: int, params: dict[str, float]) -> list[list[float]]:
+    native = render_limiter(channels, sample_rate, params)
+    if native is not None:
+        return native
+
+    # Reference of limiter.cpp with the lookahead delay compensated.
+    ceiling = _db_to_gain(min(max(params.get("ceiling_db", -1.0), -60.0), 0.0))
+    release = _time_coeff(max(params.get("release_ms", 80.0), 1.0), sample_rate)
+    lookahead = max(1, math.floor(min(max(params.get("lookahead_ms", 5.0), 0.0), 100.0) * 0.001 * sample_rate + 0.5))
+    window = lookahead + 1
+    count = len(channels[0])
+
+    held: deque[tuple[int, float]] = deque()
+    released = 1.0
+    average = deque([1.0] * window)
+    average_sum = float(window)
+    gains: list[float] = []
+    for index in range(count + lookahead):
+        peak = max((abs(channel[index]) for channel in channels), default=0.0) if index < count else 0.0
+        required = ceiling / peak if peak > ceiling else 1.0
+        while held and held[-1][1] >= required:
+            held.pop()
+        held.append((index, required))
+        if held[0][0] + window <= index:
+            held.popleft()
+        minimum = held[0][1]
+        released = minimum if minimum < released else minimum + (released - minimum) * release
+        average_sum += released - average.popleft()
+        average.append(released)
+        if index >= lookahead:
+            gains.append(average_sum / window)
+
+    return [
+        [min(max(sample * gain, -ceiling), ceiling) for sample, gain in zip(channel, gains)] for channel in channels
+    ]
+
+
 def _apply_output_gain_and_pan(samples: list[list[float]], track_state: MixerTrackState) -> None:
     if not samples:
         return
     output_gain = _db_to_gain(track_state.fader_db)
-
-    if len(samples) == 1:
-        channel = samples[0]
-        for index, value in enumerate(channel):
-            channel[index] = value * output_gain
-        return
-
     pan = min(max(track_state.pan, -1.0), 1.0)
-    angle = (pan + 1.0) * (math.pi / 4.0)
-    left_gain = math.cos(angle) * output_gain
-    right_gain = math.sin(angle) * output_gain
-
-    for index, value in enumerate(samples[0]):
-        samples[0][index] = value * left_gain
-    for index, value in enumerate(samples[1]):
-        samples[1][index] = value * right_gain
-    for channel in samples[2:]:
+    layout = _LAYOUTS_BY_CHANNEL_COUNT.get(len(samples))
+
+    if layout is None or layout == ChannelLayout.STEREO:
+        # Equal-power pan on the first two channels, as on native stereo tracks.
+        angle = (pan + 1.0) * (math.pi / 4.0)
+        gains = [math.cos(angle) * output_gain, math.sin(angle) * output_gain]
+        gains += [output_gain] * (len(samples) - 2)
+    else:
+        # Mono has nothing to pan; wider layouts balance their left and right
+        # speakers like native buses and multichannel tracks.
+        gains = [output_gain * _balance(speaker, pan) for speaker in layout.speakers]
+
+    for channel, gain in zip(samples, gains):
         for index, value in enumerate(channel):
-            channel[index] = value * output_gain
+            channel[index] = value * gain
+
+
+def _balance(speaker: str, pan: float) -> float:
+    if speaker in _LEFT_SPEAKERS:
+        return min(1.0, 1.0 - pan)
+    if speaker in _RIGHT_SPEAKERS:
+        return min(1.0, 1.0 + pan)
+    return 1.0
 
 
 def _one_pole_alpha(cutoff_hz: float, sample_rate: int) -> float:
@@ -0,0 +1,268 @@
+"""Mixdown of a `MixerGraph` through the native `mc_mix_graph_*` API."""
+
+from __future__ import annotations
+
+import ctypes
+from pathlib import Path
+from typing import Sequence
+
+from music_create.audio.mix_render import active_effect_chain
+from music_create.audio.native_engine import load_native_library
+from music_create.audio.saturator import oversampling_factor
+from music_create.mixing.fx import EFFECT_SPECS
+from music_create.mixing.mixer_graph import MASTER_BUS_ID, MixerGraph, MixerTrackState
+from music_create.mixing.models import BuiltinEffectType, ChannelLayout
+
+DEFAULT_BLOCK_SIZE = 512
+_NO_NODE = -1
+# `mc_mix_graph_set_layout` codes.
+_LAYOUT_CODES = {
+    ChannelLayout.MONO: 0,
+    ChannelLayout.STEREO: 1,
+    ChannelLayout.LCR: 2,
+    ChannelLayout.SURROUND_5_1: 3,
+    ChannelLayout.SURROUND_7_1: 4,
+}
+
+
+def render_mixdown(
+    graph: MixerGraph,
+    sources: dict[str, Sequence[Sequence[float]]],
+    sample_rate: int,
+    tempo_bpm: float = 120.0,
+    block_size: int = DEFAULT_BLOCK_SIZE,
+    dll_path: str | Path | None = None,
+) -> list[list[float]]:
+    """Mix planar track audio (`sources[track_id]`) in the master's channel layout.
+
+    Every track and bus runs in its `channel_layout` (stereo by default) and
+    is folded or panned into the layout it feeds, so a 5.1 master renders
+    surround stems and a stereo master downmixes surround buses. Source
+    channels map onto the track layout in order; a mono source feeds both
+    sides of a stereo track and missing channels are silent. Buses come from
+    `graph.buses` and from send targets; `MASTER_BUS_ID` configures the
+    master, which always ends in a limiter. Compressors and
+    gates with a `sidechains` entry key from that track or bus, and the native
+    graph orders nodes so every source is processed before its consumers. The
+    graph compensates processor latency (limiter lookahead) at every summing
+    point, and the returned mix is aligned with the sources. Raises ValueError
+    for unknown sidechain sources or routing cycles.
+    """
+    lib = load_native_library(dll_path)
+    if lib is None:
+        raise RuntimeError("native audio core is not available")
+    declare_mix_graph_api(lib)
+    handle = lib.mc_mix_graph_create(int(sample_rate), int(block_size))
+    if not handle:
+        raise ValueError("invalid sample rate or block size")
+    try:
+        return _render(lib, handle, graph, sources, tempo_bpm)
+    finally:
+        lib.mc_mix_graph_free(handle)
+
+
+def _render(
+    lib: ctypes.WinDLL,
+    handle: int,
+    graph: MixerGraph,
+    sources: dict[str, Sequence[Sequence[float]]],
+    tempo_bpm: float,
+) -> list[list[float]]:
+    track_nodes, layouts = build_native_graph(lib, handle, graph, tempo_bpm)
+
+    # The graph aligns every path to the slowest one; skipping that much of
+    # the output lines the mixdown up with the sources again.
+    latency = lib.mc_mix_graph_latency(handle)
+    frames = max((len(channels[0]) for channels in sources.values() if channels), default=0)
+    total = frames + latency
+    # One input pointer per channel of every node, in node order.
+    offsets = [0]
+    for layout in layouts:
+        offsets.append(offsets[-1] + len(layout.speakers))
+    inputs = (ctypes.POINTER(ctypes.c_float) * offsets[-1])()
+    keep_alive: list[ctypes.Array[ctypes.c_float]] = []
+    for track_id, node in track_nodes.items():
+        channels = sources.get(track_id)
+        if not channels:
+            continue
+        planar = list(channels)
+        if len(planar) == 1 and layouts[node] == ChannelLayout.STEREO:
+            planar.append(planar[0])
+        for channel, samples in enumerate(planar[: len(layouts[node].speakers)]):
+            buffer = (ctypes.c_float * total)(*samples[:frames])
+            keep_alive.append(buffer)
+            inputs[offsets[node] + channel] = ctypes.cast(buffer, ctypes.POINTER(ctypes.c_float))
+
+    outputs = [(ctypes.c_float * total)() for _ in layouts[0].speakers]
+    output_pointers = (ctypes.POINTER(ctypes.c_float) * len(outputs))(
+        *(ctypes.cast(buffer, ctypes.POINTER(ctypes.c_float)) for buffer in outputs)
+    )
+    if not lib.mc_mix_graph_process_channels(handle, inputs, output_pointers, total):
+        raise RuntimeError("mixdown failed")
+    return [list(buffer)[latency:] for buffer in outputs]
+
+
+def build_native_graph(
+    lib: ctypes.WinDLL, handle: int, graph: MixerGraph, tempo_bpm: float
+) -> tuple[dict[str, int], list[ChannelLayout]]:
+    """Add the nodes, routing and effects of `graph` to a native graph and compile it.
+
+    Returns the node of every track and the layout of every node in node
+    order. Raises ValueError for unknown sidechain sources or routing cycles.
+    """
+    bus_nodes: dict[str, int] = {MASTER_BUS_ID: 0}
+    bus_ids = list(graph.buses)
+    bus_ids += [send.target_bus_id for state in graph.tracks.values() for send in state.sends]
+    bus_ids += [send.target_bus_id for state in graph.buses.values() for send in state.sends]
+    for bus_id in bus_ids:
+        if bus_id not in bus_nodes:
+            bus_nodes[bus_id] = lib.mc_mix_graph_add_node(handle, 1)
+    track_nodes = {track_id: lib.mc_mix_graph_add_node(handle, 0) for track_id in graph.tracks}
+    node_of = {**bus_nodes, **track_nodes}
+
+    states: list[tuple[int, MixerTrackState]] = [(track_nodes[key], state) for key, state in graph.tracks.items()]
+    states += [(bus_nodes[key], state) for key, state in graph.buses.items()]
+    layouts = [ChannelLayout.STEREO] * len(node_of)
+    for node, state in states:
+        layouts[node] = state.channel_layout
+        _configure_node(lib, handle, node, state, node_of, tempo_bpm)
+    master = graph.buses.get(MASTER_BUS_ID) or MixerTrackState(track_id=MASTER_BUS_ID)
+    if all(effect_type != BuiltinEffectType.LIMITER for effect_type, _ in active_effect_chain(master)):
+        # The master always ends in a limiter so the mixdown cannot clip.
+        params = {param.param_id: param.default for param in EFFECT_SPECS[BuiltinEffectType.LIMITER].parameters}
+        limiter = master.fx_chain.effects.get(BuiltinEffectType.LIMITER)
+        params.update(limiter.parameters if limiter else {})
+        _add_limiter(lib, handle, 0, params)
+    if not lib.mc_mix_graph_compile(handle):
+        raise ValueError("mixer routing or sidechains form a cycle")
+    return track_nodes, layouts
+
+
+def _configure_node(
+    lib: ctypes.WinDLL,
+    handle: int,
+    node: int,
+    state: MixerTrackState,
+    node_of: dict[str, int],
+    tempo_bpm: float,
+) -> None:
+    lib.mc_mix_graph_set_layout(handle, node, _LAYOUT_CODES[state.channel_layout])
+    lib.mc_mix_graph_set_levels(handle, node, state.input_gain_db, state.fader_db, state.pan)
+    for send in state.sends:
+        if not lib.mc_mix_graph_add_send(handle, node, node_of[send.target_bus_id], send.level_db, send.pre_fader):
+            raise ValueError(f"invalid send from '{state.track_id}' to '{send.target_bus_id}'")
+
+    for effect_type, params in active_effect_chain(state):
+        sidechain = _NO_NODE
+        source_id = state.sidechains.get(effect_type)
+        if source_id is not None:
+            if source_id not in node_of:
+                raise ValueError(f"unknown sidechain source '{source_id}' for '{state.track_id}'")
+            sidechain = node_of[source_id]
+        if effect_type == BuiltinEffectType.EQ:
+            lib.mc_mix_graph_add_eq(
+                handle,
+                node,
+                params["low_gain_db"],
+                params["mid_gain_db"],
+                params["high_gain_db"],
+                params["low_freq_hz"],
+                params["high_freq_hz"],
+            )
+        elif effect_type == BuiltinEffectType.COMPRESSOR:
+            lib.mc_mix_graph_add_compressor(
+                handle,
+                node,
+                params["threshold_db"],
+                params["ratio"],
+                params["attack_ms"],
+                params["release_ms"],
+                params["makeup_db"],
+                sidechain,
+            )
+        elif effect_type == BuiltinEffectType.GATE:
+            lib.mc_mix_graph_add_gate(
+                handle, node, params["threshold_db"], params["attack_ms"], params["release_ms"], sidechain
+            )
+        elif effect_type == BuiltinEffectType.SATURATOR:
+            oversampling = oversampling_factor(params.get("oversampling", 1.0))
+            lib.mc_mix_graph_add_saturator(handle, node, params["drive"], params["mix"], oversampling)
+        elif effect_type == BuiltinEffectType.DELAY:
+            lib.mc_mix_graph_add_delay(
+                handle, node, params["mix"], params["time_beats"], tempo_bpm, params["feedback"], params["damping"]
+            )
+        elif effect_type == BuiltinEffectType.LIMITER:
+            _add_limiter(lib, handle, node, params)
+        elif effect_type == BuiltinEffectType.REVERB:
+            lib.mc_mix_graph_add_reverb(
+                handle,
+                node,
+                params["mix"],
+                params["decay_s"],
+                params["pre_delay_ms"],
+                params["damping"],
+                params["size"],
+            )
+
+
+def _add_limiter(lib: ctypes.WinDLL, handle: int, node: int, params: dict[str, float]) -> None:
+    lib.mc_mix_graph_add_limiter(handle, node, params["ceiling_db"], params["lookahead_ms"], params["release_ms"])
+
+
+def declare_mix_graph_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_mix_graph_create.argtypes = [ctypes.c_uint, ctypes.c_uint]
+    lib.mc_mix_graph_create.restype = ctypes.c_void_p
+    lib.mc_mix_graph_free.argtypes = [ctypes.c_void_p]
+    lib.mc_mix_graph_free.restype = None
+    lib.mc_mix_graph_add_node.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.mc_mix_graph_add_node.restype = ctypes.c_int
+    lib.mc_mix_graph_set_layout.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+    lib.mc_mix_graph_set_levels.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 3
+    lib.mc_mix_graph_add_send.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_float, ctypes.c_int]
+    lib.mc_mix_graph_add_eq.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 5
+    lib.mc_mix_graph_add_compressor.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 5 + [ctypes.c_int]
+    lib.mc_mix_graph_add_gate.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 3 + [ctypes.c_int]
+    lib.mc_mix_graph_add_saturator.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.c_float,
+        ctypes.c_float,
+        ctypes.c_uint,
+    ]
+    lib.mc_mix_graph_add_reverb.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 5
+    lib.mc_mix_graph_add_delay.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 5
+    lib.mc_mix_graph_add_limiter.argtypes = [ctypes.c_void_p, ctypes.c_int] + [ctypes.c_float] * 3
+    lib.mc_mix_graph_compile.argtypes = [ctypes.c_void_p]
+    lib.mc_mix_graph_latency.argtypes = [ctypes.c_void_p]
+    lib.mc_mix_graph_latency.restype = ctypes.c_longlong
+    lib.mc_mix_graph_node_latency.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.mc_mix_graph_node_latency.restype = ctypes.c_longlong
+    lib.mc_mix_graph_process.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_mix_graph_process_channels.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.c_ulonglong,
+    ]
+    for name in (
+        "mc_mix_graph_set_layout",
+        "mc_mix_graph_set_levels",
+        "mc_mix_graph_add_send",
+        "mc_mix_graph_add_eq",
+        "mc_mix_graph_add_compressor",
+        "mc_mix_graph_add_gate",
+        "mc_mix_graph_add_saturator",
+        "mc_mix_graph_add_reverb",
+        "mc_mix_graph_add_delay",
+        "mc_mix_graph_add_limiter",
+        "mc_mix_graph_compile",
+        "mc_mix_graph_process",
+        "mc_mix_graph_process_channels",
+    ):
+        getattr(lib, name).restype = ctypes.c_int
@@ -79,20 +79,10 @@ class NativeAudioEngine:
         return bool(self._lib.mc_audio_stop())
 
     def _load_library(self) -> None:
-        if not self._dll_path.exists():
+        lib = load_native_library(self._dll_path)
+        if lib is None:
             self._lib = None
             return
-        dll_dirs = [self._dll_path.parent, _winget_mingw_bin_dir()]
-        for directory in dll_dirs:
-            if directory is None:
-                continue
-            if not directory.exists():
-                continue
-            try:
-                os.add_dll_directory(str(directory))
-            except Exception:
-                pass
-        lib = ctypes.WinDLL(str(self._dll_path))
         lib.mc_audio_start.argtypes = [ctypes.c_uint, ctypes.c_uint]
         lib.mc_audio_start.restype = ctypes.c_int
         lib.mc_audio_stop.argtypes = []
@@ -114,6 +104,32 @@ class NativeAudioEngine:
         self._lib = lib
 
 
+_LOADED_LIBRARIES: dict[Path, ctypes.WinDLL] = {}
+
+
+def load_native_library(dll_path: str | Path | None = None) -> ctypes.WinDLL | None:
+    """Load the audio core once per path so feature bridges share one handle."""
+    path = Path(dll_path) if dll_path else default_dll_path()
+    cached = _LOADED_LIBRARIES.get(path)
+    if cached is not None:
+        return cached
+    if not path.exists():
+        return None
+    dll_dirs = [path.parent, _winget_mingw_bin_dir()]
+    for directory in dll_dirs:
+        if directory is None:
+            continue
+        if not directory.exists():
+            continue
+        try:
+            os.add_dll_directory(str(directory))
+        except Exception:
+            pass
+    lib = ctypes.WinDLL(str(path))
+    _LOADED_LIBRARIES[path] = lib
+    return lib
+
+
 def default_dll_path() -> Path:
     return Path(__file__).resolve().parents[3] / "native" / "build" / "music_create_audio_core.dll"
 
@@ -123,12 +139,12 @@ def ensure_native_library(dll_path: str | Path | None = None) -> BuildResult:
     output_path.parent.mkdir(parents=True, exist_ok=True)
     compiler = _resolve_cpp_compiler()
     src_root = Path(__file__).resolve().parents[3] / "native"
-    source = src_root / "audio_core" / "src" / "audio_core.cpp"
+    sources = sorted((src_root / "audio_core" / "src").glob("*.cpp"))
     include = src_root / "audio_core" / "include"
-    header = include / "audio_core.hpp"
+    headers = sorted(include.glob("*.hpp"))
     if output_path.exists():
         out_time = output_path.stat().st_mtime
-        if source.stat().st_mtime <= out_time and header.stat().st_mtime <= out_time:
+        if all(path.stat().st_mtime <= out_time for path in [*sources, *headers]):
             _copy_runtime_dlls_if_needed(output_path, compiler)
             return BuildResult(dll_path=output_path, built=False)
 
@@ -137,7 +153,7 @@ def ensure_native_library(dll_path: str | Path | None = None) -> BuildResult:
         "-std=c++20",
         "-O2",
         "-shared",
-        str(source),
+        *[str(source) for source in sources],
         "-I",
         str(include),
         "-o",
@@ -0,0 +1,144 @@
+"""Native compressed-asset reader bridge (FLAC and WAV via the C++ audio core)."""
+
+from __future__ import annotations
+
+import ctypes
+from dataclasses import dataclass
+from pathlib import Path
+
+from music_create.audio.native_engine import load_native_library
+from music_create.audio.wav_loader import LoadedWaveform
+
+_READ_CHUNK_FRAMES = 65_536
+NATIVE_ONLY_SUFFIXES: frozenset[str] = frozenset({".flac"})
+
+
+@dataclass(slots=True)
+class NativeAudioFileInfo:
+    sample_rate: int
+    channels: int
+    bits_per_sample: int
+    total_frames: int
+
+
+class NativeAudioFileReader:
+    """Seekable frame reader backed by `mc_audio_file_*`; frames are interleaved float32."""
+
+    def __init__(self, path: str | Path, dll_path: str | Path | None = None) -> None:
+        self._handle: int | None = None
+        file_path = Path(path)
+        if not file_path.exists():
+            raise FileNotFoundError(str(file_path))
+        lib = load_native_library(dll_path)
+        if lib is None:
+            raise RuntimeError("native audio core is not available")
+        _declare_reader_api(lib)
+        handle = lib.mc_audio_file_open_w(str(file_path.resolve()))
+        if not handle:
+            raise ValueError(f"unsupported or corrupt audio file: {file_path.name}")
+        self._lib = lib
+        self._handle = handle
+        sample_rate = ctypes.c_uint()
+        channels = ctypes.c_uint()
+        bits = ctypes.c_uint()
+        frames = ctypes.c_ulonglong()
+        lib.mc_audio_file_info(handle, ctypes.byref(sample_rate), ctypes.byref(channels), ctypes.byref(bits), ctypes.byref(frames))
+        self.info = NativeAudioFileInfo(
+            sample_rate=sample_rate.value,
+            channels=channels.value,
+            bits_per_sample=bits.value,
+            total_frames=frames.value,
+        )
+
+    def seek(self, frame: int) -> bool:
+        if self._handle is None:
+            return False
+        return bool(self._lib.mc_audio_file_seek(self._handle, max(int(frame), 0)))
+
+    def read(self, frames: int) -> list[float]:
+        if self._handle is None or frames <= 0:
+            return []
+        buffer = (ctypes.c_float * (frames * self.info.channels))()
+        count = self._lib.mc_audio_file_read_f32(self._handle, buffer, frames)
+        return list(buffer[: count * self.info.channels])
+
+    def read_planar(self, frames: int) -> list[list[float]]:
+        """Read up to `frames` frames as one list per channel, deinterleaved natively."""
+        if self._handle is None or frames <= 0:
+            return []
+        buffer = (ctypes.c_float * (frames * self.info.channels))()
+        count = self._lib.mc_audio_file_read_planar_f32(self._handle, buffer, frames)
+        if count == 0:
+            return []
+        return [buffer[channel * frames : channel * frames + count] for channel in range(self.info.channels)]
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_audio_file_close(self._handle)
+            self._handle = None
+
+    def __enter__(self) -> NativeAudioFileReader:
+        return self
+
+    def __exit__(self, *_: object) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        self.close()
+
+
+def is_native_only_format(path: str | Path) -> bool:
+    return Path(path).suffix.lower() in NATIVE_ONLY_SUFFIXES
+
+
+def load_audio_mono_float32(path: str | Path, dll_path: str | Path | None = None) -> LoadedWaveform:
+    with NativeAudioFileReader(path, dll_path=dll_path) as reader:
+        channels = max(reader.info.channels, 1)
+        samples: list[float] = []
+        while True:
+            chunk = reader.read(_READ_CHUNK_FRAMES)
+            if not chunk:
+                break
+            for index in range(0, len(chunk), channels):
+                total = sum(chunk[index : index + channels])
+                samples.append(max(min(total / channels, 1.0), -1.0))
+        return LoadedWaveform(
+            sample_rate=reader.info.sample_rate,
+            channels=reader.info.channels,
+            frame_count=len(samples),
+            samples=samples,
+        )
+
+
+def load_audio_planar_float32(path: str | Path, dll_path: str | Path | None = None) -> tuple[int, list[list[float]]]:
+    with NativeAudioFileReader(path, dll_path=dll_path) as reader:
+        channels = max(reader.info.channels, 1)
+        planar: list[list[float]] = [[] for _ in range(channels)]
+        while True:
+            chunk = reader.read_planar(_READ_CHUNK_FRAMES)
+            if not chunk:
+                break
+            for channel, samples in zip(planar, chunk):
+                channel.extend(samples)
+        return reader.info.sample_rate, planar
+
+
+def _declare_reader_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_audio_file_open_w.argtypes = [ctypes.c_wchar_p]
+    lib.mc_audio_file_open_w.restype = ctypes.c_void_p
+    lib.mc_audio_file_close.argtypes = [ctypes.c_void_p]
+    lib.mc_audio_file_close.restype = None
+    lib.mc_audio_file_info.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_uint),
+        ctypes.POINTER(ctypes.c_uint),
+        ctypes.POINTER(ctypes.c_uint),
+        ctypes.POINTER(ctypes.c_ulonglong),
+    ]
+    lib.mc_audio_file_info.restype = ctypes.c_int
+    lib.mc_audio_file_seek.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong]
+    lib.mc_audio_file_seek.restype = ctypes.c_int
+    lib.mc_audio_file_read_f32.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_float), ctypes.c_ulonglong]
+    lib.mc_audio_file_read_f32.restype = ctypes.c_ulonglong
+    lib.mc_audio_file_read_planar_f32.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_float), ctypes.c_ulonglong]
+    lib.mc_audio_file_read_planar_f32.restype = ctypes.c_ulonglong
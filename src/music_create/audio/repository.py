@@ -5,6 +5,7 @@ from __future__ import annotations
 from dataclasses import dataclass
 from pathlib import Path
 
+from music_create.audio.native_reader import is_native_only_format, load_audio_mono_float32
 from music_create.audio.wav_loader import LoadedWaveform, load_wav_mono_float32
 
 
@@ -22,7 +23,10 @@ class WaveformRepository:
         self._items: dict[str, WaveformTrackData] = {}
 
     def load_track_wav(self, track_id: str, path: str | Path) -> WaveformTrackData:
-        loaded: LoadedWaveform = load_wav_mono_float32(path)
+        if is_native_only_format(path):
+            loaded: LoadedWaveform = load_audio_mono_float32(path)
+        else:
+            loaded = load_wav_mono_float32(path)
         item = WaveformTrackData(
             track_id=track_id,
             path=Path(path),
@@ -0,0 +1,64 @@
+"""Native oversampled saturator (`mc_saturator_*`)."""
+
+from __future__ import annotations
+
+import ctypes
+import math
+from typing import Sequence
+
+from music_create.audio.native_engine import load_native_library
+
+_FACTORS = (1, 2, 4, 8)
+
+
+def oversampling_factor(value: float) -> int:
+    """Nearest supported oversampling factor (1, 2, 4 or 8) for a parameter value."""
+    if value <= 1.0:
+        return 1
+    exponent = math.floor(math.log2(value) + 0.5)
+    return _FACTORS[min(max(exponent, 0), len(_FACTORS) - 1)]
+
+
+def render_saturator(samples: Sequence[float], params: dict[str, float]) -> list[float] | None:
+    """Process one channel through a fresh native saturator with its latency compensated.
+
+    Returns None when the native core is unavailable.
+    """
+    lib = load_native_library()
+    if lib is None:
+        return None
+    _declare_saturator_api(lib)
+    handle = lib.mc_saturator_create(
+        params.get("drive", 0.0),
+        params.get("mix", 0.0),
+        oversampling_factor(params.get("oversampling", 1.0)),
+    )
+    if not handle:
+        return None
+    try:
+        latency = lib.mc_saturator_latency(handle)
+        count = len(samples) + latency
+        buffer = (ctypes.c_float * count)(*samples)
+        if not lib.mc_saturator_process(handle, buffer, None, count):
+            return None
+        return list(buffer)[latency:]
+    finally:
+        lib.mc_saturator_free(handle)
+
+
+def _declare_saturator_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_saturator_create.argtypes = [ctypes.c_float, ctypes.c_float, ctypes.c_uint]
+    lib.mc_saturator_create.restype = ctypes.c_void_p
+    lib.mc_saturator_free.argtypes = [ctypes.c_void_p]
+    lib.mc_saturator_free.restype = None
+    lib.mc_saturator_latency.argtypes = [ctypes.c_void_p]
+    lib.mc_saturator_latency.restype = ctypes.c_uint
+    lib.mc_saturator_process.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_saturator_process.restype = ctypes.c_int
+    lib.mc_saturator_reset.argtypes = [ctypes.c_void_p]
+    lib.mc_saturator_reset.restype = ctypes.c_int
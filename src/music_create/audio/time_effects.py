@@ -0,0 +1,92 @@
+"""Native FDN reverb and tempo-synced delay (`mc_fdn_reverb_*` / `mc_tempo_delay_*`)."""
+
+from __future__ import annotations
+
+import ctypes
+from typing import Sequence
+
+from music_create.audio.native_engine import load_native_library
+
+
+def render_fdn_reverb(samples: Sequence[float], sample_rate: int, params: dict[str, float]) -> list[float] | None:
+    """Process one channel through a fresh native reverb; None when the native core is unavailable."""
+    lib = _native_library()
+    if lib is None:
+        return None
+    handle = lib.mc_fdn_reverb_create(int(sample_rate))
+    if not handle:
+        return None
+    try:
+        lib.mc_fdn_reverb_set_params(
+            handle,
+            params.get("mix", 0.0),
+            params.get("decay_s", 1.8),
+            params.get("pre_delay_ms", 10.0),
+            params.get("damping", 0.4),
+            params.get("size", 0.6),
+        )
+        return _process(lib.mc_fdn_reverb_process, handle, samples)
+    finally:
+        lib.mc_fdn_reverb_free(handle)
+
+
+def render_tempo_delay(
+    samples: Sequence[float],
+    sample_rate: int,
+    params: dict[str, float],
+    tempo_bpm: float,
+) -> list[float] | None:
+    """Process one channel through a fresh native tempo delay; None when the native core is unavailable."""
+    lib = _native_library()
+    if lib is None:
+        return None
+    handle = lib.mc_tempo_delay_create(int(sample_rate))
+    if not handle:
+        return None
+    try:
+        lib.mc_tempo_delay_set_params(
+            handle,
+            params.get("mix", 0.0),
+            params.get("time_beats", 0.5),
+            float(tempo_bpm),
+            params.get("feedback", 0.35),
+            params.get("damping", 0.2),
+        )
+        return _process(lib.mc_tempo_delay_process, handle, samples)
+    finally:
+        lib.mc_tempo_delay_free(handle)
+
+
+def _process(function: ctypes._CFuncPtr, handle: int, samples: Sequence[float]) -> list[float] | None:
+    count = len(samples)
+    buffer = (ctypes.c_float * count)(*samples)
+    if not function(handle, buffer, buffer, count):
+        return None
+    return list(buffer)
+
+
+def _native_library() -> ctypes.WinDLL | None:
+    lib = load_native_library()
+    if lib is None:
+        return None
+    _declare_time_effects_api(lib)
+    return lib
+
+
+def _declare_time_effects_api(lib: ctypes.WinDLL) -> None:
+    for prefix, param_count in (("mc_fdn_reverb", 5), ("mc_tempo_delay", 5)):
+        getattr(lib, f"{prefix}_create").argtypes = [ctypes.c_uint]
+        getattr(lib, f"{prefix}_create").restype = ctypes.c_void_p
+        getattr(lib, f"{prefix}_free").argtypes = [ctypes.c_void_p]
+        getattr(lib, f"{prefix}_free").restype = None
+        getattr(lib, f"{prefix}_set_params").argtypes = [ctypes.c_void_p] + [ctypes.c_float] * param_count
+        getattr(lib, f"{prefix}_set_params").restype = ctypes.c_int
+        getattr(lib, f"{prefix}_process").argtypes = [
+            ctypes.c_void_p,
+            ctypes.POINTER(ctypes.c_float),
+            ctypes.POINTER(ctypes.c_float),
+            ctypes.c_ulonglong,
+        ]
+        getattr(lib, f"{prefix}_process").restype = ctypes.c_int
+        getattr(lib, f"{prefix}_reset").argtypes = [ctypes.c_void_p]
+        getattr(lib, f"{prefix}_reset").restype = ctypes.c_int
@@ -0,0 +1,91 @@
+"""Tempo matching and pitch shifting of audio buffers through the native `mc_time_stretch_planar` API."""
+
+from __future__ import annotations
+
+import ctypes
+from typing import Literal, Sequence
+
+from music_create.audio.native_engine import load_native_library
+
+StretchMode = Literal["wsola", "phase_vocoder"]
+
+STRETCH_MODES: dict[str, int] = {"wsola": 0, "phase_vocoder": 1}
+MIN_STRETCH = 0.25
+MAX_STRETCH = 4.0
+MAX_SEMITONES = 12.0
+
+
+def stretch_for_tempo(source_bpm: float, project_bpm: float) -> float:
+    """Timeline length over file length for a clip recorded at `source_bpm`."""
+    if source_bpm <= 0.0 or project_bpm <= 0.0:
+        raise ValueError("tempos must be positive")
+    return source_bpm / project_bpm
+
+
+def time_stretch(
+    channels: Sequence[Sequence[float]],
+    sample_rate: int,
+    stretch: float,
+    semitones: float = 0.0,
+    mode: StretchMode = "wsola",
+) -> list[list[float]] | None:
+    """Stretch one or two channels to `round(len * stretch)` frames at offline quality.
+
+    `wsola` keeps transients (drums, speech); `phase_vocoder` is smoother on
+    sustained tonal material. None when the native core is unavailable.
+    """
+    if mode not in STRETCH_MODES:
+        raise ValueError(f"unknown stretch mode '{mode}'")
+    if not 1 <= len(channels) <= 2:
+        raise ValueError("time stretch takes one or two channels")
+    stretch = min(max(float(stretch), MIN_STRETCH), MAX_STRETCH)
+    lib = _native_library()
+    if lib is None:
+        return None
+    frames = len(channels[0])
+    out_frames = round(frames * stretch)
+    inputs = [(ctypes.c_float * frames)(*channel) for channel in channels]
+    outputs = [(ctypes.c_float * out_frames)() for _ in channels]
+    in_pointers = (ctypes.POINTER(ctypes.c_float) * len(inputs))(
+        *(ctypes.cast(buffer, ctypes.POINTER(ctypes.c_float)) for buffer in inputs)
+    )
+    out_pointers = (ctypes.POINTER(ctypes.c_float) * len(outputs))(
+        *(ctypes.cast(buffer, ctypes.POINTER(ctypes.c_float)) for buffer in outputs)
+    )
+    ok = lib.mc_time_stretch_planar(
+        in_pointers,
+        len(channels),
+        frames,
+        int(sample_rate),
+        stretch,
+        float(semitones),
+        STRETCH_MODES[mode],
+        out_pointers,
+        out_frames,
+    )
+    if not ok:
+        return None
+    return [list(buffer) for buffer in outputs]
+
+
+def _native_library() -> ctypes.WinDLL | None:
+    lib = load_native_library()
+    if lib is None:
+        return None
+    _declare_time_stretch_api(lib)
+    return lib
+
+
+def _declare_time_stretch_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_time_stretch_planar.argtypes = [
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.c_uint,
+        ctypes.c_ulonglong,
+        ctypes.c_uint,
+        ctypes.c_double,
+        ctypes.c_float,
+        ctypes.c_int,
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_time_stretch_planar.restype = ctypes.c_int
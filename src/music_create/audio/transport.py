@@ -0,0 +1,355 @@
+"""Cued playback of timeline clips through the native `mc_transport_*` API."""
+
+from __future__ import annotations
+
+import ctypes
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Literal, Sequence
+
+from music_create.audio.mixdown import DEFAULT_BLOCK_SIZE, build_native_graph, declare_mix_graph_api
+from music_create.audio.native_engine import load_native_library
+from music_create.audio.time_stretch import STRETCH_MODES, StretchMode
+from music_create.mixing.mixer_graph import MixerGraph
+
+DEFAULT_PREROLL_MS = 500.0
+DEFAULT_LOOKAHEAD_MS = 250.0
+DEFAULT_CUE_TIMEOUT_MS = 2000
+
+FadeCurve = Literal["linear", "equal_power", "s_curve"]
+
+FADE_CURVES: dict[str, int] = {"linear": 0, "equal_power": 1, "s_curve": 2}
+
+
+@dataclass(slots=True)
+class TransportClip:
+    track_id: str
+    path: Path
+    start_frame: int
+    offset_frame: int = 0
+    length_frames: int = 0  # file frames; 0 plays to the end of the file
+    gain: float = 1.0
+    stretch: float = 1.0  # timeline frames per file frame, see `stretch_for_tempo`
+    semitones: float = 0.0
+    stretch_mode: StretchMode = "wsola"
+    # Fades in timeline frames, applied while playing like the gain.
+    fade_in_frames: int = 0
+    fade_out_frames: int = 0
+    fade_in_curve: FadeCurve = "equal_power"
+    fade_out_curve: FadeCurve = "equal_power"
+
+
+class NativeTransport:
+    """Streams clips from disk through the native mix graph of a `MixerGraph`.
+
+    Call `cue()` whenever the playhead moves: it opens a stream on every clip
+    around the new position, waits until the look-ahead window is resident
+    and pre-rolls the effects, so `play()` followed by `render()` produces
+    the cued audio at once. `position` counts rendered frames and lines up
+    with the clip timeline (the graph latency is absorbed by the cue).
+
+    Between `begin_scrub()` and `end_scrub()`, `render()` plays short grains
+    chasing the positions posted with `scrub_to()` at the drag speed; a UI
+    thread may post while another thread renders.
+
+    Clip edits never touch the files: trim, gain and fades are applied as
+    the clips stream, and clips overlapping on a track crossfade with equal
+    power. Gain and fade edits may come from a UI thread while another
+    thread renders; a trim waits for the next `cue()` and is silent until
+    then. Clips are addressed by their index in `clips`.
+
+    The click follows the tempo map and meter of `set_click_map()` (a
+    constant `tempo_bpm` in 4/4 to begin with) and lands on exact frames;
+    `render_with_click()` returns it separately from the master.
+    """
+
+    def __init__(
+        self,
+        graph: MixerGraph,
+        clips: Sequence[TransportClip],
+        sample_rate: int,
+        tempo_bpm: float = 120.0,
+        block_size: int = DEFAULT_BLOCK_SIZE,
+        preroll_ms: float = DEFAULT_PREROLL_MS,
+        lookahead_ms: float = DEFAULT_LOOKAHEAD_MS,
+        dll_path: str | Path | None = None,
+    ) -> None:
+        self._graph: int | None = None
+        self._handle: int | None = None
+        lib = load_native_library(dll_path)
+        if lib is None:
+            raise RuntimeError("native audio core is not available")
+        declare_mix_graph_api(lib)
+        _declare_transport_api(lib)
+        self._lib = lib
+        self._graph = lib.mc_mix_graph_create(int(sample_rate), int(block_size))
+        if not self._graph:
+            raise ValueError("invalid sample rate or block size")
+        try:
+            track_nodes, layouts = build_native_graph(lib, self._graph, graph, tempo_bpm)
+            self._channels = len(layouts[0].speakers)
+            self._handle = lib.mc_transport_create(self._graph, preroll_ms, lookahead_ms)
+            if not self._handle:
+                raise ValueError("look-ahead does not fit the stream buffers")
+            self.set_click_map([(0.0, tempo_bpm)])
+            for clip in clips:
+                if clip.track_id not in track_nodes:
+                    raise ValueError(f"clip on unknown track '{clip.track_id}'")
+                index = lib.mc_transport_add_clip_w(
+                    self._handle,
+                    str(Path(clip.path).resolve()),
+                    track_nodes[clip.track_id],
+                    max(int(clip.start_frame), 0),
+                    max(int(clip.offset_frame), 0),
+                    max(int(clip.length_frames), 0),
+                    clip.gain,
+                )
+                if index < 0:
+                    raise ValueError(f"unreadable clip or sample rate mismatch: {Path(clip.path).name}")
+                if clip.stretch != 1.0 or clip.semitones != 0.0:
+                    if clip.stretch_mode not in STRETCH_MODES:
+                        raise ValueError(f"unknown stretch mode '{clip.stretch_mode}'")
+                    lib.mc_transport_set_clip_stretch(
+                        self._handle, index, float(clip.stretch), float(clip.semitones), STRETCH_MODES[clip.stretch_mode]
+                    )
+                if clip.fade_in_frames > 0 or clip.fade_out_frames > 0:
+                    self.set_clip_fades(
+                        index, clip.fade_in_frames, clip.fade_out_frames, clip.fade_in_curve, clip.fade_out_curve
+                    )
+        except Exception:
+            self.close()
+            raise
+
+    def set_clip_trim(self, index: int, start_frame: int, offset_frame: int, length_frames: int) -> bool:
+        """Move or trim a clip; heard from the next `cue()`, silent until then. Not while another thread renders."""
+        if self._handle is None:
+            return False
+        return bool(
+            self._lib.mc_transport_set_clip_trim(
+                self._handle, int(index), max(int(start_frame), 0), max(int(offset_frame), 0), max(int(length_frames), 0)
+            )
+        )
+
+    def set_clip_gain(self, index: int, gain: float) -> bool:
+        """Heard from the next `render()`; False when the audio side has not caught up."""
+        return self._handle is not None and bool(self._lib.mc_transport_set_clip_gain(self._handle, int(index), gain))
+
+    def set_clip_fades(
+        self,
+        index: int,
+        fade_in_frames: int,
+        fade_out_frames: int,
+        fade_in_curve: FadeCurve = "equal_power",
+        fade_out_curve: FadeCurve = "equal_power",
+    ) -> bool:
+        """Heard from the next `render()`; False when the audio side has not caught up."""
+        for curve in (fade_in_curve, fade_out_curve):
+            if curve not in FADE_CURVES:
+                raise ValueError(f"unknown fade curve '{curve}'")
+        if self._handle is None:
+            return False
+        return bool(
+            self._lib.mc_transport_set_clip_fades(
+                self._handle,
+                int(index),
+                max(int(fade_in_frames), 0),
+                FADE_CURVES[fade_in_curve],
+                max(int(fade_out_frames), 0),
+                FADE_CURVES[fade_out_curve],
+            )
+        )
+
+    def set_clip_edits(self, index: int, clip: TransportClip, *, trim: bool = False) -> bool:
+        """Give clip `index` the gain and fades of `clip`, e.g. from `TimelineState.transport_clip()`.
+
+        Heard from the next `render()` and safe while another thread renders.
+        With `trim` its placement and trim move too; like `set_clip_trim()`
+        that must not race `render()` and silences playback until `cue()`.
+        """
+        trimmed = not trim or self.set_clip_trim(index, clip.start_frame, clip.offset_frame, clip.length_frames)
+        gained = self.set_clip_gain(index, clip.gain)
+        faded = self.set_clip_fades(
+            index, clip.fade_in_frames, clip.fade_out_frames, clip.fade_in_curve, clip.fade_out_curve
+        )
+        return trimmed and gained and faded
+
+    def set_click_map(
+        self,
+        tempo: Sequence[tuple[float, float]],
+        meters: Sequence[tuple[float, int, int]] = ((0.0, 4, 4),),
+    ) -> bool:
+        """Tempo points `(beat, bpm)` and meters `(beat, numerator, denominator)`, beats in quarter notes.
+
+        Both start at beat 0 and a meter change starts a bar.
+        """
+        tempo_beats = (ctypes.c_double * len(tempo))(*(float(beat) for beat, _ in tempo))
+        tempo_bpm = (ctypes.c_double * len(tempo))(*(float(bpm) for _, bpm in tempo))
+        meter_beats = (ctypes.c_double * len(meters))(*(float(beat) for beat, _, _ in meters))
+        numerators = (ctypes.c_int * len(meters))(*(int(numerator) for _, numerator, _ in meters))
+        denominators = (ctypes.c_int * len(meters))(*(int(denominator) for _, _, denominator in meters))
+        if self._handle is None:
+            return False
+        if not self._lib.mc_transport_set_click_map(
+            self._handle, tempo_beats, tempo_bpm, len(tempo), meter_beats, numerators, denominators, len(meters)
+        ):
+            raise ValueError("tempo and meter maps must start at beat 0 with increasing beats")
+        return True
+
+    def set_click(self, enabled: bool, gain: float = 1.0) -> bool:
+        """Safe from a UI thread while another thread renders."""
+        return self._handle is not None and bool(self._lib.mc_transport_set_click(self._handle, int(enabled), gain))
+
+    def cue(self, position_frame: int, timeout_ms: int = DEFAULT_CUE_TIMEOUT_MS) -> bool:
+        """Stop and move the playhead; False if the disk missed `timeout_ms`."""
+        if self._handle is None:
+            return False
+        return bool(self._lib.mc_transport_cue(self._handle, max(int(position_frame), 0), int(timeout_ms)))
+
+    def play(self) -> bool:
+        return self._handle is not None and bool(self._lib.mc_transport_play(self._handle))
+
+    def stop(self) -> bool:
+        return self._handle is not None and bool(self._lib.mc_transport_stop(self._handle))
+
+    def begin_scrub(self) -> bool:
+        """Stop playback and scrub from `position`."""
+        return self._handle is not None and bool(self._lib.mc_transport_begin_scrub(self._handle))
+
+    def scrub_to(self, position_frame: int) -> bool:
+        """Post a drag position; False when the audio side has not caught up."""
+        if self._handle is None:
+            return False
+        return bool(self._lib.mc_transport_scrub_to(self._handle, max(int(position_frame), 0)))
+
+    def end_scrub(self) -> bool:
+        return self._handle is not None and bool(self._lib.mc_transport_end_scrub(self._handle))
+
+    def render(self, frames: int) -> list[list[float]]:
+        """Next `frames` frames of the master, one list per channel; silence while stopped."""
+        if self._handle is None or frames <= 0:
+            return []
+        outputs = [(ctypes.c_float * frames)() for _ in range(self._channels)]
+        pointers = (ctypes.POINTER(ctypes.c_float) * len(outputs))(
+            *(ctypes.cast(buffer, ctypes.POINTER(ctypes.c_float)) for buffer in outputs)
+        )
+        if not self._lib.mc_transport_render(self._handle, pointers, frames):
+            raise RuntimeError("transport render failed")
+        return [list(buffer) for buffer in outputs]
+
+    def render_with_click(self, frames: int) -> tuple[list[list[float]], list[float]]:
+        """Like `render()`, with the click as its own channel instead of in the master."""
+        if self._handle is None or frames <= 0:
+            return [], []
+        outputs = [(ctypes.c_float * frames)() for _ in range(self._channels)]
+        click = (ctypes.c_float * frames)()
+        pointers = (ctypes.POINTER(ctypes.c_float) * len(outputs))(
+            *(ctypes.cast(buffer, ctypes.POINTER(ctypes.c_float)) for buffer in outputs)
+        )
+        if not self._lib.mc_transport_render_with_click(self._handle, pointers, click, frames):
+            raise RuntimeError("transport render failed")
+        return [list(buffer) for buffer in outputs], list(click)
+
+    @property
+    def position(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_transport_position(self._handle))
+
+    @property
+    def underruns(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_transport_underruns(self._handle))
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_transport_free(self._handle)
+            self._handle = None
+        if self._graph is not None:
+            self._lib.mc_mix_graph_free(self._graph)
+            self._graph = None
+
+    def __enter__(self) -> NativeTransport:
+        return self
+
+    def __exit__(self, *_: object) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        self.close()
+
+
+def _declare_transport_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_transport_create.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float]
+    lib.mc_transport_create.restype = ctypes.c_void_p
+    lib.mc_transport_free.argtypes = [ctypes.c_void_p]
+    lib.mc_transport_free.restype = None
+    lib.mc_transport_add_clip_w.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_wchar_p,
+        ctypes.c_int,
+        ctypes.c_ulonglong,
+        ctypes.c_ulonglong,
+        ctypes.c_ulonglong,
+        ctypes.c_float,
+    ]
+    lib.mc_transport_add_clip_w.restype = ctypes.c_int
+    lib.mc_transport_set_clip_stretch.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_float,
+        ctypes.c_int,
+    ]
+    lib.mc_transport_set_clip_stretch.restype = ctypes.c_int
+    lib.mc_transport_set_clip_trim.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.c_ulonglong,
+        ctypes.c_ulonglong,
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_transport_set_clip_trim.restype = ctypes.c_int
+    lib.mc_transport_set_clip_gain.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_float]
+    lib.mc_transport_set_clip_gain.restype = ctypes.c_int
+    lib.mc_transport_set_clip_fades.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.c_ulonglong,
+        ctypes.c_int,
+        ctypes.c_ulonglong,
+        ctypes.c_int,
+    ]
+    lib.mc_transport_set_clip_fades.restype = ctypes.c_int
+    lib.mc_transport_cue.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong, ctypes.c_uint]
+    lib.mc_transport_cue.restype = ctypes.c_int
+    for name in ("mc_transport_play", "mc_transport_stop", "mc_transport_begin_scrub", "mc_transport_end_scrub"):
+        getattr(lib, name).argtypes = [ctypes.c_void_p]
+        getattr(lib, name).restype = ctypes.c_int
+    lib.mc_transport_scrub_to.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong]
+    lib.mc_transport_scrub_to.restype = ctypes.c_int
+    lib.mc_transport_render.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_transport_render.restype = ctypes.c_int
+    lib.mc_transport_render_with_click.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_float)),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_transport_render_with_click.restype = ctypes.c_int
+    lib.mc_transport_set_click_map.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.c_uint,
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.c_uint,
+    ]
+    lib.mc_transport_set_click_map.restype = ctypes.c_int
+    lib.mc_transport_set_click.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_float]
+    lib.mc_transport_set_click.restype = ctypes.c_int
+    for name in ("mc_transport_position", "mc_transport_underruns"):
+        getattr(lib, name).argtypes = [ctypes.c_void_p]
+        getattr(lib, name).restype = ctypes.c_ulonglong
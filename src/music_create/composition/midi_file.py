@@ -0,0 +1,250 @@
+"""Standard MIDI File import/export backed by the native `mc_smf_*` parser."""
+
+from __future__ import annotations
+
+import ctypes
+import math
+from array import array
+from dataclasses import dataclass, field
+from pathlib import Path
+
+from music_create.audio.native_engine import load_native_library
+from music_create.composition.models import MidiClipDraft, MidiNoteEvent
+from music_create.composition.quantize import TICKS_PER_BAR_4_4, TICKS_PER_BEAT
+
+_DRUM_CHANNEL = 9
+DEFAULT_MICROSECONDS_PER_QUARTER = 500_000
+
+
+@dataclass(slots=True)
+class MidiTempoPoint:
+    tick: int
+    bpm: float
+
+
+@dataclass(slots=True)
+class MidiNoteArrays:
+    """Column-oriented notes as produced by the native parser (ticks at `ticks_per_beat`)."""
+
+    ticks_per_beat: int
+    start_tick: array = field(default_factory=lambda: array("i"))
+    length_tick: array = field(default_factory=lambda: array("i"))
+    pitch: array = field(default_factory=lambda: array("B"))
+    velocity: array = field(default_factory=lambda: array("B"))
+    channel: array = field(default_factory=lambda: array("B"))
+    track: array = field(default_factory=lambda: array("H"))
+    track_names: list[str] = field(default_factory=list)
+    programs: dict[tuple[int, int], int] = field(default_factory=dict)
+    tempo_map: list[MidiTempoPoint] = field(default_factory=list)
+
+    def __len__(self) -> int:
+        return len(self.start_tick)
+
+
+@dataclass(slots=True)
+class MidiImportResult:
+    clips: list[tuple[int, MidiClipDraft]]
+    tempo_map: list[MidiTempoPoint]
+
+    @property
+    def initial_bpm(self) -> float:
+        return self.tempo_map[0].bpm if self.tempo_map else 120.0
+
+
+def read_midi_note_arrays(
+    path: str | Path,
+    ticks_per_beat: int = TICKS_PER_BEAT,
+    dll_path: str | Path | None = None,
+) -> MidiNoteArrays:
+    file_path = Path(path)
+    if not file_path.exists():
+        raise FileNotFoundError(str(file_path))
+    lib = _require_library(dll_path)
+    handle = lib.mc_smf_read_file_w(str(file_path.resolve()), ticks_per_beat)
+    if not handle:
+        raise ValueError(f"unsupported or corrupt MIDI file: {file_path.name}")
+    try:
+        count = int(lib.mc_smf_note_count(handle))
+        result = MidiNoteArrays(ticks_per_beat=int(lib.mc_smf_ticks_per_beat(handle)))
+        result.start_tick = array("i", bytes(4 * count))
+        result.length_tick = array("i", bytes(4 * count))
+        result.pitch = array("B", bytes(count))
+        result.velocity = array("B", bytes(count))
+        result.channel = array("B", bytes(count))
+        result.track = array("H", bytes(2 * count))
+        if count:
+            lib.mc_smf_copy_notes(
+                handle,
+                _array_pointer(result.start_tick, ctypes.c_int),
+                _array_pointer(result.length_tick, ctypes.c_int),
+                _array_pointer(result.pitch, ctypes.c_ubyte),
+                _array_pointer(result.velocity, ctypes.c_ubyte),
+                _array_pointer(result.channel, ctypes.c_ubyte),
+                _array_pointer(result.track, ctypes.c_ushort),
+            )
+
+        track_count = int(lib.mc_smf_track_count(handle))
+        for track in range(track_count):
+            raw_name = lib.mc_smf_track_name(handle, track) or b""
+            result.track_names.append(raw_name.decode("utf-8", errors="replace"))
+            for channel in range(16):
+                program = int(lib.mc_smf_program(handle, track, channel))
+                if program >= 0:
+                    result.programs[(track, channel)] = program
+
+        tempo_count = int(lib.mc_smf_tempo_count(handle))
+        ticks = (ctypes.c_int * tempo_count)()
+        tempos = (ctypes.c_uint * tempo_count)()
+        if tempo_count:
+            lib.mc_smf_copy_tempo_map(handle, ticks, tempos)
+        result.tempo_map = [
+            MidiTempoPoint(tick=int(ticks[index]), bpm=60_000_000.0 / int(tempos[index])) for index in range(tempo_count)
+        ]
+        return result
+    finally:
+        lib.mc_smf_free(handle)
+
+
+def import_midi_file(path: str | Path, dll_path: str | Path | None = None) -> MidiImportResult:
+    """Split a file into one clip per (track, channel); clips are returned with their source track index."""
+    arrays = read_midi_note_arrays(path, TICKS_PER_BEAT, dll_path=dll_path)
+    grouped: dict[tuple[int, int], list[MidiNoteEvent]] = {}
+    for index in range(len(arrays)):
+        track = arrays.track[index]
+        channel = arrays.channel[index]
+        grouped.setdefault((track, channel), []).append(
+            MidiNoteEvent(
+                start_tick=arrays.start_tick[index],
+                length_tick=arrays.length_tick[index],
+                pitch=arrays.pitch[index],
+                velocity=max(arrays.velocity[index], 1),
+                channel=channel,
+            )
+        )
+
+    clips: list[tuple[int, MidiClipDraft]] = []
+    for (track, channel), notes in sorted(grouped.items()):
+        notes.sort(key=lambda note: (note.start_tick, note.pitch))
+        end_tick = max(note.start_tick + note.length_tick for note in notes)
+        name = arrays.track_names[track] if track < len(arrays.track_names) else ""
+        is_drum = channel == _DRUM_CHANNEL
+        clips.append(
+            (
+                track,
+                MidiClipDraft(
+                    name=name or f"Track {track + 1}",
+                    bars=max(1, math.ceil(end_tick / TICKS_PER_BAR_4_4)),
+                    grid="1/16",
+                    notes=notes,
+                    program=None if is_drum else arrays.programs.get((track, channel)),
+                    is_drum=is_drum,
+                    ticks_per_beat=TICKS_PER_BEAT,
+                ),
+            )
+        )
+    return MidiImportResult(clips=clips, tempo_map=arrays.tempo_map)
+
+
+def export_midi_file(
+    path: str | Path,
+    clips: list[MidiClipDraft],
+    bpm: float | list[MidiTempoPoint] = 120.0,
+    dll_path: str | Path | None = None,
+) -> None:
+    """Write clips as a format 1 file, one MTrk per clip after the conductor track."""
+    ticks_per_beat = clips[0].ticks_per_beat if clips else TICKS_PER_BEAT
+    lib = _require_library(dll_path)
+    handle = lib.mc_smf_create(ticks_per_beat)
+    if not handle:
+        raise ValueError(f"unsupported ticks_per_beat: {ticks_per_beat}")
+    try:
+        tempo_map = [MidiTempoPoint(0, float(bpm))] if isinstance(bpm, (int, float)) else bpm
+        for point in tempo_map:
+            microseconds = int(round(60_000_000.0 / point.bpm)) if point.bpm > 0 else DEFAULT_MICROSECONDS_PER_QUARTER
+            lib.mc_smf_add_tempo(handle, max(int(point.tick), 0), microseconds)
+
+        for track, clip in enumerate(clips):
+            if clip.ticks_per_beat != ticks_per_beat:
+                raise ValueError("all exported clips must share ticks_per_beat")
+            channel = _DRUM_CHANNEL if clip.is_drum else (clip.notes[0].channel if clip.notes else 0)
+            program = -1 if clip.is_drum or clip.program is None else int(clip.program)
+            lib.mc_smf_set_track(handle, track, clip.name.encode("utf-8"), channel, program)
+            count = len(clip.notes)
+            if count == 0:
+                continue
+            start = (ctypes.c_int * count)(*(note.start_tick for note in clip.notes))
+            length = (ctypes.c_int * count)(*(note.length_tick for note in clip.notes))
+            pitch = (ctypes.c_ubyte * count)(*(note.pitch for note in clip.notes))
+            velocity = (ctypes.c_ubyte * count)(*(note.velocity for note in clip.notes))
+            channels = (ctypes.c_ubyte * count)(*(note.channel for note in clip.notes))
+            tracks = (ctypes.c_ushort * count)(*([track] * count))
+            if not lib.mc_smf_add_notes(handle, count, start, length, pitch, velocity, channels, tracks):
+                raise RuntimeError("failed to add notes to MIDI file")
+
+        if not lib.mc_smf_write_file_w(handle, str(Path(path).resolve())):
+            raise OSError(f"failed to write MIDI file: {path}")
+    finally:
+        lib.mc_smf_free(handle)
+
+
+def _array_pointer(values: array, ctype: type) -> ctypes._Pointer:
+    address, _ = values.buffer_info()
+    return ctypes.cast(address, ctypes.POINTER(ctype))
+
+
+def _require_library(dll_path: str | Path | None) -> ctypes.WinDLL:
+    lib = load_native_library(dll_path)
+    if lib is None:
+        raise RuntimeError("native audio core is not available")
+    _declare_smf_api(lib)
+    return lib
+
+
+def _declare_smf_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_smf_read_file_w.argtypes = [ctypes.c_wchar_p, ctypes.c_uint]
+    lib.mc_smf_read_file_w.restype = ctypes.c_void_p
+    lib.mc_smf_create.argtypes = [ctypes.c_uint]
+    lib.mc_smf_create.restype = ctypes.c_void_p
+    lib.mc_smf_free.argtypes = [ctypes.c_void_p]
+    lib.mc_smf_free.restype = None
+    lib.mc_smf_ticks_per_beat.argtypes = [ctypes.c_void_p]
+    lib.mc_smf_ticks_per_beat.restype = ctypes.c_uint
+    lib.mc_smf_track_count.argtypes = [ctypes.c_void_p]
+    lib.mc_smf_track_count.restype = ctypes.c_uint
+    lib.mc_smf_track_name.argtypes = [ctypes.c_void_p, ctypes.c_uint]
+    lib.mc_smf_track_name.restype = ctypes.c_char_p
+    lib.mc_smf_program.argtypes = [ctypes.c_void_p, ctypes.c_uint, ctypes.c_uint]
+    lib.mc_smf_program.restype = ctypes.c_int
+    lib.mc_smf_note_count.argtypes = [ctypes.c_void_p]
+    lib.mc_smf_note_count.restype = ctypes.c_ulonglong
+    lib.mc_smf_copy_notes.argtypes = [
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_ubyte),
+        ctypes.POINTER(ctypes.c_ubyte),
+        ctypes.POINTER(ctypes.c_ubyte),
+        ctypes.POINTER(ctypes.c_ushort),
+    ]
+    lib.mc_smf_copy_notes.restype = ctypes.c_int
+    lib.mc_smf_tempo_count.argtypes = [ctypes.c_void_p]
+    lib.mc_smf_tempo_count.restype = ctypes.c_uint
+    lib.mc_smf_copy_tempo_map.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_uint)]
+    lib.mc_smf_copy_tempo_map.restype = ctypes.c_int
+    lib.mc_smf_add_notes.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_ulonglong,
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_ubyte),
+        ctypes.POINTER(ctypes.c_ubyte),
+        ctypes.POINTER(ctypes.c_ubyte),
+        ctypes.POINTER(ctypes.c_ushort),
+    ]
+    lib.mc_smf_add_notes.restype = ctypes.c_int
+    lib.mc_smf_add_tempo.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_uint]
+    lib.mc_smf_add_tempo.restype = ctypes.c_int
+    lib.mc_smf_set_track.argtypes = [ctypes.c_void_p, ctypes.c_uint, ctypes.c_char_p, ctypes.c_int, ctypes.c_int]
+    lib.mc_smf_set_track.restype = ctypes.c_int
+    lib.mc_smf_write_file_w.argtypes = [ctypes.c_void_p, ctypes.c_wchar_p]
+    lib.mc_smf_write_file_w.restype = ctypes.c_int
@@ -0,0 +1,296 @@
+"""Per-clip note store with an interval index, backed by the native `mc_note_store_*` API."""
+
+from __future__ import annotations
+
+import ctypes
+from pathlib import Path
+from typing import Iterable, Protocol
+
+from music_create.audio.native_engine import load_native_library
+from music_create.composition.models import Grid, MidiClipDraft, MidiNoteEvent
+from music_create.composition.quantize import grid_to_step_ticks
+
+_INITIAL_QUERY_CAPACITY = 1024
+
+
+class NoteLike(Protocol):
+    start_tick: int
+    length_tick: int
+    pitch: int
+    velocity: int
+
+
+class NoteStore:
+    """Structure-of-arrays note storage; ids are dense and stable until the note is removed.
+
+    Range queries cost O(log n + k) and return ids ordered by start tick.
+    """
+
+    def __init__(self, dll_path: str | Path | None = None) -> None:
+        self._handle: int | None = None
+        lib = load_native_library(dll_path)
+        if lib is None:
+            raise RuntimeError("native audio core is not available")
+        _declare_note_store_api(lib)
+        self._lib = lib
+        self._handle = lib.mc_note_store_create()
+        self._ids = (ctypes.c_uint * _INITIAL_QUERY_CAPACITY)()
+
+    @classmethod
+    def try_create(cls, dll_path: str | Path | None = None) -> NoteStore | None:
+        try:
+            return cls(dll_path)
+        except (OSError, RuntimeError, AttributeError):
+            return None
+
+    @classmethod
+    def from_clip(cls, clip: MidiClipDraft, dll_path: str | Path | None = None) -> NoteStore:
+        store = cls(dll_path)
+        store.add(clip.notes)
+        return store
+
+    def __len__(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_note_store_size(self._handle))
+
+    def add(self, notes: Iterable[NoteLike]) -> list[int]:
+        items = list(notes)
+        count = len(items)
+        if self._handle is None or count == 0:
+            return []
+        start = (ctypes.c_int * count)(*(int(note.start_tick) for note in items))
+        length = (ctypes.c_int * count)(*(int(note.length_tick) for note in items))
+        pitch = (ctypes.c_ubyte * count)(*(int(note.pitch) for note in items))
+        velocity = (ctypes.c_ubyte * count)(*(int(note.velocity) for note in items))
+        channel = (ctypes.c_ubyte * count)(*(int(getattr(note, "channel", 0)) for note in items))
+        ids = (ctypes.c_uint * count)()
+        if not self._lib.mc_note_store_add(self._handle, count, start, length, pitch, velocity, channel, ids):
+            raise RuntimeError("failed to add notes to native note store")
+        return list(ids)
+
+    def remove(self, ids: Iterable[int]) -> int:
+        values = list(ids)
+        if self._handle is None or not values:
+            return 0
+        return int(self._lib.mc_note_store_remove(self._handle, len(values), (ctypes.c_uint * len(values))(*values)))
+
+    def update(self, note_id: int, note: NoteLike) -> bool:
+        if self._handle is None:
+            return False
+        return bool(
+            self._lib.mc_note_store_update(
+                self._handle,
+                note_id,
+                int(note.start_tick),
+                int(note.length_tick),
+                int(note.pitch),
+                int(note.velocity),
+                int(getattr(note, "channel", 0)),
+            )
+        )
+
+    def get(self, ids: Iterable[int]) -> list[MidiNoteEvent]:
+        values = list(ids)
+        count = len(values)
+        if self._handle is None or count == 0:
+            return []
+        start = (ctypes.c_int * count)()
+        length = (ctypes.c_int * count)()
+        pitch = (ctypes.c_ubyte * count)()
+        velocity = (ctypes.c_ubyte * count)()
+        channel = (ctypes.c_ubyte * count)()
+        if not self._lib.mc_note_store_get(
+            self._handle, count, (ctypes.c_uint * count)(*values), start, length, pitch, velocity, channel
+        ):
+            raise KeyError("unknown note id")
+        return [
+            MidiNoteEvent(start[index], length[index], pitch[index], velocity[index], channel[index])
+            for index in range(count)
+        ]
+
+    def query(self, begin_tick: int, end_tick: int, pitch_low: int = 0, pitch_high: int = 127) -> list[int]:
+        """Ids of notes overlapping [begin_tick, end_tick) within the inclusive pitch range."""
+        return self._collect(
+            lambda buffer, capacity: self._lib.mc_note_store_query(
+                self._handle, begin_tick, end_tick, max(pitch_low, 0), min(pitch_high, 127), buffer, capacity
+            )
+        )
+
+    def query_starting(self, begin_tick: int, end_tick: int) -> list[int]:
+        """Ids of notes whose start tick lies in [begin_tick, end_tick)."""
+        return self._collect(
+            lambda buffer, capacity: self._lib.mc_note_store_query_starting(
+                self._handle, begin_tick, end_tick, buffer, capacity
+            )
+        )
+
+    def sorted_ids(self) -> list[int]:
+        return self._collect(lambda buffer, capacity: self._lib.mc_note_store_sorted_ids(self._handle, buffer, capacity))
+
+    def quantize(
+        self,
+        ids: Iterable[int],
+        grid: Grid,
+        strength: float = 1.0,
+        swing: float = 0.0,
+        quantize_length: bool = True,
+    ) -> NoteEdit:
+        """Snap starts (and lengths) toward `grid`; swing delays every second grid point by swing * step / 2."""
+        step = grid_to_step_ticks(grid)
+        return self._edit(
+            ids,
+            lambda count, values: self._lib.mc_note_store_quantize(
+                self._handle, count, values, step, float(strength), float(swing), int(quantize_length)
+            ),
+        )
+
+    def transpose(self, ids: Iterable[int], semitones: int) -> NoteEdit:
+        return self._edit(ids, lambda count, values: self._lib.mc_note_store_transpose(self._handle, count, values, semitones))
+
+    def scale_velocity(self, ids: Iterable[int], scale: float = 1.0, offset: int = 0) -> NoteEdit:
+        return self._edit(
+            ids,
+            lambda count, values: self._lib.mc_note_store_scale_velocity(self._handle, count, values, float(scale), offset),
+        )
+
+    def humanize(
+        self,
+        ids: Iterable[int],
+        timing_ticks: int = 0,
+        length_ticks: int = 0,
+        velocity_range: int = 0,
+        seed: int = 0,
+    ) -> NoteEdit:
+        """Uniform random offsets; the same seed reproduces the same edit."""
+        return self._edit(
+            ids,
+            lambda count, values: self._lib.mc_note_store_humanize(
+                self._handle, count, values, timing_ticks, length_ticks, velocity_range, seed & 0xFFFFFFFFFFFFFFFF
+            ),
+        )
+
+    def clear(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_note_store_clear(self._handle)
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_note_store_free(self._handle)
+            self._handle = None
+
+    def __enter__(self) -> NoteStore:
+        return self
+
+    def __exit__(self, *_: object) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        self.close()
+
+    def _edit(self, ids: Iterable[int], call) -> NoteEdit:
+        if self._handle is None:
+            raise RuntimeError("note store is closed")
+        values = list(ids)
+        handle = call(len(values), (ctypes.c_uint * len(values))(*values))
+        if not handle:
+            raise RuntimeError("native note edit failed")
+        return NoteEdit(self, handle)
+
+    def _collect(self, call) -> list[int]:
+        if self._handle is None:
+            return []
+        total = int(call(self._ids, len(self._ids)))
+        if total > len(self._ids):
+            self._ids = (ctypes.c_uint * max(total, len(self._ids) * 2))()
+            total = int(call(self._ids, len(self._ids)))
+        return list(self._ids[:total])
+
+
+class NoteEdit:
+    """Before/after snapshot of one batch edit; undo/redo write it back into the store."""
+
+    def __init__(self, store: NoteStore, handle: int) -> None:
+        self._store = store
+        self._lib = store._lib
+        self._handle: int | None = handle
+
+    def __len__(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_note_edit_size(self._handle))
+
+    def undo(self) -> bool:
+        if self._handle is None or self._store._handle is None:
+            return False
+        return bool(self._lib.mc_note_edit_undo(self._store._handle, self._handle))
+
+    def redo(self) -> bool:
+        if self._handle is None or self._store._handle is None:
+            return False
+        return bool(self._lib.mc_note_edit_redo(self._store._handle, self._handle))
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_note_edit_free(self._handle)
+            self._handle = None
+
+    def __del__(self) -> None:
+        self.close()
+
+
+def _declare_note_store_api(lib: ctypes.WinDLL) -> None:
+    ids = ctypes.POINTER(ctypes.c_uint)
+    ints = ctypes.POINTER(ctypes.c_int)
+    bytes_ = ctypes.POINTER(ctypes.c_ubyte)
+    lib.mc_note_store_create.argtypes = []
+    lib.mc_note_store_create.restype = ctypes.c_void_p
+    lib.mc_note_store_free.argtypes = [ctypes.c_void_p]
+    lib.mc_note_store_free.restype = None
+    lib.mc_note_store_clear.argtypes = [ctypes.c_void_p]
+    lib.mc_note_store_clear.restype = None
+    lib.mc_note_store_size.argtypes = [ctypes.c_void_p]
+    lib.mc_note_store_size.restype = ctypes.c_ulonglong
+    lib.mc_note_store_add.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong, ints, ints, bytes_, bytes_, bytes_, ids]
+    lib.mc_note_store_add.restype = ctypes.c_int
+    lib.mc_note_store_remove.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong, ids]
+    lib.mc_note_store_remove.restype = ctypes.c_ulonglong
+    lib.mc_note_store_update.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_uint,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_ubyte,
+        ctypes.c_ubyte,
+        ctypes.c_ubyte,
+    ]
+    lib.mc_note_store_update.restype = ctypes.c_int
+    lib.mc_note_store_get.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong, ids, ints, ints, bytes_, bytes_, bytes_]
+    lib.mc_note_store_get.restype = ctypes.c_int
+    lib.mc_note_store_query.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_longlong,
+        ctypes.c_longlong,
+        ctypes.c_ubyte,
+        ctypes.c_ubyte,
+        ids,
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_note_store_query.restype = ctypes.c_ulonglong
+    lib.mc_note_store_query_starting.argtypes = [ctypes.c_void_p, ctypes.c_longlong, ctypes.c_longlong, ids, ctypes.c_ulonglong]
+    lib.mc_note_store_query_starting.restype = ctypes.c_ulonglong
+    lib.mc_note_store_sorted_ids.argtypes = [ctypes.c_void_p, ids, ctypes.c_ulonglong]
+    lib.mc_note_store_sorted_ids.restype = ctypes.c_ulonglong
+    edit_args = [ctypes.c_void_p, ctypes.c_ulonglong, ids]
+    lib.mc_note_store_quantize.argtypes = [*edit_args, ctypes.c_int, ctypes.c_float, ctypes.c_float, ctypes.c_int]
+    lib.mc_note_store_quantize.restype = ctypes.c_void_p
+    lib.mc_note_store_transpose.argtypes = [*edit_args, ctypes.c_int]
+    lib.mc_note_store_transpose.restype = ctypes.c_void_p
+    lib.mc_note_store_scale_velocity.argtypes = [*edit_args, ctypes.c_float, ctypes.c_int]
+    lib.mc_note_store_scale_velocity.restype = ctypes.c_void_p
+    lib.mc_note_store_humanize.argtypes = [*edit_args, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_ulonglong]
+    lib.mc_note_store_humanize.restype = ctypes.c_void_p
+    lib.mc_note_edit_size.argtypes = [ctypes.c_void_p]
+    lib.mc_note_edit_size.restype = ctypes.c_ulonglong
+    lib.mc_note_edit_undo.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    lib.mc_note_edit_undo.restype = ctypes.c_int
+    lib.mc_note_edit_redo.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    lib.mc_note_edit_redo.restype = ctypes.c_int
+    lib.mc_note_edit_free.argtypes = [ctypes.c_void_p]
+    lib.mc_note_edit_free.restype = None
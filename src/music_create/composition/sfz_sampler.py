@@ -0,0 +1,128 @@
+"""Disk-streaming SFZ sample-player instrument backed by the native `mc_sfz_*` API."""
+
+from __future__ import annotations
+
+import ctypes
+from pathlib import Path
+from typing import Sequence
+
+from music_create.audio.native_engine import load_native_library
+
+STEAL_POLICIES: dict[str, int] = {"none": 0, "oldest": 1, "quietest": 2, "same_note": 3}
+
+
+class SfzInstrument:
+    """Sample-player for an SFZ subset (regions, velocity layers, loops).
+
+    Only sample heads stay in RAM; the remainder streams from disk on a native
+    prefetch thread, so resident memory stays in the tens of megabytes.
+    """
+
+    def __init__(
+        self,
+        path: str | Path,
+        sample_rate: int,
+        max_voices: int = 0,
+        steal_policy: str = "oldest",
+        dll_path: str | Path | None = None,
+    ) -> None:
+        self._handle: int | None = None
+        sfz_path = Path(path)
+        if not sfz_path.exists():
+            raise FileNotFoundError(str(sfz_path))
+        lib = load_native_library(dll_path)
+        if lib is None:
+            raise RuntimeError("native audio core is not available")
+        _declare_sfz_api(lib)
+        handle = lib.mc_sfz_open_w(str(sfz_path.resolve()), int(sample_rate), max(int(max_voices), 0))
+        if not handle:
+            raise ValueError(f"unsupported sfz instrument or missing samples: {sfz_path.name}")
+        self._lib = lib
+        self._handle = handle
+        self.sample_rate = int(sample_rate)
+        self.set_steal_policy(steal_policy)
+
+    @property
+    def region_count(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_sfz_region_count(self._handle))
+
+    @property
+    def resident_bytes(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_sfz_resident_bytes(self._handle))
+
+    @property
+    def underruns(self) -> int:
+        return 0 if self._handle is None else int(self._lib.mc_sfz_underruns(self._handle))
+
+    def set_steal_policy(self, policy: str) -> None:
+        """Choose which voice a note-on takes over when all voices are busy."""
+        if policy not in STEAL_POLICIES:
+            raise ValueError(f"unknown steal policy: {policy}")
+        if self._handle is not None:
+            self._lib.mc_sfz_set_steal_policy(self._handle, STEAL_POLICIES[policy])
+
+    def render_notes(
+        self,
+        start_samples: Sequence[int],
+        length_samples: Sequence[int],
+        keys: Sequence[int],
+        velocities: Sequence[int],
+        frames: int,
+    ) -> list[float]:
+        """Render notes offline; returns `frames` interleaved stereo frames."""
+        if self._handle is None:
+            raise RuntimeError("sfz instrument is closed")
+        count = len(start_samples)
+        out = (ctypes.c_float * (max(frames, 0) * 2))()
+        ok = self._lib.mc_sfz_render_notes(
+            self._handle,
+            count,
+            (ctypes.c_longlong * count)(*start_samples),
+            (ctypes.c_longlong * count)(*length_samples),
+            (ctypes.c_int * count)(*keys),
+            (ctypes.c_int * count)(*velocities),
+            out,
+            max(frames, 0),
+        )
+        if not ok:
+            raise RuntimeError("sfz render failed")
+        return list(out)
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mc_sfz_free(self._handle)
+            self._handle = None
+
+    def __enter__(self) -> SfzInstrument:
+        return self
+
+    def __exit__(self, *_: object) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        self.close()
+
+
+def _declare_sfz_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_sfz_open_w.argtypes = [ctypes.c_wchar_p, ctypes.c_uint, ctypes.c_uint]
+    lib.mc_sfz_open_w.restype = ctypes.c_void_p
+    lib.mc_sfz_free.argtypes = [ctypes.c_void_p]
+    lib.mc_sfz_free.restype = None
+    for name in ("mc_sfz_resident_bytes", "mc_sfz_underruns"):
+        getattr(lib, name).argtypes = [ctypes.c_void_p]
+        getattr(lib, name).restype = ctypes.c_ulonglong
+    lib.mc_sfz_region_count.argtypes = [ctypes.c_void_p]
+    lib.mc_sfz_region_count.restype = ctypes.c_uint
+    lib.mc_sfz_set_steal_policy.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.mc_sfz_set_steal_policy.restype = ctypes.c_int
+    lib.mc_sfz_render_notes.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_ulonglong,
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_sfz_render_notes.restype = ctypes.c_int
@@ -2,14 +2,23 @@
 
 from __future__ import annotations
 
+import ctypes
 import math
 import wave
+from dataclasses import dataclass
 from pathlib import Path
 
+from music_create.audio.native_engine import load_native_library
 from music_create.composition.models import GM_DRUM_NOTES, MidiClipDraft
 from music_create.composition.quantize import TICKS_PER_BEAT
+from music_create.composition.sfz_sampler import SfzInstrument
 
 SAMPLE_RATE = 48_000
+_DETUNED_FAMILIES: frozenset[str] = frozenset({"strings", "ensemble", "synth_pad"})
+# The native path replaces the per-harmonic detune with one unison oscillator at twice the fundamental's detune.
+_UNISON_DETUNE = 0.0032
+_WAVETABLES: dict[tuple[int, str], int] = {}
+_DRUM_CACHES: dict[int, int] = {}
 
 _INSTRUMENT_FAMILY_PRESETS: dict[str, dict[str, object]] = {
     "piano": {"harmonics": (1.0, 0.45, 0.22, 0.1), "attack": 0.002, "decay": 5.0, "sustain": 0.42, "release": 0.09},
@@ -28,7 +37,8 @@ _INSTRUMENT_FAMILY_PRESETS: dict[str, dict[str, object]] = {
 }
 
 
-def render_clip_to_wav(clip: MidiClipDraft, output_path: str | Path) -> Path:
+def render_clip_to_wav(clip: MidiClipDraft, output_path: str | Path, instrument: SfzInstrument | None = None) -> Path:
+    """Render a clip to WAV; with an SFZ `instrument`, melodic clips play its samples in stereo."""
     clip.validate()
     out = Path(output_path)
     out.parent.mkdir(parents=True, exist_ok=True)
@@ -36,8 +46,29 @@ def render_clip_to_wav(clip: MidiClipDraft, output_path: str | Path) -> Path:
     total_ticks = max((note.start_tick + note.length_tick) for note in clip.notes) if clip.notes else TICKS_PER_BEAT
     total_sec = max(_ticks_to_seconds(total_ticks) + 0.1, 0.25)
     total_samples = int(total_sec * SAMPLE_RATE)
+
+    if instrument is not None and not clip.is_drum:
+        # The instrument renders at its own rate, which the file then carries.
+        rate = instrument.sample_rate
+        stereo = instrument.render_notes(
+            [int(_ticks_to_seconds(note.start_tick) * rate) for note in clip.notes],
+            [int(max(_ticks_to_seconds(note.length_tick), 0.04) * rate) for note in clip.notes],
+            [note.pitch for note in clip.notes],
+            [note.velocity for note in clip.notes],
+            int(total_sec * rate),
+        )
+        _normalize(stereo, peak=0.9)
+        _write_wav_int16(out, stereo, channels=2, sample_rate=rate)
+        return out
+
     buffer = [0.0] * total_samples
 
+    rendered_native = _render_drums_native(buffer, clip) if clip.is_drum else _render_tones_native(buffer, clip)
+    if rendered_native:
+        _normalize(buffer, peak=0.9)
+        _write_wav_int16(out, buffer)
+        return out
+
     for note in clip.notes:
         if clip.is_drum:
             _render_drum_hit(buffer, note.pitch, note.start_tick, note.length_tick, note.velocity)
@@ -52,7 +83,7 @@ def render_clip_to_wav(clip: MidiClipDraft, output_path: str | Path) -> Path:
             )
 
     _normalize(buffer, peak=0.9)
-    _write_wav_int16_mono(out, buffer)
+    _write_wav_int16(out, buffer)
     return out
 
 
@@ -61,6 +92,159 @@ def _ticks_to_seconds(ticks: int, bpm: float = 120.0) -> float:
     return beats * (60.0 / bpm)
 
 
+@dataclass(frozen=True, slots=True)
+class _ToneShape:
+    attack_samples: int
+    decay_rate: float
+    sustain: float
+    release_samples: int
+
+
+def _tone_shape(family: str) -> _ToneShape:
+    preset = _INSTRUMENT_FAMILY_PRESETS[family]
+    return _ToneShape(
+        attack_samples=max(int(max(float(preset["attack"]), 0.001) * SAMPLE_RATE), 1),
+        decay_rate=max(float(preset["decay"]), 0.2),
+        sustain=min(max(float(preset["sustain"]), 0.05), 1.0),
+        release_samples=max(int(max(float(preset["release"]), 0.03) * SAMPLE_RATE), 1),
+    )
+
+
+def _render_tones_native(buffer: list[float], clip: MidiClipDraft, lane_width: int = 0) -> bool:
+    """Mix all clip notes through the native band-limited wavetable; False when the core is unavailable.
+
+    ``lane_width`` selects how many voices render per SIMD step (0 = widest the CPU supports, 1 = scalar).
+    """
+    lib = load_native_library()
+    if lib is None:
+        return False
+    family = _program_family(clip.program)
+    table = _wavetable_for(lib, family)
+    if table is None:
+        return False
+    shape = _tone_shape(family)
+    count = len(clip.notes)
+    starts = (ctypes.c_longlong * count)()
+    lengths = (ctypes.c_longlong * count)()
+    frequencies = (ctypes.c_float * count)()
+    amplitudes = (ctypes.c_float * count)()
+    for index, note in enumerate(clip.notes):
+        starts[index] = int(_ticks_to_seconds(note.start_tick) * SAMPLE_RATE)
+        lengths[index] = int(max(_ticks_to_seconds(note.length_tick), 0.04) * SAMPLE_RATE)
+        frequencies[index] = 440.0 * (2 ** ((note.pitch - 69) / 12.0))
+        amplitudes[index] = (note.velocity / 127.0) * 0.35 * 0.58
+    rendered = (ctypes.c_float * len(buffer))()
+    ok = lib.mc_wavetable_render_notes(
+        table,
+        count,
+        starts,
+        lengths,
+        frequencies,
+        amplitudes,
+        shape.attack_samples,
+        shape.decay_rate,
+        shape.sustain,
+        shape.release_samples,
+        _UNISON_DETUNE if family in _DETUNED_FAMILIES else 0.0,
+        rendered,
+        len(buffer),
+        lane_width,
+    )
+    if not ok:
+        return False
+    buffer[:] = rendered
+    return True
+
+
+def _wavetable_for(lib: ctypes.WinDLL, family: str) -> int | None:
+    key = (id(lib), family)
+    cached = _WAVETABLES.get(key)
+    if cached is not None:
+        return cached
+    _declare_wavetable_api(lib)
+    harmonics = [float(level) for level in _INSTRUMENT_FAMILY_PRESETS[family]["harmonics"]]  # type: ignore[union-attr]
+    handle = lib.mc_wavetable_create((ctypes.c_float * len(harmonics))(*harmonics), len(harmonics), SAMPLE_RATE)
+    if not handle:
+        return None
+    _WAVETABLES[key] = handle
+    return handle
+
+
+def _declare_wavetable_api(lib: ctypes.WinDLL) -> None:
+    lib.mc_wavetable_create.argtypes = [ctypes.POINTER(ctypes.c_float), ctypes.c_uint, ctypes.c_uint]
+    lib.mc_wavetable_create.restype = ctypes.c_void_p
+    lib.mc_wavetable_free.argtypes = [ctypes.c_void_p]
+    lib.mc_wavetable_free.restype = None
+    lib.mc_wavetable_render_notes.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_ulonglong,
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_longlong,
+        ctypes.c_float,
+        ctypes.c_float,
+        ctypes.c_longlong,
+        ctypes.c_float,
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+        ctypes.c_int,
+    ]
+    lib.mc_wavetable_render_notes.restype = ctypes.c_int
+
+
+def _render_drums_native(buffer: list[float], clip: MidiClipDraft) -> bool:
+    """Mix drum hits from the native one-shot cache; False when the core is unavailable."""
+    lib = load_native_library()
+    if lib is None:
+        return False
+    cache = _drum_cache_for(lib)
+    if cache is None:
+        return False
+    count = len(clip.notes)
+    starts = (ctypes.c_longlong * count)()
+    lengths = (ctypes.c_longlong * count)()
+    pitches = (ctypes.c_int * count)()
+    amplitudes = (ctypes.c_float * count)()
+    for index, note in enumerate(clip.notes):
+        starts[index] = int(_ticks_to_seconds(note.start_tick) * SAMPLE_RATE)
+        lengths[index] = int(max(_ticks_to_seconds(note.length_tick), 0.04) * SAMPLE_RATE)
+        pitches[index] = note.pitch
+        amplitudes[index] = (note.velocity / 127.0) * 0.45
+    rendered = (ctypes.c_float * len(buffer))()
+    if not lib.mc_drum_cache_render_hits(cache, count, starts, lengths, pitches, amplitudes, rendered, len(buffer)):
+        return False
+    buffer[:] = rendered
+    return True
+
+
+def _drum_cache_for(lib: ctypes.WinDLL) -> int | None:
+    cached = _DRUM_CACHES.get(id(lib))
+    if cached is not None:
+        return cached
+    lib.mc_drum_cache_create.argtypes = [ctypes.c_uint]
+    lib.mc_drum_cache_create.restype = ctypes.c_void_p
+    lib.mc_drum_cache_free.argtypes = [ctypes.c_void_p]
+    lib.mc_drum_cache_free.restype = None
+    lib.mc_drum_cache_render_hits.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_ulonglong,
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_longlong),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.POINTER(ctypes.c_float),
+        ctypes.c_ulonglong,
+    ]
+    lib.mc_drum_cache_render_hits.restype = ctypes.c_int
+    handle = lib.mc_drum_cache_create(SAMPLE_RATE)
+    if not handle:
+        return None
+    _DRUM_CACHES[id(lib)] = handle
+    return handle
+
+
 def _render_tone(
     buffer: list[float],
     pitch: int,
@@ -75,14 +259,8 @@ def _render_tone(
     freq = 440.0 * (2 ** ((pitch - 69) / 12.0))
     amp = (velocity / 127.0) * 0.35
     family = _program_family(program)
-    preset = _INSTRUMENT_FAMILY_PRESETS[family]
-    harmonics = preset["harmonics"]  # type: ignore[assignment]
-    attack = max(float(preset["attack"]), 0.001)
-    decay = max(float(preset["decay"]), 0.2)
-    sustain = min(max(float(preset["sustain"]), 0.05), 1.0)
-    release_sec = max(float(preset["release"]), 0.03)
-    release_samples = max(int(release_sec * SAMPLE_RATE), 1)
-    attack_samples = max(int(attack * SAMPLE_RATE), 1)
+    harmonics = _INSTRUMENT_FAMILY_PRESETS[family]["harmonics"]  # type: ignore[assignment]
+    shape = _tone_shape(family)
 
     for i in range(length_samples):
         idx = start_idx + i
@@ -92,14 +270,14 @@ def _render_tone(
         env = _adsr_envelope(
             i=i,
             total=length_samples,
-            attack_samples=attack_samples,
-            decay_rate=decay,
-            sustain_level=sustain,
-            release_samples=release_samples,
+            attack_samples=shape.attack_samples,
+            decay_rate=shape.decay_rate,
+            sustain_level=shape.sustain,
+            release_samples=shape.release_samples,
         )
         sample = 0.0
         for harmonic_index, harmonic_level in enumerate(harmonics, start=1):
-            detune = 1.0 + (0.0016 * harmonic_index if family in {"strings", "ensemble", "synth_pad"} else 0.0)
+            detune = 1.0 + (0.0016 * harmonic_index if family in _DETUNED_FAMILIES else 0.0)
             sample += math.sin(2.0 * math.pi * freq * harmonic_index * detune * t) * float(harmonic_level)
         sample *= amp * env * 0.58
         buffer[idx] += sample
@@ -188,11 +366,11 @@ def _normalize(buffer: list[float], peak: float = 0.9) -> None:
         buffer[i] = value * gain
 
 
-def _write_wav_int16_mono(path: Path, buffer: list[float]) -> None:
+def _write_wav_int16(path: Path, buffer: list[float], channels: int = 1, sample_rate: int = SAMPLE_RATE) -> None:
     with wave.open(str(path), "wb") as wav:
-        wav.setnchannels(1)
+        wav.setnchannels(channels)
         wav.setsampwidth(2)
-        wav.setframerate(SAMPLE_RATE)
+        wav.setframerate(sample_rate)
         frames = bytearray()
         for sample in buffer:
             clipped = min(max(sample, -1.0), 1.0)
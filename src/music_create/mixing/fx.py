@@ -60,6 +60,39 @@ EFFECT_SPECS: dict[BuiltinEffectType, EffectSpec] = {
         parameters=(
             ParameterSpec("drive", 0.0, 0.0, 1.0),
             ParameterSpec("mix", 0.0, 0.0, 1.0),
+            # Native rate multiplier for the shaper (1, 2, 4 or 8) against aliasing.
+            ParameterSpec("oversampling", 2.0, 1.0, 8.0),
+        ),
+    ),
+    # Time-based effects default to a dry mix so existing chains stay inactive;
+    # the shared send buses (mixer_graph.SEND_EFFECT_BUSES) run them fully wet.
+    BuiltinEffectType.REVERB: EffectSpec(
+        effect_type=BuiltinEffectType.REVERB,
+        parameters=(
+            ParameterSpec("mix", 0.0, 0.0, 1.0),
+            ParameterSpec("decay_s", 1.8, 0.2, 12.0),
+            ParameterSpec("pre_delay_ms", 10.0, 0.0, 200.0),
+            ParameterSpec("damping", 0.4, 0.0, 1.0),
+            ParameterSpec("size", 0.6, 0.1, 1.0),
+        ),
+    ),
+    BuiltinEffectType.DELAY: EffectSpec(
+        effect_type=BuiltinEffectType.DELAY,
+        parameters=(
+            ParameterSpec("mix", 0.0, 0.0, 1.0),
+            ParameterSpec("time_beats", 0.5, 0.0625, 4.0),
+            ParameterSpec("feedback", 0.35, 0.0, 0.95),
+            ParameterSpec("damping", 0.2, 0.0, 1.0),
+        ),
+    ),
+    # Like the other effects a track/bus limiter engages once moved off its defaults;
+    # the native mixdown always limits the master bus.
+    BuiltinEffectType.LIMITER: EffectSpec(
+        effect_type=BuiltinEffectType.LIMITER,
+        parameters=(
+            ParameterSpec("ceiling_db", -1.0, -24.0, 0.0),
+            ParameterSpec("lookahead_ms", 5.0, 0.5, 20.0),
+            ParameterSpec("release_ms", 80.0, 5.0, 1000.0),
         ),
     ),
 }
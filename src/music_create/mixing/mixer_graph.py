@@ -5,7 +5,17 @@ from __future__ import annotations
 from dataclasses import dataclass, field
 
 from music_create.mixing.fx import default_fx_chain
-from music_create.mixing.models import BuiltinFXChainState
+from music_create.mixing.models import BuiltinEffectType, BuiltinFXChainState, ChannelLayout
+
+MASTER_BUS_ID = "master"
+REVERB_BUS_ID = "reverb"
+DELAY_BUS_ID = "delay"
+# Shared time-based effects, one bus each: tracks feed them through sends and
+# the bus returns the effect fully wet.
+SEND_EFFECT_BUSES: dict[str, BuiltinEffectType] = {
+    REVERB_BUS_ID: BuiltinEffectType.REVERB,
+    DELAY_BUS_ID: BuiltinEffectType.DELAY,
+}
 
 
 @dataclass(slots=True)
@@ -23,11 +33,15 @@ class MixerTrackState:
     fader_db: float = 0.0
     pan: float = 0.0
     sends: list[SendState] = field(default_factory=list)
+    # Keying source (track or bus id) per dynamics effect, e.g. {COMPRESSOR: "kick"}.
+    sidechains: dict[BuiltinEffectType, str] = field(default_factory=dict)
+    channel_layout: ChannelLayout = ChannelLayout.STEREO
 
 
 @dataclass(slots=True)
 class MixerGraph:
     tracks: dict[str, MixerTrackState] = field(default_factory=dict)
+    buses: dict[str, MixerTrackState] = field(default_factory=dict)
 
     def ensure_track(self, track_id: str) -> MixerTrackState:
         existing = self.tracks.get(track_id)
@@ -36,3 +50,21 @@ class MixerGraph:
         track = MixerTrackState(track_id=track_id)
         self.tracks[track_id] = track
         return track
+
+    def ensure_bus(self, bus_id: str) -> MixerTrackState:
+        existing = self.buses.get(bus_id)
+        if existing:
+            return existing
+        bus = MixerTrackState(track_id=bus_id)
+        self.buses[bus_id] = bus
+        return bus
+
+    def ensure_send_effect_bus(self, bus_id: str) -> MixerTrackState:
+        """Bus `bus_id` of `SEND_EFFECT_BUSES`, created with its effect fully wet."""
+        effect_type = SEND_EFFECT_BUSES[bus_id]
+        existing = self.buses.get(bus_id)
+        if existing:
+            return existing
+        bus = self.ensure_bus(bus_id)
+        bus.fx_chain.effects[effect_type].parameters["mix"] = 1.0
+        return bus
@@ -5,15 +5,44 @@ from __future__ import annotations
 from dataclasses import dataclass, field
 from datetime import UTC, datetime
 from enum import Enum
-from typing import Literal
+from typing import TYPE_CHECKING, Literal
 from uuid import uuid4
 
+if TYPE_CHECKING:
+    from music_create.mixing.mixer_graph import SendState
+
 
 class BuiltinEffectType(str, Enum):
     EQ = "eq"
     COMPRESSOR = "compressor"
     GATE = "gate"
     SATURATOR = "saturator"
+    REVERB = "reverb"
+    DELAY = "delay"
+    LIMITER = "limiter"
+
+
+class ChannelLayout(str, Enum):
+    """Speaker layout of a mixer track or bus; channels in SMPTE order."""
+
+    MONO = "mono"
+    STEREO = "stereo"
+    LCR = "lcr"
+    SURROUND_5_1 = "5.1"
+    SURROUND_7_1 = "7.1"
+
+    @property
+    def speakers(self) -> tuple[str, ...]:
+        return CHANNEL_LAYOUT_SPEAKERS[self]
+
+
+CHANNEL_LAYOUT_SPEAKERS: dict[ChannelLayout, tuple[str, ...]] = {
+    ChannelLayout.MONO: ("C",),
+    ChannelLayout.STEREO: ("L", "R"),
+    ChannelLayout.LCR: ("L", "R", "C"),
+    ChannelLayout.SURROUND_5_1: ("L", "R", "C", "LFE", "Ls", "Rs"),
+    ChannelLayout.SURROUND_7_1: ("L", "R", "C", "LFE", "Ls", "Rs", "Lrs", "Rrs"),
+}
 
 
 class AnalysisMode(str, Enum):
@@ -88,6 +117,8 @@ class Suggestion:
     score: float
     reason: str
     param_updates: dict[BuiltinEffectType, dict[str, float]]
+    # Send level in dB per shared effect bus (mixer_graph.SEND_EFFECT_BUSES).
+    send_levels: dict[str, float] = field(default_factory=dict)
 
 
 @dataclass(slots=True)
@@ -99,6 +130,8 @@ class SuggestionCommand:
     before_chain: BuiltinFXChainState
     after_chain: BuiltinFXChainState
     applied: bool = field(default=False)
+    before_sends: list[SendState] = field(default_factory=list)
+    after_sends: list[SendState] = field(default_factory=list)
 
     @staticmethod
     def new(
@@ -106,6 +139,8 @@ class SuggestionCommand:
         suggestion_id: str,
         before_chain: BuiltinFXChainState,
         after_chain: BuiltinFXChainState,
+        before_sends: list[SendState] | None = None,
+        after_sends: list[SendState] | None = None,
     ) -> SuggestionCommand:
         return SuggestionCommand(
             command_id=str(uuid4()),
@@ -115,4 +150,6 @@ class SuggestionCommand:
             before_chain=before_chain,
             after_chain=after_chain,
             applied=False,
+            before_sends=before_sends or [],
+            after_sends=after_sends or [],
         )
@@ -2,6 +2,7 @@
 
 from __future__ import annotations
 
+import math
 import os
 from concurrent.futures import Future
 from typing import Callable
@@ -29,6 +30,9 @@ from music_create.mixing.suggestion_engine import (
 
 TrackSignalProvider = Callable[[str], list[float]]
 
+_SEND_LEVEL_MIN_DB = -60.0
+_SEND_LEVEL_MAX_DB = 6.0
+
 
 class MixingService:
     def __init__(
@@ -60,6 +64,8 @@ class MixingService:
         self._commands: dict[str, SuggestionCommand] = {}
         self._command_order: list[str] = []
         self._preview_cache: dict[str, BuiltinFXChainState] = {}
+        self._preview_send_cache: dict[str, list[SendState]] = {}
+        self._preview_buses: set[str] = set()  # send buses that only a preview has asked for so far
 
     def analyze(self, track_ids: list[str], mode: AnalysisMode = AnalysisMode.QUICK) -> str:
         normalized_mode = AnalysisMode(mode)
@@ -128,15 +134,23 @@ class MixingService:
         if baseline is None:
             baseline = track.fx_chain.clone()
             self._preview_cache[track_id] = baseline
+            self._preview_send_cache[track_id] = _clone_sends(track.sends)
         updated = _apply_param_updates(baseline.clone(), suggestion.param_updates, dry_wet)
         track.fx_chain = updated
+        self._preview_buses.update(bus_id for bus_id in suggestion.send_levels if bus_id not in self._mixer_graph.buses)
+        track.sends = _apply_send_levels(
+            self._mixer_graph, _clone_sends(self._preview_send_cache[track_id]), suggestion.send_levels, dry_wet
+        )
 
     def cancel_preview(self, track_id: str) -> None:
         baseline = self._preview_cache.pop(track_id, None)
+        baseline_sends = self._preview_send_cache.pop(track_id, [])
         if baseline is None:
             return
         track = self._mixer_graph.ensure_track(track_id)
         track.fx_chain = baseline
+        track.sends = baseline_sends
+        self._drop_unused_preview_buses()
 
     def apply(self, track_id: str, suggestion_id: str) -> str:
         self._require_builtin_only()
@@ -147,12 +161,17 @@ class MixingService:
         before = track.fx_chain.clone()
         after = _apply_param_updates(before.clone(), suggestion.param_updates, 1.0)
         track.fx_chain = after
+        before_sends = _clone_sends(track.sends)
+        track.sends = _apply_send_levels(self._mixer_graph, _clone_sends(before_sends), suggestion.send_levels, 1.0)
+        self._preview_buses.difference_update(suggestion.send_levels)
 
         command = SuggestionCommand.new(
             track_id=track_id,
             suggestion_id=suggestion_id,
             before_chain=before,
             after_chain=after.clone(),
+            before_sends=before_sends,
+            after_sends=_clone_sends(track.sends),
         )
         command.applied = True
         self._commands[command.command_id] = command
@@ -166,6 +185,7 @@ class MixingService:
         track = self._mixer_graph.ensure_track(command.track_id)
         self.cancel_preview(command.track_id)
         track.fx_chain = command.before_chain.clone()
+        track.sends = _clone_sends(command.before_sends)
         command.applied = False
 
     def get_command_history(self, track_id: str | None = None) -> list[SuggestionCommand]:
@@ -196,6 +216,13 @@ class MixingService:
     def get_last_suggestion_fallback_reason(self) -> str | None:
         return self._last_suggestion_fallback_reason
 
+    def _drop_unused_preview_buses(self) -> None:
+        # A bus another track still previews through stays until that preview ends.
+        used = {send.target_bus_id for track in self._mixer_graph.tracks.values() for send in track.sends}
+        for bus_id in self._preview_buses - used:
+            self._mixer_graph.buses.pop(bus_id, None)
+        self._preview_buses &= used
+
     def _require_builtin_only(self) -> None:
         if not self._capability_registry.builtin_only:
             raise RuntimeError("Current configuration allows external FX; builtin-only guard expected")
@@ -253,6 +280,37 @@ def _apply_param_updates(
     return chain
 
 
+def _apply_send_levels(
+    graph: MixerGraph,
+    sends: list[SendState],
+    levels: dict[str, float],
+    dry_wet: float,
+) -> list[SendState]:
+    # Blends each send's gain toward its target; a missing send starts silent.
+    normalized_mix = min(max(dry_wet, 0.0), 1.0)
+    for bus_id, target_db in levels.items():
+        graph.ensure_send_effect_bus(bus_id)
+        send = next((item for item in sends if item.target_bus_id == bus_id), None)
+        current_gain = 10.0 ** (send.level_db / 20.0) if send else 0.0
+        target_gain = 10.0 ** (target_db / 20.0)
+        blended_gain = current_gain + (target_gain - current_gain) * normalized_mix
+        if blended_gain <= 0.0:
+            continue
+        level_db = min(max(20.0 * math.log10(blended_gain), _SEND_LEVEL_MIN_DB), _SEND_LEVEL_MAX_DB)
+        if send is None:
+            sends.append(SendState(target_bus_id=bus_id, level_db=level_db))
+        else:
+            send.level_db = level_db
+    return sends
+
+
+def _clone_sends(sends: list[SendState]) -> list[SendState]:
+    return [
+        SendState(target_bus_id=send.target_bus_id, level_db=send.level_db, pre_fader=send.pre_fader)
+        for send in sends
+    ]
+
+
 def _clone_track_state(track: MixerTrackState) -> MixerTrackState:
     return MixerTrackState(
         track_id=track.track_id,
@@ -260,14 +318,9 @@ def _clone_track_state(track: MixerTrackState) -> MixerTrackState:
         fx_chain=track.fx_chain.clone(),
         fader_db=track.fader_db,
         pan=track.pan,
-        sends=[
-            SendState(
-                target_bus_id=send.target_bus_id,
-                level_db=send.level_db,
-                pre_fader=send.pre_fader,
-            )
-            for send in track.sends
-        ],
+        sends=_clone_sends(track.sends),
+        sidechains=dict(track.sidechains),
+        channel_layout=track.channel_layout,
     )
 
 
@@ -10,6 +10,7 @@ from urllib.error import HTTPError, URLError
 from urllib.request import Request, urlopen
 from uuid import uuid4
 
+from music_create.mixing.mixer_graph import SEND_EFFECT_BUSES
 from music_create.mixing.models import BuiltinEffectType, MixProfile, Suggestion, TrackFeatures
 from music_create.mixing.suggestions import suggest_from_features
 
@@ -119,7 +120,8 @@ def _parse_llm_response(track_id: str, profile: MixProfile, payload: dict[str, o
         if not isinstance(raw, dict):
             continue
         param_updates = _parse_param_updates(raw.get("param_updates"))
-        if not param_updates:
+        send_levels = _parse_send_levels(raw.get("send_levels"))
+        if not param_updates and not send_levels:
             continue
         variant = str(raw.get("variant") or "llm")
         reason = str(raw.get("reason") or "llm-generated")
@@ -137,6 +139,7 @@ def _parse_llm_response(track_id: str, profile: MixProfile, payload: dict[str, o
                 score=score,
                 reason=reason,
                 param_updates=param_updates,
+                send_levels=send_levels,
             )
         )
 
@@ -168,6 +171,16 @@ def _parse_param_updates(raw: object) -> dict[BuiltinEffectType, dict[str, float
     return updates
 
 
+def _parse_send_levels(raw: object) -> dict[str, float]:
+    if not isinstance(raw, dict):
+        return {}
+    return {
+        bus_id: float(level_db)
+        for bus_id, level_db in raw.items()
+        if bus_id in SEND_EFFECT_BUSES and isinstance(level_db, (int, float))
+    }
+
+
 def _feature_payload(features: TrackFeatures) -> dict[str, float]:
     return {
         "lufs": features.lufs,
@@ -5,6 +5,7 @@ from __future__ import annotations
 from dataclasses import dataclass
 from uuid import uuid4
 
+from music_create.mixing.mixer_graph import DELAY_BUS_ID, REVERB_BUS_ID
 from music_create.mixing.models import BuiltinEffectType, MixProfile, Suggestion, TrackFeatures
 
 
@@ -27,6 +28,7 @@ def suggest_from_features(track_id: str, profile: MixProfile, features: TrackFea
                     f"transient={features.transient_density:.3f}, lra={features.loudness_range_db:.1f}"
                 ),
                 param_updates=candidate.param_updates,
+                send_levels=candidate.send_levels,
             )
         )
     return suggestions
@@ -37,6 +39,7 @@ class _Candidate:
     variant: str
     score: float
     param_updates: dict[BuiltinEffectType, dict[str, float]]
+    send_levels: dict[str, float]
 
 
 def _infer_role(features: TrackFeatures) -> str:
@@ -68,6 +71,14 @@ def _build_variants(profile: MixProfile, role: str, features: TrackFeatures) ->
     if role == "drums":
         base_sat += 0.08
 
+    # Send levels into the shared reverb and delay buses.
+    base_reverb_db = {"clean": -18.0, "punch": -22.0, "warm": -16.0}[profile]
+    if role in {"bass", "drums"}:
+        base_reverb_db -= 6.0
+    wide_sends = {REVERB_BUS_ID: base_reverb_db + 3.0}
+    if role == "lead":
+        wide_sends[DELAY_BUS_ID] = -17.0
+
     transient_push = min(max((features.transient_density - 0.08) * 1.8, 0.0), 0.18)
     lra_push = min(max((features.loudness_range_db - 7.0) * 0.012, 0.0), 0.1)
 
@@ -81,6 +92,7 @@ def _build_variants(profile: MixProfile, role: str, features: TrackFeatures) ->
                 BuiltinEffectType.GATE: {"threshold_db": gate_threshold},
                 BuiltinEffectType.SATURATOR: {"mix": base_sat},
             },
+            send_levels={REVERB_BUS_ID: base_reverb_db},
         ),
         _Candidate(
             variant="tight",
@@ -91,6 +103,7 @@ def _build_variants(profile: MixProfile, role: str, features: TrackFeatures) ->
                 BuiltinEffectType.GATE: {"threshold_db": gate_threshold - 3.0},
                 BuiltinEffectType.SATURATOR: {"mix": min(base_sat + 0.08, 0.9)},
             },
+            send_levels={REVERB_BUS_ID: base_reverb_db - 6.0},
         ),
         _Candidate(
             variant="wide",
@@ -101,5 +114,6 @@ def _build_variants(profile: MixProfile, role: str, features: TrackFeatures) ->
                 BuiltinEffectType.GATE: {"threshold_db": gate_threshold + 4.0},
                 BuiltinEffectType.SATURATOR: {"mix": max(base_sat - 0.06, 0.02)},
             },
+            send_levels=wide_sends,
         ),
     ]
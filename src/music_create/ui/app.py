@@ -2103,7 +2103,7 @@ class IntegratedWindow(QMainWindow):
         if track_id not in self._timeline.tracks:
             self._show_error(f"トラックID '{track_id}' はタイムラインに存在しません。")
             return
-        file_path, _ = QFileDialog.getOpenFileName(self, "WAVファイルを選択", "", "WAV Files (*.wav)")
+        file_path, _ = QFileDialog.getOpenFileName(self, "WAVファイルを選択", "", "Audio Files (*.wav *.flac)")
         if not file_path:
             return
         self._stop_playback_sync()
@@ -2200,11 +2200,12 @@ class IntegratedWindow(QMainWindow):
 
     def _resolve_playback_wav(self, track_id: str, original_path: Path) -> tuple[Path, bool]:
         track_state = self._mixing.get_track_state(track_id)
-        if not is_track_processing_active(track_state):
+        buses = self._mixing.get_mixer_graph().buses
+        if not is_track_processing_active(track_state, buses):
             return original_path, False
 
         rendered_path = self._preview_render_path(track_id)
-        render_track_preview_wav(original_path, rendered_path, track_state)
+        render_track_preview_wav(original_path, rendered_path, track_state, tempo_bpm=self._tempo_bpm, buses=buses)
         return rendered_path, True
 
     def _preview_render_path(self, track_id: str) -> Path:
@@ -2703,6 +2704,10 @@ class IntegratedWindow(QMainWindow):
             lines.append(f"  - {effect_type.value}")
             for key, value in params.items():
                 lines.append(f"      {key}: {value:.4f}")
+        if suggestion.send_levels:
+            lines.append("センド:")
+            for bus_id, level_db in suggestion.send_levels.items():
+                lines.append(f"  - {bus_id}: {level_db:.1f} dB")
         self.suggestion_detail.setPlainText("\n".join(lines))
 
     def _selected_suggestion_id(self) -> str | None:
@@ -5,6 +5,8 @@ from __future__ import annotations
 from dataclasses import dataclass
 from typing import Callable, Sequence
 
+from music_create.composition.note_store import NoteStore
+
 try:
     from PySide6.QtCore import QRect, QSize, Qt
     from PySide6.QtGui import QBrush, QColor, QLinearGradient, QPainter, QPen
@@ -26,6 +28,7 @@ PITCH_CLASS_NAMES: tuple[str, ...] = ("C", "C#", "D", "D#", "E", "F", "F#", "G",
 DEFAULT_VISIBLE_PITCH_COUNT = 24
 DEFAULT_PITCH_LOW = 48
 DEFAULT_PITCH_HIGH = 72
+_QUERY_END_TICK = 1 << 62
 
 
 @dataclass(slots=True)
@@ -137,7 +140,9 @@ class _PianoRollCanvas(QWidget):
             return
 
         painter.setPen(Qt.PenStyle.NoPen)
-        for note in self._editor.notes():
+        notes = self._editor.notes()
+        for index in self._editor.note_indices_in_range(0, _QUERY_END_TICK, visible_low, visible_high):
+            note = notes[index]
             rect = self._note_rect(note)
             if rect is None:
                 continue
@@ -190,6 +195,7 @@ class _PianoRollCanvas(QWidget):
         note = self._editor.notes()[self._drag_index]
         note.start_tick = max(0, self._drag_origin_start + snapped_delta_tick)
         note.pitch = min(max(self._drag_origin_pitch + delta_pitch, 0), 127)
+        self._editor.note_moved(self._drag_index)
         self._editor.update_views()
 
     def mouseReleaseEvent(self, event) -> None:  # type: ignore[override]
@@ -229,7 +235,11 @@ class _PianoRollCanvas(QWidget):
         inner = self._inner_rect()
         if not inner.contains(int(x), int(y)):
             return None
-        for index in range(len(self._editor.notes()) - 1, -1, -1):
+        tick, pitch = self._point_to_tick_pitch(x, y)
+        # Rects are at least a few pixels wide, so widen the tick window before the exact rect test.
+        slack = int(self._editor.total_ticks() * max(3.0 / max(inner.width(), 1), 0.005)) + 1
+        candidates = self._editor.note_indices_in_range(tick - slack, tick + slack + 1, pitch, pitch)
+        for index in reversed(candidates):
             rect = self._note_rect(self._editor.notes()[index])
             if rect is not None and rect.contains(int(x), int(y)):
                 return index
@@ -254,6 +264,7 @@ class ScrollablePianoRollEditor(QWidget):
         super().__init__(parent)
         self.setMinimumHeight(280)
         self._notes: list[PianoRollNote] = []
+        self._note_index: NoteStore | None = None
         self._total_ticks = 3840
         self._editable = False
         self._on_notes_changed: Callable[[list[PianoRollNote]], None] | None = None
@@ -280,6 +291,7 @@ class ScrollablePianoRollEditor(QWidget):
 
     def clear(self) -> None:
         self._notes = []
+        self._rebuild_note_index()
         self._total_ticks = 3840
         self.focus_pitch_range(DEFAULT_PITCH_LOW, DEFAULT_PITCH_HIGH)
         self.update_views()
@@ -303,6 +315,7 @@ class ScrollablePianoRollEditor(QWidget):
                 except (TypeError, ValueError):
                     continue
         self._notes = converted
+        self._rebuild_note_index()
         self._total_ticks = max(int(total_ticks), 1)
         low, high = roll_pitch_range(converted)
         self.focus_pitch_range(low, high)
@@ -320,6 +333,22 @@ class ScrollablePianoRollEditor(QWidget):
     def notes(self) -> list[PianoRollNote]:
         return self._notes
 
+    def note_indices_in_range(self, begin_tick: int, end_tick: int, low_pitch: int, high_pitch: int) -> list[int]:
+        """Ascending indices of notes overlapping [begin_tick, end_tick) within the pitch range."""
+        if self._note_index is not None:
+            return sorted(self._note_index.query(begin_tick, end_tick, low_pitch, high_pitch))
+        return [
+            index
+            for index, note in enumerate(self._notes)
+            if low_pitch <= note.pitch <= high_pitch
+            and note.start_tick < end_tick
+            and note.start_tick + max(note.length_tick, 1) > begin_tick
+        ]
+
+    def note_moved(self, index: int) -> None:
+        if self._note_index is not None:
+            self._note_index.update(index, self._notes[index])
+
     def total_ticks(self) -> int:
         return self._total_ticks
 
@@ -381,6 +410,14 @@ class ScrollablePianoRollEditor(QWidget):
     def note_rect_for_index(self, index: int) -> QRect | None:
         return self.roll_canvas.note_rect_for_index(index)
 
+    def _rebuild_note_index(self) -> None:
+        if self._note_index is None:
+            self._note_index = NoteStore.try_create()
+        if self._note_index is None:
+            return
+        self._note_index.clear()
+        self._note_index.add(self._notes)
+
     def _update_scrollbar_range(self) -> None:
         maximum = max(self._pitch_max - self._pitch_min - self._visible_pitch_count + 1, 0)
         self.vertical_scrollbar.setRange(0, maximum)
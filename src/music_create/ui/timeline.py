@@ -4,9 +4,13 @@ from __future__ import annotations
 
 import math
 from dataclasses import asdict, dataclass, is_dataclass
-from typing import Any
+from pathlib import Path
+from typing import Any, cast
 from uuid import uuid4
 
+from music_create.audio.transport import FadeCurve, TransportClip
+from music_create.ui.transport_display import bar_to_seconds
+
 DEFAULT_TRACK_COLORS: tuple[str, ...] = (
     "#4D8FF4",
     "#66B7FF",
@@ -15,6 +19,7 @@ DEFAULT_TRACK_COLORS: tuple[str, ...] = (
     "#E4B84D",
     "#C28EFF",
 )
+AUDIO_FADE_CURVES: tuple[str, ...] = ("linear", "equal_power", "s_curve")
 
 
 @dataclass(slots=True)
@@ -41,6 +46,18 @@ class TimelineClip:
         return self.start_bar + self.length_bars - 1
 
 
+@dataclass(slots=True)
+class AudioClipEdits:
+    """Non-destructive edits of an audio clip, applied by the engine as it plays."""
+
+    source_offset_seconds: float = 0.0  # trimmed off the head of the file
+    gain_db: float = 0.0
+    fade_in_seconds: float = 0.0
+    fade_out_seconds: float = 0.0
+    fade_in_curve: str = "equal_power"
+    fade_out_curve: str = "equal_power"
+
+
 class TimelineState:
     def __init__(
         self,
@@ -63,6 +80,7 @@ class TimelineState:
         self.tracks: dict[str, TimelineTrack] = {}
         self.clips: dict[str, TimelineClip] = {}
         self.midi_clip_data: dict[str, dict[str, Any]] = {}
+        self.audio_clip_edits: dict[str, AudioClipEdits] = {}
 
     def add_track(
         self,
@@ -156,8 +174,56 @@ class TimelineState:
         if clip_id in self.clips:
             del self.clips[clip_id]
         self.midi_clip_data.pop(clip_id, None)
+        self.audio_clip_edits.pop(clip_id, None)
         self._recompute_content_end_bar()
 
+    def clip_edits(self, clip_id: str) -> AudioClipEdits:
+        """Edits of an audio clip; an unedited clip plays its file as is."""
+        return self.audio_clip_edits.get(clip_id) or AudioClipEdits()
+
+    def set_clip_edits(self, clip_id: str, edits: AudioClipEdits) -> None:
+        clip = self.clips.get(clip_id)
+        if clip is None:
+            raise KeyError(f"clip '{clip_id}' not found")
+        if clip.clip_type != "audio":
+            raise ValueError("only audio clips take trim, gain and fade edits")
+        if min(edits.source_offset_seconds, edits.fade_in_seconds, edits.fade_out_seconds) < 0.0:
+            raise ValueError("offsets and fade lengths must be non-negative")
+        for curve in (edits.fade_in_curve, edits.fade_out_curve):
+            if curve not in AUDIO_FADE_CURVES:
+                raise ValueError(f"unsupported fade curve '{curve}'")
+        self.audio_clip_edits[clip_id] = edits
+
+    def transport_clip(
+        self,
+        clip_id: str,
+        path: str | Path,
+        sample_rate: int,
+        tempo_bpm: float,
+        beats_per_bar: float = 4.0,
+    ) -> TransportClip:
+        """An audio clip and its edits in frames, for `NativeTransport` to play or `set_clip_edits()`."""
+        clip = self.clips.get(clip_id)
+        if clip is None:
+            raise KeyError(f"clip '{clip_id}' not found")
+        if clip.clip_type != "audio":
+            raise ValueError("only audio clips play from a file")
+        edits = self.clip_edits(clip_id)
+        start = bar_to_seconds(clip.start_bar, tempo_bpm, beats_per_bar)
+        end = bar_to_seconds(clip.start_bar + clip.length_bars, tempo_bpm, beats_per_bar)
+        return TransportClip(
+            track_id=clip.track_id,
+            path=Path(path),
+            start_frame=round(start * sample_rate),
+            offset_frame=round(edits.source_offset_seconds * sample_rate),
+            length_frames=round((end - start) * sample_rate),
+            gain=10.0 ** (edits.gain_db / 20.0),
+            fade_in_frames=round(edits.fade_in_seconds * sample_rate),
+            fade_out_frames=round(edits.fade_out_seconds * sample_rate),
+            fade_in_curve=cast(FadeCurve, edits.fade_in_curve),
+            fade_out_curve=cast(FadeCurve, edits.fade_out_curve),
+        )
+
     def set_playhead_bar(self, bar: float) -> None:
         requested = max(float(bar), 1.0)
         target_bar = max(int(math.ceil(requested)), 1)
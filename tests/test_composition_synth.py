@@ -1,5 +1,11 @@
+import platform
+import wave
 from pathlib import Path
 
+import pytest
+
+from music_create.audio.native_engine import ensure_native_library
+from music_create.composition import synth
 from music_create.composition.models import MidiClipDraft, MidiNoteEvent
 from music_create.composition.synth import render_clip_to_wav
 
@@ -29,3 +35,71 @@ def test_instrument_program_changes_rendered_audio(tmp_path: Path) -> None:
     assert piano_wav.exists()
     assert lead_wav.exists()
     assert piano_wav.read_bytes() != lead_wav.read_bytes()
+
+
+def _wav_samples(path: Path) -> list[int]:
+    with wave.open(str(path), "rb") as wav:
+        frames = wav.readframes(wav.getnframes())
+    return [int.from_bytes(frames[index : index + 2], "little", signed=True) for index in range(0, len(frames), 2)]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_wavetable_render_matches_additive_reference(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    ensure_native_library()
+    clip = _clip(0)
+    native_wav = render_clip_to_wav(clip, tmp_path / "native.wav")
+    monkeypatch.setattr(synth, "_render_tones_native", lambda _buffer, _clip: False)
+    reference_wav = render_clip_to_wav(clip, tmp_path / "reference.wav")
+
+    native = _wav_samples(native_wav)
+    reference = _wav_samples(reference_wav)
+    assert len(native) == len(reference)
+    assert max(abs(a - b) for a, b in zip(native, reference)) <= 8
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_voice_lanes_match_scalar_render() -> None:
+    ensure_native_library()
+    clip = _clip(80)
+    clip.notes.extend(
+        MidiNoteEvent(start_tick=120 * index, length_tick=480 + 37 * index, pitch=48 + index, velocity=60 + index, channel=0)
+        for index in range(24)
+    )
+    frames = synth.SAMPLE_RATE * 3
+    scalar = [0.0] * frames
+    assert synth._render_tones_native(scalar, clip, lane_width=1)
+    for lane_width in (4, 8, 16, 0):
+        lanes = [0.0] * frames
+        assert synth._render_tones_native(lanes, clip, lane_width=lane_width)
+        assert max(abs(a - b) for a, b in zip(lanes, scalar)) < 1e-4
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_drum_cache_matches_synthesized_hits(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    ensure_native_library()
+    pitches = (36, 38, 42, 46, 49)
+    clip = MidiClipDraft(
+        name="drums",
+        bars=2,
+        grid="1/16",
+        notes=[
+            MidiNoteEvent(
+                start_tick=240 * index,
+                length_tick=120 + 60 * index,
+                pitch=pitches[index % 5],
+                velocity=40 + 5 * index,
+                channel=9,
+            )
+            for index in range(16)
+        ],
+        program=None,
+        is_drum=True,
+    )
+    native_wav = render_clip_to_wav(clip, tmp_path / "native.wav")
+    monkeypatch.setattr(synth, "_render_drums_native", lambda _buffer, _clip: False)
+    reference_wav = render_clip_to_wav(clip, tmp_path / "reference.wav")
+
+    native = _wav_samples(native_wav)
+    reference = _wav_samples(reference_wav)
+    assert len(native) == len(reference)
+    assert max(abs(a - b) for a, b in zip(native, reference)) <= 2
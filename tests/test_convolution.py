@@ -0,0 +1,59 @@
+import math
+import platform
+import random
+
+import pytest
+
+from music_create.audio.convolution import ConvolutionIr, ConvolutionReverb, render_convolution_send
+from music_create.audio.native_engine import ensure_native_library
+from music_create.mixing.mixer_graph import SendState
+
+pytestmark = pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+
+
+def _direct_convolution(signal: list[float], ir: list[float]) -> list[float]:
+    out = [0.0] * (len(signal) + len(ir) - 1)
+    for index, sample in enumerate(signal):
+        if sample == 0.0:
+            continue
+        for offset, tap in enumerate(ir):
+            out[index + offset] += sample * tap
+    return out
+
+
+def _decaying_noise(length: int, seed: int) -> list[float]:
+    rng = random.Random(seed)
+    return [rng.uniform(-1.0, 1.0) * math.exp(-4.0 * index / length) * 0.1 for index in range(length)]
+
+
+def test_convolution_send_matches_direct_convolution_with_tail_partitions() -> None:
+    ensure_native_library()
+    # 64-sample blocks put everything past 2048 samples into the large tail partitions.
+    ir = ConvolutionIr(_decaying_noise(6000, seed=7), block_size=64)
+    rng = random.Random(3)
+    dry = [rng.uniform(-1.0, 1.0) if index % 97 < 40 else 0.0 for index in range(3000)]
+
+    wet = render_convolution_send(dry, SendState(target_bus_id="reverb", level_db=-6.0), ir)
+    gain = 10.0 ** (-6.0 / 20.0)
+    expected = _direct_convolution([sample * gain for sample in dry], _decaying_noise(6000, seed=7))
+
+    assert len(wet) == len(expected)
+    assert max(abs(a - b) for a, b in zip(wet, expected)) < 1e-4
+    ir.close()
+
+
+def test_convolution_reverbs_share_ir_and_report_block_latency() -> None:
+    ensure_native_library()
+    ir = ConvolutionIr([1.0, 0.5], block_size=128)
+    first = ConvolutionReverb(ir)
+    second = ConvolutionReverb(ir)
+    ir.close()
+
+    assert first.latency == 128
+    impulse = [1.0] + [0.0] * 299
+    for reverb in (first, second):
+        out = reverb.process(impulse[:100]) + reverb.process(impulse[100:])
+        assert out[128] == pytest.approx(1.0, abs=1e-6)
+        assert out[129] == pytest.approx(0.5, abs=1e-6)
+        assert max(abs(value) for value in out[:128]) < 1e-6
+        reverb.close()
@@ -0,0 +1,105 @@
+import ctypes
+import platform
+from pathlib import Path
+
+import pytest
+
+from music_create.audio.native_engine import ensure_native_library
+from music_create.composition.midi_file import MidiTempoPoint, _require_library, export_midi_file, import_midi_file
+from music_create.composition.models import MidiClipDraft, MidiNoteEvent
+
+
+def _chunk(kind: bytes, body: bytes) -> bytes:
+    return kind + len(body).to_bytes(4, "big") + body
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_import_rescales_ticks_and_handles_running_status(tmp_path: Path) -> None:
+    ensure_native_library()
+    conductor = bytes([0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, 0x00, 0xFF, 0x2F, 0x00])
+    # 480 PPQ: running-status note-ons, velocity-0 note-offs and a program change.
+    piano = bytes(
+        [0x00, 0xFF, 0x03, 0x05]
+        + list(b"Piano")
+        + [0x00, 0xC0, 0x05]
+        + [0x00, 0x90, 0x3C, 0x64]
+        + [0x00, 0x40, 0x50]
+        + [0x83, 0x60, 0x3C, 0x00]
+        + [0x00, 0x40, 0x00]
+        + [0x00, 0x43, 0x70]
+        + [0x81, 0x70, 0x80, 0x43, 0x40]
+        + [0x00, 0xFF, 0x2F, 0x00]
+    )
+    drums = bytes([0x00, 0x99, 0x24, 0x7F, 0x78, 0x89, 0x24, 0x00, 0x00, 0xFF, 0x2F, 0x00])
+    header = _chunk(b"MThd", (1).to_bytes(2, "big") + (3).to_bytes(2, "big") + (480).to_bytes(2, "big"))
+    midi_path = tmp_path / "handmade.mid"
+    midi_path.write_bytes(header + _chunk(b"MTrk", conductor) + _chunk(b"MTrk", piano) + _chunk(b"MTrk", drums))
+
+    result = import_midi_file(midi_path)
+    assert result.initial_bpm == pytest.approx(120.0)
+    assert [track for track, _ in result.clips] == [1, 2]
+    piano_clip = result.clips[0][1]
+    assert piano_clip.name == "Piano"
+    assert piano_clip.program == 5
+    assert [(n.start_tick, n.length_tick, n.pitch, n.velocity) for n in piano_clip.notes] == [
+        (0, 960, 60, 100),
+        (0, 960, 64, 80),
+        (960, 480, 67, 112),
+    ]
+    drum_clip = result.clips[1][1]
+    assert drum_clip.is_drum
+    assert drum_clip.program is None
+    assert [(n.start_tick, n.length_tick, n.channel) for n in drum_clip.notes] == [(0, 240, 9)]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_export_then_import_round_trips_clips(tmp_path: Path) -> None:
+    ensure_native_library()
+    lead = MidiClipDraft(
+        name="Lead",
+        bars=2,
+        grid="1/16",
+        notes=[MidiNoteEvent(index * 240, 240, 60 + index % 12, 90, 0) for index in range(32)]
+        + [MidiNoteEvent(0, 7680, 48, 70, 0), MidiNoteEvent(0, 960, 48, 60, 0)],
+        program=33,
+        is_drum=False,
+    )
+    drums = MidiClipDraft(
+        name="Drums",
+        bars=1,
+        grid="1/16",
+        notes=[MidiNoteEvent(index * 960, 120, 36, 127, 9) for index in range(4)],
+        program=None,
+        is_drum=True,
+    )
+    midi_path = tmp_path / "round_trip.mid"
+    export_midi_file(midi_path, [lead, drums], [MidiTempoPoint(0, 100.0), MidiTempoPoint(3840, 140.0)])
+
+    result = import_midi_file(midi_path)
+    assert [point.tick for point in result.tempo_map] == [0, 3840]
+    assert result.tempo_map[1].bpm == pytest.approx(140.0, abs=1e-3)
+    imported = {clip.name: clip for _, clip in result.clips}
+    assert imported["Lead"].program == 33
+    assert imported["Lead"].bars == 2
+    expected = sorted((n.start_tick, n.pitch, n.length_tick, n.velocity) for n in lead.notes)
+    assert sorted((n.start_tick, n.pitch, n.length_tick, n.velocity) for n in imported["Lead"].notes) == expected
+    assert imported["Drums"].is_drum
+    assert [note.start_tick for note in imported["Drums"].notes] == [0, 960, 1920, 2880]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_add_notes_rejects_track_past_the_last_index() -> None:
+    ensure_native_library()
+    lib = _require_library(None)
+    handle = lib.mc_smf_create(960)
+    try:
+        ints = (ctypes.c_int * 2)(0, 240)
+        bytes_ = (ctypes.c_ubyte * 2)(60, 64)
+        tracks = (ctypes.c_ushort * 2)(1, 0xFFFF)
+        assert not lib.mc_smf_add_notes(handle, 2, ints, ints, bytes_, bytes_, bytes_, tracks)
+        assert lib.mc_smf_note_count(handle) == 0
+        tracks[1] = 0xFFFE
+        assert lib.mc_smf_add_notes(handle, 2, ints, ints, bytes_, bytes_, bytes_, tracks)
+        assert lib.mc_smf_track_count(handle) == 0xFFFF
+    finally:
+        lib.mc_smf_free(handle)
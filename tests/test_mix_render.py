@@ -1,10 +1,16 @@
 import math
+import platform
 import wave
 from pathlib import Path
 
+import pytest
+
+from music_create.audio import mix_render
 from music_create.audio.mix_render import is_track_processing_active, render_track_preview_wav
+from music_create.audio.native_engine import ensure_native_library
+from music_create.audio.saturator import oversampling_factor, render_saturator
 from music_create.audio.wav_loader import load_wav_mono_float32
-from music_create.mixing.mixer_graph import MixerGraph
+from music_create.mixing.mixer_graph import DELAY_BUS_ID, MixerGraph, SendState
 from music_create.mixing.models import BuiltinEffectType
 
 
@@ -56,3 +62,151 @@ def test_render_track_preview_applies_fx_changes(tmp_path: Path) -> None:
     assert len(src_data.samples) == len(dst_data.samples)
     mean_abs_diff = sum(abs(a - b) for a, b in zip(src_data.samples, dst_data.samples)) / len(src_data.samples)
     assert mean_abs_diff > 0.005
+
+
+def _write_click_wav(path: Path, sample_rate: int = 48_000, duration_sec: float = 0.6) -> None:
+    frames = bytearray(int(sample_rate * duration_sec) * 2)
+    frames[0:2] = (16000).to_bytes(2, "little", signed=True)
+    with wave.open(str(path), "wb") as wav:
+        wav.setnchannels(1)
+        wav.setsampwidth(2)
+        wav.setframerate(sample_rate)
+        wav.writeframes(bytes(frames))
+
+
+def test_render_track_preview_delay_follows_tempo(tmp_path: Path) -> None:
+    track = MixerGraph().ensure_track("track-1")
+    delay = track.fx_chain.effects[BuiltinEffectType.DELAY].parameters
+    delay["mix"] = 0.5
+    delay["time_beats"] = 0.25
+    delay["damping"] = 0.0
+    assert is_track_processing_active(track) is True
+
+    src = tmp_path / "click.wav"
+    _write_click_wav(src)
+    for tempo_bpm, echo_at in ((120.0, 6000), (150.0, 4800)):
+        dst = tmp_path / f"delay_{int(tempo_bpm)}.wav"
+        render_track_preview_wav(src, dst, track, tempo_bpm=tempo_bpm)
+        samples = load_wav_mono_float32(dst).samples
+        loudest = max(range(1, len(samples)), key=lambda index: abs(samples[index]))
+        assert loudest == echo_at
+        assert abs(samples[echo_at]) > 0.2
+
+
+
+def test_render_track_preview_mixes_in_shared_delay_return(tmp_path: Path) -> None:
+    graph = MixerGraph()
+    bus = graph.ensure_send_effect_bus(DELAY_BUS_ID)
+    bus.fx_chain.effects[BuiltinEffectType.DELAY].parameters.update(
+        {"time_beats": 0.25, "feedback": 0.0, "damping": 0.0}
+    )
+    track = graph.ensure_track("track-1")
+    assert is_track_processing_active(track, graph.buses) is False
+    track.sends.append(SendState(target_bus_id=DELAY_BUS_ID, level_db=-6.0))
+    assert is_track_processing_active(track, graph.buses) is True
+
+    src = tmp_path / "click.wav"
+    dst = tmp_path / "send.wav"
+    _write_click_wav(src)
+    render_track_preview_wav(src, dst, track, tempo_bpm=120.0, buses=graph.buses)
+    samples = load_wav_mono_float32(dst).samples
+    # The dry click stays untouched and the fully wet bus returns it a
+    # sixteenth later at the send level.
+    dry = 16000 / 32768
+    assert abs(samples[0] - dry) < 1e-3
+    assert abs(samples[6000] - dry * 10.0 ** (-6.0 / 20.0)) < 1e-3
+    assert max(abs(sample) for index, sample in enumerate(samples) if index not in {0, 6000}) < 1e-3
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_reverb_and_delay_match_reference(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    ensure_native_library()
+    track = MixerGraph().ensure_track("track-1")
+    track.fx_chain.effects[BuiltinEffectType.REVERB].parameters.update({"mix": 0.4, "decay_s": 1.1, "size": 0.5})
+    track.fx_chain.effects[BuiltinEffectType.DELAY].parameters.update({"mix": 0.3, "time_beats": 0.3})
+
+    src = tmp_path / "src.wav"
+    _write_test_wav(src, duration_sec=0.4)
+    native_dst = tmp_path / "native.wav"
+    render_track_preview_wav(src, native_dst, track, tempo_bpm=97.0)
+    monkeypatch.setattr(mix_render, "render_fdn_reverb", lambda *_: None)
+    monkeypatch.setattr(mix_render, "render_tempo_delay", lambda *_: None)
+    reference_dst = tmp_path / "reference.wav"
+    render_track_preview_wav(src, reference_dst, track, tempo_bpm=97.0)
+
+    native = load_wav_mono_float32(native_dst).samples
+    reference = load_wav_mono_float32(reference_dst).samples
+    assert max(abs(a - b) for a, b in zip(native, reference)) < 2e-4
+
+
+def _limited_track(ceiling_db: float) -> MixerGraph:
+    graph = MixerGraph()
+    track = graph.ensure_track("track-1")
+    track.input_gain_db = 12.0
+    track.fx_chain.effects[BuiltinEffectType.LIMITER].parameters.update({"ceiling_db": ceiling_db, "release_ms": 40.0})
+    return graph
+
+
+def _peak(path: Path) -> float:
+    with wave.open(str(path), "rb") as wav:
+        frames = wav.readframes(wav.getnframes())
+    values = [int.from_bytes(frames[index : index + 2], "little", signed=True) for index in range(0, len(frames), 2)]
+    return max(abs(value) for value in values) / 32768.0
+
+
+def test_render_track_preview_limiter_holds_ceiling(tmp_path: Path) -> None:
+    track = _limited_track(ceiling_db=-6.0).tracks["track-1"]
+    assert is_track_processing_active(track) is True
+
+    src = tmp_path / "src.wav"
+    dst = tmp_path / "limited.wav"
+    _write_test_wav(src)
+    render_track_preview_wav(src, dst, track)
+
+    # +12 dB would push the peaks to about 2.2; the limiter holds them at the ceiling
+    # and the centre pan then applies its -3 dB equal-power gain.
+    ceiling = 10.0 ** (-6.0 / 20.0) * math.sqrt(0.5)
+    assert ceiling * 0.9 < _peak(dst) <= ceiling + 1.0 / 32768.0
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_limiter_matches_reference(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> None:
+    ensure_native_library()
+    track = _limited_track(ceiling_db=-3.0).tracks["track-1"]
+
+    src = tmp_path / "src.wav"
+    _write_test_wav(src, duration_sec=0.4)
+    native_dst = tmp_path / "native.wav"
+    render_track_preview_wav(src, native_dst, track)
+    monkeypatch.setattr(mix_render, "render_limiter", lambda *_: None)
+    reference_dst = tmp_path / "reference.wav"
+    render_track_preview_wav(src, reference_dst, track)
+
+    native = load_wav_mono_float32(native_dst).samples
+    reference = load_wav_mono_float32(reference_dst).samples
+    assert max(abs(a - b) for a, b in zip(native, reference)) < 2e-4
+
+
+def _tone_level(samples: list[float], frequency: float, sample_rate: int) -> float:
+    real = sum(sample * math.cos(2.0 * math.pi * frequency * index / sample_rate) for index, sample in enumerate(samples))
+    imag = sum(sample * math.sin(2.0 * math.pi * frequency * index / sample_rate) for index, sample in enumerate(samples))
+    return 2.0 * math.hypot(real, imag) / len(samples)
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_saturator_oversampling_suppresses_aliases() -> None:
+    ensure_native_library()
+    sample_rate = 48_000
+    # A 7 kHz tone driven hard: its 5th and 7th harmonics (35 and 49 kHz)
+    # fold back to 13 kHz and 1 kHz at the base rate.
+    tone = [0.8 * math.sin(2.0 * math.pi * 7000.0 * index / sample_rate) for index in range(4800)]
+    levels: dict[float, tuple[float, float, float]] = {}
+    for oversampling in (1.0, 4.0):
+        out = render_saturator(tone, {"drive": 1.0, "mix": 1.0, "oversampling": oversampling})
+        assert out is not None and len(out) == len(tone)
+        levels[oversampling] = tuple(_tone_level(out, hz, sample_rate) for hz in (7000.0, 13000.0, 1000.0))
+
+    assert levels[4.0][0] == pytest.approx(levels[1.0][0], rel=0.05)
+    assert levels[1.0][1] > 0.01 and levels[1.0][2] > 0.01
+    assert levels[4.0][1] < levels[1.0][1] * 0.05
+    assert levels[4.0][2] < levels[1.0][2] * 0.05
+    assert [oversampling_factor(value) for value in (1.0, 1.4, 2.0, 3.0, 6.0, 8.0)] == [1, 1, 2, 4, 8, 8]
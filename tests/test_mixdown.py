@@ -0,0 +1,186 @@
+import ctypes
+import math
+import platform
+
+import pytest
+
+from music_create.audio import mixdown
+from music_create.audio.mixdown import render_mixdown
+from music_create.audio.native_engine import ensure_native_library, load_native_library
+from music_create.mixing.mixer_graph import MixerGraph, SendState
+from music_create.mixing.models import BuiltinEffectType, ChannelLayout
+
+pytestmark = pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+
+SAMPLE_RATE = 48000
+BEAT = SAMPLE_RATE // 2
+HIT = 4800
+
+
+def _kick(frames: int) -> list[float]:
+    out = [0.0] * frames
+    for start in range(0, frames, BEAT):
+        for index in range(min(HIT, frames - start)):
+            out[start + index] = 0.9 * math.sin(2.0 * math.pi * 60.0 * index / SAMPLE_RATE)
+    return out
+
+
+def _bass(frames: int) -> list[float]:
+    return [0.5 * math.sin(2.0 * math.pi * 110.0 * index / SAMPLE_RATE) for index in range(frames)]
+
+
+def _rms(samples: list[float]) -> float:
+    return math.sqrt(sum(sample * sample for sample in samples) / len(samples))
+
+
+def _ducking_graph(sidechain: bool) -> MixerGraph:
+    graph = MixerGraph()
+    # The bass is added first so the graph has to reorder it after its key.
+    bass = graph.ensure_track("bass")
+    kick = graph.ensure_track("kick")
+    bass.pan = 1.0
+    kick.pan = -1.0
+    compressor = bass.fx_chain.effects[BuiltinEffectType.COMPRESSOR].parameters
+    compressor.update({"threshold_db": -30.0, "ratio": 8.0, "attack_ms": 1.0, "release_ms": 60.0})
+    if sidechain:
+        bass.sidechains[BuiltinEffectType.COMPRESSOR] = "kick"
+    return graph
+
+
+def test_sidechain_compressor_ducks_bass_under_kick() -> None:
+    ensure_native_library()
+    frames = BEAT * 4
+    sources = {"kick": [_kick(frames)], "bass": [_bass(frames)]}
+
+    keyed = render_mixdown(_ducking_graph(sidechain=True), sources, SAMPLE_RATE)
+    plain = render_mixdown(_ducking_graph(sidechain=False), sources, SAMPLE_RATE)
+
+    assert len(keyed[0]) == frames
+    assert max(abs(sample) for sample in keyed[0]) > 0.5
+
+    def hit_and_gap(right: list[float]) -> tuple[float, float]:
+        hits = [sample for start in range(BEAT, frames, BEAT) for sample in right[start + 480 : start + HIT]]
+        gaps = [sample for start in range(BEAT, frames, BEAT) for sample in right[start + HIT + 6000 : start + BEAT]]
+        return _rms(hits), _rms(gaps)
+
+    keyed_hit, keyed_gap = hit_and_gap(keyed[1])
+    plain_hit, plain_gap = hit_and_gap(plain[1])
+    assert keyed_hit < keyed_gap * 0.5
+    assert plain_hit == pytest.approx(plain_gap, rel=0.05)
+
+
+def test_sidechain_cycle_is_rejected() -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("bass").sends.append(SendState(target_bus_id="glue"))
+    glue = graph.ensure_bus("glue")
+    glue.sidechains[BuiltinEffectType.GATE] = "bass"
+    graph.tracks["bass"].sidechains[BuiltinEffectType.COMPRESSOR] = "glue"
+
+    with pytest.raises(ValueError):
+        render_mixdown(graph, {"bass": [_bass(1024)]}, SAMPLE_RATE)
+
+    graph.tracks["bass"].sidechains[BuiltinEffectType.COMPRESSOR] = "missing"
+    with pytest.raises(ValueError):
+        render_mixdown(graph, {"bass": [_bass(1024)]}, SAMPLE_RATE)
+
+
+def test_master_limiter_keeps_mixdown_below_ceiling() -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    for track_id in ("kick", "bass"):
+        graph.ensure_track(track_id).fader_db = 6.0
+    graph.ensure_bus("master").fx_chain.effects[BuiltinEffectType.LIMITER].parameters["ceiling_db"] = -3.0
+    frames = BEAT * 2
+    sources = {"kick": [_kick(frames)], "bass": [_bass(frames)]}
+
+    mixed = render_mixdown(graph, sources, SAMPLE_RATE)
+
+    ceiling = 10.0 ** (-3.0 / 20.0)
+    peak = max(abs(sample) for channel in mixed for sample in channel)
+    assert ceiling * 0.95 < peak <= ceiling
+
+
+def test_latency_compensation_aligns_paths_sample_exactly() -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    # "late" runs a 5 ms lookahead limiter; "direct" has none but also sends
+    # to a bus whose limiter looks 10 ms ahead. Quiet impulses never trigger
+    # gain reduction, so every path stays an exact unit delay.
+    late = graph.ensure_track("late")
+    late.pan = -1.0
+    late.fx_chain.effects[BuiltinEffectType.LIMITER].parameters["ceiling_db"] = -0.5
+    direct = graph.ensure_track("direct")
+    direct.pan = 1.0
+    direct.sends.append(SendState(target_bus_id="crush", level_db=0.0))
+    crush = graph.ensure_bus("crush")
+    crush.fx_chain.effects[BuiltinEffectType.LIMITER].parameters.update({"ceiling_db": -0.5, "lookahead_ms": 10.0})
+
+    impulse = [0.0] * 4000
+    impulse[1000] = 0.1
+    left, right = render_mixdown(graph, {"late": [impulse], "direct": [impulse]}, SAMPLE_RATE, block_size=256)
+
+    assert len(left) == len(impulse)
+    assert max(range(len(left)), key=lambda index: abs(left[index])) == 1000
+    assert left[1000] == pytest.approx(0.1, abs=1e-6)
+    # The direct path and the bus return land on the same sample.
+    assert right[1000] == pytest.approx(0.2, abs=1e-6)
+    assert max(abs(sample) for index, sample in enumerate(right) if index != 1000) < 1e-6
+
+
+def test_level_change_on_compiled_graph_glides_per_sample() -> None:
+    ensure_native_library()
+    lib = load_native_library()
+    mixdown.declare_mix_graph_api(lib)
+    handle = lib.mc_mix_graph_create(SAMPLE_RATE, 256)
+    try:
+        track = lib.mc_mix_graph_add_node(handle, 0)
+        assert lib.mc_mix_graph_compile(handle)
+        frames = SAMPLE_RATE // 5
+        ones = (ctypes.c_float * frames)(*([1.0] * frames))
+        inputs = (ctypes.POINTER(ctypes.c_float) * 4)()
+        inputs[2] = inputs[3] = ctypes.cast(ones, ctypes.POINTER(ctypes.c_float))
+        left = (ctypes.c_float * frames)()
+        right = (ctypes.c_float * frames)()
+
+        # Hard left at -20 dB without recompiling: the gains ramp instead of
+        # stepping and settle on the new levels.
+        assert lib.mc_mix_graph_set_levels(handle, track, 0.0, -20.0, -1.0)
+        assert lib.mc_mix_graph_process(handle, inputs, left, right, frames)
+    finally:
+        lib.mc_mix_graph_free(handle)
+
+    centre = math.sqrt(0.5)
+    assert left[0] == pytest.approx(centre, rel=0.01)
+    assert right[0] == pytest.approx(centre, rel=0.01)
+    assert max(abs(right[index + 1] - right[index]) for index in range(frames - 1)) < 0.01
+    assert all(right[index + 1] <= right[index] for index in range(frames - 1))
+    assert left[-1] == pytest.approx(0.1, rel=1e-4)
+    assert abs(right[-1]) < 1e-6
+
+
+def test_surround_layouts_pan_into_centre_and_fold_to_stereo() -> None:
+    ensure_native_library()
+    impulse = [0.0] * 2000
+    impulse[500] = 0.1
+    silence = [0.0] * len(impulse)
+
+    # A centred mono track lands on C of a 5.1 master and nowhere else.
+    surround = MixerGraph()
+    surround.ensure_bus("master").channel_layout = ChannelLayout.SURROUND_5_1
+    surround.ensure_track("voice").channel_layout = ChannelLayout.MONO
+    stems = render_mixdown(surround, {"voice": [impulse]}, SAMPLE_RATE)
+
+    assert len(stems) == 6
+    assert stems[2][500] == pytest.approx(0.1, abs=1e-6)
+    assert max(abs(sample) for index, channel in enumerate(stems) if index != 2 for sample in channel) < 1e-6
+
+    # A 5.1 track folds its left surround into the left of a stereo master
+    # at -3 dB and drops the LFE.
+    stereo = MixerGraph()
+    stereo.ensure_track("ambience").channel_layout = ChannelLayout.SURROUND_5_1
+    channels = [silence, silence, silence, impulse, impulse, silence]
+    left, right = render_mixdown(stereo, {"ambience": channels}, SAMPLE_RATE)
+
+    assert left[500] == pytest.approx(0.1 * math.sqrt(0.5), abs=1e-6)
+    assert max(abs(sample) for sample in right) < 1e-6
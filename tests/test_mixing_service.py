@@ -1,3 +1,6 @@
+import math
+
+from music_create.mixing.mixer_graph import REVERB_BUS_ID
 from music_create.mixing.service import MixingService
 from music_create.mixing.models import BuiltinEffectType
 
@@ -125,3 +128,65 @@ def test_suggestion_mode_can_be_updated() -> None:
     assert service.get_suggestion_mode() == "rule-based"
     service.set_suggestion_mode("llm-based")
     assert service.get_suggestion_mode() == "llm-based"
+
+
+def test_time_based_suggestions_set_sends_into_shared_buses() -> None:
+    service = MixingService(track_signal_provider=_signal_provider)
+    graph = service.get_mixer_graph()
+    commands = {}
+    for track_id in ("kick", "snare"):
+        suggestion = service.suggest(track_id=track_id, profile="warm")[0]
+        assert REVERB_BUS_ID in suggestion.send_levels
+        assert BuiltinEffectType.REVERB not in suggestion.param_updates
+        commands[track_id] = service.apply(track_id, suggestion.suggestion_id)
+
+    # One fully wet reverb bus serves both tracks; their inserts stay dry.
+    reverb_bus = graph.buses[REVERB_BUS_ID]
+    assert reverb_bus.fx_chain.effects[BuiltinEffectType.REVERB].parameters["mix"] == 1.0
+    for track_id in ("kick", "snare"):
+        track = graph.tracks[track_id]
+        assert [send.target_bus_id for send in track.sends] == [REVERB_BUS_ID]
+        assert track.fx_chain.effects[BuiltinEffectType.REVERB].parameters["mix"] == 0.0
+
+    service.revert(commands["kick"])
+    assert graph.tracks["kick"].sends == []
+    assert len(graph.tracks["snare"].sends) == 1
+
+
+def test_preview_blends_send_level_and_cancel_removes_it() -> None:
+    service = MixingService(track_signal_provider=_signal_provider)
+    suggestion = service.suggest(track_id="snare", profile="clean")[0]
+    target_db = suggestion.send_levels[REVERB_BUS_ID]
+
+    service.preview("snare", suggestion.suggestion_id, dry_wet=0.5)
+    (send,) = service.get_mixer_graph().tracks["snare"].sends
+    assert abs(send.level_db - (target_db + 20.0 * math.log10(0.5))) < 1e-9
+
+    assert REVERB_BUS_ID in service.get_mixer_graph().buses
+
+    service.cancel_preview("snare")
+    assert service.get_mixer_graph().tracks["snare"].sends == []
+    assert REVERB_BUS_ID not in service.get_mixer_graph().buses
+
+
+def test_cancelled_preview_keeps_send_buses_still_in_use() -> None:
+    service = MixingService(track_signal_provider=_signal_provider)
+    graph = service.get_mixer_graph()
+    snare = service.suggest(track_id="snare", profile="clean")[0]
+    kick = service.suggest(track_id="kick", profile="clean")[0]
+
+    # Another track still previewing through the bus keeps it.
+    service.preview("snare", snare.suggestion_id)
+    service.preview("kick", kick.suggestion_id)
+    service.cancel_preview("snare")
+    assert REVERB_BUS_ID in graph.buses
+    service.cancel_preview("kick")
+    assert REVERB_BUS_ID not in graph.buses
+
+    # Applying commits the bus a preview created.
+    service.preview("snare", snare.suggestion_id)
+    service.apply("snare", snare.suggestion_id)
+    service.preview("kick", kick.suggestion_id)
+    service.cancel_preview("kick")
+    assert REVERB_BUS_ID in graph.buses
+    assert [send.target_bus_id for send in graph.tracks["snare"].sends] == [REVERB_BUS_ID]
@@ -0,0 +1,233 @@
+import math
+import platform
+import struct
+import wave
+from pathlib import Path
+
+import pytest
+
+from music_create.audio.native_engine import ensure_native_library
+from music_create.audio.native_reader import NativeAudioFileReader, load_audio_mono_float32, load_audio_planar_float32
+from music_create.audio.repository import WaveformRepository
+
+_BLOCK = 4096
+
+
+def _crc8(data: bytes) -> int:
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def _crc16(data: bytes) -> int:
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x8005) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+_CHANNEL_ASSIGNMENTS = {"independent": 1, "left_side": 8, "side_right": 9, "mid_side": 10}
+
+
+def _rice_parameter(residuals: list[int]) -> int:
+    """Smallest parameter that keeps every unary prefix under 16 bits, capped below the escape code."""
+    largest = max((value * 2 if value >= 0 else -value * 2 - 1 for value in residuals), default=0)
+    return min((largest >> 4).bit_length(), 14)
+
+
+def _encode_subframe(put, bits: list[int], block: list[int], sample_bits: int, lpc) -> None:
+    if lpc is None:
+        order = 1
+        put(0, 1)
+        put(8 + order, 6)
+        put(0, 1)
+        residuals = [current - previous for previous, current in zip(block, block[1:])]
+    else:
+        coefficients, precision, shift = lpc
+        order = len(coefficients)
+        put(0, 1)
+        put(31 + order, 6)
+        put(0, 1)
+        residuals = [
+            block[index] - (sum(c * block[index - 1 - lag] for lag, c in enumerate(coefficients)) >> shift)
+            for index in range(order, len(block))
+        ]
+    for value in block[:order]:
+        put(value & ((1 << sample_bits) - 1), sample_bits)
+    if lpc is not None:
+        put(precision - 1, 4)
+        put(shift, 5)
+        for c in coefficients:
+            put(c & ((1 << precision) - 1), precision)
+    put(0, 2)
+    put(0, 4)
+    parameter = _rice_parameter(residuals)
+    put(parameter, 4)
+    for residual in residuals:
+        folded = residual * 2 if residual >= 0 else -residual * 2 - 1
+        bits.extend([0] * (folded >> parameter))
+        bits.append(1)
+        put(folded & ((1 << parameter) - 1), parameter)
+
+
+def _write_test_flac(
+    path: Path,
+    samples: list[int],
+    sample_rate: int = 48000,
+    *,
+    right: list[int] | None = None,
+    assignment: str = "independent",
+    lpc: tuple[list[int], int, int] | None = None,
+) -> None:
+    """16-bit FLAC with one Rice partition per subframe.
+
+    Mono, or stereo with `right` coded as `assignment`. Subframes are FIXED
+    order 1, or LPC with `lpc = (coefficients, precision, shift)`.
+    """
+    channels = 1 if right is None else 2
+    frames = bytearray()
+    for frame_number, start in enumerate(range(0, len(samples), _BLOCK)):
+        left_block = samples[start : start + _BLOCK]
+        if right is None:
+            subframes = [(left_block, 16)]
+            channel_code = 0
+        else:
+            right_block = right[start : start + _BLOCK]
+            side = [l - r for l, r in zip(left_block, right_block)]
+            subframes = {
+                "independent": [(left_block, 16), (right_block, 16)],
+                "left_side": [(left_block, 16), (side, 17)],
+                "side_right": [(side, 17), (right_block, 16)],
+                "mid_side": [([(l + r) >> 1 for l, r in zip(left_block, right_block)], 16), (side, 17)],
+            }[assignment]
+            channel_code = _CHANNEL_ASSIGNMENTS[assignment]
+        header = bytearray([0xFF, 0xF8, (7 << 4) | 10, (channel_code << 4) | (4 << 1), frame_number])
+        header += (len(left_block) - 1).to_bytes(2, "big")
+        header.append(_crc8(bytes(header)))
+        bits: list[int] = []
+
+        def put(value: int, count: int) -> None:
+            bits.extend((value >> shift) & 1 for shift in range(count - 1, -1, -1))
+
+        for block, sample_bits in subframes:
+            _encode_subframe(put, bits, block, sample_bits, lpc)
+        bits.extend([0] * (-len(bits) % 8))
+        body = bytes(header) + bytes(
+            int("".join(str(bit) for bit in bits[index : index + 8]), 2) for index in range(0, len(bits), 8)
+        )
+        frames += body + _crc16(body).to_bytes(2, "big")
+
+    stream_info = bytearray(_BLOCK.to_bytes(2, "big") * 2 + bytes(6))
+    packed = (sample_rate << 44) | ((channels - 1) << 41) | (15 << 36) | len(samples)
+    stream_info += packed.to_bytes(8, "big") + bytes(16)
+    path.write_bytes(b"fLaC" + bytes([0x80, 0, 0, len(stream_info)]) + bytes(stream_info) + bytes(frames))
+
+
+def _test_signal(count: int) -> list[int]:
+    return [int(12000 * math.sin(2 * math.pi * 440 * index / 48000)) for index in range(count)]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_reader_decodes_flac_bit_exact(tmp_path: Path) -> None:
+    ensure_native_library()
+    flac_path = tmp_path / "tone.flac"
+    signal = _test_signal(10_000)
+    _write_test_flac(flac_path, signal)
+
+    loaded = load_audio_mono_float32(flac_path)
+    assert loaded.sample_rate == 48000
+    assert loaded.frame_count == len(signal)
+    assert loaded.samples == [value / 32768.0 for value in signal]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+@pytest.mark.parametrize(
+    "lpc",
+    [
+        ([2043, -1024], 12, 10),  # scalar 32-bit predictor
+        ([2043, -1024, 5, -3, 1], 12, 10),  # SSE4.1 predictor over a padded order
+        ([2043, -1024, 5, -3, 1, 0, -2, 1], 12, 10),
+        ([16344, -8192, 40, -24, 8, 0, -16, 8], 15, 13),  # needs the 64-bit accumulator
+    ],
+)
+def test_native_reader_decodes_lpc_subframes_bit_exact(tmp_path: Path, lpc: tuple[list[int], int, int]) -> None:
+    ensure_native_library()
+    flac_path = tmp_path / "lpc.flac"
+    signal = [value + (index * 7919 % 61) - 30 for index, value in enumerate(_test_signal(10_000))]
+    _write_test_flac(flac_path, signal, lpc=lpc)
+
+    loaded = load_audio_mono_float32(flac_path)
+    assert loaded.samples == [value / 32768.0 for value in signal]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+@pytest.mark.parametrize("assignment", ["independent", "left_side", "side_right", "mid_side"])
+@pytest.mark.parametrize("lpc", [None, ([2043, -1024, 5, -3, 1], 12, 10)])
+def test_native_reader_undoes_stereo_decorrelation(
+    tmp_path: Path, assignment: str, lpc: tuple[list[int], int, int] | None
+) -> None:
+    ensure_native_library()
+    flac_path = tmp_path / "stereo.flac"
+    left = _test_signal(10_000)
+    # Louder and out of phase, so the side channel needs its extra bit.
+    right = [int(-30000 * math.sin(2 * math.pi * 660 * index / 48000)) for index in range(len(left))]
+    _write_test_flac(flac_path, left, right=right, assignment=assignment, lpc=lpc)
+
+    sample_rate, planar = load_audio_planar_float32(flac_path)
+    assert sample_rate == 48000
+    assert planar == [[value / 32768.0 for value in left], [value / 32768.0 for value in right]]
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_reader_seeks_across_frames(tmp_path: Path) -> None:
+    ensure_native_library()
+    flac_path = tmp_path / "seek.flac"
+    signal = _test_signal(20_000)
+    _write_test_flac(flac_path, signal)
+
+    with NativeAudioFileReader(flac_path) as reader:
+        assert reader.info.total_frames == len(signal)
+        for target in (12_345, 100, 4096, 19_999):
+            assert reader.seek(target)
+            assert reader.read(1) == [signal[target] / 32768.0]
+        assert reader.seek(len(signal))
+        assert reader.read(16) == []
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_waveform_repository_loads_flac_track(tmp_path: Path) -> None:
+    ensure_native_library()
+    flac_path = tmp_path / "track.flac"
+    _write_test_flac(flac_path, _test_signal(9_600))
+
+    repository = WaveformRepository()
+    data = repository.load_track_wav("track-1", flac_path)
+    assert data.sample_rate == 48000
+    assert data.duration_sec == pytest.approx(0.2)
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_native_reader_reads_planar_channels(tmp_path: Path) -> None:
+    ensure_native_library()
+    left = _test_signal(70_000)
+    right = [-value // 2 for value in left]
+    wav_path = tmp_path / "stereo.wav"
+    with wave.open(str(wav_path), "wb") as handle:
+        handle.setnchannels(2)
+        handle.setsampwidth(2)
+        handle.setframerate(48000)
+        handle.writeframes(b"".join(struct.pack("<hh", l, r) for l, r in zip(left, right)))
+
+    sample_rate, planar = load_audio_planar_float32(wav_path)
+    assert sample_rate == 48000
+    assert planar == [[value / 32768.0 for value in left], [value / 32768.0 for value in right]]
+
+    flac_path = tmp_path / "mono.flac"
+    _write_test_flac(flac_path, left[:10_000])
+    _, mono = load_audio_planar_float32(flac_path)
+    assert mono == [[value / 32768.0 for value in left[:10_000]]]
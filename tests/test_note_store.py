@@ -0,0 +1,124 @@
+import platform
+import random
+
+import pytest
+
+from music_create.audio.native_engine import ensure_native_library
+from music_create.composition.models import MidiNoteEvent
+from music_create.composition.note_store import NoteStore
+from music_create.composition.quantize import quantize_note
+
+
+def _overlapping(notes: dict[int, MidiNoteEvent], begin: int, end: int, low: int, high: int) -> list[int]:
+    return sorted(
+        note_id
+        for note_id, note in notes.items()
+        if note.start_tick < end and note.start_tick + note.length_tick > begin and low <= note.pitch <= high
+    )
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_note_store_range_queries_match_linear_scan() -> None:
+    ensure_native_library()
+    rng = random.Random(7)
+    notes = [
+        MidiNoteEvent(rng.randrange(0, 200_000), rng.choice((60, 240, 960, 15_360)), rng.randrange(0, 128), 100, 0)
+        for _ in range(20_000)
+    ]
+    with NoteStore() as store:
+        ids = store.add(notes)
+        assert ids == list(range(len(notes)))
+        live = dict(zip(ids, notes))
+        removed = rng.sample(ids, 2_000)
+        assert store.remove(removed) == len(removed)
+        for note_id in removed:
+            live.pop(note_id)
+        assert len(store) == len(live)
+
+        for _ in range(100):
+            begin = rng.randrange(-1_000, 200_000)
+            end = begin + rng.randrange(1, 8_000)
+            low = rng.randrange(0, 128)
+            high = rng.randrange(low, 128)
+            assert sorted(store.query(begin, end, low, high)) == _overlapping(live, begin, end, low, high)
+
+        starting = store.query_starting(10_000, 20_000)
+        assert sorted(starting) == sorted(k for k, n in live.items() if 10_000 <= n.start_tick < 20_000)
+        assert [note.start_tick for note in store.get(starting)] == sorted(live[k].start_tick for k in starting)
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_note_store_update_reindexes_and_reuses_ids() -> None:
+    ensure_native_library()
+    with NoteStore() as store:
+        first, second = store.add([MidiNoteEvent(0, 480, 60, 90, 0), MidiNoteEvent(960, 480, 64, 90, 0)])
+        assert store.update(first, MidiNoteEvent(1920, 240, 67, 70, 1))
+        assert store.query(0, 960) == []
+        assert store.sorted_ids() == [second, first]
+        assert store.get([first]) == [MidiNoteEvent(1920, 240, 67, 70, 1)]
+        assert store.remove([second]) == 1
+        assert store.add([MidiNoteEvent(100, 10, 1, 1, 0)]) == [second]
+        with pytest.raises(KeyError):
+            store.get([99])
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_batch_quantize_matches_python_quantize_and_undoes() -> None:
+    ensure_native_library()
+    rng = random.Random(3)
+    notes = [MidiNoteEvent(rng.randrange(0, 50_000), rng.randrange(1, 2_000), 60, 90, 0) for _ in range(10_000)]
+    with NoteStore() as store:
+        ids = store.add(notes)
+        for grid in ("1/16", "1/8T", "1/32T"):
+            edit = store.quantize(ids, grid)
+            assert len(edit) == len(ids)
+            quantized = store.get(ids)
+            for original, note in zip(notes, quantized):
+                assert (note.start_tick, note.length_tick) == quantize_note(original.start_tick, original.length_tick, grid)
+            assert edit.undo()
+            assert store.get(ids) == notes
+            assert edit.redo()
+            assert store.get(ids) == quantized
+            edit.undo()
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_batch_quantize_strength_swing_and_other_edits() -> None:
+    ensure_native_library()
+    with NoteStore() as store:
+        ids = store.add([MidiNoteEvent(500, 240, 60, 100, 0), MidiNoteEvent(700, 240, 126, 20, 0)])
+        store.quantize(ids, "1/8", strength=0.5, quantize_length=False)
+        assert [note.start_tick for note in store.get(ids)] == [490, 590]
+        store.quantize(ids, "1/8", swing=0.5)
+        assert [note.start_tick for note in store.get(ids)] == [600, 600]
+
+        store.transpose(ids, 5)
+        assert [note.pitch for note in store.get(ids)] == [65, 127]
+        velocity_edit = store.scale_velocity(ids, scale=1.5, offset=-10)
+        assert [note.velocity for note in store.get(ids)] == [127, 20]
+        velocity_edit.undo()
+        assert [note.velocity for note in store.get(ids)] == [100, 20]
+
+        before = store.get(ids)
+        first = store.humanize(ids, timing_ticks=30, velocity_range=10, seed=42)
+        humanized = store.get(ids)
+        first.undo()
+        store.humanize(ids, timing_ticks=30, velocity_range=10, seed=42)
+        assert store.get(ids) == humanized
+        assert all(abs(a.start_tick - b.start_tick) <= 30 for a, b in zip(before, humanized))
+
+
+@pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+def test_undo_skips_notes_whose_id_was_recycled() -> None:
+    ensure_native_library()
+    with NoteStore() as store:
+        edited, kept = store.add([MidiNoteEvent(0, 480, 60, 90, 0), MidiNoteEvent(960, 480, 64, 90, 0)])
+        edit = store.transpose([edited, kept], 2)
+        assert store.remove([edited]) == 1
+        newcomer = MidiNoteEvent(1920, 240, 72, 80, 0)
+        assert store.add([newcomer]) == [edited]  # the freed id is reused
+
+        assert edit.undo()
+        assert store.get([edited, kept]) == [newcomer, MidiNoteEvent(960, 480, 64, 90, 0)]
+        assert edit.redo()
+        assert store.get([edited, kept]) == [newcomer, MidiNoteEvent(960, 480, 66, 90, 0)]
@@ -0,0 +1,128 @@
+import math
+import platform
+import wave
+from pathlib import Path
+
+import pytest
+
+from music_create.audio.native_engine import ensure_native_library
+from music_create.composition.models import MidiClipDraft, MidiNoteEvent
+from music_create.composition.sfz_sampler import SfzInstrument
+from music_create.composition.synth import SAMPLE_RATE, render_clip_to_wav
+
+pytestmark = pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+
+
+def _write_wav(path: Path, samples: list[int], channels: int = 1) -> None:
+    with wave.open(str(path), "wb") as wav:
+        wav.setnchannels(channels)
+        wav.setsampwidth(2)
+        wav.setframerate(SAMPLE_RATE)
+        wav.writeframes(b"".join(value.to_bytes(2, "little", signed=True) for value in samples))
+
+
+def _instrument_dir(tmp_path: Path) -> Path:
+    frames = SAMPLE_RATE * 2
+    stereo: list[int] = []
+    for index in range(frames):
+        value = int(8000 * math.sin(2 * math.pi * 220 * index / SAMPLE_RATE)) + index % 61
+        stereo.extend((value, -value))
+    samples = tmp_path / "samples"
+    samples.mkdir()
+    _write_wav(samples / "soft tone.wav", [int(4000 * math.sin(2 * math.pi * index / 100)) for index in range(2000)])
+    _write_wav(samples / "loud tone.wav", stereo, channels=2)
+    (tmp_path / "piano.sfz").write_text(
+        "// two velocity layers\n"
+        "<control> default_path=samples/\n"
+        "<global> amp_veltrack=0 ampeg_release=0\n"
+        "<group> lokey=c3 hikey=c5 pitch_keycenter=60\n"
+        "<region> sample=soft tone.wav hivel=63 loop_mode=loop_continuous loop_start=0 loop_end=99\n"
+        "<region> sample=loud tone.wav lovel=64\n",
+        encoding="utf-8",
+    )
+    return tmp_path
+
+
+def test_sfz_instrument_streams_sample_tail_bit_exact(tmp_path: Path) -> None:
+    ensure_native_library()
+    root = _instrument_dir(tmp_path)
+    frames = SAMPLE_RATE * 2
+    with SfzInstrument(root / "piano.sfz", SAMPLE_RATE) as instrument:
+        assert instrument.region_count == 2
+        assert instrument.resident_bytes < 64 * 1024 * 1024
+        stereo = instrument.render_notes([0], [frames * 2], [60], [100], frames)
+
+    source = [int(8000 * math.sin(2 * math.pi * 220 * index / SAMPLE_RATE)) + index % 61 for index in range(frames)]
+    for index in (0, 1000, 40_000, 90_000, frames - 1):
+        assert stereo[index * 2] == pytest.approx(source[index] / 32768.0, abs=1e-6)
+        assert stereo[index * 2 + 1] == pytest.approx(-source[index] / 32768.0, abs=1e-6)
+
+
+def test_sfz_instrument_selects_velocity_layer_and_loops(tmp_path: Path) -> None:
+    ensure_native_library()
+    root = _instrument_dir(tmp_path)
+    frames = SAMPLE_RATE
+    with SfzInstrument(root / "piano.sfz", SAMPLE_RATE) as instrument:
+        soft = instrument.render_notes([0], [frames], [60], [40], frames)
+
+    # The soft layer is a 100-frame looped cycle, so it keeps sounding well past its 2000 frames.
+    assert max(abs(value) for value in soft[frames : frames * 2]) > 0.1
+    assert soft[(frames - 100) * 2] == pytest.approx(soft[(frames - 200) * 2], abs=1e-6)
+
+
+def test_render_clip_to_wav_with_sfz_instrument_writes_stereo(tmp_path: Path) -> None:
+    ensure_native_library()
+    root = _instrument_dir(tmp_path)
+    clip = MidiClipDraft(
+        name="sampled",
+        bars=1,
+        grid="1/16",
+        notes=[MidiNoteEvent(start_tick=0, length_tick=960, pitch=64, velocity=100, channel=0)],
+        program=0,
+        is_drum=False,
+    )
+    with SfzInstrument(root / "piano.sfz", SAMPLE_RATE) as instrument:
+        wav_path = render_clip_to_wav(clip, tmp_path / "sampled.wav", instrument=instrument)
+
+    with wave.open(str(wav_path), "rb") as wav:
+        assert wav.getnchannels() == 2
+        assert wav.getnframes() > 0
+
+
+def test_render_clip_to_wav_follows_the_instrument_sample_rate(tmp_path: Path) -> None:
+    ensure_native_library()
+    root = _instrument_dir(tmp_path)
+    rate = 44100
+    clip = MidiClipDraft(
+        name="sampled",
+        bars=1,
+        grid="1/16",
+        notes=[MidiNoteEvent(start_tick=960, length_tick=960, pitch=60, velocity=100, channel=0)],
+        program=0,
+        is_drum=False,
+    )
+    with SfzInstrument(root / "piano.sfz", rate) as instrument:
+        wav_path = render_clip_to_wav(clip, tmp_path / "sampled.wav", instrument=instrument)
+
+    with wave.open(str(wav_path), "rb") as wav:
+        assert wav.getframerate() == rate
+        assert wav.getnframes() == int(1.1 * rate)
+        frames = wav.readframes(wav.getnframes())
+    left = [int.from_bytes(frames[index : index + 2], "little", signed=True) for index in range(0, len(frames), 4)]
+    # The note starts half a second in, at the instrument's rate.
+    onset = next(index for index, value in enumerate(left) if value != 0)
+    assert rate // 2 <= onset <= rate // 2 + 2
+
+
+@pytest.mark.parametrize(("policy", "stolen"), [("oldest", True), ("same_note", True), ("none", False)])
+def test_sfz_instrument_voice_stealing(tmp_path: Path, policy: str, stolen: bool) -> None:
+    ensure_native_library()
+    root = _instrument_dir(tmp_path)
+    frames = SAMPLE_RATE // 2
+    with SfzInstrument(root / "piano.sfz", SAMPLE_RATE, max_voices=1, steal_policy=policy) as instrument:
+        # Held soft (mono, L == R) note, then a loud (R == -L) note on the same key with no free voice.
+        stereo = instrument.render_notes([0, 10_000], [frames, frames], [60, 60], [40, 100], frames)
+
+    left, right = stereo[20_025 * 2], stereo[20_025 * 2 + 1]
+    assert abs(left) > 1e-3
+    assert right == pytest.approx(-left if stolen else left, abs=1e-6)
@@ -0,0 +1,48 @@
+import math
+import platform
+
+import pytest
+
+from music_create.audio.native_engine import ensure_native_library
+from music_create.audio.time_stretch import stretch_for_tempo, time_stretch
+
+pytestmark = pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+
+SAMPLE_RATE = 48000
+
+
+def _tone(frames: int, hz: float) -> list[float]:
+    return [0.5 * math.sin(2.0 * math.pi * hz * index / SAMPLE_RATE) for index in range(frames)]
+
+
+def _rising_crossings_hz(samples: list[float]) -> float:
+    middle = samples[len(samples) // 4 : len(samples) * 3 // 4]
+    crossings = [index for index in range(1, len(middle)) if middle[index - 1] < 0.0 <= middle[index]]
+    return (len(crossings) - 1) * SAMPLE_RATE / (crossings[-1] - crossings[0])
+
+
+@pytest.mark.parametrize("mode", ["wsola", "phase_vocoder"])
+def test_tempo_match_changes_length_but_not_pitch(mode: str) -> None:
+    ensure_native_library()
+    stretch = stretch_for_tempo(source_bpm=120.0, project_bpm=96.0)
+    source = _tone(SAMPLE_RATE, 440.0)
+
+    stretched = time_stretch([source, source], SAMPLE_RATE, stretch, mode=mode)
+
+    assert stretched is not None
+    assert [len(channel) for channel in stretched] == [round(SAMPLE_RATE * 1.25)] * 2
+    assert _rising_crossings_hz(stretched[0]) == pytest.approx(440.0, rel=0.01)
+
+
+def test_pitch_shift_keeps_length() -> None:
+    ensure_native_library()
+    shifted = time_stretch([_tone(SAMPLE_RATE, 440.0)], SAMPLE_RATE, 1.0, semitones=12.0, mode="phase_vocoder")
+
+    assert shifted is not None
+    assert len(shifted[0]) == SAMPLE_RATE
+    assert _rising_crossings_hz(shifted[0]) == pytest.approx(880.0, rel=0.01)
+
+
+def test_stretch_for_tempo_rejects_non_positive_tempos() -> None:
+    with pytest.raises(ValueError):
+        stretch_for_tempo(0.0, 120.0)
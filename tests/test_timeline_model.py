@@ -1,6 +1,8 @@
+from pathlib import Path
+
 import pytest
 
-from music_create.ui.timeline import TimelineState
+from music_create.ui.timeline import AudioClipEdits, TimelineState
 
 
 def test_add_track_and_clip() -> None:
@@ -83,3 +85,47 @@ def test_add_track_stores_instrument_metadata() -> None:
     assert track.program == 10
     assert track.is_drum is False
     assert track.color == "#123456"
+
+
+def test_audio_clip_edits_are_validated_and_dropped_with_the_clip() -> None:
+    timeline = TimelineState(bars=16)
+    track = timeline.add_track("Vocals")
+    audio = timeline.add_clip(track_id=track.track_id, clip_type="audio", start_bar=1, length_bars=4)
+    midi = timeline.add_clip(track_id=track.track_id, clip_type="midi", start_bar=5, length_bars=4)
+
+    assert timeline.clip_edits(audio.clip_id) == AudioClipEdits()
+    edits = AudioClipEdits(source_offset_seconds=0.5, gain_db=-6.0, fade_in_seconds=0.01, fade_out_curve="s_curve")
+    timeline.set_clip_edits(audio.clip_id, edits)
+    assert timeline.clip_edits(audio.clip_id) == edits
+
+    with pytest.raises(ValueError):
+        timeline.set_clip_edits(midi.clip_id, AudioClipEdits())
+    with pytest.raises(ValueError):
+        timeline.set_clip_edits(audio.clip_id, AudioClipEdits(fade_out_seconds=-1.0))
+    with pytest.raises(ValueError):
+        timeline.set_clip_edits(audio.clip_id, AudioClipEdits(fade_in_curve="exponential"))
+
+    timeline.remove_clip(audio.clip_id)
+    assert audio.clip_id not in timeline.audio_clip_edits
+
+
+def test_audio_clip_edits_map_onto_a_transport_clip() -> None:
+    timeline = TimelineState(bars=16)
+    track = timeline.add_track("Vocals")
+    audio = timeline.add_clip(track_id=track.track_id, clip_type="audio", start_bar=3, length_bars=2)
+    midi = timeline.add_clip(track_id=track.track_id, clip_type="midi", start_bar=5, length_bars=4)
+    timeline.set_clip_edits(
+        audio.clip_id,
+        AudioClipEdits(source_offset_seconds=0.5, gain_db=-6.0, fade_in_seconds=0.01, fade_out_curve="s_curve"),
+    )
+
+    # Two 4/4 bars at 120 BPM are four seconds.
+    clip = timeline.transport_clip(audio.clip_id, "take.wav", 48000, 120.0)
+    assert (clip.track_id, clip.path) == (track.track_id, Path("take.wav"))
+    assert (clip.start_frame, clip.length_frames, clip.offset_frame) == (192000, 192000, 24000)
+    assert clip.gain == pytest.approx(0.501187, rel=1e-5)
+    assert (clip.fade_in_frames, clip.fade_out_frames) == (480, 0)
+    assert (clip.fade_in_curve, clip.fade_out_curve) == ("equal_power", "s_curve")
+
+    with pytest.raises(ValueError):
+        timeline.transport_clip(midi.clip_id, "take.wav", 48000, 120.0)
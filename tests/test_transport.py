@@ -0,0 +1,245 @@
+import math
+import platform
+import struct
+import time
+import wave
+from pathlib import Path
+
+import pytest
+
+from music_create.audio.mixdown import render_mixdown
+from music_create.audio.native_engine import ensure_native_library
+from music_create.audio.transport import NativeTransport, TransportClip
+from music_create.mixing.mixer_graph import MixerGraph
+from music_create.ui.timeline import AudioClipEdits, TimelineState
+
+pytestmark = pytest.mark.skipif(platform.system() != "Windows", reason="native engine test is Windows-specific")
+
+SAMPLE_RATE = 48000
+BLOCK = 256
+
+
+def _write_stereo_wav(path: Path, frames: int, hz: float) -> list[list[float]]:
+    values = [
+        [int(round(4000 * math.sin(2.0 * math.pi * hz * index / SAMPLE_RATE + side))) for index in range(frames)]
+        for side in range(2)
+    ]
+    with wave.open(str(path), "wb") as handle:
+        handle.setnchannels(2)
+        handle.setsampwidth(2)
+        handle.setframerate(SAMPLE_RATE)
+        handle.writeframes(b"".join(struct.pack("<hh", left, right) for left, right in zip(*values)))
+    return [[value / 32768.0 for value in channel] for channel in values]
+
+
+def test_cued_playback_starts_at_the_cue_point_without_underruns(tmp_path: Path) -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("keys")
+    graph.ensure_track("bass").pan = -0.5
+    keys = _write_stereo_wav(tmp_path / "keys.wav", SAMPLE_RATE, 440.0)
+    bass = _write_stereo_wav(tmp_path / "bass.wav", SAMPLE_RATE, 110.0)
+    clips = [
+        TransportClip("keys", tmp_path / "keys.wav", start_frame=2000),
+        TransportClip("bass", tmp_path / "bass.wav", start_frame=30000, offset_frame=1000, length_frames=20000),
+    ]
+    cue = 24000
+    frames = BLOCK * 32
+
+    timeline = 2000 + SAMPLE_RATE
+    sources = {"keys": [[0.0] * timeline for _ in range(2)], "bass": [[0.0] * timeline for _ in range(2)]}
+    for side in range(2):
+        sources["keys"][side][2000:] = keys[side]
+        sources["bass"][side][30000:50000] = bass[side][1000:21000]
+    expected = render_mixdown(graph, sources, SAMPLE_RATE, block_size=BLOCK)
+
+    with NativeTransport(graph, clips, SAMPLE_RATE, block_size=BLOCK) as transport:
+        transport.cue(SAMPLE_RATE // 4)
+        assert transport.cue(cue)
+        assert transport.render(BLOCK) == [[0.0] * BLOCK, [0.0] * BLOCK]  # stopped
+        assert transport.play()
+        played = [[], []]
+        for _ in range(frames // BLOCK):
+            for side, samples in enumerate(transport.render(BLOCK)):
+                played[side].extend(samples)
+        assert transport.position == cue + frames
+        assert transport.underruns == 0
+
+    for side in range(2):
+        assert played[side] == pytest.approx(expected[side][cue : cue + frames], abs=1e-5)
+
+
+def test_scrubbing_follows_the_drag_and_fades_when_held(tmp_path: Path) -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("keys")
+    _write_stereo_wav(tmp_path / "keys.wav", SAMPLE_RATE * 2, 440.0)
+    clips = [TransportClip("keys", tmp_path / "keys.wav", start_frame=0)]
+
+    with NativeTransport(graph, clips, SAMPLE_RATE, block_size=BLOCK) as transport:
+        transport.cue(SAMPLE_RATE // 2)
+        assert transport.begin_scrub()
+        dragged = []
+        for index in range(1, 121):
+            assert transport.scrub_to(SAMPLE_RATE // 2 + index * BLOCK)
+            dragged.extend(transport.render(BLOCK)[0])
+            time.sleep(BLOCK / SAMPLE_RATE)  # lets the streams load like real time would
+        target = SAMPLE_RATE // 2 + 120 * BLOCK
+        held = []
+        for _ in range(60):
+            transport.scrub_to(target)
+            held.extend(transport.render(BLOCK)[0])
+        position = transport.position
+        assert transport.end_scrub()
+
+    assert max(abs(value) for value in dragged[-BLOCK * 20 :]) > 0.01
+    assert max(abs(value) for value in held[-BLOCK * 10 :]) < 1e-4
+    assert abs(position - target) <= 2
+
+
+def test_stretched_clip_plays_longer_at_the_same_pitch(tmp_path: Path) -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("loop")
+    _write_stereo_wav(tmp_path / "loop.wav", SAMPLE_RATE // 2, 440.0)
+    clips = [TransportClip("loop", tmp_path / "loop.wav", start_frame=0, stretch=1.5)]
+
+    with NativeTransport(graph, clips, SAMPLE_RATE, block_size=BLOCK) as transport:
+        assert transport.cue(0)
+        assert transport.play()
+        played = []
+        for _ in range(SAMPLE_RATE // BLOCK):
+            played.extend(transport.render(BLOCK)[0])
+            time.sleep(BLOCK / SAMPLE_RATE)  # real time, as the prefetcher expects
+        assert transport.underruns == 0
+
+    stretched_end = round(SAMPLE_RATE // 2 * 1.5)
+    middle = played[stretched_end // 4 : stretched_end * 3 // 4]
+    crossings = [index for index in range(1, len(middle)) if middle[index - 1] < 0.0 <= middle[index]]
+    assert (len(crossings) - 1) * SAMPLE_RATE / (crossings[-1] - crossings[0]) == pytest.approx(440.0, rel=0.01)
+    assert max(abs(value) for value in played[stretched_end - BLOCK * 4 : stretched_end - BLOCK * 2]) > 0.01
+    assert max(abs(value) for value in played[stretched_end + BLOCK * 2 :]) == 0.0
+
+
+def test_clip_fades_and_gain_shape_playback_without_touching_the_file(tmp_path: Path) -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("keys")
+    path = tmp_path / "keys.wav"
+    _write_stereo_wav(path, SAMPLE_RATE, 440.0)
+    original = path.read_bytes()
+    fade = BLOCK * 8
+    frames = BLOCK * 16
+
+    def play(transport: NativeTransport) -> list[float]:
+        assert transport.cue(0)
+        assert transport.play()
+        return [value for _ in range(frames // BLOCK) for value in transport.render(BLOCK)[0]]
+
+    with NativeTransport(graph, [TransportClip("keys", path, start_frame=0)], SAMPLE_RATE, block_size=BLOCK) as transport:
+        plain = play(transport)
+        assert transport.set_clip_fades(0, fade, 0, fade_in_curve="linear")
+        assert transport.set_clip_gain(0, 0.5)
+        edited = play(transport)
+        with pytest.raises(ValueError):
+            transport.set_clip_fades(0, fade, 0, fade_in_curve="exponential")
+
+    expected = [value * 0.5 * min((index + 0.5) / fade, 1.0) for index, value in enumerate(plain)]
+    assert edited == pytest.approx(expected, abs=1e-5)
+    assert path.read_bytes() == original
+
+
+def test_timeline_clip_edits_reach_the_engine(tmp_path: Path) -> None:
+    ensure_native_library()
+    timeline = TimelineState(bars=4)
+    track = timeline.add_track("Keys")
+    audio = timeline.add_clip(track_id=track.track_id, clip_type="audio", start_bar=1, length_bars=1)
+    graph = MixerGraph()
+    graph.ensure_track(track.track_id)
+    path = tmp_path / "keys.wav"
+    _write_stereo_wav(path, SAMPLE_RATE * 2, 440.0)
+    offset = SAMPLE_RATE // 4
+    fade = BLOCK * 8
+    frames = BLOCK * 16
+
+    def play(transport: NativeTransport) -> list[float]:
+        assert transport.cue(0)
+        assert transport.play()
+        return [value for _ in range(frames // BLOCK) for value in transport.render(BLOCK)[0]]
+
+    # One 4/4 bar at 240 BPM is one second.
+    clips = [timeline.transport_clip(audio.clip_id, path, SAMPLE_RATE, 240.0)]
+    with NativeTransport(graph, clips, SAMPLE_RATE, block_size=BLOCK) as transport:
+        assert transport.set_clip_trim(0, 0, offset, SAMPLE_RATE)
+        plain = play(transport)
+        edits = AudioClipEdits(
+            source_offset_seconds=offset / SAMPLE_RATE,
+            gain_db=20.0 * math.log10(0.5),
+            fade_in_seconds=fade / SAMPLE_RATE,
+            fade_in_curve="linear",
+        )
+        timeline.set_clip_edits(audio.clip_id, edits)
+        clip = timeline.transport_clip(audio.clip_id, path, SAMPLE_RATE, 240.0)
+        assert transport.set_clip_edits(0, clip, trim=True)
+        edited = play(transport)
+
+    expected = [value * 0.5 * min((index + 0.5) / fade, 1.0) for index, value in enumerate(plain)]
+    assert edited == pytest.approx(expected, abs=1e-5)
+
+
+def test_clip_edits_on_a_playing_transport_keep_it_sounding(tmp_path: Path) -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("keys")
+    path = tmp_path / "keys.wav"
+    _write_stereo_wav(path, SAMPLE_RATE, 440.0)
+    blocks = 8
+
+    def render(transport: NativeTransport) -> list[float]:
+        return [value for _ in range(blocks) for value in transport.render(BLOCK)[0]]
+
+    clips = [TransportClip("keys", path, start_frame=0)]
+    with NativeTransport(graph, clips, SAMPLE_RATE, block_size=BLOCK) as transport:
+        assert transport.cue(0)
+        assert transport.play()
+        before = render(transport)
+        halved = TransportClip("keys", path, start_frame=0, gain=0.5, fade_out_frames=SAMPLE_RATE // 2)
+        assert transport.set_clip_edits(0, halved)
+        after = render(transport)
+
+    # The first blocks after the edit still carry the graph latency at the old gain.
+    loudest = max(abs(value) for value in before)
+    assert max(abs(value) for value in after[len(after) // 2 :]) == pytest.approx(loudest * 0.5, rel=0.05)
+
+
+def test_click_follows_the_tempo_map_on_its_own_output() -> None:
+    ensure_native_library()
+    graph = MixerGraph()
+    graph.ensure_track("keys")
+    with NativeTransport(graph, [], SAMPLE_RATE, tempo_bpm=120.0, block_size=BLOCK) as transport:
+        # Two beats at 120 BPM, then 90 BPM in 3/4.
+        assert transport.set_click_map([(0.0, 120.0), (2.0, 90.0)], [(0.0, 4, 4), (2.0, 3, 4)])
+        assert transport.set_click(True, 0.5)
+        assert transport.cue(0)
+        assert transport.play()
+        master: list[float] = []
+        click: list[float] = []
+        for _ in range(2 * SAMPLE_RATE // BLOCK):
+            outputs, clicks = transport.render_with_click(BLOCK)
+            master.extend(outputs[0])
+            click.extend(clicks)
+        with pytest.raises(ValueError):
+            transport.set_click_map([(1.0, 120.0)])
+
+    onsets = [index for index in range(1, len(click)) if click[index - 1] == 0.0 and click[index] != 0.0]
+    beats = [0, SAMPLE_RATE // 2, SAMPLE_RATE, SAMPLE_RATE + SAMPLE_RATE * 2 // 3]
+    # Each click starts at phase zero, so its first non-zero sample is one frame in.
+    assert onsets == [beat + 1 for beat in beats]
+    assert max(abs(value) for value in master) == 0.0
+
+
+def test_clip_on_unknown_track_is_rejected(tmp_path: Path) -> None:
+    ensure_native_library()
+    _write_stereo_wav(tmp_path / "keys.wav", 1000, 440.0)
+    with pytest.raises(ValueError):
+        NativeTransport(MixerGraph(), [TransportClip("keys", tmp_path / "keys.wav", 0)], SAMPLE_RATE)